@@ -0,0 +1,202 @@
+// Description: Reproducible data-sets for benchmarks.
+// Documentation: benchmarking.txt
+
+#ifndef PASTELBENCHMARK_DATASET_H
+#define PASTELBENCHMARK_DATASET_H
+
+#include "benchmark/benchmark_init.h"
+
+#include "pastel/sys/vector.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace PastelBenchmark
+{
+
+	//! A point distribution.
+	enum class Dataset : integer
+	{
+		//! Uniform in [0, 1]^d.
+		Uniform,
+		//! A mixture of 16 narrow gaussians in [0, 1]^d.
+		Clustered,
+		//! Uniform on a random 2-dimensional plane in [0, 1]^d.
+		Manifold
+	};
+
+	inline const std::vector<Dataset>& datasetSet()
+	{
+		static const std::vector<Dataset> result =
+		{
+			Dataset::Uniform,
+			Dataset::Clustered,
+			Dataset::Manifold
+		};
+		return result;
+	}
+
+	inline std::string datasetName(Dataset dataset)
+	{
+		switch(dataset)
+		{
+		case Dataset::Uniform:
+			return "Uniform";
+		case Dataset::Clustered:
+			return "Clustered";
+		case Dataset::Manifold:
+			return "Manifold";
+		};
+		return "";
+	}
+
+	//! A random number generator with the same sequence on all platforms.
+	/*!
+	The distributions of the standard library are
+	implementation-defined; only the engines are not.
+	*/
+	class Random
+	{
+	public:
+		explicit Random(uint64 seed)
+			: engine_(seed)
+		{
+		}
+
+		//! Returns a uniform random number in [0, 1).
+		dreal uniform()
+		{
+			return (dreal)(engine_() >> 11) * 0x1.0p-53;
+		}
+
+		//! Returns a random number from the standard normal distribution.
+		dreal gaussian()
+		{
+			// Box-Muller transform.
+			dreal u = 1 - uniform();
+			dreal v = uniform();
+			return std::sqrt(-2 * std::log(u)) *
+				std::cos(2 * constantPi<dreal>() * v);
+		}
+
+		//! Returns a uniform random integer in [0, n).
+		integer index(integer n)
+		{
+			return std::min((integer)(uniform() * n), n - 1);
+		}
+
+	private:
+		std::mt19937_64 engine_;
+	};
+
+	//! Generates a reproducible point-set.
+	/*!
+	The same 'dataset', 'n', and 'seed' always give
+	the same points. The points of different seeds are
+	independent; a query-set is generated with a seed
+	different from that of the data-set.
+	*/
+	template <int N>
+	std::vector<Vector<dreal, N>> generatePointSet(
+		Dataset dataset,
+		integer n,
+		uint64 seed = 0)
+	{
+		using Point = Vector<dreal, N>;
+
+		// The centers and the planes depend only on
+		// the dimension, so that the query-sets
+		// follow the distribution of the data-sets.
+		Random shape(N + 1);
+		Random random(seed * 3 + (uint64)dataset + 0x5eed);
+
+		std::vector<Point> pointSet;
+		pointSet.reserve(n);
+
+		switch(dataset)
+		{
+		case Dataset::Uniform:
+		{
+			for (integer i = 0;i < n;++i)
+			{
+				Point point;
+				for (integer k = 0;k < N;++k)
+				{
+					point[k] = random.uniform();
+				}
+				pointSet.push_back(point);
+			}
+			break;
+		}
+		case Dataset::Clustered:
+		{
+			integer clusters = 16;
+			dreal deviation = 0.02;
+
+			std::vector<Point> centerSet;
+			for (integer j = 0;j < clusters;++j)
+			{
+				Point center;
+				for (integer k = 0;k < N;++k)
+				{
+					center[k] = 0.1 + 0.8 * shape.uniform();
+				}
+				centerSet.push_back(center);
+			}
+
+			for (integer i = 0;i < n;++i)
+			{
+				const Point& center = centerSet[random.index(clusters)];
+				Point point;
+				for (integer k = 0;k < N;++k)
+				{
+					point[k] = center[k] + deviation * random.gaussian();
+				}
+				pointSet.push_back(point);
+			}
+			break;
+		}
+		case Dataset::Manifold:
+		{
+			// The plane is spanned by two random directions
+			// through the center of the unit cube.
+			Point u;
+			Point v;
+			for (integer k = 0;k < N;++k)
+			{
+				u[k] = shape.gaussian();
+				v[k] = shape.gaussian();
+			}
+			u /= norm(u);
+			v -= dot(u, v) * u;
+			v /= norm(v);
+
+			for (integer i = 0;i < n;++i)
+			{
+				dreal s = random.uniform() - 0.5;
+				dreal t = random.uniform() - 0.5;
+				Point point = 0.5 + s * u + t * v;
+				pointSet.push_back(point);
+			}
+			break;
+		}
+		};
+
+		return pointSet;
+	}
+
+	//! Returns the side-length of a query cube with 'k' expected points.
+	/*!
+	The side-length is exact for the uniform
+	distribution.
+	*/
+	inline dreal rangeSide(integer k, integer n, integer d)
+	{
+		return std::min(std::pow((dreal)k / n, (dreal)1 / d), (dreal)1);
+	}
+
+}
+
+#endif
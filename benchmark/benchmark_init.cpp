@@ -0,0 +1,347 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "benchmark/benchmark_init.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace PastelBenchmark
+{
+
+	namespace
+	{
+
+		Options options_;
+		std::vector<MeasureTable> tableSet_;
+
+		std::atomic<integer> allocatedBytes_(0);
+		std::atomic<integer> peakBytes_(0);
+
+		// The header in front of each allocation,
+		// which stores the size of the allocation.
+		constexpr integer HeaderSize = alignof(std::max_align_t);
+
+		struct Header
+		{
+			void* memory;
+			integer size;
+		};
+
+		static_assert(sizeof(Header) <= HeaderSize,
+			"The header must fit before the allocation.");
+
+		void* allocate(std::size_t size, std::size_t alignment)
+		{
+			// Over-allocate so that there is room for the header,
+			// and the result can be aligned to 'alignment'.
+			std::size_t extra = HeaderSize +
+				(alignment > (std::size_t)HeaderSize ? alignment : 0);
+			void* memory = std::malloc(size + extra);
+			if (!memory)
+			{
+				throw std::bad_alloc();
+			}
+
+			std::uintptr_t address = (std::uintptr_t)memory + HeaderSize;
+			if (alignment > (std::size_t)HeaderSize)
+			{
+				address = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+			}
+
+			Header* header = (Header*)(address - sizeof(Header));
+			header->memory = memory;
+			header->size = size;
+
+			integer bytes = allocatedBytes_.fetch_add(size) + size;
+			integer peak = peakBytes_.load(std::memory_order_relaxed);
+			while (bytes > peak &&
+				!peakBytes_.compare_exchange_weak(peak, bytes))
+			{
+			}
+
+			return (void*)address;
+		}
+
+		void deallocate(void* address)
+		{
+			if (!address)
+			{
+				return;
+			}
+
+			Header* header = (Header*)((std::uintptr_t)address - sizeof(Header));
+			allocatedBytes_.fetch_sub(header->size);
+			std::free(header->memory);
+		}
+
+		void printTables(
+			std::ostream& stream,
+			void (*print)(const MeasureTable&, std::ostream&))
+		{
+			for (const MeasureTable& table : tableSet_)
+			{
+				print(table, stream);
+				stream << std::endl;
+			}
+		}
+
+		void writeOutput(const std::string& prefix)
+		{
+			std::ofstream pretty(prefix + ".txt");
+			printTables(pretty, printPretty);
+
+			std::ofstream latex(prefix + ".tex");
+			printTables(latex, printLatex);
+
+			// The tables form an array of Json objects.
+			std::ofstream json(prefix + ".json");
+			json << "[" << std::endl;
+			for (integer i = 0;i < tableSet_.size();++i)
+			{
+				printJson(tableSet_[i], json);
+				if (i < (integer)tableSet_.size() - 1)
+				{
+					json << "," << std::endl;
+				}
+			}
+			json << "]" << std::endl;
+		}
+
+	}
+
+	const Options& options()
+	{
+		return options_;
+	}
+
+	void report(const MeasureTable& table)
+	{
+		printPretty(table, std::cout);
+		std::cout << std::endl;
+		tableSet_.push_back(table);
+	}
+
+	integer allocatedBytes()
+	{
+		return allocatedBytes_.load();
+	}
+
+	integer peakBytes()
+	{
+		return peakBytes_.load();
+	}
+
+	void resetPeakBytes()
+	{
+		peakBytes_.store(allocatedBytes_.load());
+	}
+
+	void setHeader(
+		MeasureTable& table,
+		std::initializer_list<std::string> nameSet)
+	{
+		table.setSize(nameSet.size(), 1);
+
+		integer x = 0;
+		for (const std::string& name : nameSet)
+		{
+			table(x, 0).text() = name;
+			if (x > 0)
+			{
+				table(x, 0).setAlignment(MeasureTable::Alignment::Right);
+			}
+			++x;
+		}
+
+		table.addHorizontalSeparator(0);
+		table.addHorizontalSeparator(1);
+		table.addVerticalSeparator(0);
+		table.addVerticalSeparator(table.width());
+	}
+
+	void addRow(
+		MeasureTable& table,
+		std::initializer_list<std::string> entrySet)
+	{
+		ENSURE_OP(entrySet.size(), ==, table.width());
+
+		integer y = table.height();
+		table.setSize(table.width(), y + 1);
+
+		// The first column names the row;
+		// the rest are numbers.
+		integer x = 0;
+		for (const std::string& entry : entrySet)
+		{
+			table(x, y).text() = entry;
+			if (x > 0)
+			{
+				table(x, y).setAlignment(MeasureTable::Alignment::Right);
+			}
+			++x;
+		}
+	}
+
+	void addSeparator(MeasureTable& table)
+	{
+		table.addHorizontalSeparator(table.height());
+	}
+
+}
+
+// Replace every form of the global operator new and delete,
+// so that all allocations are counted.
+
+void* operator new(std::size_t size)
+{
+	return PastelBenchmark::allocate(size, 0);
+}
+
+void* operator new[](std::size_t size)
+{
+	return PastelBenchmark::allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return PastelBenchmark::allocate(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return PastelBenchmark::allocate(size, (std::size_t)alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return PastelBenchmark::allocate(size, 0);
+	}
+	catch(...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return PastelBenchmark::allocate(size, (std::size_t)alignment);
+	}
+	catch(...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* address) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete[](void* address) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete(void* address, std::size_t) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete[](void* address, std::size_t) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete(void* address, std::align_val_t) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete[](void* address, std::align_val_t) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete(void* address, std::size_t, std::align_val_t) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete[](void* address, std::size_t, std::align_val_t) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete(void* address, const std::nothrow_t&) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete[](void* address, const std::nothrow_t&) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete(void* address, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+void operator delete[](void* address, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	PastelBenchmark::deallocate(address);
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace Catch::clara;
+	using PastelBenchmark::options_;
+
+	Catch::Session session;
+
+	auto cli = session.cli()
+		| Opt(options_.points, "points")
+			["--points"]
+			("the number of points in a data-set")
+		| Opt(options_.queries, "queries")
+			["--queries"]
+			("the number of queries in a query-set")
+		| Opt(options_.output, "prefix")
+			["--output"]
+			("write the tables to <prefix>.txt, <prefix>.tex and <prefix>.json");
+	session.cli(cli);
+
+	int result = session.applyCommandLine(argc, argv);
+	if (result != 0)
+	{
+		return result;
+	}
+
+	result = session.run();
+
+	if (!options_.output.empty())
+	{
+		PastelBenchmark::writeOutput(options_.output);
+	}
+
+	return result;
+}
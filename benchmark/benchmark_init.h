@@ -0,0 +1,140 @@
+// Description: Initialization for benchmarks.
+// Documentation: benchmarking.txt
+
+#ifndef PASTELBENCHMARK_INIT_H
+#define PASTELBENCHMARK_INIT_H
+
+#include "test/catch.hpp"
+
+#include "pastel/sys/mytypes.h"
+#include "pastel/sys/measuretable.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using namespace Pastel;
+
+namespace PastelBenchmark
+{
+
+	//! The options of the benchmark run.
+	struct Options
+	{
+		//! The number of points in a data-set.
+		integer points = 100000;
+
+		//! The number of queries in a query-set.
+		integer queries = 1000;
+
+		//! The prefix of the output files.
+		/*!
+		If non-empty, the tables are also written to
+		<output>.txt, <output>.tex, and <output>.json.
+		*/
+		std::string output;
+	};
+
+	//! Returns the options of the benchmark run.
+	const Options& options();
+
+	//! Reports a measure-table.
+	/*!
+	The table is printed to the standard output, and stored
+	to be written to the output files at the end of the run.
+	*/
+	void report(const MeasureTable& table);
+
+	//! Returns the number of bytes currently allocated.
+	/*!
+	The benchmark replaces the global operator new, and
+	counts the bytes allocated through it.
+	*/
+	integer allocatedBytes();
+
+	//! Returns the maximum of allocatedBytes() since the last reset.
+	integer peakBytes();
+
+	//! Sets the peak to the currently allocated bytes.
+	void resetPeakBytes();
+
+	//! Returns the time taken by a function, in seconds.
+	template <typename Function>
+	dreal seconds(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		std::chrono::duration<dreal> elapsed =
+			std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	//! Measures the time and the memory taken by a function.
+	/*!
+	The memory is the number of bytes which remain
+	allocated after the function returns.
+	*/
+	struct Measurement
+	{
+		dreal seconds = 0;
+		integer bytes = 0;
+		integer peakBytes = 0;
+	};
+
+	template <typename Function>
+	Measurement measure(Function&& function)
+	{
+		integer bytesBefore = allocatedBytes();
+		resetPeakBytes();
+
+		Measurement result;
+		result.seconds = seconds(function);
+		result.bytes = allocatedBytes() - bytesBefore;
+		result.peakBytes = peakBytes() - bytesBefore;
+		return result;
+	}
+
+	//! Formats a number for a measure-table.
+	template <typename Type>
+	std::string format(const Type& that, integer digits = 4)
+	{
+		std::ostringstream stream;
+		stream.precision(digits);
+		stream << that;
+		return stream.str();
+	}
+
+	//! Formats a number of bytes as mebibytes.
+	inline std::string formatMegabytes(integer bytes)
+	{
+		return format((dreal)bytes / (1024 * 1024));
+	}
+
+	//! Formats the number of queries per second.
+	inline std::string formatThroughput(integer queries, dreal seconds)
+	{
+		return format((integer)(queries / std::max(seconds, (dreal)1e-9)), 12);
+	}
+
+	//! Sets the header row of a measure-table.
+	/*!
+	Sets the width of the table to the number of
+	column names, and its height to 1.
+	*/
+	void setHeader(
+		MeasureTable& table,
+		std::initializer_list<std::string> nameSet);
+
+	//! Adds a row to a measure-table.
+	void addRow(
+		MeasureTable& table,
+		std::initializer_list<std::string> entrySet);
+
+	//! Adds a separator after the last row of a measure-table.
+	void addSeparator(MeasureTable& table);
+
+}
+
+using namespace PastelBenchmark;
+
+#endif
@@ -0,0 +1,118 @@
+// Description: Benchmarks for coherentPointDrift
+// DocumentationOf: coherent_point_drift.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/pattern_matching/coherent_point_drift.h"
+
+namespace
+{
+
+	void benchmarkCoherentPointDrift(MeasureTable& table)
+	{
+		static constexpr int N = 3;
+		using Point = Vector<dreal, N>;
+
+		// The exact algorithm stores an (n x n) matrix;
+		// it is measured only up to this size.
+		integer maxExact = 2000;
+		dreal kernelError = 1e-6;
+
+		// A rotation around the z-axis, and a translation.
+		dreal alpha = constantPi<dreal>() / 30;
+		Matrix<dreal> Q(N, N);
+		Q <<
+			std::cos(alpha), -std::sin(alpha), 0,
+			std::sin(alpha), std::cos(alpha), 0,
+			0, 0, 1;
+		ColMatrix<dreal> t(N, 1);
+		t << 0.02, -0.01, 0.01;
+
+		for (Dataset dataset : datasetSet())
+		{
+			for (integer n : {1000, 2000, 8000})
+			{
+				std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+
+				Matrix<dreal> P(N, n);
+				for (integer i = 0;i < n;++i)
+				{
+					for (integer k = 0;k < N;++k)
+					{
+						P(k, i) = pointSet[i][k];
+					}
+				}
+				Matrix<dreal> R = (Q * P).colwise() + t;
+
+				// Returns the measurement, and the error
+				// in the estimated transformation.
+				auto run = [&](dreal kernelError)
+				{
+					Matrix<dreal> Qe(N, N);
+					Matrix<dreal> Se(N, N);
+					ColMatrix<dreal> te(N, 1);
+
+					Measurement measurement = measure([&]()
+					{
+						coherentPointDrift(
+							view(P), view(R), view(Qe), view(Se), view(te),
+							PASTEL_TAG(scaling), Cpd_Scaling::Rigid,
+							PASTEL_TAG(maxIterations), 30,
+							PASTEL_TAG(kernelError), kernelError);
+					});
+
+					dreal error = std::max(
+						maxNorm(Qe * Se - Q),
+						maxNorm(te - t));
+
+					return std::make_pair(measurement, error);
+				};
+
+				// Eigen does not allocate through the operator new,
+				// so the weighting matrix is not included in the
+				// measured memory; report its size instead.
+				std::string exactTime = "-";
+				std::string exactError = "-";
+				if (n <= maxExact)
+				{
+					auto exact = run(0);
+					exactTime = format(exact.first.seconds);
+					exactError = format(exact.second);
+				}
+
+				auto truncated = run(kernelError);
+
+				addRow(table, {
+					datasetName(dataset),
+					format(n),
+					exactTime,
+					formatMegabytes(n * n * sizeof(dreal)),
+					exactError,
+					format(truncated.first.seconds),
+					formatMegabytes(truncated.first.peakBytes),
+					format(truncated.second)});
+			}
+		}
+	}
+
+}
+
+TEST_CASE("coherentPointDrift", "[coherent_point_drift]")
+{
+	MeasureTable table;
+	table.setCaption("coherentPointDrift: time (s) and the maximum "
+		"error in the estimated transformation for 30 iterations of "
+		"rigid registration of n 3-dimensional points, with the exact "
+		"kernel, and with the kernel truncated at 1e-6; the size of "
+		"the weighting matrix (MiB) of the exact kernel, and the peak "
+		"memory (MiB) of the kd-tree of the truncated kernel.");
+	setHeader(table, {
+		"Dataset", "n",
+		"Exact", "W", "Error",
+		"Truncated", "Memory", "Error"});
+
+	benchmarkCoherentPointDrift(table);
+
+	report(table);
+}
@@ -0,0 +1,121 @@
+// Description: Benchmarks for Frozen_PointKdTree
+// DocumentationOf: frozen_pointkdtree.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/pointkdtree/frozen_pointkdtree.h"
+#include "pastel/geometry/pointkdtree/pointkdtree_count_range.h"
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+#include "pastel/geometry/splitrules.h"
+
+#include "pastel/sys/locator.h"
+
+namespace
+{
+
+	template <int N>
+	void benchmarkFrozen(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Settings = PointKdTree_Settings<Locator>;
+		using Tree = PointKdTree<Settings>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer queries = options().queries;
+		integer kNearest = 8;
+		integer bucketSize = 8;
+		dreal side = rangeSide(32, n, N);
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			std::vector<Point> querySet = generatePointSet<N>(dataset, queries, 1);
+
+			Tree tree;
+			tree.insertSet(pointSet);
+			tree.refine(SlidingMidpoint_SplitRule(), bucketSize);
+
+			Frozen_PointKdTree<Settings> frozen;
+			Measurement freezing = measure([&]()
+			{
+				frozen = freeze(tree);
+			});
+
+			auto addLayout = [&](const char* name, auto&& tree,
+				const std::string& freezeTime,
+				const std::string& freezeMemory)
+			{
+				auto nearestSet = kdTreeNearestSet(tree,
+					PASTEL_TAG(nBruteForce), bucketSize);
+
+				integer found = 0;
+				dreal nearestTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						searchNearest(
+							nearestSet, query,
+							PASTEL_TAG(kNearest), kNearest,
+							PASTEL_TAG(report), [&](auto&&, auto&&)
+							{
+								++found;
+							});
+					}
+				});
+				REQUIRE(found == queries * std::min(kNearest, n));
+
+				integer counted = 0;
+				dreal countTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						counted += countRange(tree,
+							AlignedBox<dreal, N>(query - side / 2, query + side / 2),
+							bucketSize);
+					}
+				});
+
+				addRow(table, {
+					datasetName(dataset),
+					format(N),
+					name,
+					freezeTime,
+					freezeMemory,
+					formatThroughput(queries, nearestTime),
+					formatThroughput(queries, countTime)});
+
+				return counted;
+			};
+
+			integer counted = addLayout("PointKdTree", tree, "", "");
+			integer frozenCounted = addLayout("Frozen", frozen,
+				format(freezing.seconds),
+				formatMegabytes(freezing.bytes));
+			REQUIRE(frozenCounted == counted);
+		}
+
+		addSeparator(table);
+	}
+
+}
+
+TEST_CASE("Frozen_PointKdTree", "[frozen_pointkdtree]")
+{
+	MeasureTable table;
+	table.setCaption("Frozen_PointKdTree: freeze time (s) and memory "
+		"(MiB), and query throughput (queries/s) for 8 nearest "
+		"neighbors and for counting the points in a cube with 32 "
+		"points on average, against the PointKdTree it was frozen "
+		"from; the bucket size is 8.");
+	setHeader(table, {
+		"Dataset", "d", "Layout", "Freeze", "Memory", "kNN", "Count"});
+
+	benchmarkFrozen<2>(table);
+	benchmarkFrozen<3>(table);
+	benchmarkFrozen<6>(table);
+
+	report(table);
+}
@@ -0,0 +1,101 @@
+// Description: Benchmarks for half-edge structures
+// DocumentationOf: compact_halfmesh.h
+
+#include "benchmark/benchmark_init.h"
+
+#include "pastel/geometry/halfmesh/compact_halfmesh.h"
+
+namespace
+{
+
+	using Settings = HalfMesh_Settings<Empty, Empty, Empty, Empty, false, true>;
+	using Mesh = HalfMesh<Settings>;
+	using Compact = Compact_HalfMesh<Settings>;
+
+	//! Triangulates a k x k grid of squares.
+	std::vector<integer> gridTriangles(integer k)
+	{
+		std::vector<integer> indexSet;
+		indexSet.reserve(6 * k * k);
+		for (integer y = 0;y < k;++y)
+		{
+			for (integer x = 0;x < k;++x)
+			{
+				integer a = y * (k + 1) + x;
+				integer b = a + 1;
+				integer c = b + k + 1;
+				integer d = a + k + 1;
+				indexSet.insert(indexSet.end(), {a, b, c, a, c, d});
+			}
+		}
+		return indexSet;
+	}
+
+}
+
+TEST_CASE("HalfMesh", "[halfmesh]")
+{
+	MeasureTable table;
+	table.setCaption("Building a triangulated grid of n triangles: "
+		"the time (s) to build a Compact_HalfMesh from the indexed "
+		"triangles with and without threads, to convert it to a "
+		"HalfMesh, and to build the HalfMesh by inserting the "
+		"triangles by their vertices.");
+	setHeader(table, {
+		"n", "Compact", "Serial", "Convert", "Insert"});
+
+	for (integer m = options().points >> 6;m <= options().points;m *= 4)
+	{
+		integer k = std::max((integer)std::sqrt((dreal)m / 2), (integer)1);
+		integer vertices = (k + 1) * (k + 1);
+		std::vector<integer> indexSet = gridTriangles(k);
+
+		Compact compact;
+		dreal time = seconds([&]()
+		{
+			Compact(vertices, indexSet).swap(compact);
+		});
+
+		dreal serialTime = seconds([&]()
+		{
+			Compact(vertices, indexSet, PASTEL_TAG(parallel), false);
+		});
+
+		Mesh converted;
+		dreal convertTime = seconds([&]()
+		{
+			converted = compact.toHalfMesh();
+		});
+		REQUIRE(converted.polygons() == compact.polygons());
+
+		dreal insertTime = seconds([&]()
+		{
+			Mesh mesh;
+			std::vector<Mesh::Vertex_Iterator> vertexSet;
+			for (integer i = 0;i < vertices;++i)
+			{
+				vertexSet.push_back(mesh.insertVertex());
+			}
+
+			std::vector<Mesh::Vertex_Iterator> loopSet(3);
+			for (integer i = 0;i < indexSet.size();i += 3)
+			{
+				for (integer j = 0;j < 3;++j)
+				{
+					loopSet[j] = vertexSet[indexSet[i + j]];
+				}
+				mesh.insertPolygon(loopSet);
+			}
+			REQUIRE(mesh.polygons() == compact.polygons());
+		});
+
+		addRow(table, {
+			format(compact.polygons()),
+			format(time),
+			format(serialTime),
+			format(convertTime),
+			format(insertTime)});
+	}
+
+	report(table);
+}
@@ -0,0 +1,95 @@
+// Description: Benchmarks for icp
+// DocumentationOf: icp.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/pattern_matching/icp.h"
+
+namespace
+{
+
+	void benchmarkIcp(MeasureTable& table)
+	{
+		static constexpr int N = 3;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+
+		// A rotation around the z-axis, and a translation.
+		dreal alpha = constantPi<dreal>() / 30;
+		Matrix<dreal> Q(N, N);
+		Q <<
+			std::cos(alpha), -std::sin(alpha), 0,
+			std::sin(alpha), std::cos(alpha), 0,
+			0, 0, 1;
+		ColMatrix<dreal> t(N, 1);
+		t << 0.02, -0.01, 0.01;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+
+			Matrix<dreal> P(N, n);
+			for (integer i = 0;i < n;++i)
+			{
+				for (integer k = 0;k < N;++k)
+				{
+					P(k, i) = pointSet[i][k];
+				}
+			}
+			Matrix<dreal> R = (Q * P).colwise() + t;
+
+			for (integer levels : {1, 4})
+			{
+				for (bool parallel : {false, true})
+				{
+					Matrix<dreal> Qe(N, N);
+					Matrix<dreal> Se(N, N);
+					ColMatrix<dreal> te(N, 1);
+
+					Icp_Return<dreal> result;
+					dreal time = seconds([&]()
+					{
+						result = icp(
+							view(P), view(R), view(Qe), view(Se), view(te),
+							PASTEL_TAG(levels), levels,
+							PASTEL_TAG(minError), 1e-12,
+							PASTEL_TAG(parallel), parallel);
+					});
+
+					dreal error = std::max(
+						maxNorm(Qe * Se - Q),
+						maxNorm(te - t));
+
+					addRow(table, {
+						datasetName(dataset),
+						format(n),
+						format(levels),
+						parallel ? "Yes" : "No",
+						format(result.iterations),
+						format(time),
+						format(error)});
+				}
+			}
+		}
+	}
+
+}
+
+TEST_CASE("icp", "[icp]")
+{
+	MeasureTable table;
+	table.setCaption("icp: the number of iterations, time (s), and "
+		"the maximum error in the estimated transformation for rigid "
+		"registration of n 3-dimensional points, with a coarse-to-fine "
+		"schedule of the given number of levels, with and without "
+		"parallel nearest neighbor searching.");
+	setHeader(table, {
+		"Dataset", "n", "Levels", "Parallel",
+		"Iterations", "Time", "Error"});
+
+	benchmarkIcp(table);
+
+	report(table);
+}
@@ -0,0 +1,90 @@
+// Description: Benchmarks for maximum clique of aligned boxes
+// DocumentationOf: maximum_clique_alignedbox.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/maximum_clique_alignedbox.h"
+
+namespace
+{
+
+	template <int N>
+	void benchmarkMaximumClique(MeasureTable& table)
+	{
+		using Box = AlignedBox<dreal, N>;
+		using Point = Vector<dreal, N>;
+
+		// The depths on a 2-dimensional manifold are high in
+		// 4 dimensions, and make the branch-and-bound slow.
+		integer maxN = (N <= 3) ? options().points : options().points / 4;
+
+		// Cubes of the same total volume at each size.
+		for (integer n = maxN >> 6;n <= maxN;n *= 4)
+		{
+			dreal side = std::pow((dreal)16 / n, (dreal)1 / N);
+
+			for (Dataset dataset : datasetSet())
+			{
+				std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+				std::vector<Box> boxSet;
+				boxSet.reserve(n);
+				for (const Point& point : pointSet)
+				{
+					boxSet.emplace_back(point - side / 2, point + side / 2);
+				}
+
+				std::pair<Box, integer> result;
+				dreal time = seconds([&]()
+				{
+					result = maximumCliqueAlignedBox(boxSet);
+				});
+
+				dreal serialTime = seconds([&]()
+				{
+					maximumCliqueAlignedBox(boxSet, PASTEL_TAG(parallel), false);
+				});
+
+				integer reported = 0;
+				dreal reportTime = seconds([&]()
+				{
+					maximumCliqueAlignedBox(boxSet,
+						PASTEL_TAG(report), [&](auto&&)
+						{
+							++reported;
+						});
+				});
+				REQUIRE(reported == result.second);
+
+				addRow(table, {
+					datasetName(dataset),
+					format(N),
+					format(n),
+					format(result.second),
+					format(time),
+					format(serialTime),
+					format(reportTime)});
+			}
+		}
+
+		addSeparator(table);
+	}
+
+}
+
+TEST_CASE("MaximumClique", "[maximum_clique]")
+{
+	MeasureTable table;
+	table.setCaption("maximumCliqueAlignedBox: the size of the maximum "
+		"clique among n cubes whose union covers [0, 1]^d about 16 times, "
+		"and the time (s) to find it with and without threads, and to "
+		"also report its boxes.");
+	setHeader(table, {
+		"Dataset", "d", "n", "Clique", "Time", "Serial", "Report"});
+
+	benchmarkMaximumClique<2>(table);
+	benchmarkMaximumClique<3>(table);
+	benchmarkMaximumClique<4>(table);
+
+	report(table);
+}
@@ -0,0 +1,185 @@
+// Description: Benchmarks for PointKdTree
+// DocumentationOf: pointkdtree.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/pointkdtree.h"
+#include "pastel/geometry/pointkdtree/pointkdtree_count_range.h"
+#include "pastel/geometry/pointkdtree/pointkdtree_search_range.h"
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+#include "pastel/geometry/splitrules.h"
+
+#include "pastel/sys/locator.h"
+
+namespace
+{
+
+	template <int N>
+	void benchmarkPointKdTree(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Tree = PointKdTree<PointKdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer queries = options().queries;
+		integer kNearest = 8;
+		dreal side = rangeSide(32, n, N);
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			std::vector<Point> querySet = generatePointSet<N>(dataset, queries, 1);
+
+			for (integer bucketSize : {1, 8, 32})
+			{
+				Tree tree;
+				Measurement build = measure([&]()
+				{
+					tree.insertSet(pointSet);
+					tree.refine(SlidingMidpoint_SplitRule(), bucketSize);
+				});
+
+				auto nearestSet = kdTreeNearestSet(tree,
+					PASTEL_TAG(nBruteForce), bucketSize);
+
+				integer found = 0;
+				dreal nearestTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						searchNearest(
+							nearestSet, query,
+							PASTEL_TAG(kNearest), kNearest,
+							PASTEL_TAG(report), [&](auto&&, auto&&)
+							{
+								++found;
+							});
+					}
+				});
+				REQUIRE(found == queries * std::min(kNearest, n));
+
+				integer reported = 0;
+				dreal rangeTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						searchRange(tree,
+							AlignedBox<dreal, N>(query - side / 2, query + side / 2),
+							[&](auto&&)
+							{
+								++reported;
+							});
+					}
+				});
+
+				integer counted = 0;
+				dreal countTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						counted += countRange(tree,
+							AlignedBox<dreal, N>(query - side / 2, query + side / 2),
+							bucketSize);
+					}
+				});
+				REQUIRE(counted == reported);
+
+				addRow(table, {
+					datasetName(dataset),
+					format(N),
+					format(bucketSize),
+					format(n),
+					format(tree.nodes()),
+					format(build.seconds),
+					formatMegabytes(build.bytes),
+					formatThroughput(queries, nearestTime),
+					formatThroughput(queries, rangeTime),
+					formatThroughput(queries, countTime)});
+			}
+		}
+
+		addSeparator(table);
+	}
+
+	template <int N>
+	void benchmarkRefine(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Tree = PointKdTree<PointKdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer bucketSize = 8;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+
+			Tree tree;
+			tree.insertSet(pointSet);
+			dreal refineTime = seconds([&]()
+			{
+				tree.refine(SlidingMidpoint_SplitRule(), bucketSize);
+			});
+
+			Tree parallelTree;
+			parallelTree.insertSet(pointSet);
+			dreal parallelTime = seconds([&]()
+			{
+				parallelTree.refineInParallel(
+					SlidingMidpoint_SplitRule(), bucketSize);
+			});
+			REQUIRE(equivalent(tree, parallelTree));
+
+			addRow(table, {
+				datasetName(dataset),
+				format(N),
+				format(n),
+				format(tree.nodes()),
+				format(refineTime),
+				format(parallelTime),
+				format(refineTime / std::max(parallelTime, (dreal)1e-9))});
+		}
+
+		addSeparator(table);
+	}
+
+}
+
+TEST_CASE("PointKdTree", "[pointkdtree]")
+{
+	MeasureTable table;
+	table.setCaption("PointKdTree: build time (s), memory (MiB), "
+		"and query throughput (queries/s) for 8 nearest neighbors, "
+		"and for reporting and counting the points in a cube with "
+		"32 points on average.");
+	setHeader(table, {
+		"Dataset", "d", "Bucket", "n", "Nodes",
+		"Build", "Memory", "kNN", "Range", "Count"});
+
+	benchmarkPointKdTree<2>(table);
+	benchmarkPointKdTree<3>(table);
+	benchmarkPointKdTree<8>(table);
+	benchmarkPointKdTree<16>(table);
+
+	report(table);
+}
+
+TEST_CASE("PointKdTree refineInParallel", "[pointkdtree_refine]")
+{
+	MeasureTable table;
+	table.setCaption("PointKdTree: the time (s) to refine the tree "
+		"with the sliding midpoint rule and a bucket size of 8, by "
+		"refine() and by refineInParallel(), and the speedup.");
+	setHeader(table, {
+		"Dataset", "d", "n", "Nodes", "refine", "Parallel", "Speedup"});
+
+	benchmarkRefine<2>(table);
+	benchmarkRefine<3>(table);
+	benchmarkRefine<8>(table);
+
+	report(table);
+}
@@ -0,0 +1,118 @@
+// Description: Benchmarks for poisson-disk patterns
+// DocumentationOf: poisson_disk_pattern.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/poisson_disk_pattern.h"
+#include "pastel/geometry/pointkdtree.h"
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+#include "pastel/geometry/splitrules.h"
+
+#include "pastel/sys/locator.h"
+
+namespace
+{
+
+	//! Returns the fraction of the window not covered by the pattern.
+	/*!
+	A probe is uncovered when it is at least minDistance
+	away from every pattern point; then a point could be
+	added there. A maximal pattern leaves no probe uncovered.
+	*/
+	template <int N>
+	dreal uncoveredFraction(
+		const std::vector<Vector<dreal, N>>& pointSet,
+		dreal minDistance)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Tree = PointKdTree<PointKdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		Tree tree;
+		tree.insertSet(pointSet);
+		tree.refine(SlidingMidpoint_SplitRule(), 8);
+		auto nearestSet = kdTreeNearestSet(tree, PASTEL_TAG(nBruteForce), 8);
+
+		integer probes = 10 * options().queries;
+		integer uncovered = 0;
+		for (const Point& probe : generatePointSet<N>(Dataset::Uniform, probes, 2))
+		{
+			if (~searchNearest(nearestSet, probe).first >= square(minDistance))
+			{
+				++uncovered;
+			}
+		}
+
+		return (dreal)uncovered / probes;
+	}
+
+	template <int N>
+	void benchmarkPoissonDiskPattern(MeasureTable& table)
+	{
+		using Point = Vector<dreal, N>;
+
+		// A maximal pattern has roughly one point per
+		// minDistance^N volume; choose the minimum distance
+		// so that [0, 1]^N receives about options().points points.
+		dreal minDistance = std::pow((dreal)options().points, -(dreal)1 / N);
+		AlignedBox<dreal, N> window(Point(0), Point(1));
+
+		std::vector<Point> dartSet;
+		auto report = [&](const Point& point)
+		{
+			dartSet.emplace_back(point);
+		};
+
+		dreal dartTime = seconds([&]()
+		{
+			poissonDiskPattern(window, minDistance, report);
+		});
+
+		std::vector<Point> serialSet;
+		dreal serialTime = seconds([&]()
+		{
+			serialSet = gridPoissonDiskPattern(window, minDistance,
+				PASTEL_TAG(parallel), false);
+		});
+
+		std::vector<Point> gridSet;
+		dreal gridTime = seconds([&]()
+		{
+			gridSet = gridPoissonDiskPattern(window, minDistance);
+		});
+		REQUIRE(gridSet == serialSet);
+
+		addRow(table, {
+			format(N),
+			format(minDistance),
+			format(dartSet.size()),
+			formatThroughput(dartSet.size(), dartTime),
+			format(uncoveredFraction(dartSet, minDistance)),
+			format(gridSet.size()),
+			formatThroughput(serialSet.size(), serialTime),
+			formatThroughput(gridSet.size(), gridTime),
+			format(uncoveredFraction(gridSet, minDistance))});
+	}
+
+}
+
+TEST_CASE("PoissonDiskPattern", "[poisson_disk_pattern]")
+{
+	MeasureTable table;
+	table.setCaption("Poisson-disk patterns in [0, 1]^d: the number of "
+		"points, the throughput (points/s), and the fraction of uncovered "
+		"probes (0 for a maximal pattern) of poissonDiskPattern(), and of "
+		"gridPoissonDiskPattern() without and with threads.");
+	setHeader(table, {
+		"d", "Distance",
+		"Darts n", "Darts", "Uncovered",
+		"Grid n", "Serial", "Grid", "Uncovered"});
+
+	benchmarkPoissonDiskPattern<2>(table);
+	benchmarkPoissonDiskPattern<3>(table);
+	benchmarkPoissonDiskPattern<4>(table);
+
+	report(table);
+}
@@ -0,0 +1,154 @@
+// Description: Benchmarks for RangeTree
+// DocumentationOf: rangetree.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/rangetree/rangetree.h"
+#include "pastel/geometry/rangetree/rangetree_count_range.h"
+
+namespace
+{
+
+	class MultiLess
+	{
+	public:
+		template <typename Point>
+		bool operator()(
+			const Point& left,
+			const Point& right,
+			integer i) const
+		{
+			return left[i] < right[i];
+		}
+	};
+
+	template <int N>
+	class Settings
+	{
+	public:
+		using Point = Vector<dreal, N>;
+		using MultiLess = ::MultiLess;
+	};
+
+	template <int N>
+	void benchmarkRangeTree(MeasureTable& table)
+	{
+		using Tree = RangeTree<Settings<N>>;
+		using Point = Vector<dreal, N>;
+
+		// The memory of a range tree is O(n log(n)^(d - 1));
+		// scale down the number of points for d > 2.
+		integer n = std::max(options().points >> (3 * (N - 2)), (integer)1);
+		integer queries = options().queries;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			std::vector<Point> querySet = generatePointSet<N>(dataset, queries, 1);
+
+			Tree tree;
+			Measurement build = measure([&]()
+			{
+				Tree(pointSet, N).swap(tree);
+			});
+
+			dreal serialBuild = seconds([&]()
+			{
+				Tree(pointSet, N, PASTEL_TAG(parallel), false);
+			});
+
+			// Returns the throughputs of reporting and
+			// counting the points in a cube with 'k'
+			// points on average.
+			auto searchTime = [&](integer k)
+			{
+				dreal side = rangeSide(k, n, N);
+
+				integer reported = 0;
+				dreal rangeTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						searchRange(tree,
+							Point(query - side / 2), Point(query + side / 2),
+							[&](auto&&)
+							{
+								++reported;
+							});
+					}
+				});
+
+				integer counted = 0;
+				dreal countTime = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						counted += searchRange(tree,
+							Point(query - side / 2), Point(query + side / 2));
+					}
+				});
+				REQUIRE(counted == reported);
+
+				std::vector<Point> minSet;
+				std::vector<Point> maxSet;
+				for (const Point& query : querySet)
+				{
+					minSet.emplace_back(query - side / 2);
+					maxSet.emplace_back(query + side / 2);
+				}
+
+				integer batchCounted = 0;
+				dreal batchTime = seconds([&]()
+				{
+					for (integer count : countAllRange(tree, minSet, maxSet))
+					{
+						batchCounted += count;
+					}
+				});
+				REQUIRE(batchCounted == counted);
+
+				return std::make_tuple(
+					formatThroughput(queries, rangeTime),
+					formatThroughput(queries, countTime),
+					formatThroughput(queries, batchTime));
+			};
+
+			auto small = searchTime(32);
+			auto large = searchTime(1024);
+
+			addRow(table, {
+				datasetName(dataset),
+				format(N),
+				format(n),
+				format(build.seconds),
+				format(serialBuild),
+				formatMegabytes(build.bytes),
+				std::get<0>(small),
+				std::get<1>(small),
+				std::get<0>(large),
+				std::get<1>(large),
+				std::get<2>(large)});
+		}
+
+		addSeparator(table);
+	}
+
+}
+
+TEST_CASE("RangeTree", "[rangetree]")
+{
+	MeasureTable table;
+	table.setCaption("RangeTree: build time (s) with and without "
+		"threads, memory (MiB), and query throughput (queries/s) for "
+		"reporting and counting the points in a cube with 32 and 1024 "
+		"points on average, and for counting with countAllRange().");
+	setHeader(table, {
+		"Dataset", "d", "n", "Build", "Serial", "Memory",
+		"Range 32", "Count 32", "Range 1024", "Count 1024", "Batch 1024"});
+
+	benchmarkRangeTree<2>(table);
+	benchmarkRangeTree<3>(table);
+
+	report(table);
+}
@@ -0,0 +1,106 @@
+// Description: Benchmarks for searchNearest
+// DocumentationOf: search_nearest.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/nearestset/bruteforce_nearestset.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+#include "pastel/geometry/pointkdtree.h"
+#include "pastel/geometry/tdtree/tdtree.h"
+#include "pastel/geometry/splitrules.h"
+
+#include "pastel/sys/locator.h"
+
+namespace
+{
+
+	template <int N>
+	void benchmarkSearchNearest(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using KdTree = PointKdTree<PointKdTree_Settings<Locator>>;
+		using TdTree_ = TdTree<TdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer queries = options().queries;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			std::vector<Point> querySet = generatePointSet<N>(dataset, queries, 1);
+
+			KdTree kdTree;
+			kdTree.insertSet(pointSet);
+			kdTree.refine(SlidingMidpoint_SplitRule(), 8);
+
+			TdTree_ tdTree(pointSet);
+
+			for (integer kNearest : {1, 8, 32})
+			{
+				// Returns the time to find the k nearest
+				// neighbors of the queries, and the sum
+				// of the distances, to compare the results.
+				auto searchTime = [&](auto&& nearestSet)
+				{
+					dreal distanceSum = 0;
+					dreal time = seconds([&]()
+					{
+						for (const Point& query : querySet)
+						{
+							searchNearest(
+								nearestSet, query,
+								PASTEL_TAG(kNearest), kNearest,
+								PASTEL_TAG(report), [&](auto&& distance, auto&&)
+								{
+									distanceSum += ~distance;
+								});
+						}
+					});
+					return std::make_pair(time, distanceSum);
+				};
+
+				auto bruteForce = searchTime(bruteForceNearestSet(pointSet));
+				auto kdTreeSearch = searchTime(kdTreeNearestSet(kdTree));
+				auto tdTreeSearch = searchTime(kdTreeNearestSet(tdTree));
+
+				REQUIRE(kdTreeSearch.second ==
+					Approx(bruteForce.second).epsilon(1e-9));
+				REQUIRE(tdTreeSearch.second ==
+					Approx(bruteForce.second).epsilon(1e-9));
+
+				addRow(table, {
+					datasetName(dataset),
+					format(N),
+					format(n),
+					format(kNearest),
+					formatThroughput(queries, bruteForce.first),
+					formatThroughput(queries, kdTreeSearch.first),
+					formatThroughput(queries, tdTreeSearch.first)});
+			}
+		}
+
+		addSeparator(table);
+	}
+
+}
+
+TEST_CASE("searchNearest", "[search_nearest]")
+{
+	MeasureTable table;
+	table.setCaption("searchNearest: query throughput (queries/s) "
+		"for k nearest neighbors by brute force, in a PointKdTree "
+		"with buckets of 8 points, and in a TdTree.");
+	setHeader(table, {
+		"Dataset", "d", "n", "k",
+		"BruteForce", "PointKdTree", "TdTree"});
+
+	benchmarkSearchNearest<2>(table);
+	benchmarkSearchNearest<8>(table);
+	benchmarkSearchNearest<16>(table);
+	benchmarkSearchNearest<32>(table);
+
+	report(table);
+}
@@ -0,0 +1,259 @@
+// Description: Benchmarks for TdTree
+// DocumentationOf: tdtree.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/geometry/tdtree/tdtree.h"
+#include "pastel/geometry/tdtree/dynamic_tdtree.h"
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/search_all_temporal_nearest.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+
+#include "pastel/sys/locator.h"
+
+namespace
+{
+
+	template <int N>
+	void benchmarkTdTree(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Tree = TdTree<TdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer queries = options().queries;
+		integer kNearest = 8;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			std::vector<Point> querySet = generatePointSet<N>(dataset, queries, 1);
+
+			Tree tree;
+			Measurement build = measure([&]()
+			{
+				Tree(pointSet).swap(tree);
+			});
+
+			// The points have the times 0, 1, ..., n - 1.
+			// Measure the search in the whole time-range,
+			// and in time-windows of decreasing size.
+			auto searchTime = [&](dreal fraction)
+			{
+				dreal begin = n * (1 - fraction) / 2;
+				Vector2 timeInterval(begin, begin + n * fraction);
+
+				auto nearestSet = kdTreeNearestSet(tree,
+					PASTEL_TAG(intervalSequence), timeInterval);
+
+				integer found = 0;
+				dreal time = seconds([&]()
+				{
+					for (const Point& query : querySet)
+					{
+						searchNearest(
+							nearestSet, query,
+							PASTEL_TAG(kNearest), kNearest,
+							PASTEL_TAG(report), [&](auto&&, auto&&)
+							{
+								++found;
+							});
+					}
+				});
+				REQUIRE(found > 0);
+
+				return time;
+			};
+
+			addRow(table, {
+				datasetName(dataset),
+				format(N),
+				format(n),
+				format(tree.nodes()),
+				format(build.seconds),
+				formatMegabytes(build.bytes),
+				formatThroughput(queries, searchTime(1)),
+				formatThroughput(queries, searchTime(0.1)),
+				formatThroughput(queries, searchTime(0.01))});
+		}
+
+		addSeparator(table);
+	}
+
+	template <int N>
+	void benchmarkAllTemporalNearest(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Tree = TdTree<TdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer kNearest = 8;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			Tree tree(pointSet);
+
+			// The windows cover 1% of the time-range.
+			dreal timeWindow = n / 200;
+
+			// Query the points one by one, each with
+			// its own nearest-set.
+			dreal loopTime = seconds([&]()
+			{
+				for (auto i = tree.begin(); i != tree.end(); ++i)
+				{
+					Vector2 window(
+						i->time() - timeWindow,
+						i->time() + timeWindow + 1);
+
+					searchNearest(
+						kdTreeNearestSet(tree,
+							PASTEL_TAG(intervalSequence), window),
+						pointSet[i - tree.begin()],
+						PASTEL_TAG(kNearest), kNearest + 1);
+				}
+			});
+
+			auto batchTime = [&](bool parallel)
+			{
+				return seconds([&]()
+				{
+					auto resultSet = searchAllTemporalNearest(
+						tree, timeWindow,
+						PASTEL_TAG(kNearest), kNearest,
+						PASTEL_TAG(parallel), parallel);
+					REQUIRE(resultSet.size() == n * kNearest);
+				});
+			};
+
+			addRow(table, {
+				datasetName(dataset),
+				format(N),
+				format(n),
+				formatThroughput(n, loopTime),
+				formatThroughput(n, batchTime(false)),
+				formatThroughput(n, batchTime(true))});
+		}
+
+		addSeparator(table);
+	}
+
+	template <int N>
+	void benchmarkDynamicTdTree(MeasureTable& table)
+	{
+		using Locator = Vector_Locator<dreal, N>;
+		using Tree = Dynamic_TdTree<TdTree_Settings<Locator>>;
+		using Point = Vector<dreal, N>;
+
+		integer n = options().points;
+		integer queries = options().queries;
+		integer kNearest = 8;
+
+		for (Dataset dataset : datasetSet())
+		{
+			std::vector<Point> pointSet = generatePointSet<N>(dataset, n);
+			std::vector<Point> querySet = generatePointSet<N>(dataset, queries, 1);
+
+			// Stream the points one by one, while keeping
+			// the last 10% of the points alive.
+			integer window = n / 10;
+
+			Tree tree;
+			integer maxBuckets = 0;
+			Measurement stream = measure([&]()
+			{
+				for (integer i = 0; i < n; ++i)
+				{
+					tree.append(pointSet[i], i);
+					tree.expire(i - window + 1);
+					maxBuckets = std::max(maxBuckets, tree.buckets());
+				}
+			});
+			REQUIRE(tree.points() == window);
+
+			integer found = 0;
+			dreal searchTime = seconds([&]()
+			{
+				auto nearestSet = kdTreeNearestSet(tree);
+				for (const Point& query : querySet)
+				{
+					searchNearest(
+						nearestSet, query,
+						PASTEL_TAG(kNearest), kNearest,
+						PASTEL_TAG(report), [&](auto&&, auto&&)
+						{
+							++found;
+						});
+				}
+			});
+			REQUIRE(found > 0);
+
+			addRow(table, {
+				datasetName(dataset),
+				format(N),
+				format(n),
+				format(window),
+				format(maxBuckets),
+				formatThroughput(n, stream.seconds),
+				formatThroughput(queries, searchTime)});
+		}
+
+		addSeparator(table);
+	}
+
+}
+
+TEST_CASE("TdTree", "[tdtree]")
+{
+	MeasureTable table;
+	table.setCaption("TdTree: build time (s), memory (MiB), "
+		"and query throughput (queries/s) for 8 nearest neighbors "
+		"in the whole time-range, and in time-windows of 10% and "
+		"1% of the time-range.");
+	setHeader(table, {
+		"Dataset", "d", "n", "Nodes", "Build", "Memory",
+		"kNN", "kNN 10%", "kNN 1%"});
+
+	benchmarkTdTree<2>(table);
+	benchmarkTdTree<3>(table);
+	benchmarkTdTree<8>(table);
+	benchmarkTdTree<16>(table);
+
+	report(table);
+}
+
+TEST_CASE("searchAllTemporalNearest", "[tdtree]")
+{
+	MeasureTable table;
+	table.setCaption("searchAllTemporalNearest: query throughput "
+		"(queries/s) for 8 nearest neighbors of all points in "
+		"time-windows of 1% of the time-range, by searchNearest() "
+		"in a loop, and in a batch without and with threads.");
+	setHeader(table, {
+		"Dataset", "d", "n", "Loop", "Batch", "Parallel"});
+
+	benchmarkAllTemporalNearest<2>(table);
+	benchmarkAllTemporalNearest<8>(table);
+
+	report(table);
+}
+
+TEST_CASE("Dynamic_TdTree", "[tdtree]")
+{
+	MeasureTable table;
+	table.setCaption("Dynamic_TdTree: throughput (points/s) of appending "
+		"n points one by one while expiring all but the last 10% of them, "
+		"the maximum number of buckets, and the query throughput "
+		"(queries/s) for 8 nearest neighbors in the alive points.");
+	setHeader(table, {
+		"Dataset", "d", "n", "Alive", "Buckets", "Stream", "kNN"});
+
+	benchmarkDynamicTdTree<2>(table);
+	benchmarkDynamicTdTree<8>(table);
+
+	report(table);
+}
@@ -0,0 +1,68 @@
+// Description: Benchmarks for convolution
+// DocumentationOf: convolution.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/gfx/drawing.h"
+#include "pastel/gfx/image_processing/convolution.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/view/arrayview.h"
+
+TEST_CASE("Convolute", "[convolution]")
+{
+	MeasureTable table;
+	table.setCaption("convolute: the time (s) to convolute a dense "
+		"real32 image with a box filter by each policy. The direct "
+		"convolution is skipped when it takes more than 2e9 "
+		"multiplications.");
+	setHeader(table, {
+		"Image", "Filter", "Direct", "Separable", "Fft", "Automatic"});
+
+	Random random(0);
+	for (integer n : {256, 1024})
+	{
+		Array<real32, 2> input(Vector2i(n, n));
+		for (integer i = 0;i < input.size();++i)
+		{
+			input(i) = random.uniform();
+		}
+
+		for (integer m : {3, 7, 15, 31, 63, 127})
+		{
+			Array<real32, 2> filter(Vector2i(m, m), 1);
+
+			auto measure = [&](Convolution_Policy policy) -> std::string
+			{
+				if (policy == Convolution_Policy::Direct &&
+					(dreal)n * n * m * m > 2e9)
+				{
+					return "";
+				}
+
+				Array<real32, 2> output(input.extent(), 0);
+				return format(seconds([&]()
+				{
+					convolute(
+						constArrayView(input),
+						constArrayView(filter),
+						arrayView(output),
+						PASTEL_TAG(policy), policy);
+				}));
+			};
+
+			addRow(table, {
+				format(n) + "^2",
+				format(m) + "^2",
+				measure(Convolution_Policy::Direct),
+				measure(Convolution_Policy::Separable),
+				measure(Convolution_Policy::Fft),
+				measure(Convolution_Policy::Automatic)});
+		}
+
+		addSeparator(table);
+	}
+
+	report(table);
+}
@@ -0,0 +1,141 @@
+// Description: Benchmarks for the Fourier transforms
+// DocumentationOf: fourier_transform.txt
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/gfx/transform/fourier_transform.h"
+#include "pastel/gfx/transform/fourier_transform_n.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/subarray_for_each.h"
+
+#include <complex>
+#include <vector>
+
+namespace
+{
+
+	using Complex = std::complex<dreal>;
+
+	std::vector<Complex> randomSignal(integer n)
+	{
+		Random random(n);
+
+		std::vector<Complex> result;
+		result.reserve(n);
+		for (integer i = 0;i < n;++i)
+		{
+			result.emplace_back(
+				2 * random.uniform() - 1,
+				2 * random.uniform() - 1);
+		}
+		return result;
+	}
+
+}
+
+TEST_CASE("Fourier", "[fourier]")
+{
+	MeasureTable table;
+	table.setCaption("dft: the throughput in transforms per second "
+		"of sizes with the radices 2, 3, 5, and 7, and of a prime "
+		"size, which uses Bluestein's algorithm, by dft() and by a "
+		"FourierPlan with a reused workspace.");
+	setHeader(table, {
+		"n", "Algorithm", "Method", "Transforms/s"});
+
+	integer repeats = 20;
+	for (integer n : {1 << 16, 3 * 5 * 7 * 128, 65537})
+	{
+		std::vector<Complex> input = randomSignal(n);
+		std::vector<Complex> output(n);
+
+		FourierPlan<dreal> plan(n);
+		const char* algorithm = plan.bluestein()
+			? "Bluestein" : "Mixed-radix";
+
+		dreal rangeTime = seconds([&]()
+		{
+			for (integer i = 0;i < repeats;++i)
+			{
+				dft(range(input.begin(), input.end()),
+					range(output.begin(), output.end()));
+			}
+		});
+
+		std::vector<Complex> workspace;
+		dreal planTime = seconds([&]()
+		{
+			for (integer i = 0;i < repeats;++i)
+			{
+				plan.dft(input.data(), output.data(), false, workspace);
+			}
+		});
+
+		addRow(table, {
+			format(n), algorithm, "dft",
+			formatThroughput(repeats, rangeTime)});
+		addRow(table, {
+			format(n), algorithm, "FourierPlan",
+			formatThroughput(repeats, planTime)});
+	}
+
+	report(table);
+}
+
+TEST_CASE("FourierN", "[fourier_n]")
+{
+	MeasureTable table;
+	table.setCaption("fftN: the time (s) of a 2-dimensional transform, "
+		"by transforming the rows of each axis with dft(), and by "
+		"fftN() serially and in parallel, and of the half-spectrum "
+		"of a real input by realFftN().");
+	setHeader(table, {
+		"Extent", "Method", "Time"});
+
+	integer side = 2048;
+	Vector<integer, 2> extent(side, side);
+
+	Array<Complex, 2> input(extent);
+	{
+		std::vector<Complex> signal = randomSignal(input.size());
+		std::copy(signal.begin(), signal.end(), input.begin());
+	}
+
+	auto addMethod = [&](const char* name, auto&& transform)
+	{
+		Array<Complex, 2> data(input);
+		addRow(table, {
+			format(side) + "^2", name,
+			format(seconds([&]() {transform(data);}))});
+	};
+
+	addMethod("Rows", [](Array<Complex, 2>& data)
+	{
+		forEachRowOnAllAxes(data(), Dft());
+	});
+
+	addMethod("fftN serial", [](Array<Complex, 2>& data)
+	{
+		fftN(data(), PASTEL_TAG(parallel), false);
+	});
+
+	addMethod("fftN", [](Array<Complex, 2>& data)
+	{
+		fftN(data());
+	});
+
+	Array<dreal, 2> realInput(extent);
+	for (integer i = 0;i < realInput.size();++i)
+	{
+		realInput(i) = input(i).real();
+	}
+
+	Array<Complex, 2> output(Vector<integer, 2>(side / 2 + 1, side));
+	addRow(table, {
+		format(side) + "^2", "realFftN",
+		format(seconds([&]() {realFftN(realInput(), output());}))});
+
+	report(table);
+}
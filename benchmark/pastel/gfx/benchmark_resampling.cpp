@@ -0,0 +1,62 @@
+// Description: Benchmarks for resampling
+// DocumentationOf: resampling.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/gfx/resampling.h"
+#include "pastel/gfx/filter.h"
+#include "pastel/gfx/color.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/extender/indexextenders.h"
+#include "pastel/sys/view/arrayview.h"
+
+TEST_CASE("Resample", "[resampling]")
+{
+	MeasureTable table;
+	table.setCaption("resampleTable: the time (s) to resample a "
+		"2048^2 color image with the Lanczos filter of radius 3, "
+		"deterministically, and with the fast summation serially "
+		"and in parallel.");
+	setHeader(table, {
+		"Output", "Deterministic", "Fast", "Parallel"});
+
+	Vector<integer, 2> inputExtent(2048, 2048);
+	Array<Color, 2> input(inputExtent);
+	{
+		Random random(0);
+		for (integer i = 0;i < input.size();++i)
+		{
+			input(i) = Color(random.uniform());
+		}
+	}
+
+	ArrayExtender<2, Color> arrayExtender(clampExtender());
+	ConstTableFilterPtr filter = tableFilter(lanczosFilter(3));
+
+	for (integer side : {256, 1024, 3000})
+	{
+		Array<Color, 2> output(Vector<integer, 2>(side, side));
+
+		auto measure = [&](bool parallel, bool deterministic)
+		{
+			return format(seconds([&]()
+			{
+				resampleTable<Color>(
+					constArrayView(input), arrayExtender, filter,
+					arrayView(output),
+					PASTEL_TAG(parallel), parallel,
+					PASTEL_TAG(deterministic), deterministic);
+			}));
+		};
+
+		addRow(table, {
+			format(side) + "^2",
+			measure(false, true),
+			measure(false, false),
+			measure(true, false)});
+	}
+
+	report(table);
+}
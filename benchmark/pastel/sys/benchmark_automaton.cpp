@@ -0,0 +1,136 @@
+// Description: Benchmarks for Compiled_Automaton
+// DocumentationOf: compiled_automaton.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/sys/automaton/compiled_automaton.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+	using Autom = Automaton<integer>;
+	using State = Autom::State_ConstIterator;
+
+	//! Returns a random complete automaton.
+	Autom randomAutomaton(integer states, integer symbols)
+	{
+		Random random(states);
+
+		Autom automaton;
+		std::vector<State> stateSet;
+		for (integer i = 0;i < states;++i)
+		{
+			stateSet.push_back(automaton.addState());
+		}
+
+		for (integer i = 0;i < states;++i)
+		{
+			for (integer symbol = 0;symbol < symbols;++symbol)
+			{
+				automaton.addTransition(
+					stateSet[i], symbol,
+					stateSet[random.index(states)]);
+			}
+			if (i % 2 == 1)
+			{
+				automaton.addFinal(stateSet[i]);
+			}
+		}
+		automaton.addStart(stateSet[0]);
+
+		return automaton;
+	}
+
+}
+
+TEST_CASE("Compiled_Automaton", "[automaton]")
+{
+	MeasureTable table;
+	table.setCaption("Compiled_Automaton: the throughput in bytes per "
+		"second of running a random deterministic automaton of "
+		"the given number of states over 64 symbols, by finding "
+		"the transitions in the Automaton, and in the compiled "
+		"automaton one input at a time and interleaving the inputs.");
+	setHeader(table, {
+		"States", "Table (kB)", "Method", "Bytes/s"});
+
+	integer symbols = 64;
+	integer streams = 64;
+	integer streamSize = std::max(options().points / 4, (integer)1);
+
+	std::vector<std::string> inputSet(streams);
+	{
+		Random random(0);
+		for (std::string& input : inputSet)
+		{
+			input.resize(streamSize);
+			for (char& c : input)
+			{
+				c = (char)random.index(symbols);
+			}
+		}
+	}
+	std::vector<std::string_view> viewSet(
+		inputSet.begin(), inputSet.end());
+	integer bytes = streams * streamSize;
+
+	for (integer states : {16, 256, 4096})
+	{
+		Autom automaton = randomAutomaton(states, symbols);
+		Compiled_Automaton compiled = compileAutomaton(automaton);
+
+		auto addMethod = [&](const char* name, dreal time)
+		{
+			addRow(table, {
+				format(states),
+				format(compiled.states() * compiled.classes() * 4 / 1024),
+				name,
+				formatThroughput(bytes, time)});
+		};
+
+		integer accepted = 0;
+		addMethod("Automaton", seconds([&]()
+		{
+			for (const std::string& input : inputSet)
+			{
+				State state = *automaton.cStartBegin();
+				for (char c : input)
+				{
+					state = automaton.findTransition(state, (uint8)c)->to();
+				}
+				accepted += state->data().final();
+			}
+		}));
+
+		integer compiledAccepted = 0;
+		addMethod("Compiled", seconds([&]()
+		{
+			for (std::string_view input : viewSet)
+			{
+				compiledAccepted += compiled.accepts(input);
+			}
+		}));
+		REQUIRE(compiledAccepted == accepted);
+
+		std::vector<Compiled_Automaton::State> stateSet(streams);
+		addMethod("Interleaved", seconds([&]()
+		{
+			std::fill(stateSet.begin(), stateSet.end(), compiled.start());
+			compiled.run(stateSet, viewSet);
+		}));
+
+		integer interleavedAccepted = 0;
+		for (auto state : stateSet)
+		{
+			interleavedAccepted += compiled.final(state);
+		}
+		REQUIRE(interleavedAccepted == accepted);
+	}
+
+	report(table);
+}
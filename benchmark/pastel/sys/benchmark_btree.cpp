@@ -0,0 +1,146 @@
+// Description: Benchmarks for BTree
+// DocumentationOf: btree.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/sys/btree.h"
+#include "pastel/sys/redblacktree.h"
+
+#include <array>
+
+namespace
+{
+
+	//! Propagates the number of elements in a subtree.
+	template <typename Settings_>
+	class Counting_Customization
+		: public Empty_RedBlackTree_Customization<Settings_>
+	{
+	protected:
+		using Fwd = RedBlackTree_Fwd<Settings_>;
+		PASTEL_FWD(Iterator);
+		PASTEL_FWD(Propagation);
+
+		Counting_Customization() {}
+
+		void updatePropagation(
+			const Iterator& iter,
+			Propagation& propagation)
+		{
+			propagation =
+				iter.left().propagation() + 1 +
+				iter.right().propagation();
+		}
+
+	private:
+		Counting_Customization(const Counting_Customization& that) = delete;
+		Counting_Customization(Counting_Customization&& that) = delete;
+		Counting_Customization& operator=(Counting_Customization) = delete;
+	};
+
+	template <integer Capacity_>
+	class Capacity_Settings
+		: public RedBlackTree_Set_Settings<integer>
+	{
+	public:
+		static constexpr integer Capacity = Capacity_;
+	};
+
+	//! Returns the times to insert, find, and erase the keys.
+	template <typename Tree>
+	std::array<dreal, 3> measure(const std::vector<integer>& keySet)
+	{
+		std::vector<integer> searchSet = keySet;
+		Random random(1);
+		for (integer i = (integer)searchSet.size() - 1;i > 0;--i)
+		{
+			std::swap(searchSet[i], searchSet[random.index(i + 1)]);
+		}
+
+		Tree tree;
+		dreal insertTime = seconds([&]()
+		{
+			for (integer key : keySet)
+			{
+				tree.insert(key);
+			}
+		});
+
+		integer found = 0;
+		dreal findTime = seconds([&]()
+		{
+			for (integer key : searchSet)
+			{
+				found += (tree.find(key) != tree.cend());
+			}
+		});
+		REQUIRE(found == keySet.size());
+
+		dreal eraseTime = seconds([&]()
+		{
+			for (integer key : searchSet)
+			{
+				tree.erase(key);
+			}
+		});
+		REQUIRE(tree.empty());
+
+		return { insertTime, findTime, eraseTime };
+	}
+
+}
+
+TEST_CASE("BTree", "[btree]")
+{
+	MeasureTable table;
+	table.setCaption("BTree: the time (s) to insert n random keys, "
+		"to find them, and to erase them, in the RedBlackTree and "
+		"in the BTree of the given node capacity, without and with "
+		"the propagation of the subtree sizes.");
+	setHeader(table, {
+		"n", "Tree", "Capacity", "Propagation", "Insert", "Find", "Erase"});
+
+	for (integer n = options().points >> 4;n <= options().points * 4;n *= 16)
+	{
+		std::vector<integer> keySet(n);
+		{
+			Random random(0);
+			for (integer& key : keySet)
+			{
+				key = random.index(4 * n);
+			}
+		}
+
+		auto addTree = [&](const char* name, integer capacity,
+			bool propagation, const std::array<dreal, 3>& timeSet)
+		{
+			addRow(table, {
+				format(n),
+				name,
+				capacity > 0 ? format(capacity) : std::string("-"),
+				propagation ? "Yes" : "No",
+				format(timeSet[0]),
+				format(timeSet[1]),
+				format(timeSet[2])});
+		};
+
+		addTree("RedBlackTree", 0, false,
+			measure<RedBlackTree_Set<integer>>(keySet));
+		addTree("RedBlackTree", 0, true,
+			measure<RedBlackTree_Set<integer, Empty, LessThan, integer,
+			Empty, false, Counting_Customization>>(keySet));
+
+		addTree("BTree", 7, false,
+			measure<BTree<Capacity_Settings<7>>>(keySet));
+		addTree("BTree", 31, false,
+			measure<BTree<Capacity_Settings<31>>>(keySet));
+		addTree("BTree", 127, false,
+			measure<BTree<Capacity_Settings<127>>>(keySet));
+		addTree("BTree", BTree_Set<integer>::Capacity, true,
+			measure<BTree_Set<integer, Empty, LessThan, integer,
+			Counting_Customization>>(keySet));
+	}
+
+	report(table);
+}
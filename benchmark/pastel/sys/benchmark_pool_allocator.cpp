@@ -0,0 +1,88 @@
+// Description: Benchmarks for the pool allocators
+// DocumentationOf: concurrent_pool_allocator.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/sys/allocator/concurrent_pool_allocator.h"
+#include "pastel/sys/allocator/pool_allocator.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Pool allocator", "[pool_allocator]")
+{
+	MeasureTable table;
+	table.setCaption("Pool allocators: the throughput in units per "
+		"second of allocating 32-byte units, and deallocating them "
+		"in a random order, by the same thread, and for the "
+		"ConcurrentPoolAllocator also by another thread.");
+	setHeader(table, {
+		"Allocator", "Deallocation", "Units", "Units/s"});
+
+	integer units = options().points * 10;
+	std::vector<void*> memoryList(units);
+
+	std::vector<integer> order(units);
+	{
+		Random random(0);
+		for (integer i = 0;i < units;++i)
+		{
+			order[i] = i;
+		}
+		for (integer i = units - 1;i > 0;--i)
+		{
+			std::swap(order[i], order[random.index(i + 1)]);
+		}
+	}
+
+	auto measure = [&](auto& allocator, bool remote)
+	{
+		return seconds([&]()
+		{
+			for (integer i = 0;i < units;++i)
+			{
+				memoryList[i] = allocator.allocate();
+			}
+
+			auto deallocate = [&]()
+			{
+				for (integer i : order)
+				{
+					allocator.deallocate(memoryList[i]);
+				}
+			};
+
+			if (remote)
+			{
+				std::thread(deallocate).join();
+			}
+			else
+			{
+				deallocate();
+			}
+		});
+	};
+
+	auto addAllocator = [&](const char* name, const char* deallocation, dreal time)
+	{
+		addRow(table, {
+			name, deallocation, format(units),
+			formatThroughput(units, time)});
+	};
+
+	{
+		PoolAllocator allocator(32);
+		addAllocator("PoolAllocator", "Local", measure(allocator, false));
+	}
+
+	{
+		ConcurrentPoolAllocator allocator(32);
+		addAllocator("ConcurrentPoolAllocator", "Local", measure(allocator, false));
+		addAllocator("ConcurrentPoolAllocator", "Remote", measure(allocator, true));
+		REQUIRE(allocator.allocated() == 0);
+	}
+
+	report(table);
+}
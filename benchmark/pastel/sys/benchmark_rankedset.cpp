@@ -0,0 +1,133 @@
+// Description: Benchmarks for RankedSet
+// DocumentationOf: rankedset.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/sys/rankedset/rankedset.h"
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+	using Candidate = std::pair<dreal, integer>;
+
+	//! Compares candidates by distance.
+	class Candidate_Less
+	{
+	public:
+		bool operator()(const Candidate& left, const Candidate& right) const
+		{
+			return left.first < right.first;
+		}
+	};
+
+	template <typename Type>
+	Type candidate(dreal distance, integer id);
+
+	template <>
+	dreal candidate<dreal>(dreal distance, integer id)
+	{
+		return distance;
+	}
+
+	template <>
+	Candidate candidate<Candidate>(dreal distance, integer id)
+	{
+		return Candidate(distance, id);
+	}
+
+	//! Returns the time (ns) per push.
+	/*!
+	Each query pushes 'pushes' candidates into an empty
+	set, as in a nearest-neighbor search. The candidates
+	come closer during a query, so that a part of them
+	is inserted also after the set is full.
+	*/
+	template <typename Set, typename Type>
+	dreal measure(
+		Set set,
+		const std::vector<Type>& candidateSet,
+		integer pushes)
+	{
+		integer queries = candidateSet.size() / pushes;
+		integer found = 0;
+		dreal time = seconds([&]()
+		{
+			for (integer i = 0;i < queries;++i)
+			{
+				set.clear();
+				const Type* query = candidateSet.data() + i * pushes;
+				for (integer j = 0;j < pushes;++j)
+				{
+					set.push(query[j]);
+				}
+				found += set.size();
+			}
+		});
+		REQUIRE(found == queries * std::min(set.capacity(), pushes));
+
+		return time * 1e9 / (queries * pushes);
+	}
+
+	template <typename Type, typename Less, int... CapacitySet>
+	void measureType(
+		MeasureTable& table,
+		const char* typeName,
+		std::integer_sequence<int, CapacitySet...>)
+	{
+		integer pushes = 256;
+		std::vector<Type> candidateSet(
+			std::max(options().points * 16 / pushes, (integer)1) * pushes);
+		{
+			Random random(0);
+			for (integer i = 0;i < (integer)candidateSet.size();++i)
+			{
+				integer j = i % pushes;
+				dreal distance = random.uniform() * (pushes - j);
+				candidateSet[i] = candidate<Type>(distance, i);
+			}
+		}
+
+		auto addSet = [&](integer k, const char* name, auto&& set)
+		{
+			addRow(table, {
+				format(k),
+				typeName,
+				name,
+				format(measure(std::move(set), candidateSet, pushes))});
+		};
+
+		for (integer k = 1;k <= pushes;k *= 2)
+		{
+			using Set = RankedSet<Type, Less>;
+			addSet(k, "Heap", Set(k, Less(), RankedSet_Policy::Heap));
+			addSet(k, "Sorted", Set(k, Less(), RankedSet_Policy::Sorted));
+			addSet(k, "Automatic", Set(k, Less(), RankedSet_Policy::Automatic));
+
+			((k == CapacitySet ?
+				addSet(k, "Fixed", RankedSet<Type, Less, CapacitySet>()) :
+				void()), ...);
+		}
+	}
+
+}
+
+TEST_CASE("RankedSet", "[rankedset]")
+{
+	MeasureTable table;
+	table.setCaption("RankedSet: the time (ns) per push, when "
+		"keeping the k nearest of 256 candidates of decreasing "
+		"distance, in a set of the given policy, or of the given "
+		"fixed capacity.");
+	setHeader(table, {
+		"k", "Type", "Policy", "Push"});
+
+	using CapacitySet = std::integer_sequence<int, 1, 2, 4, 8, 16, 32>;
+	measureType<dreal, LessThan>(table, "dreal", CapacitySet());
+	measureType<Candidate, Candidate_Less>(table, "Candidate", CapacitySet());
+
+	report(table);
+}
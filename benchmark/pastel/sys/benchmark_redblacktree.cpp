@@ -0,0 +1,226 @@
+// Description: Benchmarks for RedBlackTree
+// DocumentationOf: redblacktree.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/sys/redblacktree.h"
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+	//! Propagates the number of elements in a subtree.
+	template <typename Settings_>
+	class Counting_Customization
+		: public Empty_RedBlackTree_Customization<Settings_>
+	{
+	protected:
+		using Fwd = RedBlackTree_Fwd<Settings_>;
+		PASTEL_FWD(Iterator);
+		PASTEL_FWD(Propagation);
+
+		Counting_Customization() {}
+
+		void updatePropagation(
+			const Iterator& iter,
+			Propagation& propagation)
+		{
+			propagation =
+				iter.left().propagation() + 1 +
+				iter.right().propagation();
+		}
+
+	private:
+		Counting_Customization(const Counting_Customization& that) = delete;
+		Counting_Customization(Counting_Customization&& that) = delete;
+		Counting_Customization& operator=(Counting_Customization) = delete;
+	};
+
+	using Tree = RedBlackTree<
+		RedBlackTree_Set_Settings<integer, Empty, LessThan, integer>,
+		Counting_Customization>;
+
+	//! Returns n distinct sorted keys in [0, m).
+	std::vector<integer> generateKeySet(integer n, integer m, uint64 seed)
+	{
+		Random random(seed);
+		std::set<integer> keySet;
+		while (keySet.size() < n)
+		{
+			keySet.insert(random.index(m));
+		}
+		return std::vector<integer>(keySet.begin(), keySet.end());
+	}
+
+	Tree sortedTree(const std::vector<integer>& keySet)
+	{
+		Tree tree;
+		tree.assignSorted(keySet);
+		return tree;
+	}
+
+}
+
+TEST_CASE("RedBlackTree", "[redblacktree]")
+{
+	MeasureTable table;
+	table.setCaption("RedBlackTree: the time (s) to build a tree of "
+		"n sorted keys by assignSorted() and by repeated insert(), "
+		"and to erase the middle half of the keys by erase() of the "
+		"range and element by element.");
+	setHeader(table, {
+		"n", "Sorted", "Insert", "Erase", "Elements"});
+
+	for (integer n = options().points >> 6;n <= options().points * 4;n *= 4)
+	{
+		std::vector<integer> keySet = generateKeySet(n, 4 * n, 0);
+
+		Tree tree;
+		dreal sortedTime = seconds([&]()
+		{
+			tree.assignSorted(keySet);
+		});
+
+		dreal insertTime = seconds([&]()
+		{
+			Tree inserted;
+			for (integer key : keySet)
+			{
+				inserted.insert(key);
+			}
+			REQUIRE(inserted.size() == tree.size());
+		});
+
+		Tree copy = tree;
+		auto begin = std::next(tree.cbegin(), n / 4);
+		auto end = std::next(tree.cbegin(), n - n / 4);
+		dreal eraseTime = seconds([&]()
+		{
+			tree.erase(begin, end);
+		});
+
+		begin = std::next(copy.cbegin(), n / 4);
+		end = std::next(copy.cbegin(), n - n / 4);
+		dreal elementTime = seconds([&]()
+		{
+			while (begin != end)
+			{
+				begin = copy.erase(begin);
+			}
+		});
+		REQUIRE(copy.size() == tree.size());
+
+		addRow(table, {
+			format(n),
+			format(sortedTime),
+			format(insertTime),
+			format(eraseTime),
+			format(elementTime)});
+	}
+
+	report(table);
+}
+
+TEST_CASE("RedBlackTree set operations", "[redblacktree]")
+{
+	MeasureTable table;
+	table.setCaption("RedBlackTree: the time (s) to compute the union, "
+		"the intersection, and the difference of trees of n and "
+		"m random keys, in parallel and sequentially, and to compute "
+		"them by inserting, finding, or erasing the m keys one by one.");
+	setHeader(table, {
+		"n", "m", "Operation", "Parallel", "Serial", "Elements"});
+
+	integer n = options().points * 4;
+	for (integer m = n;m >= n >> 8;m >>= 4)
+	{
+		std::vector<integer> aSet = generateKeySet(n, 4 * n, 1);
+		std::vector<integer> bSet = generateKeySet(m, 4 * n, 2);
+
+		auto operate = [&](const char* name, auto&& operation, auto&& byElements)
+		{
+			integer size = 0;
+			auto time = [&](bool parallel)
+			{
+				Tree aTree = sortedTree(aSet);
+				Tree bTree;
+				bTree.useBottomFrom(aTree);
+				bTree.assignSorted(bSet);
+
+				dreal result = seconds([&]()
+				{
+					operation(aTree, bTree, parallel);
+				});
+				size = aTree.size();
+				return result;
+			};
+
+			dreal parallelTime = time(true);
+			dreal serialTime = time(false);
+
+			Tree aTree = sortedTree(aSet);
+			dreal elementTime = seconds([&]()
+			{
+				byElements(aTree);
+			});
+			REQUIRE(aTree.size() == size);
+
+			addRow(table, {
+				format(n),
+				format(m),
+				name,
+				format(parallelTime),
+				format(serialTime),
+				format(elementTime)});
+		};
+
+		operate("Union",
+			[](Tree& a, Tree& b, bool parallel)
+			{
+				a.unite(b, PASTEL_TAG(parallel), parallel);
+			},
+			[&](Tree& a)
+			{
+				for (integer key : bSet)
+				{
+					a.insert(key);
+				}
+			});
+
+		operate("Intersection",
+			[](Tree& a, Tree& b, bool parallel)
+			{
+				a.intersect(b, PASTEL_TAG(parallel), parallel);
+			},
+			[&](Tree& a)
+			{
+				Tree result;
+				for (integer key : bSet)
+				{
+					if (a.find(key) != a.cend())
+					{
+						result.insert(key);
+					}
+				}
+				a.swap(result);
+			});
+
+		operate("Difference",
+			[](Tree& a, Tree& b, bool parallel)
+			{
+				a.subtract(b, PASTEL_TAG(parallel), parallel);
+			},
+			[&](Tree& a)
+			{
+				for (integer key : bSet)
+				{
+					a.erase(key);
+				}
+			});
+	}
+
+	report(table);
+}
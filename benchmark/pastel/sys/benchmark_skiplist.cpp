@@ -0,0 +1,160 @@
+// Description: Benchmarks for SkipList and ConcurrentSkipList
+// DocumentationOf: concurrent_skiplist.h
+
+#include "benchmark/benchmark_init.h"
+#include "benchmark/benchmark_dataset.h"
+
+#include "pastel/sys/skiplist.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+	//! A SkipList behind a mutex.
+	template <typename Mutex>
+	class Locked_SkipList
+	{
+	public:
+		void insert(integer key)
+		{
+			std::unique_lock<Mutex> lock(mutex_);
+			list_.insert(key);
+		}
+
+		void erase(integer key)
+		{
+			std::unique_lock<Mutex> lock(mutex_);
+			list_.erase(key);
+		}
+
+		bool exists(integer key)
+		{
+			if constexpr (std::is_same_v<Mutex, std::shared_mutex>) {
+				std::shared_lock<Mutex> lock(mutex_);
+				return list_.find(key) != list_.cend();
+			} else {
+				std::unique_lock<Mutex> lock(mutex_);
+				return list_.find(key) != list_.cend();
+			}
+		}
+
+	private:
+		SkipList_Set<integer> list_;
+		Mutex mutex_;
+	};
+
+	struct Throughput
+	{
+		integer reads = 0;
+		integer writes = 0;
+		dreal seconds = 0;
+	};
+
+	//! Measures concurrent reads with a concurrent writer.
+	/*!
+	The list contains the even keys in [0, 2n). The readers
+	search for random keys, while the writer inserts and
+	erases odd keys until the readers are done.
+	*/
+	template <typename List>
+	Throughput measure(List& list, integer n, integer readers, integer reads)
+	{
+		for (integer i = 0;i < n;++i)
+		{
+			list.insert(2 * i);
+		}
+
+		Throughput result;
+		std::atomic<integer> readersLeft(readers);
+		std::atomic<integer> found(0);
+
+		result.seconds = seconds([&]()
+		{
+			std::vector<std::thread> threadSet;
+			for (integer j = 0;j < readers;++j)
+			{
+				threadSet.emplace_back([&, j]()
+				{
+					Random random(j + 1);
+					integer foundHere = 0;
+					for (integer i = 0;i < reads;++i)
+					{
+						foundHere += list.exists(random.index(2 * n));
+					}
+					found += foundHere;
+					--readersLeft;
+				});
+			}
+
+			Random random(0);
+			while (readersLeft > 0)
+			{
+				integer key = 2 * random.index(n) + 1;
+				list.insert(key);
+				list.erase(key);
+				result.writes += 2;
+			}
+
+			for (auto& thread : threadSet)
+			{
+				thread.join();
+			}
+		});
+
+		// Only the even keys are found.
+		REQUIRE(found <= readers * reads);
+
+		result.reads = readers * reads;
+		return result;
+	}
+
+}
+
+TEST_CASE("ConcurrentSkipList", "[skiplist]")
+{
+	MeasureTable table;
+	table.setCaption("ConcurrentSkipList: the number of searches and "
+		"writes per second, when the given number of threads search "
+		"for random keys in a skip list of n keys, while one thread "
+		"inserts and erases keys. The SkipList is behind a mutex, or "
+		"behind a shared mutex.");
+	setHeader(table, {
+		"n", "Readers", "List", "Reads/s", "Writes/s"});
+
+	integer n = options().points;
+	integer reads = options().points * 4;
+	integer maxReaders = std::max((integer)std::thread::hardware_concurrency() - 1, (integer)1);
+
+	for (integer readers = 1;readers <= maxReaders;readers *= 2)
+	{
+		auto addList = [&](const char* name, const Throughput& throughput)
+		{
+			addRow(table, {
+				format(n),
+				format(readers),
+				name,
+				formatThroughput(throughput.reads, throughput.seconds),
+				formatThroughput(throughput.writes, throughput.seconds)});
+		};
+
+		{
+			Locked_SkipList<std::mutex> list;
+			addList("Mutex", measure(list, n, readers, reads));
+		}
+		{
+			Locked_SkipList<std::shared_mutex> list;
+			addList("SharedMutex", measure(list, n, readers, reads));
+		}
+		{
+			ConcurrentSkipList_Set<integer> list;
+			addList("Concurrent", measure(list, n, readers, reads));
+		}
+	}
+
+	report(table);
+}
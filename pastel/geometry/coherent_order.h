@@ -0,0 +1,137 @@
+// Description: Spatially coherent ordering of points
+// Documentation: nearest_neighbors.txt
+
+#ifndef PASTELGEOMETRY_COHERENT_ORDER_H
+#define PASTELGEOMETRY_COHERENT_ORDER_H
+
+#include "pastel/sys/point/point_concept.h"
+#include "pastel/sys/range/range_concept.h"
+#include "pastel/sys/ensure.h"
+
+#include <tbb/parallel_invoke.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Orders points so that consecutive points are near each other.
+	/*!
+	pointSet (Random-access range of points):
+	The points to order.
+
+	bucketSize (integer >= 1):
+	The number of points under which a subset is
+	not ordered any further.
+
+	returns (std::vector<integer>):
+	A permutation of [0, n), where n is the number of
+	points. The t:th element is the index of the t:th
+	point in the order.
+
+	Time complexity:
+	O(n d log(n / bucketSize))
+
+	The order is the leaf order of a kd-tree whose nodes are
+	split at the median of the widest axis. Processing nearest
+	neighbor queries in this order means that consecutive queries
+	visit mostly the same nodes of the searched data structure,
+	which improves cache reuse. The order is deterministic.
+	*/
+	template <ranges::random_access_range Point_Range>
+	std::vector<integer> coherentOrder(
+		const Point_Range& pointSet,
+		integer bucketSize = 16)
+	{
+		ENSURE_OP(bucketSize, >=, 1);
+
+		using Point = ranges::range_value_t<Point_Range>;
+		using Real = Point_Real<Point>;
+		using Iterator = std::vector<integer>::iterator;
+
+		auto pointBegin = ranges::begin(pointSet);
+		integer n = ranges::distance(pointSet);
+
+		std::vector<integer> indexSet(n);
+		std::iota(indexSet.begin(), indexSet.end(), (integer)0);
+
+		if (n <= bucketSize)
+		{
+			return indexSet;
+		}
+
+		integer d = dimension(pointBegin[0]);
+
+		// Subsets larger than this are ordered in parallel.
+		const integer parallelThreshold = 1 << 14;
+
+		auto order = [&](auto&& self, Iterator begin, Iterator end) -> void
+		{
+			integer m = end - begin;
+			if (m <= bucketSize)
+			{
+				return;
+			}
+
+			// Find the widest axis of the bounding box.
+			std::vector<Real> minSet(d, (Real)Infinity());
+			std::vector<Real> maxSet(d, -(Real)Infinity());
+			for (Iterator i = begin; i != end; ++i)
+			{
+				const auto& point = pointBegin[*i];
+				for (integer axis = 0; axis < d; ++axis)
+				{
+					Real x = pointAxis(point, axis);
+					if (x < minSet[axis]) minSet[axis] = x;
+					if (x > maxSet[axis]) maxSet[axis] = x;
+				}
+			}
+
+			integer splitAxis = 0;
+			for (integer axis = 1; axis < d; ++axis)
+			{
+				if (maxSet[axis] - minSet[axis] >
+					maxSet[splitAxis] - minSet[splitAxis])
+				{
+					splitAxis = axis;
+				}
+			}
+
+			if (!(maxSet[splitAxis] > minSet[splitAxis]))
+			{
+				// All points are at the same position.
+				return;
+			}
+
+			// Split at the median.
+			Iterator middle = begin + m / 2;
+			std::nth_element(begin, middle, end,
+				[&](integer left, integer right)
+				{
+					return pointAxis(pointBegin[left], splitAxis) <
+						pointAxis(pointBegin[right], splitAxis);
+				});
+
+			if (m >= parallelThreshold)
+			{
+				tbb::parallel_invoke(
+					[&]() {self(self, begin, middle);},
+					[&]() {self(self, middle, end);});
+			}
+			else
+			{
+				self(self, begin, middle);
+				self(self, middle, end);
+			}
+		};
+
+		order(order, indexSet.begin(), indexSet.end());
+
+		return indexSet;
+	}
+
+}
+
+#endif
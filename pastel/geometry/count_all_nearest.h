@@ -0,0 +1,161 @@
+// Description: Batch nearest neighbors counting
+// Documentation: nearest_neighbors.txt
+
+#ifndef PASTELGEOMETRY_COUNT_ALL_NEAREST_H
+#define PASTELGEOMETRY_COUNT_ALL_NEAREST_H
+
+// Template concepts
+
+#include "pastel/sys/indicator/indicator_concept.h"
+#include "pastel/sys/point/point_concept.h"
+#include "pastel/math/norm/norm_concept.h"
+#include "pastel/geometry/nearestset/nearestset_concept.h"
+
+// Template defaults
+
+#include "pastel/math/norm/euclidean_norm.h"
+#include "pastel/sys/indicator/all_indicator.h"
+
+// Implementation requirements
+
+#include "pastel/geometry/count_nearest.h"
+#include "pastel/geometry/coherent_order.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Counts the points in open norm-balls around a set of points.
+	/*!
+	nearestSet (NearestSet):
+	The nearest-set in which to search neighbors in.
+
+	querySet (Random-access range of points):
+	The centers of the norm-balls.
+
+	returns (std::vector<integer>):
+	The i:th element is the number of accepted points
+	under distance maxDistance2 from the i:th query.
+
+	Optional arguments
+	------------------
+
+	accept (Indicator(PointId)):
+	An indicator which decides whether to accept a point
+	as a neighbor or not.
+	Default: allIndicator()
+
+	queryAccept (Function(integer) -> Indicator(PointId)):
+	A function which returns the accept-indicator for
+	the i:th query. Overrides 'accept' when given.
+	Default: [&](integer i) {return accept;}
+
+	maxDistance2 (Distance):
+	The distance after which points are not considered neighbors
+	anymore. Can be set to (Real)Infinity().
+	Default: norm((Real)Infinity())
+
+	queryMaxDistance2 (Function(integer) -> Distance):
+	A function which returns the maximum distance for
+	the i:th query. Overrides 'maxDistance2' when given.
+	Default: [&](integer i) {return maxDistance2;}
+
+	norm (Norm):
+	The norm used to measure distance.
+
+	parallel (bool):
+	Whether to distribute the queries over threads.
+	Default: true
+
+	grainSize (integer >= 1):
+	The number of consecutive queries under which a
+	range of queries is not divided between threads
+	any further.
+	Default: 64
+
+	See searchAllNearest() for the order of processing.
+	*/
+	template <
+		NearestSet_Concept NearestSet,
+		ranges::random_access_range Query_Range,
+		typename... ArgumentSet
+	>
+	std::vector<integer> countAllNearest(
+		const NearestSet& nearestSet,
+		const Query_Range& querySet,
+		ArgumentSet&&... argumentSet)
+	{
+		using PointId = PointSet_PointId<NearestSet>;
+		using Search_Point = ranges::range_value_t<Query_Range>;
+		using Real = Point_Real<Search_Point>;
+
+		PASTEL_CONCEPT_CHECK(Search_Point, Point_Concept);
+
+		auto&& accept =
+			PASTEL_ARG_C1(accept, allIndicator(), Indicator_Concept, PointId);
+
+		auto&& queryAccept =
+			PASTEL_ARG_S(queryAccept, [&](integer i) {return accept;});
+
+		auto&& norm =
+			PASTEL_ARG_C(norm, Euclidean_Norm<Real>(), Norm_Concept);
+
+		using Distance = decltype(norm());
+
+		Distance maxDistance2 =
+			PASTEL_ARG_C(maxDistance2, norm((Real)Infinity()), Distance_Concept);
+
+		auto&& queryMaxDistance2 =
+			PASTEL_ARG_S(queryMaxDistance2, [&](integer i) {return maxDistance2;});
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer grainSize = PASTEL_ARG_S(grainSize, 64);
+		ENSURE_OP(grainSize, >=, 1);
+
+		auto queryBegin = ranges::begin(querySet);
+		integer n = ranges::distance(querySet);
+
+		std::vector<integer> countSet(n, 0);
+		if (n == 0)
+		{
+			return countSet;
+		}
+
+		std::vector<integer> orderSet = coherentOrder(querySet);
+
+		using Block = tbb::blocked_range<integer>;
+
+		auto count = [&](const Block& block)
+		{
+			for (integer t = block.begin(); t < block.end(); ++t)
+			{
+				integer i = orderSet[t];
+
+				countSet[i] = countNearest(
+					nearestSet,
+					queryBegin[i],
+					PASTEL_TAG(accept), queryAccept(i),
+					PASTEL_TAG(norm), norm,
+					PASTEL_TAG(maxDistance2), queryMaxDistance2(i));
+			}
+		};
+
+		if (parallel)
+		{
+			tbb::parallel_for(Block(0, n, grainSize), count);
+		}
+		else
+		{
+			count(Block(0, n, grainSize));
+		}
+
+		return countSet;
+	}
+
+}
+
+#endif
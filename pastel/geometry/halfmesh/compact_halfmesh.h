@@ -0,0 +1,852 @@
+// Description: Compact half-edge structure
+// Documentation: halfmesh.txt
+
+#ifndef PASTELGEOMETRY_COMPACT_HALFMESH_H
+#define PASTELGEOMETRY_COMPACT_HALFMESH_H
+
+#include "pastel/geometry/halfmesh/halfmesh.h"
+#include "pastel/sys/named_parameter.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Compact half-edge structure
+	/*!
+	The compact half-edge structure stores the same links as
+	the HalfMesh, but in contiguous arrays, one per field, with
+	32-bit indices in place of iterators. The edge e consists of
+	the half-edges 2e and 2e + 1, so that the pair and the edge
+	of a half-edge are implicit.
+
+	The structure is built in bulk, either from an indexed
+	triangle list, or from a HalfMesh; it can not be modified
+	afterwards, except for the data of its elements. For
+	modification, convert it to a HalfMesh by toHalfMesh().
+	*/
+	template <typename Settings>
+	class Compact_HalfMesh
+	{
+	public:
+		using Fwd = Settings;
+		PASTEL_FWD(VertexData);
+		PASTEL_FWD(HalfData);
+		PASTEL_FWD(EdgeData);
+		PASTEL_FWD(PolygonData);
+
+		//! The index of a vertex, a half-edge, an edge, or a polygon.
+		using Index = uint32;
+
+		//! An index which refers to nothing.
+		static constexpr Index InvalidIndex =
+			std::numeric_limits<Index>::max();
+
+		//! Constructs an empty mesh.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		Compact_HalfMesh() = default;
+
+		//! Constructs a triangle mesh from an indexed triangle list.
+		/*!
+		Preconditions:
+		0 <= vertices < InvalidIndex
+		indexSet.size() is a multiple of 3.
+
+		vertices:
+		The number of vertices.
+
+		indexSet (Forward range of integers):
+		The vertex-indices of the triangles; the triangle i
+		consists of the vertices 3i, 3i + 1, and 3i + 2 of the
+		range, and is bounded by the half-edges between them
+		in this order.
+
+		Optional arguments
+		------------------
+
+		parallel (bool):
+		Whether to pair the half-edges and link the triangles
+		in parallel. The result does not depend on the number
+		of threads.
+		Default: true
+
+		Time complexity:
+		O(n + m log(d))
+		where
+		n is the number of vertices,
+		m is the number of triangles, and
+		d is the maximum degree of a vertex.
+
+		Exception safety: strong
+
+		Throws an InvariantFailure if the triangles do not form
+		an oriented 2-manifold with boundary; that is, if a
+		triangle is degenerate, if an edge is shared by more than
+		two triangles, or if two triangles sharing an edge have
+		opposite orientations.
+
+		The half-edges are paired by bucketing them by their
+		smaller end-vertex, and sorting each bucket by the larger
+		end-vertex, so that no incidence searches are needed. The
+		edges are numbered in the order of the buckets. A half-edge
+		which has no pair borders the boundary; its pair is a free
+		half-edge, which is linked to the next free half-edge
+		around the boundary loop. At a vertex with several
+		boundary loops, the free half-edges are linked in the
+		order of their indices.
+		*/
+		template <
+			ranges::forward_range Index_Range,
+			typename... ArgumentSet>
+		Compact_HalfMesh(
+			integer vertices,
+			const Index_Range& indexSet,
+			ArgumentSet&&... argumentSet);
+
+		//! Constructs from a half-edge structure.
+		/*!
+		Time complexity: O(n + m + p) on average
+		where
+		n is the number of vertices,
+		m is the number of edges, and
+		p is the number of polygons.
+
+		Exception safety: strong
+
+		The elements are indexed in the order of iteration
+		in 'that'. The half-edge edge->half() of the i:th edge
+		becomes the half-edge 2i.
+		*/
+		template <template <typename> class Customization>
+		explicit Compact_HalfMesh(
+			const HalfMesh<Settings, Customization>& that);
+
+		//! Swaps two meshes.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void swap(Compact_HalfMesh& that)
+		{
+			vertexHalfSet_.swap(that.vertexHalfSet_);
+			nextSet_.swap(that.nextSet_);
+			previousSet_.swap(that.previousSet_);
+			originSet_.swap(that.originSet_);
+			leftSet_.swap(that.leftSet_);
+			polygonHalfSet_.swap(that.polygonHalfSet_);
+			vertexDataSet_.swap(that.vertexDataSet_);
+			halfDataSet_.swap(that.halfDataSet_);
+			edgeDataSet_.swap(that.edgeDataSet_);
+			polygonDataSet_.swap(that.polygonDataSet_);
+		}
+
+		//! Removes all elements.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void clear()
+		{
+			Compact_HalfMesh().swap(*this);
+		}
+
+		//! Returns the number of vertices.
+		integer vertices() const
+		{
+			return vertexHalfSet_.size();
+		}
+
+		//! Returns the number of half-edges.
+		integer halves() const
+		{
+			return nextSet_.size();
+		}
+
+		//! Returns the number of edges.
+		integer edges() const
+		{
+			return halves() / 2;
+		}
+
+		//! Returns the number of polygons.
+		integer polygons() const
+		{
+			return polygonHalfSet_.size();
+		}
+
+		//! Returns a half-edge whose origin is the vertex.
+		/*!
+		returns:
+		A free half-edge, if there is one, and
+		InvalidIndex, if the vertex is isolated.
+		*/
+		Index vertexHalf(Index vertex) const
+		{
+			return vertexHalfSet_[vertex];
+		}
+
+		//! Returns the half-edge 2 * edge of the edge.
+		Index edgeHalf(Index edge) const
+		{
+			return 2 * edge;
+		}
+
+		//! Returns a half-edge of the polygon.
+		Index polygonHalf(Index polygon) const
+		{
+			return polygonHalfSet_[polygon];
+		}
+
+		//! Returns the next half-edge in the loop.
+		Index next(Index half) const
+		{
+			return nextSet_[half];
+		}
+
+		//! Returns the previous half-edge in the loop.
+		Index previous(Index half) const
+		{
+			return previousSet_[half];
+		}
+
+		//! Returns the oppositely oriented half-edge.
+		Index pair(Index half) const
+		{
+			return half ^ 1;
+		}
+
+		//! Returns the edge of the half-edge.
+		Index edge(Index half) const
+		{
+			return half / 2;
+		}
+
+		//! Returns the origin vertex of the half-edge.
+		Index origin(Index half) const
+		{
+			return originSet_[half];
+		}
+
+		//! Returns the destination vertex of the half-edge.
+		Index destination(Index half) const
+		{
+			return originSet_[pair(half)];
+		}
+
+		//! Returns the polygon of the loop of the half-edge.
+		/*!
+		returns:
+		The polygon, or InvalidIndex for a free half-edge.
+		*/
+		Index left(Index half) const
+		{
+			return leftSet_[half];
+		}
+
+		//! Returns the polygon of the loop of the pair.
+		Index right(Index half) const
+		{
+			return left(pair(half));
+		}
+
+		//! Returns whether the half-edge has no polygon.
+		bool free(Index half) const
+		{
+			return left(half) == InvalidIndex;
+		}
+
+		//! Returns the next half-edge around the origin.
+		Index rotateNext(Index half) const
+		{
+			return next(pair(half));
+		}
+
+		//! Returns the previous half-edge around the origin.
+		Index rotatePrevious(Index half) const
+		{
+			return pair(previous(half));
+		}
+
+		VertexData& vertexData(Index vertex)
+		{
+			return vertexDataSet_[vertex];
+		}
+
+		const VertexData& vertexData(Index vertex) const
+		{
+			return vertexDataSet_[vertex];
+		}
+
+		HalfData& halfData(Index half)
+		{
+			return halfDataSet_[half];
+		}
+
+		const HalfData& halfData(Index half) const
+		{
+			return halfDataSet_[half];
+		}
+
+		EdgeData& edgeData(Index edge)
+		{
+			return edgeDataSet_[edge];
+		}
+
+		const EdgeData& edgeData(Index edge) const
+		{
+			return edgeDataSet_[edge];
+		}
+
+		PolygonData& polygonData(Index polygon)
+		{
+			return polygonDataSet_[polygon];
+		}
+
+		const PolygonData& polygonData(Index polygon) const
+		{
+			return polygonDataSet_[polygon];
+		}
+
+		//! Converts to a half-edge structure.
+		/*!
+		Time complexity:
+		O(sum_v v'^2)
+		where
+		v' is the number of edges incident to the vertex v.
+
+		Exception safety: strong
+
+		The elements are inserted in the order of their indices,
+		and the polygons keep their loops of half-edges. The free
+		half-edges are linked by the HalfMesh, and may be linked
+		in a different order.
+		*/
+		template <template <typename> class Customization = Empty_HalfMesh_Customization>
+		HalfMesh<Settings, Customization> toHalfMesh() const;
+
+	private:
+		//! Links the free half-edges into loops.
+		/*!
+		The next of a free half-edge is a free half-edge
+		whose origin is its destination.
+		*/
+		void linkFree();
+
+		//! An outgoing half-edge of each vertex.
+		std::vector<Index> vertexHalfSet_;
+
+		//! The next half-edge of each half-edge.
+		std::vector<Index> nextSet_;
+
+		//! The previous half-edge of each half-edge.
+		std::vector<Index> previousSet_;
+
+		//! The origin vertex of each half-edge.
+		std::vector<Index> originSet_;
+
+		//! The polygon of each half-edge.
+		std::vector<Index> leftSet_;
+
+		//! A half-edge of each polygon.
+		std::vector<Index> polygonHalfSet_;
+
+		std::vector<VertexData> vertexDataSet_;
+		std::vector<HalfData> halfDataSet_;
+		std::vector<EdgeData> edgeDataSet_;
+		std::vector<PolygonData> polygonDataSet_;
+	};
+
+	template <typename Settings>
+	template <
+		ranges::forward_range Index_Range,
+		typename... ArgumentSet>
+	Compact_HalfMesh<Settings>::Compact_HalfMesh(
+		integer vertices,
+		const Index_Range& indexSet,
+		ArgumentSet&&... argumentSet)
+	: Compact_HalfMesh()
+	{
+		bool parallel = PASTEL_ARG_S(parallel, true);
+
+		ENSURE_OP(vertices, >=, 0);
+		ENSURE_OP(vertices, <, InvalidIndex);
+
+		std::vector<Index> cornerSet;
+		for (auto&& index : indexSet)
+		{
+			ENSURE_OP(index, >=, 0);
+			ENSURE_OP(index, <, vertices);
+			cornerSet.push_back(index);
+		}
+
+		integer corners = cornerSet.size();
+		ENSURE_OP(corners % 3, ==, 0);
+		ENSURE_OP(corners, <, InvalidIndex / 2);
+
+		integer triangles = corners / 3;
+
+		using Block = tbb::blocked_range<integer>;
+		auto forEach = [&](integer n, const auto& function)
+		{
+			if (parallel)
+			{
+				tbb::parallel_for(Block(0, n, 1024), function);
+			}
+			else
+			{
+				function(Block(0, n, 1024));
+			}
+		};
+
+		// The c:th corner is the half-edge from the c:th
+		// vertex of the list to the next vertex of its triangle.
+		auto from = [&](integer c)
+		{
+			return cornerSet[c];
+		};
+
+		auto to = [&](integer c)
+		{
+			return cornerSet[c % 3 == 2 ? c - 2 : c + 1];
+		};
+
+		// Bucket the corners by their smaller end-vertex.
+		std::vector<Index> bucketBeginSet(vertices + 1, 0);
+		for (integer c = 0;c < corners;++c)
+		{
+			ENSURE_OP(from(c), !=, to(c));
+			++bucketBeginSet[std::min(from(c), to(c)) + 1];
+		}
+
+		for (integer i = 0;i < vertices;++i)
+		{
+			bucketBeginSet[i + 1] += bucketBeginSet[i];
+		}
+
+		std::vector<Index> bucketSet(corners);
+		{
+			std::vector<Index> fillSet(
+				bucketBeginSet.begin(), bucketBeginSet.end() - 1);
+			for (integer c = 0;c < corners;++c)
+			{
+				bucketSet[fillSet[std::min(from(c), to(c))]++] = c;
+			}
+		}
+
+		// Sort each bucket by the larger end-vertex, and
+		// check that the corners of an edge are at most two,
+		// and oppositely oriented.
+		std::vector<Index> edgeBeginSet(vertices + 1, 0);
+		forEach(vertices, [&](const Block& block)
+		{
+			for (integer i = block.begin();i < block.end();++i)
+			{
+				auto begin = bucketSet.begin() + bucketBeginSet[i];
+				auto end = bucketSet.begin() + bucketBeginSet[i + 1];
+				std::sort(begin, end,
+					[&](Index left, Index right)
+					{
+						Index leftMax = std::max(from(left), to(left));
+						Index rightMax = std::max(from(right), to(right));
+						if (leftMax != rightMax)
+						{
+							return leftMax < rightMax;
+						}
+						return left < right;
+					});
+
+				integer edges = 0;
+				for (auto j = begin;j != end;)
+				{
+					auto k = std::next(j);
+					if (k != end &&
+						std::max(from(*k), to(*k)) == std::max(from(*j), to(*j)))
+					{
+						// A non-manifold edge, or an orientation flip.
+						ENSURE(std::next(k) == end ||
+							std::max(from(*std::next(k)), to(*std::next(k))) !=
+							std::max(from(*k), to(*k)));
+						ENSURE_OP(from(*j), !=, from(*k));
+						++k;
+					}
+
+					++edges;
+					j = k;
+				}
+
+				edgeBeginSet[i + 1] = edges;
+			}
+		});
+
+		for (integer i = 0;i < vertices;++i)
+		{
+			edgeBeginSet[i + 1] += edgeBeginSet[i];
+		}
+
+		integer edges = edgeBeginSet[vertices];
+		integer halves = 2 * edges;
+
+		std::vector<Index> vertexHalfSet(vertices, InvalidIndex);
+		std::vector<Index> nextSet(halves, InvalidIndex);
+		std::vector<Index> previousSet(halves, InvalidIndex);
+		std::vector<Index> originSet(halves);
+		std::vector<Index> leftSet(halves, InvalidIndex);
+		std::vector<Index> polygonHalfSet(triangles);
+
+		// Number the edges. The half-edge 2e of the edge e
+		// starts from the smaller end-vertex.
+		std::vector<Index> cornerHalfSet(corners);
+		forEach(vertices, [&](const Block& block)
+		{
+			for (integer i = block.begin();i < block.end();++i)
+			{
+				integer e = edgeBeginSet[i];
+				auto begin = bucketSet.begin() + bucketBeginSet[i];
+				auto end = bucketSet.begin() + bucketBeginSet[i + 1];
+				for (auto j = begin;j != end;++e)
+				{
+					Index max = std::max(from(*j), to(*j));
+					originSet[2 * e] = i;
+					originSet[2 * e + 1] = max;
+					do
+					{
+						cornerHalfSet[*j] = 2 * e + (from(*j) != i);
+						++j;
+					}
+					while (j != end && std::max(from(*j), to(*j)) == max);
+				}
+			}
+		});
+
+		// Link the triangles.
+		forEach(triangles, [&](const Block& block)
+		{
+			for (integer t = block.begin();t < block.end();++t)
+			{
+				for (integer k = 0;k < 3;++k)
+				{
+					Index half = cornerHalfSet[3 * t + k];
+					Index next = cornerHalfSet[3 * t + (k + 1) % 3];
+					nextSet[half] = next;
+					previousSet[next] = half;
+					leftSet[half] = t;
+				}
+				polygonHalfSet[t] = cornerHalfSet[3 * t];
+			}
+		});
+
+		for (integer c = 0;c < corners;++c)
+		{
+			if (vertexHalfSet[from(c)] == InvalidIndex)
+			{
+				vertexHalfSet[from(c)] = cornerHalfSet[c];
+			}
+		}
+
+		vertexHalfSet_.swap(vertexHalfSet);
+		nextSet_.swap(nextSet);
+		previousSet_.swap(previousSet);
+		originSet_.swap(originSet);
+		leftSet_.swap(leftSet);
+		polygonHalfSet_.swap(polygonHalfSet);
+		linkFree();
+
+		vertexDataSet_.resize(vertices);
+		halfDataSet_.resize(halves);
+		edgeDataSet_.resize(edges);
+		polygonDataSet_.resize(triangles);
+	}
+
+	template <typename Settings>
+	template <template <typename> class Customization>
+	Compact_HalfMesh<Settings>::Compact_HalfMesh(
+		const HalfMesh<Settings, Customization>& that)
+	: Compact_HalfMesh()
+	{
+		using Mesh = HalfMesh<Settings, Customization>;
+		using Vertex_ConstIterator = typename Mesh::Vertex_ConstIterator;
+		using Half_ConstIterator = typename Mesh::Half_ConstIterator;
+		using Polygon_ConstIterator = typename Mesh::Polygon_ConstIterator;
+
+		ENSURE_OP(that.vertices(), <, InvalidIndex);
+		ENSURE_OP(that.edges(), <, InvalidIndex / 2);
+		ENSURE_OP(that.polygons(), <, InvalidIndex);
+
+		std::unordered_map<Vertex_ConstIterator, Index> vertexMap;
+		std::unordered_map<Half_ConstIterator, Index> halfMap;
+		std::unordered_map<Polygon_ConstIterator, Index> polygonMap;
+
+		Compact_HalfMesh result;
+
+		for (auto vertex = that.vertexBegin();vertex != that.vertexEnd();++vertex)
+		{
+			vertexMap.emplace(vertex, vertexMap.size());
+			result.vertexDataSet_.push_back(vertex->data());
+		}
+
+		for (auto edge = that.edgeBegin();edge != that.edgeEnd();++edge)
+		{
+			Half_ConstIterator half = edge->half();
+			halfMap.emplace(half, halfMap.size());
+			halfMap.emplace(half->pair(), halfMap.size());
+			result.halfDataSet_.push_back(half->data());
+			result.halfDataSet_.push_back(half->pair()->data());
+			result.edgeDataSet_.push_back(edge->data());
+		}
+
+		for (auto polygon = that.polygonBegin();polygon != that.polygonEnd();++polygon)
+		{
+			polygonMap.emplace(polygon, polygonMap.size());
+			result.polygonHalfSet_.push_back(halfMap.at(polygon->half()));
+			result.polygonDataSet_.push_back(polygon->data());
+		}
+
+		for (auto vertex = that.vertexBegin();vertex != that.vertexEnd();++vertex)
+		{
+			Half_ConstIterator half = vertex->half();
+			if (!half.empty())
+			{
+				// Prefer a free half-edge, as in the bulk construction.
+				Half_ConstIterator free = vertex->findFree();
+				if (!free.empty())
+				{
+					half = free;
+				}
+			}
+			result.vertexHalfSet_.push_back(
+				half.empty() ? InvalidIndex : halfMap.at(half));
+		}
+
+		integer halves = halfMap.size();
+		result.nextSet_.resize(halves);
+		result.previousSet_.resize(halves);
+		result.originSet_.resize(halves);
+		result.leftSet_.resize(halves);
+		for (auto&& entry : halfMap)
+		{
+			Half_ConstIterator half = entry.first;
+			Index i = entry.second;
+			result.nextSet_[i] = halfMap.at(half->next());
+			result.previousSet_[i] = halfMap.at(half->previous());
+			result.originSet_[i] = vertexMap.at(half->origin());
+			result.leftSet_[i] = half->free() ?
+				InvalidIndex : polygonMap.at(half->left());
+		}
+
+		swap(result);
+	}
+
+	template <typename Settings>
+	template <template <typename> class Customization>
+	HalfMesh<Settings, Customization>
+		Compact_HalfMesh<Settings>::toHalfMesh() const
+	{
+		using Mesh = HalfMesh<Settings, Customization>;
+		using Vertex_Iterator = typename Mesh::Vertex_Iterator;
+		using Half_Iterator = typename Mesh::Half_Iterator;
+		using Edge_Iterator = typename Mesh::Edge_Iterator;
+		using Polygon_Iterator = typename Mesh::Polygon_Iterator;
+
+		Mesh mesh;
+
+		std::vector<Vertex_Iterator> vertexSet;
+		vertexSet.reserve(vertices());
+		for (integer i = 0;i < vertices();++i)
+		{
+			vertexSet.push_back(mesh.insertVertex(vertexData(i)));
+		}
+
+		std::vector<Half_Iterator> halfSet(halves());
+		for (integer e = 0;e < edges();++e)
+		{
+			Vertex_Iterator from = vertexSet[origin(edgeHalf(e))];
+			Vertex_Iterator to = vertexSet[destination(edgeHalf(e))];
+
+			Edge_Iterator edge;
+			if constexpr (Mesh::MultipleEdges)
+			{
+				edge = mesh.insertEdge(from, to, edgeData(e));
+			}
+			else
+			{
+				edge = mesh.insertEdge(from, to, edgeData(e)).first;
+			}
+			ENSURE(!edge.empty());
+
+			Half_Iterator half = edge->half();
+			if (half->origin() != from)
+			{
+				half = half->pair();
+			}
+			halfSet[edgeHalf(e)] = half;
+			halfSet[pair(edgeHalf(e))] = half->pair();
+			half->data() = halfData(edgeHalf(e));
+			half->pair()->data() = halfData(pair(edgeHalf(e)));
+		}
+
+		std::vector<Half_Iterator> loopSet;
+		for (integer i = 0;i < polygons();++i)
+		{
+			loopSet.clear();
+			Index begin = polygonHalf(i);
+			Index half = begin;
+			do
+			{
+				loopSet.push_back(halfSet[half]);
+				half = next(half);
+			}
+			while (half != begin);
+
+			Polygon_Iterator polygon =
+				mesh.insertPolygon(loopSet, polygonData(i));
+			ENSURE(polygon != mesh.polygonEnd());
+		}
+
+		return mesh;
+	}
+
+	template <typename Settings>
+	void Compact_HalfMesh<Settings>::linkFree()
+	{
+		integer n = vertices();
+
+		// Bucket the free half-edges by their origins,
+		// and by their destinations.
+		std::vector<Index> outBeginSet(n + 1, 0);
+		std::vector<Index> inBeginSet(n + 1, 0);
+		for (integer half = 0;half < halves();++half)
+		{
+			if (free(half))
+			{
+				++outBeginSet[origin(half) + 1];
+				++inBeginSet[destination(half) + 1];
+			}
+		}
+
+		for (integer i = 0;i < n;++i)
+		{
+			outBeginSet[i + 1] += outBeginSet[i];
+			inBeginSet[i + 1] += inBeginSet[i];
+		}
+
+		std::vector<Index> outSet(outBeginSet[n]);
+		std::vector<Index> inSet(inBeginSet[n]);
+		{
+			std::vector<Index> outFillSet(outBeginSet.begin(), outBeginSet.end() - 1);
+			std::vector<Index> inFillSet(inBeginSet.begin(), inBeginSet.end() - 1);
+			for (integer half = 0;half < halves();++half)
+			{
+				if (free(half))
+				{
+					outSet[outFillSet[origin(half)]++] = half;
+					inSet[inFillSet[destination(half)]++] = half;
+				}
+			}
+		}
+
+		// Around each vertex, there are as many free half-edges
+		// coming in as going out; link them in pairs.
+		for (integer i = 0;i < n;++i)
+		{
+			integer outs = outBeginSet[i + 1] - outBeginSet[i];
+			ASSERT_OP(outs, ==, inBeginSet[i + 1] - inBeginSet[i]);
+			for (integer k = 0;k < outs;++k)
+			{
+				Index in = inSet[inBeginSet[i] + k];
+				Index out = outSet[outBeginSet[i] + k];
+				nextSet_[in] = out;
+				previousSet_[out] = in;
+			}
+
+			if (outs > 0)
+			{
+				vertexHalfSet_[i] = outSet[outBeginSet[i]];
+			}
+		}
+	}
+
+	//! Returns whether the invariants hold for a compact half-edge structure.
+	/*!
+	Time complexity: O(mesh.vertices() + mesh.edges() + mesh.polygons())
+	Exception safety: nothrow
+
+	This function is useful only for testing and debugging. For
+	a correct implementation this function always returns true.
+	*/
+	template <typename Settings>
+	bool testInvariants(const Compact_HalfMesh<Settings>& mesh)
+	{
+		using Mesh = Compact_HalfMesh<Settings>;
+		using Index = typename Mesh::Index;
+		const Index Invalid = Mesh::InvalidIndex;
+
+		integer halves = mesh.halves();
+
+		for (integer i = 0;i < mesh.vertices();++i)
+		{
+			Index half = mesh.vertexHalf(i);
+			if (half != Invalid &&
+				(half >= halves || mesh.origin(half) != i))
+			{
+				// The half-edge of a vertex must start
+				// from the vertex.
+				return false;
+			}
+		}
+
+		for (integer i = 0;i < mesh.polygons();++i)
+		{
+			Index half = mesh.polygonHalf(i);
+			if (half >= halves || mesh.left(half) != i)
+			{
+				// The half-edge of a polygon must be
+				// in the loop of the polygon.
+				return false;
+			}
+		}
+
+		for (integer half = 0;half < halves;++half)
+		{
+			Index next = mesh.next(half);
+			Index previous = mesh.previous(half);
+			if (next >= halves || previous >= halves ||
+				mesh.origin(half) >= mesh.vertices())
+			{
+				// All of the fields of a half-edge
+				// must exist.
+				return false;
+			}
+
+			if (mesh.previous(next) != half ||
+				mesh.next(previous) != half ||
+				mesh.left(next) != mesh.left(half) ||
+				mesh.origin(next) != mesh.destination(half) ||
+				mesh.vertexHalf(mesh.origin(half)) == Invalid)
+			{
+				// The fields must be linked together
+				// in a bidirectional manner.
+				return false;
+			}
+
+			if (mesh.left(half) != Invalid &&
+				mesh.left(half) >= mesh.polygons())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}
+
+#endif
@@ -5,13 +5,17 @@
 
 #include "pastel/sys/output/output_concept.h"
 #include "pastel/sys/range.h"
-#include "pastel/sys/redblacktree.h"
+#include "pastel/sys/btree.h"
 #include "pastel/sys/output/null_output.h"
 #include "pastel/sys/output/push_back_output.h"
 #include "pastel/sys/random/random_uniform.h"
+#include "pastel/sys/named_parameter.h"
 
 #include "pastel/geometry/shape/alignedbox.h"
 
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <vector>
 #include <iterator>
 #include <type_traits>
@@ -392,7 +396,7 @@ namespace Pastel
 			const Iterator& root,
 			const Direction_Output& report)
 		{
-			// The augmented red-black tree is traversed
+			// The augmented binary search tree is traversed
 			// from the root downwards to find _a_ maximum clique.
 			// Maximum cliques are not unique; there can be
 			// many of them. In this case we choose one randomly.
@@ -473,6 +477,696 @@ namespace Pastel
 			return iter;
 		}
 
+
+		//! A segment tree for range addition and maximum.
+		/*!
+		The tree stores integers x_0, ..., x_{m - 1}, all zero
+		initially. Each node stores the amount added to its whole
+		range, and the maximum of its range including that amount;
+		the additions are never pushed down to the children, and
+		so the maximum of all elements is at the root.
+		*/
+		class MaxAdd_SegmentTree
+		{
+		public:
+			explicit MaxAdd_SegmentTree(integer m)
+				: m_(m)
+				, addSet_(4 * std::max(m, (integer)1), 0)
+				, maxSet_(4 * std::max(m, (integer)1), 0)
+			{
+			}
+
+			//! Adds 'amount' to x_i, for i in [begin, end).
+			/*!
+			Time complexity: O(log(m))
+			*/
+			void add(integer begin, integer end, integer amount)
+			{
+				add(1, 0, m_, begin, end, amount);
+			}
+
+			//! Returns max(x_0, ..., x_{m - 1}).
+			integer max() const
+			{
+				return maxSet_[1];
+			}
+
+			//! Returns the smallest i such that x_i = max().
+			/*!
+			Time complexity: O(log(m))
+			*/
+			integer argMax() const
+			{
+				return argMax(1, 0, m_);
+			}
+
+		private:
+			integer argMax(integer node, integer begin, integer end) const
+			{
+				integer target = maxSet_[node];
+				while (end - begin > 1)
+				{
+					target -= addSet_[node];
+					integer middle = (begin + end) / 2;
+					if (maxSet_[2 * node] == target)
+					{
+						node = 2 * node;
+						end = middle;
+					}
+					else
+					{
+						node = 2 * node + 1;
+						begin = middle;
+					}
+				}
+				return begin;
+			}
+
+			void add(
+				integer node, integer nodeBegin, integer nodeEnd,
+				integer begin, integer end, integer amount)
+			{
+				if (end <= nodeBegin || nodeEnd <= begin)
+				{
+					return;
+				}
+
+				if (begin <= nodeBegin && nodeEnd <= end)
+				{
+					addSet_[node] += amount;
+					maxSet_[node] += amount;
+					return;
+				}
+
+				integer middle = (nodeBegin + nodeEnd) / 2;
+				add(2 * node, nodeBegin, middle, begin, end, amount);
+				add(2 * node + 1, middle, nodeEnd, begin, end, amount);
+				maxSet_[node] = addSet_[node] +
+					std::max(maxSet_[2 * node], maxSet_[2 * node + 1]);
+			}
+
+			integer m_;
+			std::vector<integer> addSet_;
+			std::vector<integer> maxSet_;
+		};
+
+		//! A maximum clique in the rank-space of the box end-points.
+		/*!
+		On each axis, the 2n end-points of the boxes are ordered
+		by Event::operator<(), and replaced by their ranks in
+		that order. Two boxes then overlap on an axis if and only
+		if their rank-intervals [minRank, maxRank) overlap. A
+		slot r on an axis is the set of points between the
+		end-points of rank r and r + 1; the depth of a slot-vector
+		is the number of boxes which contain its slot on every axis.
+		*/
+		class Clique
+		{
+		public:
+			//! The number of boxes in the clique.
+			integer depth = 0;
+
+			//! The slot on each level of the sweep.
+			std::vector<integer> slotSet;
+		};
+
+		//! The boxes in the rank-space of their end-points.
+		class Clique_Solver
+		{
+		public:
+			Clique_Solver(
+				integer d,
+				const std::vector<integer>& rankSet)
+				: d_(d)
+				, rankSet_(rankSet)
+				, slots_(rankSet.size() / d)
+			{
+			}
+
+			//! Returns the number of slots on each axis.
+			integer slots() const
+			{
+				return slots_;
+			}
+
+			//! Returns the rank of an end-point of a box.
+			integer rank(integer level, integer box, bool max) const
+			{
+				return rankSet_[(box * d_ + level) * 2 + max];
+			}
+
+			//! Finds a maximum clique by sweeping, for d <= 2.
+			/*!
+			The boxes are swept along the first axis. For d = 1,
+			the sweep keeps track of the depth. For d = 2, the sweep
+			keeps the depths of the slots of the second axis in a
+			segment tree with range additions. A maximum clique can
+			only be found after a start which is followed by an end.
+			Of the maximum cliques, the first one in the sweep order
+			is returned.
+
+			Time complexity: O(n log(n))
+			*/
+			Clique sweep() const
+			{
+				ASSERT_OP(d_, <=, 2);
+
+				integer n = slots_ / 2;
+
+				Clique best;
+				best.slotSet.assign(d_, 0);
+
+				// The sweep events, as (rank, box); since the
+				// ranks are distinct, sorting them reproduces
+				// the order of the end-points.
+				std::vector<std::pair<integer, integer>> eventSet;
+				eventSet.reserve(2 * n);
+				for (integer i = 0;i < n;++i)
+				{
+					eventSet.emplace_back(rank(0, i, false), i);
+					eventSet.emplace_back(rank(0, i, true), i);
+				}
+				std::sort(eventSet.begin(), eventSet.end());
+
+				auto isMin = [&](integer k)
+				{
+					return eventSet[k].first ==
+						rank(0, eventSet[k].second, false);
+				};
+
+				auto candidate = [&](integer k)
+				{
+					return isMin(k) && (k + 1 == 2 * n || !isMin(k + 1));
+				};
+
+				MaxAdd_SegmentTree tree(d_ == 2 ? slots_ : 1);
+				integer depth = 0;
+				for (integer k = 0;k < 2 * n;++k)
+				{
+					integer box = eventSet[k].second;
+					integer amount = isMin(k) ? 1 : -1;
+					if (d_ == 1)
+					{
+						depth += amount;
+					}
+					else
+					{
+						tree.add(
+							rank(1, box, false), 
+							rank(1, box, true), 
+							amount);
+						depth = tree.max();
+					}
+
+					if (depth > best.depth && candidate(k))
+					{
+						best.depth = depth;
+						best.slotSet[0] = eventSet[k].first;
+						if (d_ == 2)
+						{
+							best.slotSet[1] = tree.argMax();
+						}
+					}
+				}
+
+				return best;
+			}
+
+		private:
+			integer d_;
+			const std::vector<integer>& rankSet_;
+			integer slots_;
+		};
+
+		//! Finds a maximum clique in a window by branch-and-bound.
+		/*!
+		The number of boxes which intersect the window bounds
+		the depth of the slot-vectors in the window from above,
+		and the number of boxes which cover the whole window
+		bounds it from below. If all of the boxes cover the whole
+		window, every slot-vector in the window is a clique of all
+		of the boxes. Otherwise the window is split at the median
+		of the end-points inside the window, on the axis which has
+		the most of them, and the halves are searched, the one
+		with more boxes first.
+
+		Of the maximum cliques, the first one in the order of
+		the search is stored in 'best', if it is deeper than
+		'best'.
+		*/
+		inline void solveWindow(
+			const Clique_Solver& solver,
+			integer d,
+			const std::vector<integer>& boxSet,
+			std::vector<integer>& windowSet,
+			Clique& best)
+		{
+			integer m = boxSet.size();
+			if (m <= best.depth)
+			{
+				return;
+			}
+
+			// Count the end-points inside the window.
+			std::vector<integer> innerSet(d, 0);
+			integer covered = 0;
+			for (integer box : boxSet)
+			{
+				bool coversWindow = true;
+				for (integer level = 0;level < d;++level)
+				{
+					integer inner = 
+						(solver.rank(level, box, false) > windowSet[2 * level]) +
+						(solver.rank(level, box, true) < windowSet[2 * level + 1]);
+					innerSet[level] += inner;
+					coversWindow = coversWindow && inner == 0;
+				}
+
+				if (coversWindow)
+				{
+					++covered;
+				}
+			}
+
+			if (covered > best.depth)
+			{
+				best.depth = covered;
+				for (integer level = 0;level < d;++level)
+				{
+					best.slotSet[level] = windowSet[2 * level];
+				}
+			}
+
+			if (covered == m)
+			{
+				return;
+			}
+
+			integer splitLevel = 
+				std::max_element(innerSet.begin(), innerSet.end()) - 
+				innerSet.begin();
+
+			integer begin = windowSet[2 * splitLevel];
+			integer end = windowSet[2 * splitLevel + 1];
+
+			std::vector<integer> splitSet;
+			splitSet.reserve(innerSet[splitLevel]);
+			for (integer box : boxSet)
+			{
+				integer min = solver.rank(splitLevel, box, false);
+				integer max = solver.rank(splitLevel, box, true);
+				if (min > begin)
+				{
+					splitSet.push_back(min);
+				}
+				if (max < end)
+				{
+					splitSet.push_back(max);
+				}
+			}
+
+			std::nth_element(
+				splitSet.begin(), 
+				splitSet.begin() + splitSet.size() / 2, 
+				splitSet.end());
+			integer split = splitSet[splitSet.size() / 2];
+
+			std::vector<integer> lowSet;
+			std::vector<integer> highSet;
+			lowSet.reserve(m);
+			highSet.reserve(m);
+			for (integer box : boxSet)
+			{
+				if (solver.rank(splitLevel, box, false) < split)
+				{
+					lowSet.push_back(box);
+				}
+				if (solver.rank(splitLevel, box, true) > split)
+				{
+					highSet.push_back(box);
+				}
+			}
+
+			bool highFirst = highSet.size() > lowSet.size();
+			for (integer i = 0;i < 2;++i)
+			{
+				bool high = (i == 0) == highFirst;
+				windowSet[2 * splitLevel] = high ? split : begin;
+				windowSet[2 * splitLevel + 1] = high ? end : split;
+				solveWindow(solver, d, high ? highSet : lowSet, windowSet, best);
+			}
+
+			windowSet[2 * splitLevel] = begin;
+			windowSet[2 * splitLevel + 1] = end;
+		}
+
+		//! Finds a maximum clique by branch-and-bound over a grid of slots.
+		/*!
+		The slots of each axis are divided into runs of equal
+		width, which form a grid of cells. The number of boxes
+		which intersect a cell bounds the depth of the slot-vectors
+		in the cell. The counts are obtained by adding the 2^d
+		corners of the cell-range of each box into a difference
+		array, and then by summing the array over each axis.
+
+		The cells are solved in decreasing order of their bounds,
+		for the boxes which intersect the cell, until no bound
+		exceeds the depth of the best clique so far. A clique among
+		some of the boxes is also a clique among all of the boxes,
+		and each box which contains a slot-vector intersects its
+		cell; therefore the best clique is a maximum clique.
+
+		The cells are solved in groups of a fixed size, the cells
+		of a group in parallel. Of the maximum cliques, the one in
+		the first cell in the order is returned, so that the result
+		does not depend on the number of threads.
+		*/
+		inline Clique solveByGrid(
+			const Clique_Solver& solver,
+			integer d,
+			integer n,
+			bool parallel)
+		{
+			// The width of the cells on each axis is a quarter
+			// of the median extent of the boxes, in slots.
+			std::vector<integer> medianSet(d);
+			std::vector<integer> widthSet(d);
+			{
+				std::vector<integer> extentSet(n);
+				for (integer level = 0;level < d;++level)
+				{
+					for (integer i = 0;i < n;++i)
+					{
+						extentSet[i] =
+							solver.rank(level, i, true) -
+							solver.rank(level, i, false);
+					}
+					std::nth_element(
+						extentSet.begin(),
+						extentSet.begin() + n / 2,
+						extentSet.end());
+					medianSet[level] = extentSet[n / 2];
+					widthSet[level] = std::max(medianSet[level] / 4, (integer)1);
+				}
+			}
+
+			// Widen the cells until there are at most 16n cells.
+			std::vector<integer> sizeSet(d);
+			std::vector<integer> strideSet(d);
+			integer cells = 0;
+			while (true)
+			{
+				cells = 1;
+				for (integer level = 0;level < d;++level)
+				{
+					sizeSet[level] = (2 * n + widthSet[level] - 1) / widthSet[level];
+					strideSet[level] = cells;
+					cells *= sizeSet[level];
+					if (cells > 16 * n)
+					{
+						break;
+					}
+				}
+
+				if (cells <= 16 * n)
+				{
+					break;
+				}
+
+				for (integer& width : widthSet)
+				{
+					width *= 2;
+				}
+			}
+
+			// The cell-ranges of the boxes; a box which contains
+			// no slot has an empty cell-range.
+			std::vector<integer> minCellSet(n * d);
+			std::vector<integer> maxCellSet(n * d);
+			std::vector<bool> emptySet(n, false);
+			for (integer i = 0;i < n;++i)
+			{
+				for (integer level = 0;level < d;++level)
+				{
+					integer min = solver.rank(level, i, false);
+					integer max = solver.rank(level, i, true);
+					if (max <= min)
+					{
+						emptySet[i] = true;
+						break;
+					}
+					minCellSet[i * d + level] = min / widthSet[level];
+					maxCellSet[i * d + level] = (max - 1) / widthSet[level];
+				}
+			}
+
+			// Count the boxes which intersect each cell.
+			std::vector<integer> countSet(cells, 0);
+			for (integer i = 0;i < n;++i)
+			{
+				if (emptySet[i])
+				{
+					continue;
+				}
+
+				for (integer corner = 0;corner < ((integer)1 << d);++corner)
+				{
+					integer index = 0;
+					integer sign = 1;
+					bool inside = true;
+					for (integer level = 0;level < d && inside;++level)
+					{
+						integer c = minCellSet[i * d + level];
+						if (corner & ((integer)1 << level))
+						{
+							c = maxCellSet[i * d + level] + 1;
+							sign = -sign;
+							inside = c < sizeSet[level];
+						}
+						index += c * strideSet[level];
+					}
+
+					if (inside)
+					{
+						countSet[index] += sign;
+					}
+				}
+			}
+
+			for (integer level = 0;level < d;++level)
+			{
+				integer stride = strideSet[level];
+				for (integer index = 0;index < cells;++index)
+				{
+					if ((index / stride) % sizeSet[level] > 0)
+					{
+						countSet[index] += countSet[index - stride];
+					}
+				}
+			}
+
+			// Bucket the boxes by their minimum cells, except for
+			// the boxes larger than twice the median extent. The
+			// boxes which intersect a cell are then found from the
+			// nearby buckets, and from the large boxes.
+			std::vector<integer> spanSet(d, 0);
+			std::vector<integer> largeSet;
+			std::vector<integer> bucketBeginSet(cells + 1, 0);
+			std::vector<integer> bucketSet;
+			{
+				std::vector<integer> minIndexSet(n, -1);
+				for (integer i = 0;i < n;++i)
+				{
+					if (emptySet[i])
+					{
+						continue;
+					}
+
+					bool large = false;
+					for (integer level = 0;level < d && !large;++level)
+					{
+						large = 
+							solver.rank(level, i, true) - solver.rank(level, i, false) >
+							2 * medianSet[level];
+					}
+
+					if (large)
+					{
+						largeSet.push_back(i);
+						continue;
+					}
+
+					integer index = 0;
+					for (integer level = 0;level < d;++level)
+					{
+						spanSet[level] = std::max(spanSet[level],
+							maxCellSet[i * d + level] - minCellSet[i * d + level]);
+						index += minCellSet[i * d + level] * strideSet[level];
+					}
+					minIndexSet[i] = index;
+					++bucketBeginSet[index + 1];
+				}
+
+				for (integer index = 0;index < cells;++index)
+				{
+					bucketBeginSet[index + 1] += bucketBeginSet[index];
+				}
+
+				bucketSet.resize(bucketBeginSet[cells]);
+				std::vector<integer> fillSet(
+					bucketBeginSet.begin(), bucketBeginSet.end() - 1);
+				for (integer i = 0;i < n;++i)
+				{
+					if (minIndexSet[i] >= 0)
+					{
+						bucketSet[fillSet[minIndexSet[i]]++] = i;
+					}
+				}
+			}
+
+			std::vector<integer> cellOrder;
+			for (integer index = 0;index < cells;++index)
+			{
+				if (countSet[index] > 0)
+				{
+					cellOrder.push_back(index);
+				}
+			}
+			std::sort(cellOrder.begin(), cellOrder.end(),
+				[&](integer left, integer right)
+				{
+					if (countSet[left] != countSet[right])
+					{
+						return countSet[left] > countSet[right];
+					}
+					return left < right;
+				});
+
+			Clique best;
+			best.depth = 0;
+			best.slotSet.assign(d, 0);
+
+			integer groupSize = 16;
+			integer k = 0;
+			while (k < cellOrder.size() && countSet[cellOrder[k]] > best.depth)
+			{
+				integer end = k;
+				while (end < cellOrder.size() && end - k < groupSize &&
+					countSet[cellOrder[end]] > best.depth)
+				{
+					++end;
+				}
+
+				std::vector<Clique> resultSet(end - k);
+				auto solveCell = [&](integer j)
+				{
+					integer index = cellOrder[k + j];
+
+					std::vector<integer> cellSet(d);
+					std::vector<integer> windowSet(2 * d);
+					for (integer level = 0;level < d;++level)
+					{
+						cellSet[level] = (index / strideSet[level]) % sizeSet[level];
+						windowSet[2 * level] = cellSet[level] * widthSet[level];
+						windowSet[2 * level + 1] = std::min(
+							windowSet[2 * level] + widthSet[level], solver.slots());
+					}
+
+					auto intersects = [&](integer i)
+					{
+						for (integer level = 0;level < d;++level)
+						{
+							if (minCellSet[i * d + level] > cellSet[level] ||
+								maxCellSet[i * d + level] < cellSet[level])
+							{
+								return false;
+							}
+						}
+						return true;
+					};
+
+					std::vector<integer> subSet;
+					for (integer i : largeSet)
+					{
+						if (intersects(i))
+						{
+							subSet.push_back(i);
+						}
+					}
+
+					// Go through the minimum cells on the axes other
+					// than the first; on the first axis, the buckets
+					// are consecutive.
+					std::vector<integer> minSet(d);
+					for (integer level = 0;level < d;++level)
+					{
+						minSet[level] = std::max(cellSet[level] - spanSet[level], (integer)0);
+					}
+
+					std::vector<integer> cornerSet = minSet;
+					while (true)
+					{
+						integer base = 0;
+						for (integer level = 1;level < d;++level)
+						{
+							base += cornerSet[level] * strideSet[level];
+						}
+
+						integer begin = bucketBeginSet[base + minSet[0]];
+						integer end = bucketBeginSet[base + cellSet[0] + 1];
+						for (integer t = begin;t < end;++t)
+						{
+							if (intersects(bucketSet[t]))
+							{
+								subSet.push_back(bucketSet[t]);
+							}
+						}
+
+						integer level = 1;
+						while (level < d && cornerSet[level] == cellSet[level])
+						{
+							cornerSet[level] = minSet[level];
+							++level;
+						}
+						if (level == d)
+						{
+							break;
+						}
+						++cornerSet[level];
+					}
+
+					Clique& cellBest = resultSet[j];
+					cellBest.depth = best.depth;
+					cellBest.slotSet.assign(d, 0);
+					solveWindow(solver, d, subSet, windowSet, cellBest);
+				};
+
+				if (parallel)
+				{
+					tbb::parallel_for((integer)0, end - k, solveCell);
+				}
+				else
+				{
+					for (integer j = 0;j < end - k;++j)
+					{
+						solveCell(j);
+					}
+				}
+
+				for (Clique& clique : resultSet)
+				{
+					if (clique.depth > best.depth)
+					{
+						best = std::move(clique);
+					}
+				}
+
+				k = end;
+			}
+
+			return best;
+		}
+
 	}
 
 	//! Finds an aligned box of maximum intersection among aligned boxes.
@@ -494,6 +1188,7 @@ namespace Pastel
 	Preconditions:
 	The dimension of the aligned boxes are 2.
 	N == 2 || N == Dynamic.
+	For other dimensions, see maximumCliqueAlignedBox().
 
 	Time complexity:
 	O(n log n)
@@ -523,9 +1218,10 @@ namespace Pastel
 		// Journal of Algorithms, pp. 310-323, 1983.
 		//
 		// essentially describes the algorithm here. However, whereas
-		// they augment 2-3-trees, we augment red-black trees. The
-		// point here is to have a balanced tree to guarantee O(log n)
-		// augmented insertion and deletion.
+		// they augment 2-3-trees, we augment the binary view of a
+		// B-tree. The point here is to have a balanced tree to guarantee
+		// O(log n) augmented insertion and deletion; the B-tree stores
+		// the elements in arrays, which is friendlier to the cache.
 
 		using namespace MaximumCliqueAlignedBox_;
 
@@ -538,7 +1234,7 @@ namespace Pastel
 
 		using Event = Event<Real, AlignedBox_ConstIterator>;
 		using Data = MaximumCliqueAlignedBox_::Data;
-		using Tree = RedBlackTree_Set<Event, Empty, LessThan, Data, Empty, false, MaximumClique_Customization>;
+		using Tree = BTree_Set<Event, Empty, LessThan, Data, MaximumClique_Customization>;
 		using Event_ConstIterator = typename Tree::ConstIterator;
 
 		ENSURE_OP(sweepDirection, >=, 0);
@@ -834,6 +1530,196 @@ namespace Pastel
 			sweepDirection, Null_Output());
 	}
 
+
+	//! Finds an aligned box of maximum intersection among d-dimensional aligned boxes.
+	/*!
+	boxSet:
+	An iterator range where AlignedBox_ConstIterator
+	dereferences to AlignedBox<Real, N>, all of the
+	same dimension d.
+
+	returns (std::pair<AlignedBox<Real, N>, integer>):
+	A maximum clique box, and the number of boxes in the
+	maximum clique. The box is the region between consecutive
+	end-points on each axis, in the intersection of the boxes
+	of the clique. If 'boxSet' is empty, the number is zero.
+
+	Optional arguments
+	------------------
+
+	report (Output(AlignedBox_ConstIterator)):
+	An output which is called for each box of the
+	maximum clique.
+	Default: nullOutput()
+
+	sweepDirection (integer):
+	The axis of the sweep for d <= 2; for d > 2, the
+	axis which is split first.
+	Default: 0
+
+	parallel (bool):
+	Whether to solve the cells of the branch-and-bound
+	in parallel, for d > 2. The result does not depend on
+	the number of threads.
+	Default: true
+
+	Time complexity:
+	O(n log(n)) for d <= 2,
+	O(d n (4n)^d) for d > 2 in the worst case, plus
+	O(n d) for reporting.
+
+	This works in any dimension, including d = 1. The
+	end-points of the boxes on each axis are first replaced
+	by their ranks in the order of the end-points, which also
+	takes care of the topologies of the boxes.
+
+	For d <= 2, the boxes are then swept along the sweep
+	direction. A maximum clique can only occur right after
+	the start of a box which is followed by the end of a box.
+	For d = 2, the sweep keeps the depths on the other axis
+	in a segment tree with range additions.
+
+	For d > 2, the slots between consecutive end-points are
+	divided into a grid of cells, and the number of boxes
+	which intersect a cell bounds the depth in the cell. The
+	cells are solved in decreasing order of their bounds until
+	no cell can contain a deeper clique than the best one so
+	far. A cell is solved by splitting it in halves recursively,
+	with the same bound, until all of the boxes which intersect
+	a part cover the whole part. For boxes of similar sizes, only
+	a fraction of the cells needs to be solved, and the time is
+	near-linear in practice; the worst case is for boxes whose
+	boundaries cut each other in many places.
+
+	In case there are multiple maximum cliques, the result depends
+	only on the boxes and the sweep direction. For the 2-dimensional
+	function above, which also maximizes the area of the clique box,
+	see maximumClique().
+	*/
+	template <
+		ranges::forward_range AlignedBox_ConstRange,
+		typename... ArgumentSet>
+	std::pair<ranges::range_value_t<AlignedBox_ConstRange>, integer>
+		maximumCliqueAlignedBox(
+		AlignedBox_ConstRange&& boxSet,
+		ArgumentSet&&... argumentSet)
+	{
+		using namespace MaximumCliqueAlignedBox_;
+
+		using AlignedBox_ConstIterator = ranges::iterator_t<AlignedBox_ConstRange>;
+		using Box = ranges::range_value_t<AlignedBox_ConstRange>;
+		using Real = typename Box::Real_;
+
+		auto&& report = PASTEL_ARG_S(report, nullOutput());
+		integer sweepDirection = PASTEL_ARG_S(sweepDirection, 0);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+
+		std::vector<AlignedBox_ConstIterator> iteratorSet;
+		for (auto iter = ranges::begin(boxSet);iter != ranges::end(boxSet);++iter)
+		{
+			iteratorSet.push_back(iter);
+		}
+
+		integer n = iteratorSet.size();
+		if (n == 0)
+		{
+			return std::make_pair(Box(), (integer)0);
+		}
+
+		integer d = iteratorSet.front()->n();
+		ENSURE_OP(sweepDirection, >=, 0);
+		ENSURE_OP(sweepDirection, <, d);
+
+		// The sweep direction comes first, and then the
+		// other axes in increasing order.
+		std::vector<integer> axisSet(1, sweepDirection);
+		for (integer i = 0;i < d;++i)
+		{
+			if (i != sweepDirection)
+			{
+				axisSet.push_back(i);
+			}
+		}
+
+		// Replace the end-points by their ranks.
+		using Event = Event<Real, integer>;
+		std::vector<integer> rankSet(2 * n * d);
+		std::vector<std::vector<Real>> positionSet(d);
+		{
+			std::vector<Event> eventSet;
+			eventSet.reserve(2 * n);
+			for (integer level = 0;level < d;++level)
+			{
+				integer axis = axisSet[level];
+
+				eventSet.clear();
+				for (integer i = 0;i < n;++i)
+				{
+					const Box& box = *iteratorSet[i];
+					PENSURE_OP(box.n(), ==, d);
+
+					eventSet.emplace_back(
+						box.min()[axis], i,
+						box.minTopology()[axis] == Topology::Closed ?
+						EventType::ClosedMin : EventType::OpenMin,
+						i);
+					eventSet.emplace_back(
+						box.max()[axis], i,
+						box.maxTopology()[axis] == Topology::Closed ?
+						EventType::ClosedMax : EventType::OpenMax,
+						i);
+				}
+				std::sort(eventSet.begin(), eventSet.end());
+
+				positionSet[level].reserve(2 * n);
+				for (integer k = 0;k < 2 * n;++k)
+				{
+					const Event& e = eventSet[k];
+					rankSet[(e.index * d + level) * 2 + !e.min()] = k;
+					positionSet[level].push_back(e.position);
+				}
+			}
+		}
+
+		Clique_Solver solver(d, rankSet);
+		Clique clique = (d <= 2) ?
+			solver.sweep() :
+			solveByGrid(solver, d, n, parallel);
+
+		Box cliqueBox(d);
+		for (integer level = 0;level < d;++level)
+		{
+			integer axis = axisSet[level];
+			integer slot = clique.slotSet[level];
+			cliqueBox.min()[axis] = positionSet[level][slot];
+			cliqueBox.max()[axis] = positionSet[level][slot + 1];
+		}
+
+		bool reportBoxes =
+			!std::is_same<std::decay_t<decltype(report)>, Null_Output>::value;
+		if (reportBoxes)
+		{
+			for (integer i = 0;i < n;++i)
+			{
+				bool contained = true;
+				for (integer level = 0;level < d && contained;++level)
+				{
+					integer slot = clique.slotSet[level];
+					contained =
+						solver.rank(level, i, false) <= slot &&
+						slot < solver.rank(level, i, true);
+				}
+
+				if (contained)
+				{
+					report(iteratorSet[i]);
+				}
+			}
+		}
+
+		return std::make_pair(cliqueBox, clique.depth);
+	}
+
 }
 
 #endif
@@ -4,6 +4,9 @@
 #define PASTELGEOMETRY_NEAREST_NEIGHBORS_H
 
 #include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/search_all_nearest.h"
+#include "pastel/geometry/count_nearest.h"
+#include "pastel/geometry/count_all_nearest.h"
 #include "pastel/geometry/bestfirst_pointkdtree_searchalgorithm.h"
 #include "pastel/geometry/depthfirst_pointkdtree_searchalgorithm.h"
 
@@ -30,6 +30,8 @@
 #include "pastel/geometry/distance/distance_point_point.h"
 #include "pastel/geometry/distance/distance_alignedbox_point.h"
 
+#include "pastel/math/distance/block_distance.h"
+
 #include "pastel/sys/rankedset/rankedset.h"
 
 #include <optional>
@@ -93,6 +95,36 @@ namespace Pastel
 			return location(point->point(), kdTree.locator());
 		}
 
+		//! Returns the coordinates of a point-set of a node.
+		/*!
+		Available only for a Frozen_PointKdTree, whose points
+		are stored contiguously in structure-of-arrays layout.
+		Enables searchNearby() to compute the distances to the
+		points of a node with blockDistance().
+		*/
+		template <typename PointId_Range>
+		requires IsFrozenPointKdTree<KdTree>::value
+		CoordinateBlock<Real> coordinateBlock(
+			const PointId_Range& pointIdSet) const
+		{
+			integer n = ranges::distance(pointIdSet);
+			if (n == 0)
+			{
+				return CoordinateBlock<Real>{nullptr, 0, 0};
+			}
+
+			return CoordinateBlock<Real>{
+				(*ranges::begin(pointIdSet))->point(),
+				kdTree.locator().stride(),
+				n};
+		}
+
+		//! Reports the point-sets of the nodes near the search-point.
+		/*!
+		The traversal state is local to the call, so
+		concurrent calls are safe as long as the kd-tree
+		is not modified; see searchAllNearest().
+		*/
 		template <
 			Point_Concept Search_Point,
 			Norm_Concept Norm,
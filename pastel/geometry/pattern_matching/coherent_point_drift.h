@@ -6,9 +6,18 @@
 
 #include "pastel/geometry/pattern_matching/ls_affine.h"
 #include "pastel/geometry/nearestset/nearestset_concept.h"
+#include "pastel/geometry/pointkdtree/pointkdtree.h"
+#include "pastel/geometry/pointkdtree/pointkdtree_search_range.h"
+#include "pastel/sys/locator/pointer_locator.h"
 #include "pastel/sys/output/null_output.h"
 #include "pastel/sys/math/constants.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
 namespace Pastel
 {
 
@@ -119,6 +128,24 @@ namespace Pastel
     minError (Real : see below):
     The minimum error under which to accept the transformation 
     and stop iteration. For float 1e-4; for double 1e-11.
+
+    kernelError (Real : 0):
+    A real number in [0, 1), which gives the value of the Gaussian
+    kernel exp(-|x|^2 / (2 sigma2)) under which the affinity between
+    a pair of points is ignored. When zero, the affinities between 
+    all pairs of points are evaluated, and the (m x n) weighting 
+    matrix W is stored; this takes O(mn) time and memory per 
+    iteration. When positive, the affinities are evaluated only 
+    between the pairs closer than sqrt(-2 sigma2 ln(kernelError)), 
+    which are found by range searching a kd-tree of the transformed
+    fromSet, in parallel. Only the moments of W are then accumulated,
+    W is not formed, and the W in the reported Cpd_State is empty. 
+    Each column of W is normalized with an absolute error of at most 
+    m kernelError. While sigma2 is large compared to the extent of
+    the point-sets, as in the first iterations, most pairs are still
+    evaluated, but in O(m + n) memory. Requires d <= 64. A value 
+    such as 1e-6 gives practically the same transformation as the 
+    exact algorithm.
     */
 	template <
 		typename Real_from, int M_from, int N_from,
@@ -184,6 +211,8 @@ namespace Pastel
             PASTEL_ARG_S(maxIterations, std::max(minIterations, (integer)100));
         Real minError = 
             PASTEL_ARG_S(minError, defaultMinError);
+        Real kernelError = 
+            PASTEL_ARG_S(kernelError, 0);
         Cpd_Matrix matrix = 
             PASTEL_ARG_ENUM(matrix, Cpd_Matrix::Free);
         Cpd_Scaling scaling = 
@@ -199,6 +228,10 @@ namespace Pastel
         ENSURE(noiseRatio < 1);
         ENSURE_OP(minIterations, >=, 0);
         ENSURE_OP(minIterations, <=, maxIterations);
+        ENSURE_OP(kernelError, >=, 0);
+        ENSURE_OP(kernelError, <, 1);
+
+        bool truncated = (kernelError > 0);
 
         MapMatrix<Real, D, D> Q = asMatrix(Qs);
         MapMatrix<Real, D, D> S = asMatrix(Ss);
@@ -227,27 +260,229 @@ namespace Pastel
         // Compute a constant to be used later.
         Real c = (noiseRatio / (1 - noiseRatio)) * ((Real)m / n);
 
-        // Compute an initial estimate for sigma^2.
-        Real sigma2 = 0;
-        for (integer j = 0; j < n;++j)
+        // Compute an initial estimate for sigma^2, the mean of
+        // the squared distances between all pairs of points:
+        // sum_{i, j} |y_i - r_j|^2 =
+        // n sum_i |y_i - mean(y)|^2 + m sum_j |r_j - mean(r)|^2 + 
+        // mn |mean(y) - mean(r)|^2.
+        ColMatrix<Real, D> fromMean = transformedSet.rowwise().mean();
+        ColMatrix<Real, D> toMean = R.rowwise().mean();
+        Real sigma2 = 
+            ((transformedSet.colwise() - fromMean).squaredNorm() / m +
+            (R.colwise() - toMean).squaredNorm() / n +
+            (fromMean - toMean).squaredNorm()) / d;
+
+        // The weighting matrix will be computed here,
+        // unless the kernel is truncated.
+        Matrix<Real, N_from, N_to> W;
+        if (!truncated)
         {
-            sigma2 += deltaSet(j).array().square().sum();
+            W.resize(m, n);
         }
-        sigma2 = sigma2 / (d * m * n);
-
-        // The weighting matrix will be computed here.
-        Matrix<Real, N_from, N_to> W(m, n);
         MatrixView<Real, N_from, N_to> Ws = view(W);
 
         // These will be used as temporary space for
         // computing the weighting matrix.
-        RowMatrix<Real, D> expSet(m);
+        RowMatrix<Real, D> expSet(truncated ? 0 : m);
 
         // These will store the previous estimate.
         Matrix<Real, D, D> qPrev(d, d);
         Matrix<Real, D, D> sPrev(d, d);
         ColMatrix<Real, D> tPrev(d, 1);
 
+        // With the truncated kernel, the affinities are found by 
+        // range searching a kd-tree of the transformed model-set.
+        // The points refer to the columns of the transformed set.
+        using KdTree = PointKdTree<PointKdTree_Settings<Pointer_Locator<Real, D>>>;
+        KdTree tree{Pointer_Locator<Real, D>(d)};
+        std::vector<const Real*> pointSet;
+        if (truncated)
+        {
+            pointSet.reserve(m);
+            for (integer i = 0;i < m;++i)
+            {
+                pointSet.push_back(transformedSet.col(i).data());
+            }
+        }
+
+        // The moments of the weighting matrix; the coordinates
+        // are relative to the means of the point-sets.
+        ColMatrix<Real, D> pMean = P.rowwise().mean();
+        struct Moments
+        {
+            // sum_{i, j} w_{ij}
+            Real total = 0;
+            // sum_j w_{ij}, for each i.
+            ColMatrix<Real> rowSum;
+            // sum_{i, j} w_{ij} r_j
+            ColMatrix<Real, D> toSum;
+            // sum_{i, j} w_{ij} |r_j|^2
+            Real toNorm2 = 0;
+            // sum_{i, j} w_{ij} r_j p_i^T
+            Matrix<Real, D, D> cross;
+            // The affinities of the current column.
+            std::vector<std::pair<integer, Real>> affinitySet;
+        };
+
+        auto zeroMoments = [&]()
+        {
+            Moments moments;
+            moments.rowSum = ColMatrix<Real>::Zero(m);
+            moments.toSum = ColMatrix<Real, D>::Zero(d);
+            moments.cross = Matrix<Real, D, D>::Zero(d, d);
+            return moments;
+        };
+
+        // Computes the moments of the weighting matrix
+        // with the truncated kernel.
+        auto truncatedMoments = [&](Real f)
+        {
+            tree.clear();
+            tree.insertSet(pointSet);
+            tree.refineInParallel();
+
+            Real radius2 = -2 * sigma2 * std::log(kernelError);
+            Real radius = std::sqrt(radius2);
+
+            tbb::enumerable_thread_specific<Moments> momentsSet(zeroMoments);
+
+            tbb::parallel_for(tbb::blocked_range<integer>(0, n),
+                [&](const tbb::blocked_range<integer>& block)
+                {
+                    Moments& local = momentsSet.local();
+                    AlignedBox<Real, D> range(d);
+                    ColMatrix<Real, D> r(d);
+                    ColMatrix<Real, D> pSum(d);
+
+                    for (integer j = block.begin();j < block.end();++j)
+                    {
+                        for (integer k = 0;k < d;++k)
+                        {
+                            range.min()[k] = R(k, j) - radius;
+                            range.max()[k] = R(k, j) + radius;
+                        }
+
+                        // Find the affinities which are not truncated
+                        // in the j:th column.
+                        local.affinitySet.clear();
+                        Real affinitySum = 0;
+                        searchRange(tree, range, [&](auto&& point)
+                        {
+                            integer i = (point->point() - transformedSet.data()) / d;
+                            Real distance2 = (transformedSet.col(i) - R.col(j)).squaredNorm();
+                            if (distance2 <= radius2)
+                            {
+                                Real affinity = std::exp(distance2 / (-2 * sigma2));
+                                local.affinitySet.emplace_back(i, affinity);
+                                affinitySum += affinity;
+                            }
+                        });
+
+                        if (local.affinitySet.empty())
+                        {
+                            continue;
+                        }
+
+                        // Normalize the affinities into weights,
+                        // and accumulate the moments of the column.
+                        Real normalization = 1 / (affinitySum + f);
+                        Real columnSum = affinitySum * normalization;
+                        pSum.setZero();
+                        for (auto&& [i, affinity] : local.affinitySet)
+                        {
+                            Real w = affinity * normalization;
+                            local.rowSum[i] += w;
+                            pSum += w * (P.col(i) - pMean);
+                        }
+
+                        r = R.col(j) - toMean;
+                        local.total += columnSum;
+                        local.toSum += columnSum * r;
+                        local.toNorm2 += columnSum * r.squaredNorm();
+                        local.cross += r * pSum.transpose();
+                    }
+                });
+
+            Moments moments = zeroMoments();
+            for (const Moments& local : momentsSet)
+            {
+                moments.total += local.total;
+                moments.rowSum += local.rowSum;
+                moments.toSum += local.toSum;
+                moments.toNorm2 += local.toNorm2;
+                moments.cross += local.cross;
+            }
+
+            return moments;
+        };
+
+        // Computes a new estimate for the optimal transformation,
+        // and for sigma^2, from the moments of the weighting matrix.
+        auto solveMoments = [&](const Moments& moments)
+        {
+            Real total = moments.total;
+
+            ColMatrix<Real, D> fromOffset = ColMatrix<Real, D>::Zero(d);
+            for (integer i = 0;i < m;++i)
+            {
+                fromOffset += moments.rowSum[i] * (P.col(i) - pMean);
+            }
+            fromOffset /= total;
+            ColMatrix<Real, D> toOffset = moments.toSum / total;
+
+            ColMatrix<Real, D> fromCentroid = pMean + fromOffset;
+            ColMatrix<Real, D> toCentroid = toMean + toOffset;
+
+            // Compute the moments about the centroids.
+            Matrix<Real, D, D> PP = Matrix<Real, D, D>::Zero(d, d);
+            for (integer i = 0;i < m;++i)
+            {
+                ColMatrix<Real, D> p = P.col(i) - fromCentroid;
+                PP += moments.rowSum[i] * p * p.transpose();
+            }
+            Matrix<Real, D, D> RP = 
+                moments.cross - total * toOffset * fromOffset.transpose();
+            Real RR = moments.toNorm2 - total * toOffset.squaredNorm();
+
+            if (translation == Cpd_Translation::Free)
+            {
+                LsAffine_::solve<Real, D>(
+                    PP, RP, fromCentroid, toCentroid,
+                    Q, S, t,
+                    matrix, scaling, translation, orientation);
+            }
+            else
+            {
+                // Without translation, the moments are
+                // about the origin.
+                LsAffine_::solve<Real, D>(
+                    Matrix<Real, D, D>(PP + total * fromCentroid * fromCentroid.transpose()),
+                    Matrix<Real, D, D>(RP + total * toCentroid * fromCentroid.transpose()),
+                    fromCentroid, toCentroid,
+                    Q, S, t,
+                    matrix, scaling, translation, orientation);
+            }
+
+            // Compute the transformed model-set.
+            transformedSet = 
+                (Q * S * P).colwise() + t;
+
+            // Compute a new estimate for sigma^2: with A = QS,
+            // sum_{i, j} w_{ij} |A p_i + t - r_j|^2 =
+            // tr(A PP A^T) - 2 tr(A RP^T) + RR + total |e|^2,
+            // where e = A fromCentroid + t - toCentroid.
+            Matrix<Real, D, D> A = Q * S;
+            ColMatrix<Real, D> e = A * fromCentroid + t - toCentroid;
+            Real error = 
+                (A * PP * A.transpose()).trace() - 
+                2 * (A.array() * RP.array()).sum() + 
+                RR + total * e.squaredNorm();
+
+            // The error can become slightly negative
+            // because of cancellation.
+            sigma2 = std::max(error, (Real)0) / (total * d);
+        };
+
         for (integer iteration = 0; iteration < maxIterations; ++iteration)
         {
             if (sigma2 == 0)
@@ -264,41 +499,62 @@ namespace Pastel
             // the loop.
             Real f = std::pow(2 * constantPi<Real>() * sigma2, (Real)d / 2) * c;
 
-            // Compute the weighting matrix.
-            for (integer j = 0;j < n;++j)
+            if (truncated)
             {
-                expSet = (deltaSet(j).array().square().colwise().sum() / (-2 * sigma2)).exp();
-                W.col(j) = expSet.transpose() / (expSet.sum() + f);
+                Moments moments = truncatedMoments(f);
+                if (moments.total == 0)
+                {
+                    // No pair of points is closer than the 
+                    // truncation radius; there is nothing
+                    // to estimate the transformation from.
+                    break;
+                }
+
+                // Store the previous transformation for comparison.
+                qPrev = Q;
+                sPrev = S;
+                tPrev = t;
+
+                solveMoments(moments);
             }
-
-            // Store the previous transformation for comparison.
-            qPrev = Q;
-            sPrev = S;
-            tPrev = t;
-
-            // Compute a new estimate for the optimal transformation.
-            lsAffine(
-                fromSet, toSet,
-                Qs, Ss, ts,
-                PASTEL_TAG(matrix), matrix,
-                PASTEL_TAG(scaling), scaling,
-                PASTEL_TAG(translation), translation,
-                PASTEL_TAG(orientation), orientation,
-                PASTEL_TAG(W), Ws
-                );
-
-            // Compute the transformed model-set.
-            transformedSet = 
-                (Q * S * P).colwise() + t;
-
-            // Compute a new estimate for sigma^2.
-            sigma2 = 0;
-            for (integer j = 0;j < n;++j)
+            else
             {
-                sigma2 += 
-                    (W.col(j).transpose().array() * deltaSet(j).array().square().colwise().sum()).sum();
+                // Compute the weighting matrix.
+                for (integer j = 0;j < n;++j)
+                {
+                    expSet = (deltaSet(j).array().square().colwise().sum() / (-2 * sigma2)).exp();
+                    W.col(j) = expSet.transpose() / (expSet.sum() + f);
+                }
+
+                // Store the previous transformation for comparison.
+                qPrev = Q;
+                sPrev = S;
+                tPrev = t;
+
+                // Compute a new estimate for the optimal transformation.
+                lsAffine(
+                    fromSet, toSet,
+                    Qs, Ss, ts,
+                    PASTEL_TAG(matrix), matrix,
+                    PASTEL_TAG(scaling), scaling,
+                    PASTEL_TAG(translation), translation,
+                    PASTEL_TAG(orientation), orientation,
+                    PASTEL_TAG(W), Ws
+                    );
+
+                // Compute the transformed model-set.
+                transformedSet = 
+                    (Q * S * P).colwise() + t;
+
+                // Compute a new estimate for sigma^2.
+                sigma2 = 0;
+                for (integer j = 0;j < n;++j)
+                {
+                    sigma2 += 
+                        (W.col(j).transpose().array() * deltaSet(j).array().square().colwise().sum()).sum();
+                }
+                sigma2 /= W.sum() * d;
             }
-            sigma2 /= W.sum() * d;
 
 			// Report the current estimate.
 			Cpd_State<Real> state = 
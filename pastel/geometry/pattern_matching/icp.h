@@ -4,7 +4,17 @@
 #ifndef PASTELGEOMETRY_ICP_H
 #define PASTELGEOMETRY_ICP_H
 
-#include "pastel/geometry/ls_affine.h"
+#include "pastel/geometry/pattern_matching/ls_affine.h"
+#include "pastel/geometry/pointkdtree/pointkdtree.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/sys/locator/pointer_locator.h"
+#include "pastel/sys/output/null_output.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
 
 namespace Pastel
 {
@@ -20,160 +30,201 @@ namespace Pastel
     };
 
     template <typename Real>
-    struct Icp_Return
+    struct Icp_State
     {
-        Matrix<Real> Q;
-        Matrix<Real> S;
-        ColMatrix<Real> t;
+        MatrixView<Real> Q;
+        MatrixView<Real> S;
+        MatrixView<Real> t;
+        integer iteration;
+        // The number of model points in the current
+        // level of the coarse-to-fine schedule.
+        integer points;
+        integer kNearest;
+        // The number of pairs used in the estimation.
+        integer pairs;
+        Real meanDistance;
+        Real lambda;
+        Real inlierRatio;
     };
 
     template <typename Real>
-    using Icp_State = 
-        Icp_Return<Real>;
+    struct Icp_Return
+    {
+        // The mean squared distance between the
+        // paired points in the last iteration.
+        Real meanDistance;
+        integer iterations;
+    };
 
     //! Iterated closest points (ICP)
-    /*
+    /*!
     Preconditions:
-    0 <= inlierThreshold <= 1
-    0 <= lambdaThreshold <= 1
+    0 <= minIterations <= maxIterations
+    kNearest >= 1
+    levels >= 1
+    levelIterations >= 1
+    matchingDistance2 >= 0
+    n > 0
+    m > 0
+    0 < d <= 64
 
     Locally optimal transformation between unpaired point-sets.
+    Finds matrices Q, S, and t such that
+
+        (Q * S * modelSet).colwise() + t
+
+    matches sceneSet.
 
-    modelSet:
+    modelSet ((d x n) real matrix):
     A set of n d-dimensional points. The points in the 'modelSet'
     are attempted to match to the points in the 'sceneSet'.
 
-    sceneSet:
+    sceneSet ((d x m) real matrix):
     A set of m d-dimensional points.
 
-    matchingDistance2: 
-    The distance over which to accept points being matched.
+    Qs ((d x d) real matrix):
+    Initial guess on Q and storage for the solution.
+
+    Ss ((d x d) real matrix):
+    Initial guess on S and storage for the solution.
+
+    ts ((d x 1) real vector):
+    Initial guess on t and storage for the solution.
+
+    returns (Icp_Return<Real>):
+    The mean squared distance between the paired points,
+    and the number of iterations taken.
+
+    Each iteration searches the k nearest neighbors in the
+    scene-set for each transformed model point, pairs the points,
+    rejects the pairs which are too far apart, and re-estimates
+    the transformation from the remaining pairs. The buffers are
+    allocated once, and reused across the iterations. The
+    nearest neighbors are searched in parallel; the result does
+    not depend on the number of threads.
 
     Optional arguments
     ------------------
 
+    initialize (bool : true):
+    Whether to initialize the transformation to defaults:
+    Q = identity
+    S = identity
+    t = the difference of the centroids of the scene-set and the
+        model-set. This is the optimal translation assuming that
+        the point-sets match bijectively, and that Q = S = I.
+    If false, the passed matrices are used instead.
+
     kNearest (integer : 10):
-    The number of nearest neighbors to search for each model point in 
-    each iteration. Having a greater number of nearest neighbors allows 
-    flexibility for finding bijective pairings (when matching = 
-    Icp_Matching::Biunique). 
+    The number of nearest neighbors to search for each model point in
+    each iteration. Having a greater number of nearest neighbors allows
+    flexibility for finding bijective pairings (when matching =
+    Icp_Matching::Biunique).
+
+    matchingDistance2 (Real : Infinity()):
+    The squared distance over which points are not paired.
 
     minIterations (integer : 0):
     The minimum number of iterations for the algorithm to take.
 
     maxIterations (integer : 100):
-    The maximum number of iterations for the algorithm to take. 
-    It must hold that MINITERATIONS < MAXITERATIONS.
-    Default: 100.
+    The maximum number of iterations for the algorithm to take.
 
     minError (Real : 1e-11):
-    The minimum trimmed-mean-square error under  which to accept 
+    The minimum mean squared distance under which to accept
     the transformation and stop iteration.
 
     matrix (Icp_Matrix : Free):
-    Constraint for the matrix Q. 
+    Constraint for the matrix Q.
         Free: Q^T Q = I
         Identity: Q = I
 
+    scaling (Icp_Scaling : Rigid):
+    Constraint for the scaling S.
+        Free: S^T = S
+        Diagonal: S is diagonal
+        Conformal: S = sI
+        Rigid: S = I
+
     translation (Icp_Translation : Free)
     Constraint for the translation t.
         Free: no constraint
-        Identity: T = 0
+        Identity: t = 0
 
     orientation (integer : 1)
-    Constraint for the determinant of Q.
-       <0: det(Q) < 0,
+    Constraint for the determinant of QS.
+       <0: det(QS) < 0,
         0: no constraint,
-       >0: det(Q) > 0.
+       >0: det(QS) > 0.
 
     matching (Icp_Matching : Biunique):
     The strategy for pairing points in each iteration.
          Closest: closest point pairing; the original algorithm
          Biunique: approximate minimum-distance maximum matching
-                   in the k-neighbor graph; the Biunique ICP 
+                   in the k-neighbor graph; the Biunique ICP
                    algorithm.
 
-    Q0: (Matrix<Real> : Matrix<Real>()):
-    A (d, d) matrix by which to initialize the returned Q.
-    If empty, then Q is initialized with the identity matrix,
-    with fresh memory.
-
-    S0: (Matrix<Real> : Matrix<Real>()):
-    A (d, d) matrix by which to initialize the returned S.
-    If empty, then S is initialized with the identity matrix,
-    with fresh memory.
-
-    t0: (ColMatrix<Real> : ColMatrix<Real>()):
-    A (d, 1) matrix by which to initialize the returned t.
-    If empty, then t is initialized with s - Q0 * m, where s 
-    and m are the centroids of the scene and model point-sets, 
-    respectively. This is the optimal translation assuming 
-    'sceneSet' and 'modelSet' match bijectively and Q0 = Q.
-
     inlierThreshold (Real : 0.25):
     Specifies a threshold for the ratio of model points taking
-    part on estimation (the inlier ratio). When the inlier ratio exceeds 
+    part on estimation (the inlier ratio). When the inlier ratio exceeds
     the inlier threshold, the 'kNearest' is decremented by 1 (if > 1). This
-    coarse-to-fine strategy helps the algorithm to get over possible local 
+    coarse-to-fine strategy helps the algorithm to get over possible local
     minima.
 
     lambdaThreshold (Real : 0.1):
     Specifies a threshold for the ratio of NC-outliers in the
-    model set (lambda). When lambda exceeds the lambda threshold, 
+    model set (lambda). When lambda exceeds the lambda threshold,
     then the strategy for distance-rejection changes.
 
-    REPORTER ("reporter") is a lambda function which takes a single
-    struct argument. The reporter is called after each iteration with
-    the currently found transformation. This can be used to visualize
-    or debug the workings of the algorithm. The reported struct consists
-    of the following fields:
-
-        modelSet, sceneSet: The input values.
-        Q, t, pairSet: As in return values.
-        transformedSet: Q * modelSet + ones(1, n) * t
-        iteration: The iteration number, an integer.
-        lambda
-        meanDistance: The mean-squared distance between the paired points.
-        inlierRatio
-
-    Return values
-    -------------
-
-    The returned MATCH object is a struct containing the following fields.
-
-    Q ("Q") is a (d x d) special-orthogonal matrix, containing the
-    matching rotation.
+    levels (integer : 1):
+    The number of levels in a coarse-to-fine subsampling schedule
+    for the model-set. The level l = 0, ..., levels - 1 uses every
+    2^(levels - 1 - l):th model point, so that the last level uses
+    all of them. The subsampling is deterministic.
 
-    T ("t") is a (d x 1) vector, containing the matching translation.
+    levelIterations (integer : 10):
+    The maximum number of iterations to take on each level
+    but the last. A level is also left when its mean squared
+    distance falls under minError.
 
-    PAIRSET ("pairSet") is a (2 x k)-integer-array of indices, where each 
-    column is a pair (i, j), where i is the index of a model point, and j
-    is the index of its matched scene point. 
+    parallel (bool : true):
+    Whether to search the nearest neighbors in parallel.
 
-    It should approximately be true that 
+    report (Output(Icp_State<Real>) : nullOutput()):
+    An output to which the current estimate is reported after each
+    iteration. This can be used to visualize or debug the workings
+    of the algorithm.
 
-        Q * modelSet + t * ones(1, n)
+    The parameter choices correspond to known algorithms roughly
+    as follows:
 
-    matches sceneSet. The parameter choices correspond to known 
-    algorithms roughly as follows:
-
-        Original ICP: 
+        Original ICP:
             kNearest = 1
-            matchingType = "closest"
+            matching = Icp_Matching::Closest
 
-        Biunique ICP: 
+        Biunique ICP:
             kNearest = k
-            matchingType = "biunique"
+            matching = Icp_Matching::Biunique
     */
-    template <
-        NearestSet_Concept Model_NearestSet,
-        NearestSet_Concept Scene_NearestSet,
-        typename... ArgumentSet
+	template <
+		typename Real_from, int M_from, int N_from,
+		typename Real_to, int M_to, int N_to,
+		typename Real_Q, int M_Q, int N_Q,
+		typename Real_S, int M_S, int N_S,
+		typename Real_t, int M_t,
+		typename... ArgumentSet
     >
-    Icp_Return<Real> icp(
-        const Model_NearestSet& modelSet, 
-        const Scene_NearestSet& sceneSet, 
-        Real matchingDistance2,
+    requires
+        IsPlain<Real_Q> &&
+        IsPlain<Real_S> &&
+        IsPlain<Real_t> &&
+        IsSameObject<Real_from, Real_to, Real_Q, Real_S, Real_t>
+    Icp_Return<Real_from> icp(
+		const MatrixView<Real_from, M_from, N_from>& modelSet,
+		const MatrixView<Real_to, M_to, N_to>& sceneSet,
+		const MatrixView<Real_Q, M_Q, N_Q>& Qs,
+		const MatrixView<Real_S, M_S, N_S>& Ss,
+		const ColMatrixView<Real_t, M_t>& ts,
         ArgumentSet&&... argumentSet)
     {
         // See _Robust ICP Registration using Biunique Correspondence_,
@@ -181,80 +232,85 @@ namespace Pastel
         // International Conference on 3D Imaging, Modeling, Processing,
         // Visualization and Transmission, 2011.
 
-        ENSURE_OP(pointSetDimension(modelSet), ==, pointSetDimension(sceneSet));
+        ENSURE_OP(modelSet.rows(), ==, sceneSet.rows());
+
+        using Real = Real_from;
+
+		constexpr const int D = Common_Dimension<M_from, M_to, M_Q, M_S, M_t, N_Q, N_S>;
+
+		MapMatrix<Real, D, N_from> P = asMatrix(modelSet);
+		MapMatrix<Real, D, N_to> R = asMatrix(sceneSet);
+
+        integer d = P.rows();
+        integer n = P.cols();
+        integer m = R.cols();
+
+        ENSURE_OP(d, >, 0);
+        ENSURE_OP(n, >, 0);
+        ENSURE_OP(m, >, 0);
+
+        ENSURE_OP(Qs.rows(), ==, d);
+        ENSURE_OP(Qs.cols(), ==, d);
+        ENSURE_OP(Ss.rows(), ==, d);
+        ENSURE_OP(Ss.cols(), ==, d);
+        ENSURE_OP(ts.rows(), ==, d);
+        ENSURE_OP(ts.cols(), ==, 1);
 
-        integer kNearest = 
+        // Optional input arguments
+        bool initialize =
+            PASTEL_ARG_S(initialize, true);
+        integer kNearest =
             PASTEL_ARG_S(kNearest, 10);
-        integer minIterations = 
+        Real matchingDistance2 =
+            PASTEL_ARG_S(matchingDistance2, (Real)Infinity());
+        integer minIterations =
             PASTEL_ARG_S(minIterations, 0);
-        integer maxIterations = 
+        integer maxIterations =
             PASTEL_ARG_S(maxIterations, 100);
-        Real minError = 
+        Real minError =
             PASTEL_ARG_S(minError, 1e-11);
-        Icp_Matrix matrix = 
+        Icp_Matrix matrix =
             PASTEL_ARG_ENUM(matrix, Icp_Matrix::Free);
-        Icp_Translation translation = 
+        Icp_Scaling scaling =
+            PASTEL_ARG_ENUM(scaling, Icp_Scaling::Rigid);
+        Icp_Translation translation =
             PASTEL_ARG_ENUM(translation, Icp_Translation::Free);
-        integer orientation = 
-            PASTEL_ARG_S(orientation, 1);
-        Icp_Matching matching = 
+        integer orientation =
+            PASTEL_ARG_S(orientation, (integer)1);
+        Icp_Matching matching =
             PASTEL_ARG_ENUM(matching, Icp_Matching::Biunique);
-        auto&& report = 
+        Real inlierThreshold =
+            PASTEL_ARG_S(inlierThreshold, 0.25);
+        Real lambdaThreshold =
+            PASTEL_ARG_S(lambdaThreshold, 0.1);
+        integer levels =
+            PASTEL_ARG_S(levels, (integer)1);
+        integer levelIterations =
+            PASTEL_ARG_S(levelIterations, (integer)10);
+        bool parallel =
+            PASTEL_ARG_S(parallel, true);
+        auto&& report =
             PASTEL_ARG_S(report, nullOutput());
 
-        Matrix<Real> Q = PASTEL_ARG_S(Q0, Matrix<Real>());
-        Matrix<Real> S = PASTEL_ARG_S(S0, Matrix<Real>());
-        ColMatrix<Real> t = PASTEL_ARG_S(t0, ColMatrix<Real>());
-
-        Real inlierThreshold = 0.25;
-        Real lambdaThreshold = 0.1;
- 
-        integer d = pointSetDimension(sceneSet);
-        integer n = pointSetSize(modelSet);
-        integer m = pointSetSize(sceneSet);
-
-        if (Q.isempty())
-        {
-            // Clear a possible replicated strict flag.
-            Q.reset();
-            // The default for Q is the identity matrix.
-            Q = Matrix<Real>::Identity(d, d);
-        }
-
-        ENSURE_OP(Q.rows(), ==, d);
-        ENSURE_OP(Q.cols(), ==, d);
-
-        if (S.isempty())
-        {
-            // Clear a possible replicated strict flag.
-            S.reset();
-            // The default for S is the identity matrix.
-            S = Matrix<Real>::Identity(d, d);
-        }
-
-        ENSURE_OP(S.rows(), ==, d);
-        ENSURE_OP(S.cols(), ==, d);
-
-        if (t.isempty())
-        {
-            // Clear a possible replicated strict flag.
-            t.reset();
-
-            // Compute centroids for both point-sets.
-            modelCentroid = sum(modelSet, 2) / n;
-            sceneCentroid = sum(sceneSet, 2) / m;
-
-            // The default for t matches centroids. 
-            t = sceneCentroid - Q * S * modelCentroid;
-        }
-
-        ENSURE_OP(t.rows(), ==, d);
-        ENSURE_OP(t.cols(), ==, 1);
         ENSURE_OP(kNearest, >=, 1);
         ENSURE_OP(minIterations, >=, 0);
         ENSURE_OP(minIterations, <=, maxIterations);
+        ENSURE_OP(levels, >=, 1);
+        ENSURE_OP(levelIterations, >=, 1);
         ENSURE(!negative(matchingDistance2));
 
+        MapMatrix<Real, D, D> Q = asMatrix(Qs);
+        MapMatrix<Real, D, D> S = asMatrix(Ss);
+        MapColMatrix<Real, D> t = asMatrix(ts);
+
+        if (initialize)
+        {
+            // The default for t matches the centroids.
+            Q = Matrix<Real, D, D>::Identity(d, d);
+            S = Matrix<Real, D, D>::Identity(d, d);
+            t = R.rowwise().mean() - P.rowwise().mean();
+        }
+
         if (matching == Icp_Matching::Closest && kNearest > 1)
         {
             // When closest-point matching is used, using
@@ -262,135 +318,260 @@ namespace Pastel
             kNearest = 1;
         }
 
-        using Tree = PointKdTree<int>;
-
-        Tree kdTree(d);
-        kdTree.insert(sceneSet);
-        kdTree.refine();
+        // Store the scene-set contiguously, so that its
+        // columns can be used as the points of a kd-tree.
+        Matrix<Real, D, Dynamic> scenePointSet = R;
 
-        Vector<Real> transformedPoint(ofDimension(d));
-        Matrix<arma::uword> neighborGraph = Matrix<arma::uword>::Zero(
-            2, kNearest * n);
-        for (integer iteration = 0;iteration < maxIterations;++iteration)
+        using KdTree = PointKdTree<PointKdTree_Settings<Pointer_Locator<Real, D>>>;
+        KdTree kdTree{Pointer_Locator<Real, D>(d)};
         {
-            // Compute the transformed model-set.
-            Matrix<Real> transformedSet = 
-                (Q * S * modelSet).colwise() + t;
+            std::vector<const Real*> pointSet;
+            pointSet.reserve(m);
+            for (integer j = 0;j < m;++j)
+            {
+                pointSet.push_back(scenePointSet.col(j).data());
+            }
+            kdTree.insertSet(pointSet);
+            kdTree.refine();
+        }
 
-            // Find nearest neighbors for each point in the
-            // transformed model-set.
-            for (integer j = 0;j < transformedSet.cols();++j)
+        auto nearestSet = kdTreeNearestSet(kdTree);
+        Euclidean_Distance<Real> maxDistance2(
+            Distance_Native(), matchingDistance2);
+
+        // Returns the index of a scene point in the kd-tree.
+        auto sceneIndex = [&](auto&& point)
+        {
+            return (integer)((point->point() - scenePointSet.data()) / d);
+        };
+
+        // These buffers are reused over the iterations.
+
+        // The k nearest neighbors of each model point,
+        // in the order of increasing distance; -1 if missing.
+        std::vector<integer> neighborSet(kNearest * n);
+        std::vector<Real> neighborDistanceSet(kNearest * n);
+
+        // The paired (model, scene) points, and their
+        // squared distances.
+        std::vector<std::pair<integer, integer>> pairSet;
+        pairSet.reserve(n);
+        std::vector<Real> distanceSet;
+        distanceSet.reserve(n);
+
+        // Whether a scene point has already been paired.
+        std::vector<bool> reservedSet(m);
+
+        Matrix<Real, D, D> A(d, d);
+        Matrix<Real, D, D> PP(d, d);
+        Matrix<Real, D, D> RP(d, d);
+        ColMatrix<Real, D> fromCentroid(d);
+        ColMatrix<Real, D> toCentroid(d);
+        ColMatrix<Real, D> p(d);
+        ColMatrix<Real, D> r(d);
+
+        integer level = 0;
+        integer levelIteration = 0;
+        Real meanDistance = Infinity();
+        integer iteration = 0;
+        while (iteration < maxIterations)
+        {
+            // Subsample the model-set for the current level.
+            integer stride = (integer)1 << (levels - 1 - level);
+            integer points = (n + stride - 1) / stride;
+
+            // Find the nearest neighbors for each point in
+            // the transformed model-set.
+            A.noalias() = Q * S;
+            auto searchNeighbors = [&](const tbb::blocked_range<integer>& block)
             {
-                for (integer i = 0;i < d;++i)
+                Vector<Real, D> transformedPoint(ofDimension(d));
+                for (integer a = block.begin();a < block.end();++a)
                 {
-                    transformedPoint(i) = transformRange(i, j);
-                }
-
-                // TODO!
-                ENSURE(false);
+                    for (integer k = 0;k < d;++k)
+                    {
+                        transformedPoint[k] = A.row(k).dot(P.col(a * stride)) + t[k];
+                    }
 
-                searchNearest(
-                    kdTree,
-                    transformedPoint, 
-                    PASTEL_TAG(maxDistance2), matchingDistance2, 
-                    PASTEL_TAG(kNearest), kNearest);
-            }
+                    integer* neighbor = neighborSet.data() + a * kNearest;
+                    Real* neighborDistance = neighborDistanceSet.data() + a * kNearest;
+                    std::fill(neighbor, neighbor + kNearest, -1);
+
+                    integer found = 0;
+                    searchNearest(
+                        nearestSet,
+                        transformedPoint,
+                        PASTEL_TAG(kNearest), kNearest,
+                        PASTEL_TAG(maxDistance2), maxDistance2,
+                        PASTEL_TAG(report), [&](auto&& distance, auto&& point)
+                        {
+                            neighbor[found] = sceneIndex(point);
+                            neighborDistance[found] = ~distance;
+                            ++found;
+                        });
+                }
+            };
 
-            if (matching == Icp_Matching::Biunique)
+            tbb::blocked_range<integer> pointRange(0, points);
+            if (parallel)
             {
-                neighborGraph = biunique_matching(neighborSet);
-                neighbors = size(neighborGraph, 2);
+                tbb::parallel_for(pointRange, searchNeighbors);
             }
             else
             {
-                // Form a bipartite neighbor graph from the neighbor-relation.
-                neighbors = 0;
-                for (integer i = 0; i < n;++i)
+                searchNeighbors(pointRange);
+            }
+
+            // Pair the points.
+            pairSet.clear();
+            distanceSet.clear();
+            if (matching == Icp_Matching::Biunique)
+            {
+                // Pair each model point with its nearest
+                // scene point which has not been paired yet.
+                std::fill(reservedSet.begin(), reservedSet.end(), false);
+                for (integer a = 0;a < points;++a)
                 {
-                    for (integer j = 0;j < kNearest;++j)
+                    for (integer k = 0;k < kNearest;++k)
                     {
-                        neighbor = neighborSet(i, j);
-                        if (neighbor == 0)
+                        integer j = neighborSet[a * kNearest + k];
+                        if (j < 0)
+                        {
+                            break;
+                        }
+
+                        if (!reservedSet[j])
                         {
+                            reservedSet[j] = true;
+                            pairSet.emplace_back(a * stride, j);
+                            distanceSet.push_back(neighborDistanceSet[a * kNearest + k]);
                             break;
                         }
- 
-                        neighbors = neighbors + 1;
-                        neighborGraph(1, neighbors) = i;
-                        neighborGraph(2, neighbors) = neighbor;
                     }
                 }
             }
- 
-            // Matching pairs.
-            matchSet = neighborGraph(:, 1 : neighbors);
- 
-            // Compute the positions of the corresponding points.
-            aSet = transformRange(:, matchSet(1, :));
-            bSet = sceneSet(:, matchSet(2, :));
-            distanceSet = sum((aSet - bSet).^2);
- 
+            else
+            {
+                // Pair each model point with its nearest scene point.
+                for (integer a = 0;a < points;++a)
+                {
+                    integer j = neighborSet[a * kNearest];
+                    if (j >= 0)
+                    {
+                        pairSet.emplace_back(a * stride, j);
+                        distanceSet.push_back(neighborDistanceSet[a * kNearest]);
+                    }
+                }
+            }
+
+            integer neighbors = pairSet.size();
+            if (neighbors == 0)
+            {
+                // No point is closer than the matching distance;
+                // there is nothing to estimate the transformation from.
+                break;
+            }
+
             // The ratio of NC-outliers w.r.t. model points.
-            lambda = 1 - (neighbors / n);
- 
-            // Mean-squared-distance between corresponding points.
-            meanDistance = distanceSet.colwise().mean();
- 
+            Real lambda = 1 - (Real)neighbors / points;
+
             // Compute the threshold for rejecting pairs based on
             // their distance.
-            t = meanDistance;
+            Real threshold = 0;
+            Real minDistance = (Real)Infinity();
+            for (Real distance : distanceSet)
+            {
+                threshold += distance;
+                minDistance = std::min(minDistance, distance);
+            }
+            threshold /= neighbors;
+
             if (lambda > lambdaThreshold)
             {
-                // Compute centroids for both point-sets.
-                ColMatrix<Real> aCentroid = aSet.rowwise().mean();
-                ColMatrix<Real> bCentroid = bSet.rowwise().mean();
-                Real centroidDistance2 = (bCentroid - aCentroid).squaredNorm();
- 
-                t = t * std::pow(kNearest, lambda) + centroidDistance2;
+                // Compute the centroids of the paired points.
+                fromCentroid.setZero();
+                toCentroid.setZero();
+                for (auto&& [i, j] : pairSet)
+                {
+                    fromCentroid += P.col(i);
+                    toCentroid += R.col(j);
+                }
+                p.noalias() = A * fromCentroid;
+                fromCentroid = p / neighbors + t;
+                toCentroid /= neighbors;
+
+                threshold = threshold * std::pow((Real)kNearest, lambda) +
+                    (toCentroid - fromCentroid).squaredNorm();
             }
- 
+
+            // When the distances are equal, the rounded mean
+            // may be less than all of them; always accept the
+            // closest pairs.
+            threshold = std::max(threshold, minDistance);
+
             // Reject those pairs which are too far apart.
-            acceptSet = distanceSet <= t;
- 
-            acceptPairSet = distanceSet <= matchingDistance2^2;
-            pairSet = matchSet(:, acceptPairSet);
- 
-            // Compute the positions of the corresponding points.
-            matchSet = matchSet(:, acceptSet);
-            distanceSet = distanceSet(acceptSet);
-            aSet = modelSet(:, matchSet(1, :));
-            bSet = sceneSet(:, matchSet(2, :));
-
-            Real meanDistance = distanceSet.colwise().mean();
+            integer accepted = 0;
+            meanDistance = 0;
+            for (integer k = 0;k < neighbors;++k)
+            {
+                if (distanceSet[k] <= threshold)
+                {
+                    pairSet[accepted] = pairSet[k];
+                    meanDistance += distanceSet[k];
+                    ++accepted;
+                }
+            }
+            // The threshold is at least the minimum distance,
+            // so that it accepts at least one pair.
+            ASSERT_OP(accepted, >, 0);
+            pairSet.resize(accepted);
+            meanDistance /= accepted;
 
             // Compute a new estimate for the optimal transformation.
-            auto lsMatch = lsAffine(
-                aSet, bSet, 
-                PASTEL_TAG(matrix), matrix, 
-                PASTEL_TAG(scaling), scaling, 
-                PASTEL_TAG(translation), translation, 
-                PASTEL_TAG(orientation), orientation,
-                PASTEL_TAG(Q0), std::move(Q),
-                PASTEL_TAG(S0), std::move(S),
-                PASTEL_TAG(t0), std::move(t)
-                );
-
-            Icp_State<Real> state = 
+            fromCentroid.setZero();
+            toCentroid.setZero();
+            if (translation == Icp_Translation::Free)
             {
-                std::move(lsMatch.Q);
-                std::move(lsMatch.S);
-                std::move(lsMatch.t);
-            };
+                for (auto&& [i, j] : pairSet)
+                {
+                    fromCentroid += P.col(i);
+                    toCentroid += R.col(j);
+                }
+                fromCentroid /= accepted;
+                toCentroid /= accepted;
+            }
 
-            report(state);
+            PP.setZero();
+            RP.setZero();
+            for (auto&& [i, j] : pairSet)
+            {
+                p = P.col(i) - fromCentroid;
+                r = R.col(j) - toCentroid;
+                PP.noalias() += p * p.transpose();
+                RP.noalias() += r * p.transpose();
+            }
 
-            Q = std::move(state.Q);
-            S = std::move(state.S);
-            t = std::move(state.t);
+            LsAffine_::solve<Real, D>(
+                PP, RP, fromCentroid, toCentroid,
+                Q, S, t,
+                matrix, scaling, translation, orientation);
 
             // Compute the inlier ratio. It is the ratio of model points
             // taking part on the estimation phase.
-            Real inlierRatio = (Real)size(matchSet, 2) / n;
+            Real inlierRatio = (Real)accepted / points;
+
+            Icp_State<Real> state =
+            {
+                Qs, Ss, ts,
+                iteration, points, kNearest, accepted,
+                meanDistance, lambda, inlierRatio
+            };
+
+            report(addConst(state));
+
+            ++iteration;
+            ++levelIteration;
+
             if (inlierRatio > inlierThreshold)
             {
                 // Since almost all points are inliers, we can afford
@@ -399,17 +580,29 @@ namespace Pastel
                 // local minima.
                 kNearest = std::max(kNearest - 1, (integer)1);
             }
- 
-            if (meanDistance < minError && 
-                iteration >= minIterations - 1)
+
+            if (level + 1 < levels)
+            {
+                if (levelIteration >= levelIterations ||
+                    meanDistance < minError)
+                {
+                    // Move to the next finer level.
+                    ++level;
+                    levelIteration = 0;
+                }
+                continue;
+            }
+
+            if (meanDistance < minError &&
+                iteration >= minIterations)
             {
                 // Since the mean-square-error has dropped
                 // below the required level, we can stop iterating.
-                break
+                break;
             }
         }
 
-        return {std::move(Q), std::move(S), std::move(t), std::move(pairSet)};
+        return {meanDistance, iteration};
     }
 
 }
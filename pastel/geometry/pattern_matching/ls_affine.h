@@ -31,6 +31,242 @@ namespace Pastel
 		Identity
 	};
 
+	namespace LsAffine_
+	{
+
+		//! Solves the transformation from weighted moments.
+		/*!
+		This is the part of lsAffine() which does not depend on
+		the individual points. Here
+
+		  PP = sum_{i, j} w_{ij} (p_i - fromCentroid)(p_i - fromCentroid)^T
+		  RP = sum_{i, j} w_{ij} (r_j - toCentroid)(p_i - fromCentroid)^T
+
+		where the centroids are the weighted centroids when 
+		translation == Free, and zero otherwise. See lsAffine()
+		for the rest of the parameters.
+		*/
+		template <typename Real, int D>
+		void solve(
+			const Matrix<Real, D, D>& PP,
+			const Matrix<Real, D, D>& RP,
+			const ColMatrix<Real, D>& fromCentroid,
+			const ColMatrix<Real, D>& toCentroid,
+			MapMatrix<Real, D, D>& Q,
+			MapMatrix<Real, D, D>& S,
+			MapColMatrix<Real, D>& t,
+			LsAffine_Matrix matrix,
+			LsAffine_Scaling scaling,
+			LsAffine_Translation translation,
+			integer orientation)
+		{
+			integer d = PP.rows();
+
+			// Initialize Q, S, and t.
+			Q = Matrix<Real, D, D>::Identity(d, d);
+			S = Matrix<Real, D, D>::Identity(d, d);
+			t = ColMatrix<Real, D>::Zero(d, 1);
+
+			// When Q = I, and S is not rigid, forcing the
+			// orientation results in solutions for which
+			// det(QS) = 0.
+			ENSURE(!(matrix == LsAffine_Matrix::Identity &&
+				scaling != LsAffine_Scaling::Rigid &&
+				orientation != 0));
+
+			// When S is free, forcing the orientation
+			// results in solutions for which det(QS) = 0.
+			ENSURE(!(scaling == LsAffine_Scaling::Free &&
+				orientation != 0));
+
+			// This case is not implemented; I do not know
+			// the solution to this problem.
+			ENSURE(!(matrix == LsAffine_Matrix::Free &&
+				scaling == LsAffine_Scaling::Diagonal));
+
+			// This case is not implemented, because
+			// Eigen does not have a Sylvester-equation solver.
+			ENSURE(!(scaling == LsAffine_Scaling::Free && 
+				matrix == LsAffine_Matrix::Identity));
+
+			// When Q = I and S = +/- I, a negative
+			// det(QS) is only possible in odd dimensions.
+			ENSURE(!(orientation < 0 &&
+				matrix == LsAffine_Matrix::Identity &&
+				scaling == LsAffine_Scaling::Rigid &&
+				even(d)));
+
+			if (scaling == LsAffine_Scaling::Free && 
+				matrix == LsAffine_Matrix::Identity)
+			{
+			    // f(x) = Sx
+		 
+			    // Find the optimal scaling; solve:
+				// PP^T S + S PP^T = RP^T + PR^T
+
+				// Not implemented, since Eigen is missing
+				// a solver for Sylvester equations.
+
+				// Forced oriented solution would have det(QS) < 0;
+				// oriented solution is not implemented.
+				ASSERT_OP(orientation, ==, 0);
+			}
+
+			if (scaling == LsAffine_Scaling::Free && 
+				matrix == LsAffine_Matrix::Free)
+			{
+
+			    // f(x) = Ax
+		 
+			    // Compute the optimal linear transformation.
+			    // [UP, UR, X, DP, DR] = gsvd(PP, RP);
+			    // A = UR * (DR * pinv(DP)) * UP.transpose();
+			    Matrix<Real, D, D> pinvPP = PP.completeOrthogonalDecomposition().pseudoInverse();
+				Matrix<Real, D, D> A = RP * pinvPP;
+
+				// Compute Q and S from A such that
+				// A = QS and S is symmetric positive semi-definite.
+				Eigen::JacobiSVD<Matrix<Real, D, D>> svd(A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+				const auto& U = svd.matrixU();
+				const auto& V = svd.matrixV();
+				const auto& s = svd.singularValues();
+				Q = U * V.transpose();
+				S = V * diagonalMatrix(s) * V.transpose();
+
+				// Forced oriented solution would have det(QS) < 0;
+				// oriented solution is not implemented.
+				ASSERT_OP(orientation, ==, 0);
+			}
+
+			if (matrix == LsAffine_Matrix::Free &&
+				(scaling == LsAffine_Scaling::Rigid ||
+				scaling == LsAffine_Scaling::Conformal))
+			{
+			    // f(x) = sQx
+
+			    // Compute the optimal orthogonal transformation.
+
+				Eigen::JacobiSVD<Matrix<Real, D, D>> svd(RP, Eigen::ComputeThinU | Eigen::ComputeThinV);
+				const auto& U = svd.matrixU();
+				const auto& V = svd.matrixV();
+
+			    // Compute the optimal non-oriented orthogonal Q.
+				Q = U * V.transpose();
+
+			    if (orientation != 0 &&
+			    	sign(determinant(Q)) != sign(orientation))
+			    {
+			        // If orientation is to be forced at det(A) = g, where g = +- 1,
+			        // then A is given by:
+			        //
+			        //    Q = UDV^T, where
+			        //    D = [1, ..., 1, g det(UV^T)].
+
+			        ColMatrix<Real, D> s = ColMatrix<Real, D>::Ones(d, 1);
+			        s(d - 1) = -1;
+
+			        // Compute the optimal oriented orthogonal Q.
+			        Q = U * diagonalMatrix(s) * V.transpose();
+			    }
+			}
+
+			if (matrix == LsAffine_Matrix::Identity &&
+				scaling == LsAffine_Scaling::Diagonal)
+			{
+				// f(x) = Dx
+
+				// The error is given by
+				// sum_{i = 1}^d S_{ii}^2 (PP^T)_{ii} - 
+				// 2 sum_{i = 1}^d S_{ii}  (RP^T)_{ii}
+
+				// Compute the optimal diagonal scaling S.
+				// FIX: Make this orthogonality-maximizing.
+				S.diagonal() = RP.diagonal().array() / PP.diagonal().array();
+
+				// Compute det(QS) = det(S).
+				Real sDet = S.diagonal().prod();
+
+				if (orientation != 0 &&
+					sign(sDet) != sign(orientation))
+				{
+					// From the form of the error functional
+					// we see that we can obtain the solution
+					// of the oriented problem by negating that
+					// diagonal element of S for which 
+					// S_{ii} (RP^T)_{ii} is the smallest.
+				
+					ColMatrix<Real, D> product = S.diagonal() * RP.diagonal();
+
+					// Find smallest S_{ii} (RP^T)_{ii}.
+					integer iMin = 0;
+					Real minValue = Infinity();
+					for (integer i = 1;i < d;++i)
+					{
+						// S_{ii} (RP^T)_{ii} >= 0; otherwise
+						// the non-oriented solution would not
+						// have minimum error.
+						ASSERT_OP(product(i), >=, 0);
+						if (product(i) < minValue)
+						{
+							iMin = i;
+							minValue = product(i);
+						}
+					}
+
+					// Negate that diagonal element which causes
+					// the least error.
+					S(iMin, iMin) = -S(iMin, iMin);
+				}
+			}
+
+			if (scaling == LsAffine_Scaling::Conformal)
+			{
+				// f(x) = sQx
+
+				// Compute the optimal scaling parameter.
+				Real s = (Q.transpose() * RP).trace() / PP.trace();
+				S *= s;
+
+				if (matrix == LsAffine_Matrix::Free)
+				{
+					if (orientation != 0)
+					{
+						// The orientation has already been handled
+						// in the selection of Q.
+						ASSERT(sign(determinant(Q * S)) == sign(orientation));
+					}
+				}
+				else
+				{
+					// det(sQ) < 0 is possible only when d is odd.
+					// In addition, forced oriented solutions would 
+					// have det(sQ) = 0; oriented solution is not 
+					// implemented.
+					ASSERT_OP(orientation, ==, 0);
+				}
+			}
+
+			if (matrix == LsAffine_Matrix::Identity &&
+				scaling == LsAffine_Scaling::Rigid &&
+				orientation < 0)
+			{
+				ASSERT1(odd(d), d);
+
+				// S = -I is the only possible choice, since
+				// det(QS) = det(S) = det(-I) = (-1)^d = -1;
+				// here we require d to be odd.
+				S = -S;
+			}
+
+			if (translation == LsAffine_Translation::Free)
+			{
+			    // Compute the optimal translation.
+			    t = toCentroid - Q * S * fromCentroid;
+			}
+		}
+
+	}
+
 	//! Least-squares affine transformation between point-sets
 	/*!
 	Preconditions:
@@ -166,11 +402,6 @@ namespace Pastel
         MapColMatrix<Real, D> t = asMatrix(ts);
         MapMatrix<Real> W = asMatrix(Ws);
 
-		// Initialize Q, S, and t.
-		Q = Matrix<Real, D, D>::Identity(d, d);
-		S = Matrix<Real, D, D>::Identity(d, d);
-		t = ColMatrix<Real, D>::Zero(d, 1);
-
 		bool wSpecified = !Ws.isEmpty();
 
 		// When W is not specified, we require
@@ -181,35 +412,6 @@ namespace Pastel
 			(P.cols() == R.cols()), 
 			P.cols(), R.cols());
 
-		// When Q = I, and S is not rigid, forcing the
-		// orientation results in solutions for which
-		// det(QS) = 0.
-		ENSURE(!(matrix == LsAffine_Matrix::Identity &&
-			scaling != LsAffine_Scaling::Rigid &&
-			orientation != 0));
-
-		// When S is free, forcing the orientation
-		// results in solutions for which det(QS) = 0.
-		ENSURE(!(scaling == LsAffine_Scaling::Free &&
-			orientation != 0));
-
-		// This case is not implemented; I do not know
-		// the solution to this problem.
-		ENSURE(!(matrix == LsAffine_Matrix::Free &&
-			scaling == LsAffine_Scaling::Diagonal));
-
-		// This case is not implemented, because
-		// Eigen does not have a Sylvester-equation solver.
-		ENSURE(!(scaling == LsAffine_Scaling::Free && 
-			matrix == LsAffine_Matrix::Identity));
-
-		// When Q = I and S = +/- I, a negative
-		// det(QS) is only possible in odd dimensions.
-		ENSURE(!(orientation < 0 &&
-			matrix == LsAffine_Matrix::Identity &&
-			scaling == LsAffine_Scaling::Rigid &&
-			even(d)));
-
 		Real totalWeight = n;
 		if (wSpecified)
 		{
@@ -258,173 +460,10 @@ namespace Pastel
 		    RP = (R.colwise() - toCentroid) * (P.colwise() - fromCentroid).transpose();
 		}
 
-		if (scaling == LsAffine_Scaling::Free && 
-			matrix == LsAffine_Matrix::Identity)
-		{
-		    // f(x) = Sx
-		 
-		    // Find the optimal scaling; solve:
-			// PP^T S + S PP^T = RP^T + PR^T
-
-			// Not implemented, since Eigen is missing
-			// a solver for Sylvester equations.
-
-			// Forced oriented solution would have det(QS) < 0;
-			// oriented solution is not implemented.
-			ASSERT_OP(orientation, ==, 0);
-		}
-
-		if (scaling == LsAffine_Scaling::Free && 
-			matrix == LsAffine_Matrix::Free)
-		{
-
-		    // f(x) = Ax
-		 
-		    // Compute the optimal linear transformation.
-		    // [UP, UR, X, DP, DR] = gsvd(PP, RP);
-		    // A = UR * (DR * pinv(DP)) * UP.transpose();
-		    Matrix<Real, D, D> pinvPP = PP.completeOrthogonalDecomposition().pseudoInverse();
-			Matrix<Real, D, D> A = RP * pinvPP;
-
-			// Compute Q and S from A such that
-			// A = QS and S is symmetric positive semi-definite.
-			Eigen::JacobiSVD<Matrix<Real, D, D>> svd(A, Eigen::ComputeThinU | Eigen::ComputeThinV);
-			const auto& U = svd.matrixU();
-			const auto& V = svd.matrixV();
-			const auto& s = svd.singularValues();
-			Q = U * V.transpose();
-			S = V * diagonalMatrix(s) * V.transpose();
-
-			// Forced oriented solution would have det(QS) < 0;
-			// oriented solution is not implemented.
-			ASSERT_OP(orientation, ==, 0);
-		}
-
-		if (matrix == LsAffine_Matrix::Free &&
-			(scaling == LsAffine_Scaling::Rigid ||
-			scaling == LsAffine_Scaling::Conformal))
-		{
-		    // f(x) = sQx
-
-		    // Compute the optimal orthogonal transformation.
-
-			Eigen::JacobiSVD<Matrix<Real, D, D>> svd(RP, Eigen::ComputeThinU | Eigen::ComputeThinV);
-			const auto& U = svd.matrixU();
-			const auto& V = svd.matrixV();
-
-		    // Compute the optimal non-oriented orthogonal Q.
-			Q = U * V.transpose();
-
-		    if (orientation != 0 &&
-		    	sign(determinant(Q)) != sign(orientation))
-		    {
-		        // If orientation is to be forced at det(A) = g, where g = +- 1,
-		        // then A is given by:
-		        //
-		        //    Q = UDV^T, where
-		        //    D = [1, ..., 1, g det(UV^T)].
-
-		        ColMatrix<Real, D> s = ColMatrix<Real, D>::Ones(d, 1);
-		        s(d - 1) = -1;
-
-		        // Compute the optimal oriented orthogonal Q.
-		        Q = U * diagonalMatrix(s) * V.transpose();
-		    }
-		}
-
-		if (matrix == LsAffine_Matrix::Identity &&
-			scaling == LsAffine_Scaling::Diagonal)
-		{
-			// f(x) = Dx
-
-			// The error is given by
-			// sum_{i = 1}^d S_{ii}^2 (PP^T)_{ii} - 
-			// 2 sum_{i = 1}^d S_{ii}  (RP^T)_{ii}
-
-			// Compute the optimal diagonal scaling S.
-			// FIX: Make this orthogonality-maximizing.
-			S.diagonal() = RP.diagonal().array() / PP.diagonal().array();
-
-			// Compute det(QS) = det(S).
-			Real sDet = S.diagonal().prod();
-
-			if (orientation != 0 &&
-				sign(sDet) != sign(orientation))
-			{
-				// From the form of the error functional
-				// we see that we can obtain the solution
-				// of the oriented problem by negating that
-				// diagonal element of S for which 
-				// S_{ii} (RP^T)_{ii} is the smallest.
-				
-				ColMatrix<Real, D> product = S.diagonal() * RP.diagonal();
-
-				// Find smallest S_{ii} (RP^T)_{ii}.
-				integer iMin = 0;
-				Real minValue = Infinity();
-				for (integer i = 1;i < d;++i)
-				{
-					// S_{ii} (RP^T)_{ii} >= 0; otherwise
-					// the non-oriented solution would not
-					// have minimum error.
-					ASSERT_OP(product(i), >=, 0);
-					if (product(i) < minValue)
-					{
-						iMin = i;
-						minValue = product(i);
-					}
-				}
-
-				// Negate that diagonal element which causes
-				// the least error.
-				S(iMin, iMin) = -S(iMin, iMin);
-			}
-		}
-
-		if (scaling == LsAffine_Scaling::Conformal)
-		{
-			// f(x) = sQx
-
-			// Compute the optimal scaling parameter.
-			Real s = (Q.transpose() * RP).trace() / PP.trace();
-			S *= s;
-
-			if (matrix == LsAffine_Matrix::Free)
-			{
-				if (orientation != 0)
-				{
-					// The orientation has already been handled
-					// in the selection of Q.
-					ASSERT(sign(determinant(Q * S)) == sign(orientation));
-				}
-			}
-			else
-			{
-				// det(sQ) < 0 is possible only when d is odd.
-				// In addition, forced oriented solutions would 
-				// have det(sQ) = 0; oriented solution is not 
-				// implemented.
-				ASSERT_OP(orientation, ==, 0);
-			}
-		}
-
-		if (matrix == LsAffine_Matrix::Identity &&
-			scaling == LsAffine_Scaling::Rigid &&
-			orientation < 0)
-		{
-			ASSERT1(odd(d), d);
-
-			// S = -I is the only possible choice, since
-			// det(QS) = det(S) = det(-I) = (-1)^d = -1;
-			// here we require d to be odd.
-			S = -S;
-		}
-
-		if (translation == LsAffine_Translation::Free)
-		{
-		    // Compute the optimal translation.
-		    t = toCentroid - Q * S * fromCentroid;
-		}
+		LsAffine_::solve<Real, D>(
+			PP, RP, fromCentroid, toCentroid,
+			Q, S, t,
+			matrix, scaling, translation, orientation);
 	}
 
 }
@@ -28,7 +28,7 @@
 #include "pastel/sys/stdpair_as_pair.h"
 #include "pastel/sys/hashing/iteratoraddress_hash.h"
 
-#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/search_all_nearest.h"
 
 #include <vector>
 #include <unordered_map>
@@ -198,12 +198,9 @@ namespace Pastel
 			}
 		}
 
-		Vector<Real, N> searchPoint(ofDimension(d));
+		std::vector<Vector<Real, N>> searchSet(
+			indexToModel.size(), Vector<Real, N>(ofDimension(d)));
 		Vector<Real, N> translation(ofDimension(d));
-		// We allow relative error for the nearest neighbor,
-		// since this is an approximate algorithm anyway.
-		// This gives us some performance boost.
-		Real maxRelativeError = 1;
 
 		integer minMatches =
 			std::min(
@@ -251,34 +248,31 @@ namespace Pastel
 
 				// Find out how many points match
 				// under this translation.
-				std::fill(nearestSet.begin(), nearestSet.end(), -1);
 				for (integer j = 0;j < indexToModel.size();++j)
 				{
-					Model_ConstIterator modelPoint = indexToModel[j];
-					
-					searchPoint = 
-						pointAsVector(model.asPoint(modelPoint)) + translation;
-
-					integer k = 0;
-					auto nearestReport = [&](
-						const Distance& distance,
-						const Scene_ConstIterator& scenePoint)
+					searchSet[j] = 
+						pointAsVector(model.asPoint(indexToModel[j])) + translation;
+				}
+
+				auto neighborSet = searchAllNearest(
+					scene, 
+					searchSet,
+					PASTEL_TAG(norm), norm,
+					PASTEL_TAG(kNearest), kNearest,
+					PASTEL_TAG(maxDistance2), matchingDistance2);
+
+				for (integer j = 0;j < indexToModel.size();++j)
+				{
+					for (integer k = 0;k < kNearest;++k)
 					{
-						nearestSet(j, k) = sceneToIndex[scenePoint];
-						++k;
-					};
-
-					searchNearest(
-						scene, 
-						searchPoint,
-						PASTEL_TAG(norm), norm,
-						PASTEL_TAG(report), nearestReport,
-						PASTEL_TAG(kNearest), kNearest,
-						PASTEL_TAG(maxDistance2), matchingDistance2,
-						PASTEL_TAG(maxRelativeError), maxRelativeError);
-
-					//std::cout << "Distance " << neighbor.key() << std::endl;
-				
+						// The missing neighbors are at infinity,
+						// while the found ones are in the open ball.
+						auto&& neighbor = neighborSet[j * kNearest + k];
+						nearestSet(j, k) = 
+							~neighbor.first < ~matchingDistance2
+							? sceneToIndex.at(neighbor.second)
+							: -1;
+					}
 				}
 
 				PairSet pairSet;
@@ -0,0 +1,545 @@
+// Description: Frozen point kd-tree
+// Documentation: pointkdtree.txt
+
+#ifndef PASTELGEOMETRY_FROZEN_POINTKDTREE_H
+#define PASTELGEOMETRY_FROZEN_POINTKDTREE_H
+
+#include "pastel/geometry/pointkdtree/pointkdtree.h"
+
+#include "pastel/sys/locator/strided_locator.h"
+#include "pastel/sys/range/interval_range.h"
+
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Frozen point kd-tree
+	/*!
+	A frozen kd-tree is an immutable copy of a refined PointKdTree,
+	stored in contiguous arrays without pointers. The nodes are stored
+	in breadth-first order in an array of 32-byte nodes (for
+	Real = double), with the children of a node next to each other.
+	The points are stored in leaf order, so that the points of each
+	subtree are contiguous, and their coordinates are stored in a
+	structure-of-arrays layout.
+
+	The interface is the same as that of a PointKdTree, to the extent
+	that the search algorithms need; kdTreeNearestSet(), searchRange()
+	and countRange() work with a frozen kd-tree as they do with the
+	PointKdTree. A point of the frozen kd-tree is a pointer to the
+	first coordinate of the point in the coordinate array; the user
+	point is available from the point-iterator as original().
+	*/
+	template <typename Settings>
+	class Frozen_PointKdTree
+	{
+	public:
+		using Tree_Fwd = PointKdTree_Fwd<Settings>;
+
+		using Real = typename Tree_Fwd::Real;
+		static constexpr int N = Tree_Fwd::N;
+
+		using Original = typename Tree_Fwd::Point;
+		using Locator = Strided_Locator<Real, N>;
+		using Point = typename Locator::Point;
+
+		class PointInfo
+		{
+		public:
+			template <typename>
+			friend class Frozen_PointKdTree;
+
+			PointInfo(
+				Point point,
+				const Original& original)
+				: point_(point)
+				, original_(original)
+			{
+			}
+
+			const Point& operator*() const
+			{
+				return point_;
+			}
+
+			//! Returns the point in terms of the locator().
+			const Point& point() const
+			{
+				return point_;
+			}
+
+			//! Returns the point of the original kd-tree.
+			const Original& original() const
+			{
+				return original_;
+			}
+
+		private:
+			Point point_;
+			Original original_;
+		};
+
+		using Point_ConstIterator = const PointInfo*;
+		using Point_ConstRange = ranges::subrange<Point_ConstIterator>;
+
+		class Node
+		{
+		public:
+			// The bounds of the points of the node on
+			// the splitting axis of the parent node.
+			Real min;
+			Real max;
+
+			// The index of the left child; the right child
+			// follows it. Zero for a leaf node.
+			int32 child;
+
+			// The index of the first point of the node
+			// in the leaf order.
+			int32 first;
+
+			// The splitting axis of the node.
+			int32 splitAxis;
+
+			// The bounds of the parent node on its splitting axis,
+			// which are the previous bounds of this node. If >= 0,
+			// they are the bounds of the node with this index.
+			// Otherwise they are the bounds of the tree on the
+			// axis -(prev + 1).
+			int32 prev;
+		};
+
+		class Cursor
+		{
+		public:
+			// Using default copy constructor.
+			// Using default assignment.
+			// Using default destructor.
+
+			Cursor()
+				: tree_(0)
+				, node_(0)
+				, end_(0)
+			{
+			}
+
+			auto operator<=>(const Cursor& that) const = default;
+
+			explicit operator bool() const
+			{
+				return tree_ != 0;
+			}
+
+			// Tree
+
+			Cursor left() const
+			{
+				PENSURE(!leaf());
+				const Node* child = &tree_->nodeSet_[node().child];
+				return Cursor(tree_, node().child, child[1].first);
+			}
+
+			Cursor right() const
+			{
+				PENSURE(!leaf());
+				return Cursor(tree_, node().child + 1, end_);
+			}
+
+			bool leaf() const
+			{
+				return node().child == 0;
+			}
+
+			// Points
+
+			decltype(auto) pointSet(integer min, integer max) const
+			{
+				// The 'min' and 'max' are present only for
+				// compatibility with the TdTree.
+				return intervalRange(begin(), end());
+			}
+
+			Point_ConstIterator begin() const
+			{
+				return tree_->pointSet_.data() + node().first;
+			}
+
+			Point_ConstIterator end() const
+			{
+				return tree_->pointSet_.data() + end_;
+			}
+
+			integer points() const
+			{
+				return end_ - node().first;
+			}
+
+			bool empty() const
+			{
+				return points() == 0;
+			}
+
+			// Splitting plane
+
+			integer splitAxis() const
+			{
+				return node().splitAxis;
+			}
+
+			// Bounds
+
+			const Real& min() const
+			{
+				return node().min;
+			}
+
+			const Real& max() const
+			{
+				return node().max;
+			}
+
+			const Real& prevMin() const
+			{
+				integer prev = node().prev;
+				if (prev < 0)
+				{
+					return tree_->bound_.min()[-(prev + 1)];
+				}
+				return tree_->nodeSet_[prev].min;
+			}
+
+			const Real& prevMax() const
+			{
+				integer prev = node().prev;
+				if (prev < 0)
+				{
+					return tree_->bound_.max()[-(prev + 1)];
+				}
+				return tree_->nodeSet_[prev].max;
+			}
+
+			// Fractional cascading
+
+			integer cascade(integer index, bool right) const
+			{
+				// This is just for compatible interfaces,
+				// see PointKdTree::Cursor::cascade().
+				return 0;
+			}
+
+		private:
+			template <typename>
+			friend class Frozen_PointKdTree;
+
+			Cursor(
+				const Frozen_PointKdTree* tree,
+				int32 node,
+				int32 end)
+				: tree_(tree)
+				, node_(node)
+				, end_(end)
+			{
+			}
+
+			const Node& node() const
+			{
+				PENSURE(tree_);
+				return tree_->nodeSet_[node_];
+			}
+
+			const Frozen_PointKdTree* tree_;
+			int32 node_;
+			int32 end_;
+		};
+
+		//! Constructs an empty tree.
+		/*!
+		The tree has a root leaf, as the trees frozen
+		from a PointKdTree do.
+		*/
+		Frozen_PointKdTree()
+			: nodeSet_(1, Node{0, 0, 0, 0, 0, -1})
+			, pointSet_()
+			, coordinateSet_()
+			, bound_()
+			, locator_()
+		{
+		}
+
+		//! Freezes a point kd-tree.
+		/*!
+		Time complexity:
+		O(tree.nodes() * depth + tree.points() * tree.n())
+
+		Hidden points are not included.
+		*/
+		template <template <typename> class Customization>
+		explicit Frozen_PointKdTree(
+			const PointKdTree<Settings, Customization>& tree)
+			: Frozen_PointKdTree()
+		{
+			using Tree_Cursor = typename Tree_Fwd::Cursor;
+
+			integer n = tree.n();
+			integer points = tree.points();
+
+			ENSURE_OP(tree.nodes(), <, (integer)1 << 30);
+			ENSURE_OP(points, <, (integer)1 << 30);
+
+			bound_ = tree.bound();
+			locator_ = Locator(n, points);
+
+			// Copy the points in leaf order, the coordinates
+			// in structure-of-arrays layout.
+			coordinateSet_.resize(n * points);
+			pointSet_.reserve(points);
+
+			std::vector<int32> firstSet;
+			firstSet.reserve(tree.nodes());
+
+			// The nodes of the linked tree in depth-first order.
+			std::vector<Tree_Cursor> cursorSet;
+			cursorSet.reserve(tree.nodes());
+
+			auto copyPoints = [&](auto&& self, const Tree_Cursor& cursor) -> void
+			{
+				firstSet.push_back(pointSet_.size());
+				cursorSet.push_back(cursor);
+				if (cursor.leaf())
+				{
+					for (auto i = cursor.begin(); i != cursor.end(); ++i)
+					{
+						integer index = pointSet_.size();
+						for (integer axis = 0; axis < n; ++axis)
+						{
+							coordinateSet_[axis * points + index] =
+								tree.locator()(i->point(), axis);
+						}
+						pointSet_.emplace_back(
+							coordinateSet_.data() + index,
+							i->point());
+					}
+					return;
+				}
+
+				self(self, cursor.left());
+				self(self, cursor.right());
+			};
+			copyPoints(copyPoints, tree.root());
+
+			integer nodes = cursorSet.size();
+
+			// Find the right child of each split node; the
+			// left child follows its parent in depth-first order.
+			std::vector<integer> rightSet(nodes, 0);
+			auto findRight = [&](auto&& self, integer index) -> integer
+			{
+				if (cursorSet[index].leaf())
+				{
+					return index + 1;
+				}
+				integer right = self(self, index + 1);
+				rightSet[index] = right;
+				return self(self, right);
+			};
+			findRight(findRight, 0);
+
+			// Lay out the nodes in breadth-first order.
+			std::vector<integer> depthFirstSet(nodes, 0);
+			std::vector<integer> parentSet(nodes, -1);
+			nodeSet_.resize(nodes);
+			integer breadthEnd = 1;
+			for (integer i = 0; i < breadthEnd; ++i)
+			{
+				integer index = depthFirstSet[i];
+				const Tree_Cursor& cursor = cursorSet[index];
+
+				Node& node = nodeSet_[i];
+				node.min = cursor.min();
+				node.max = cursor.max();
+				node.child = 0;
+				node.first = firstSet[index];
+				node.splitAxis = 0;
+				node.prev = -1;
+
+				if (!cursor.leaf())
+				{
+					node.child = breadthEnd;
+					node.splitAxis = cursor.splitAxis();
+					depthFirstSet[breadthEnd] = index + 1;
+					depthFirstSet[breadthEnd + 1] = rightSet[index];
+					parentSet[breadthEnd] = i;
+					parentSet[breadthEnd + 1] = i;
+					breadthEnd += 2;
+				}
+			}
+
+			// Find the previous bounds of each node. These are the
+			// bounds of the parent on the splitting axis of the parent,
+			// which are the bounds of the nearest ancestor whose parent
+			// splits on the same axis.
+			for (integer i = 1; i < nodes; ++i)
+			{
+				integer parent = parentSet[i];
+				integer axis = nodeSet_[parent].splitAxis;
+
+				integer prev = -(axis + 1);
+				for (integer j = parent; j > 0; j = parentSet[j])
+				{
+					if (nodeSet_[parentSet[j]].splitAxis == axis)
+					{
+						prev = j;
+						break;
+					}
+				}
+				nodeSet_[i].prev = prev;
+			}
+		}
+
+		//! Move-constructs from another tree.
+		Frozen_PointKdTree(Frozen_PointKdTree&& that)
+			: Frozen_PointKdTree()
+		{
+			swap(that);
+		}
+
+		//! Copy-constructs from another tree.
+		Frozen_PointKdTree(const Frozen_PointKdTree& that)
+			: nodeSet_(that.nodeSet_)
+			, pointSet_(that.pointSet_)
+			, coordinateSet_(that.coordinateSet_)
+			, bound_(that.bound_)
+			, locator_(that.locator_)
+		{
+			// Rebase the points to the copied coordinates.
+			for (PointInfo& point : pointSet_)
+			{
+				point.point_ = coordinateSet_.data() +
+					(point.point_ - that.coordinateSet_.data());
+			}
+		}
+
+		//! Assigns another tree.
+		Frozen_PointKdTree& operator=(Frozen_PointKdTree that)
+		{
+			swap(that);
+			return *this;
+		}
+
+		//! Swaps two trees.
+		void swap(Frozen_PointKdTree& that)
+		{
+			using std::swap;
+			nodeSet_.swap(that.nodeSet_);
+			pointSet_.swap(that.pointSet_);
+			coordinateSet_.swap(that.coordinateSet_);
+			bound_.swap(that.bound_);
+			swap(locator_, that.locator_);
+		}
+
+		//! Returns the locator.
+		/*!
+		The locator maps a point to its coordinates in
+		the structure-of-arrays layout.
+		*/
+		const Locator& locator() const
+		{
+			return locator_;
+		}
+
+		//! Returns the bounding box of the tree.
+		const AlignedBox<Real, N>& bound() const
+		{
+			return bound_;
+		}
+
+		//! Returns true if there are no points in the tree.
+		bool empty() const
+		{
+			return pointSet_.empty();
+		}
+
+		//! Returns the root node of the tree.
+		Cursor root() const
+		{
+			return Cursor(this, 0, pointSet_.size());
+		}
+
+		//! Returns an iterator to the beginning of the point list.
+		Point_ConstIterator begin() const
+		{
+			return pointSet_.data();
+		}
+
+		//! Returns an iterator to the end of the point list.
+		Point_ConstIterator end() const
+		{
+			return pointSet_.data() + pointSet_.size();
+		}
+
+		//! Returns an iterator range to the point list.
+		Point_ConstRange range() const
+		{
+			return Point_ConstRange(begin(), end());
+		}
+
+		//! Returns the number of nodes in the tree.
+		integer nodes() const
+		{
+			return nodeSet_.size();
+		}
+
+		//! Returns the number of points in the tree.
+		integer points() const
+		{
+			return pointSet_.size();
+		}
+
+		//! Returns the dimension of the tree.
+		integer n() const
+		{
+			return locator_.n();
+		}
+
+		//! Returns the coordinates of the points.
+		/*!
+		The i:th coordinate of the j:th point in leaf order
+		is at index i * points() + j.
+		*/
+		const std::vector<Real>& coordinateSet() const
+		{
+			return coordinateSet_;
+		}
+
+		//! Converts time to a cascading index.
+		/*!
+		See PointKdTree::timeToIndex().
+		*/
+		integer timeToIndex(const Real& time) const
+		{
+			return 0;
+		}
+
+	private:
+		std::vector<Node> nodeSet_;
+		std::vector<PointInfo> pointSet_;
+		std::vector<Real> coordinateSet_;
+		AlignedBox<Real, N> bound_;
+		Locator locator_;
+	};
+
+	//! Freezes a point kd-tree.
+	/*!
+	See Frozen_PointKdTree.
+	*/
+	template <typename Settings, template <typename> class Customization>
+	Frozen_PointKdTree<Settings> freeze(
+		const PointKdTree<Settings, Customization>& tree)
+	{
+		return Frozen_PointKdTree<Settings>(tree);
+	}
+
+}
+
+#endif
@@ -263,6 +263,59 @@ namespace Pastel
 			const SplitRule& splitRule = SplitRule(),
 			integer bucketSize = 8);
 
+		//! Subdivides the tree using multiple threads.
+		/*!
+		Preconditions:
+		bucketSize >= 0
+		parallelThreshold >= 1
+
+		The resulting tree is identical to the one produced by
+		refine(), including the order of the points, provided 
+		that the split rule depends only on the points and the 
+		bound it is given (e.g. SlidingMidpoint_SplitRule and
+		LongestMedian_SplitRule). The split rule must be safe 
+		to call concurrently.
+
+		The splits are first computed for a contiguous array 
+		of the points, with each thread allocating the nodes 
+		of the subtrees it builds from its own pool. The 
+		subdivision is then transferred to the tree.
+
+		parallelThreshold:
+		The number of points in a node above which its child
+		subtrees are built as independent tasks.
+		*/
+		template <typename SplitRule = SlidingMidpoint2_SplitRule>
+		void refineInParallel(
+			const SplitRule& splitRule = SplitRule(),
+			integer bucketSize = 8,
+			integer parallelThreshold = 1 << 14);
+
+		//! Subdivides a leaf node with a given plane.
+		/*!
+		Preconditions:
+		cursor.leaf()
+		0 <= splitAxis < n()
+		The tree has no points.
+
+		Exception safety:
+		strong
+
+		This recreates a known subdivision, such as one
+		saved to a file, without a splitting rule; the
+		subdivision is built first, and the points inserted
+		afterwards (as in the copy-constructor).
+
+		prevMin, prevMax:
+		The bounds of the node on the splitting axis.
+		*/
+		void subdivide(
+			const Cursor& cursor,
+			const Real& splitPosition,
+			integer splitAxis,
+			const Real& prevMin,
+			const Real& prevMax);
+
 		//! Insert a point into the tree.
 		Point_ConstIterator insert(
 			const Point& point, 
@@ -516,6 +569,16 @@ namespace Pastel
 			integer depth,
 			integer bucketSize);
 
+		//! Sets the leaf nodes and the point ranges after refinement.
+		/*!
+		This is the bottom-up part of refine(), used
+		by refineInParallel().
+		*/
+		void finishRefine(Node* node);
+
+		//! Removes the leaf nodes of the hidden points which were split.
+		void detachSplitHidden();
+
 		//! Actually inserts points into the tree.
 		void commitInsertion();
 
@@ -610,6 +673,7 @@ namespace Pastel
 #include "pastel/geometry/pointkdtree/pointkdtree_equivalent.h"
 #include "pastel/geometry/pointkdtree/pointkdtree_invariants.h"
 #include "pastel/geometry/pointkdtree/pointkdtree_private.hpp"
+#include "pastel/geometry/pointkdtree/pointkdtree_refine_parallel.hpp"
 #include "pastel/geometry/pointkdtree/pointkdtree_search_range.h"
 #include "pastel/geometry/pointkdtree/pointkdtree_splitpredicate.h"
 
@@ -258,24 +258,7 @@ namespace Pastel
 			0,
 			bucketSize);
 
-		// After refinement, a leaf node containing a
-		// hidden point might be turned into a split node.
-		// In this case we remove the associated node,
-		// essentially turning the point into a hidden point 
-		// waiting for insertion.
-
-		Point_ConstIterator iter = hiddenSet_.begin();
-		Point_ConstIterator iterEnd = hiddenSet_.end();
-		while(iter != iterEnd)
-		{
-			Node* node = iter->leaf().node_;
-			if (node && !node->leaf())
-			{
-				iter->setLeaf(0);
-			}
-
-			++iter;
-		}
+		detachSplitHidden();
 	}
 
 	template <typename Settings, template <typename> class Customization>
@@ -475,6 +458,28 @@ namespace Pastel
 		erase(cursor.node_, eraseHidden);
 	}
 
+	template <typename Settings, template <typename> class Customization>
+	void PointKdTree<Settings, Customization>::subdivide(
+		const Cursor& cursor,
+		const Real& splitPosition,
+		integer splitAxis,
+		const Real& prevMin,
+		const Real& prevMax)
+	{
+		ENSURE(cursor.leaf());
+		ENSURE_OP(splitAxis, >=, 0);
+		ENSURE_OP(splitAxis, <, n());
+		ENSURE(pointSet_.empty());
+		ENSURE(hiddenSet_.empty());
+		ENSURE(insertionSet_.empty());
+
+		// Since there are no points, there is no
+		// hierarchical information to update.
+		subdivide(cursor.node_, 
+			splitPosition, splitAxis, 
+			prevMin, prevMax);
+	}
+
 	template <typename Settings, template <typename> class Customization>
 	void PointKdTree<Settings, Customization>::merge()
 	{
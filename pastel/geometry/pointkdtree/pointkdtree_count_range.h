@@ -51,7 +51,8 @@ namespace Pastel
 	bucketSize > 0
 
 	kdTree:
-	The kd-tree to count the points in.
+	The kd-tree to count the points in; a PointKdTree
+	or a Frozen_PointKdTree.
 
 	range:
 	An open aligned box for which to count the number
@@ -66,12 +67,15 @@ namespace Pastel
 	The number of points contained in the 'range'.
 	*/
 	template <
-		typename Settings, template <typename> class Customization,
-		typename Locator = typename Settings::Locator,
+		typename KdTree,
+		typename Locator = typename KdTree::Locator,
 		typename Real = typename Locator::Real,
 		int N = Locator::N>
+	requires (
+		IsPointKdTree<KdTree>::value ||
+		IsFrozenPointKdTree<KdTree>::value)
 	integer countRange(
-		const PointKdTree<Settings, Customization>& kdTree,
+		const KdTree& kdTree,
 		const NoDeduction<AlignedBox<Real, N>>& range,
 		integer bucketSize = 8)
 	{
@@ -16,6 +16,33 @@ namespace Pastel
 	template <typename, template <typename> class>
 	class PointKdTree;
 
+	template <typename>
+	class Frozen_PointKdTree;
+
+	namespace PointKdTree_
+	{
+
+		//! The allocator of the nodes.
+		/*!
+		The settings may define 'Allocator' to replace
+		the PoolAllocator; e.g. ConcurrentPoolAllocator
+		allows to allocate nodes from several threads.
+		*/
+		template <typename Settings>
+		struct Allocator
+		{
+			using type = PoolAllocator;
+		};
+
+		template <typename Settings>
+		requires requires { typename Settings::Allocator; }
+		struct Allocator<Settings>
+		{
+			using type = typename Settings::Allocator;
+		};
+
+	}
+
 	template <typename Settings>
 	class PointKdTree_Fwd
 	{
@@ -30,9 +57,9 @@ namespace Pastel
 		class Cursor;
 		class SplitPredicate;
 
-		using NodeAllocator = PoolAllocator;
-		using PointAllocator = PoolAllocator;
-		using BoundAllocator = PoolAllocator;
+		using NodeAllocator = typename PointKdTree_::Allocator<Settings>::type;
+		using PointAllocator = NodeAllocator;
+		using BoundAllocator = NodeAllocator;
 
 		class Node;
 
@@ -131,6 +158,26 @@ namespace Pastel
 	using IsPointKdTree =
 		PointKdTree_::IsPointKdTree<RemoveCvRef<Type>>;
 
+	namespace PointKdTree_
+	{
+
+		//! Returns whether Type is an instance of Frozen_PointKdTree.
+		template <typename Type>
+		struct IsFrozenPointKdTree
+		: std::false_type
+		{};
+
+		template <typename Settings>
+		struct IsFrozenPointKdTree<Frozen_PointKdTree<Settings>>
+		: std::true_type
+		{};
+
+	}
+
+	template <typename Type>
+	using IsFrozenPointKdTree =
+		PointKdTree_::IsFrozenPointKdTree<RemoveCvRef<Type>>;
+
 }
 
 #endif
@@ -691,6 +691,47 @@ namespace Pastel
 		}
 	}
 
+	template <typename Settings, template <typename> class Customization>
+	void PointKdTree<Settings, Customization>::finishRefine(
+		Node* node)
+	{
+		ASSERT(node);
+
+		if (node->leaf())
+		{
+			setLeaf(node->first(), node->end(), node);
+			return;
+		}
+
+		finishRefine(node->left());
+		finishRefine(node->right());
+
+		updateHierarchical(node);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void PointKdTree<Settings, Customization>::detachSplitHidden()
+	{
+		// After refinement, a leaf node containing a
+		// hidden point might be turned into a split node.
+		// In this case we remove the associated node,
+		// essentially turning the point into a hidden point 
+		// waiting for insertion.
+
+		Point_ConstIterator iter = hiddenSet_.begin();
+		Point_ConstIterator iterEnd = hiddenSet_.end();
+		while(iter != iterEnd)
+		{
+			Node* node = iter->leaf().node_;
+			if (node && !node->leaf())
+			{
+				iter->setLeaf(0);
+			}
+
+			++iter;
+		}
+	}
+
 	template <typename Settings, template <typename> class Customization>
 	void PointKdTree<Settings, Customization>::commitInsertion()
 	{
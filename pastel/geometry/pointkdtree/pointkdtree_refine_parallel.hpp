@@ -0,0 +1,423 @@
+#ifndef PASTELGEOMETRY_POINTKDTREE_REFINE_PARALLEL_HPP
+#define PASTELGEOMETRY_POINTKDTREE_REFINE_PARALLEL_HPP
+
+#include "pastel/geometry/pointkdtree/pointkdtree.h"
+
+#include "pastel/sys/allocator/pool_allocator.h"
+#include "pastel/sys/destruct.h"
+#include "pastel/sys/range.h"
+#include "pastel/sys/range/transformed_range.h"
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
+#include <vector>
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	template <typename SplitRule>
+	void PointKdTree<Settings, Customization>::refineInParallel(
+		const SplitRule& splitRule,
+		integer bucketSize,
+		integer parallelThreshold)
+	{
+		ENSURE_OP(bucketSize, >=, 0);
+		ENSURE_OP(parallelThreshold, >=, 1);
+
+		// A split node of a subtree under construction.
+		struct Split
+		{
+			Split* left;
+			Split* right;
+
+			// The points of the children are at the ranges
+			// [begin, middle[ and [middle, end[ of the
+			// point array of the subtree.
+			integer middle;
+			integer end;
+
+			Real splitPosition;
+			integer splitAxis;
+
+			// The bounds of the children on the splitting axis.
+			Real leftMin;
+			Real leftMax;
+			Real rightMin;
+			Real rightMax;
+
+			// The bounds of this node on the splitting axis.
+			Real prevMin;
+			Real prevMax;
+		};
+
+		// A leaf node of the tree which needs to be subdivided.
+		struct Job
+		{
+			Node* node;
+			AlignedBox<Real, N> bound;
+			std::vector<Point_ConstIterator> pointSet;
+			Split* root;
+		};
+
+		// The thread-local state.
+		struct Local
+		{
+			Local()
+				: splitAllocator(sizeof(Split))
+			{
+			}
+
+			PoolAllocator splitAllocator;
+			std::vector<int8> sideSet;
+			std::vector<Point_ConstIterator> partitionSet;
+		};
+
+		// Find the leaf nodes which need to be subdivided,
+		// and their bounds, as in refine().
+
+		std::vector<Job> jobSet;
+
+		auto findJobs = [&](
+			auto&& self,
+			Node* node,
+			AlignedBox<Real, N>& bound) -> void
+		{
+			if (node->leaf())
+			{
+				if (node->points() > bucketSize)
+				{
+					jobSet.push_back(Job{node, bound, {}, 0});
+				}
+				return;
+			}
+
+			integer splitAxis = node->splitAxis();
+
+			Real oldMinBound = bound.min()[splitAxis];
+			Real oldMaxBound = bound.max()[splitAxis];
+
+			bound.min()[splitAxis] = node->left()->min();
+			bound.max()[splitAxis] = node->left()->max();
+			self(self, node->left(), bound);
+
+			bound.min()[splitAxis] = node->right()->min();
+			bound.max()[splitAxis] = node->right()->max();
+			self(self, node->right(), bound);
+
+			bound.min()[splitAxis] = oldMinBound;
+			bound.max()[splitAxis] = oldMaxBound;
+		};
+
+		{
+			AlignedBox<Real, N> rootBound = bound();
+			findJobs(findJobs, root_, rootBound);
+		}
+
+		for (Job& job : jobSet)
+		{
+			job.pointSet.reserve(job.node->points());
+			Point_ConstIterator iter = job.node->first();
+			Point_ConstIterator iterEnd = job.node->end();
+			while (iter != iterEnd)
+			{
+				job.pointSet.push_back(iter);
+				++iter;
+			}
+		}
+
+		// Compute the subdivisions in parallel.
+
+		tbb::enumerable_thread_specific<Local> localSet;
+
+		auto computeBound = [&](
+			const Point_ConstIterator* begin,
+			const Point_ConstIterator* end,
+			integer axis)
+		{
+			std::pair<Real, Real> bound(
+				(Real)Infinity(), -(Real)Infinity());
+
+			for (auto iter = begin; iter != end; ++iter)
+			{
+				Real position = locator()((*iter)->point(), axis);
+				if (position < bound.first)
+				{
+					bound.first = position;
+				}
+				if (position > bound.second)
+				{
+					bound.second = position;
+				}
+			}
+
+			return bound;
+		};
+
+		auto build = [&](
+			auto&& self,
+			Point_ConstIterator* pointSet,
+			integer begin,
+			integer end,
+			AlignedBox<Real, N>& bound) -> Split*
+		{
+			integer points = end - begin;
+			if (points <= bucketSize)
+			{
+				return 0;
+			}
+
+			Local& local = localSet.local();
+
+			auto locationSet_ = transformRange(
+				Pastel::range(pointSet + begin, pointSet + end),
+				[&](const Point_ConstIterator& point)
+				{
+					return point->point();
+				});
+
+			std::pair<Real, integer> split =
+				splitRule(
+					locationSet(locationSet_, locator()),
+					bound);
+
+			Real splitPosition = split.first;
+			integer splitAxis = split.second;
+			ASSERT2(splitAxis >= 0 && splitAxis < n(), splitAxis, n());
+
+			// Partition the points exactly as partition()
+			// partitions the point list in subdivide().
+
+			SplitPredicate splitPredicate(
+				splitPosition, splitAxis,
+				locator());
+
+			enum
+			{
+				True,
+				False,
+				TrueBoth,
+				FalseBoth
+			};
+
+			integer count[4] = {0, 0, 0, 0};
+
+			std::vector<int8>& sideSet = local.sideSet;
+			sideSet.resize(points);
+			for (integer i = 0; i < points; ++i)
+			{
+				TriState side = splitPredicate(*pointSet[begin + i]);
+
+				integer group = True;
+				if (side == TriState::False)
+				{
+					group = False;
+				}
+				else if (side == TriState::Both)
+				{
+					group = (count[TrueBoth] < count[FalseBoth]) ?
+						TrueBoth : FalseBoth;
+				}
+
+				sideSet[i] = group;
+				++count[group];
+			}
+
+			integer offset[4];
+			offset[True] = 0;
+			if (count[True] < count[False])
+			{
+				offset[FalseBoth] = count[True];
+				offset[False] = offset[FalseBoth] + count[FalseBoth];
+				offset[TrueBoth] = offset[False] + count[False];
+			}
+			else
+			{
+				offset[TrueBoth] = count[True];
+				offset[False] = offset[TrueBoth] + count[TrueBoth];
+				offset[FalseBoth] = offset[False] + count[False];
+			}
+
+			// The left child gets the True-group and one of the
+			// Both-groups, which precede the False-group.
+			integer middle = begin + offset[False];
+
+			std::vector<Point_ConstIterator>& partitionSet =
+				local.partitionSet;
+			partitionSet.resize(points);
+			for (integer i = 0; i < points; ++i)
+			{
+				partitionSet[offset[(integer)sideSet[i]]++] = pointSet[begin + i];
+			}
+			std::copy(
+				partitionSet.begin(), partitionSet.end(),
+				pointSet + begin);
+
+			// Compute the bounds of the children on the
+			// splitting axis, as in subdivide().
+
+			Real prevMin = bound.min()[splitAxis];
+			Real prevMax = bound.max()[splitAxis];
+
+			std::pair<Real, Real> leftBound(prevMin, splitPosition);
+			std::pair<Real, Real> rightBound(splitPosition, prevMax);
+			if (!simulateKdTree_)
+			{
+				leftBound = computeBound(
+					pointSet + begin, pointSet + middle, splitAxis);
+				rightBound = computeBound(
+					pointSet + middle, pointSet + end, splitAxis);
+			}
+
+			Split* node = (Split*)local.splitAllocator.allocate();
+			new(node) Split{
+				0, 0,
+				middle, end,
+				splitPosition, splitAxis,
+				leftBound.first, leftBound.second,
+				rightBound.first, rightBound.second,
+				prevMin, prevMax};
+
+			// Subdivide the children recursively.
+
+			if (points > parallelThreshold)
+			{
+				AlignedBox<Real, N> leftBox = bound;
+				leftBox.min()[splitAxis] = leftBound.first;
+				leftBox.max()[splitAxis] = leftBound.second;
+
+				AlignedBox<Real, N> rightBox = bound;
+				rightBox.min()[splitAxis] = rightBound.first;
+				rightBox.max()[splitAxis] = rightBound.second;
+
+				tbb::parallel_invoke(
+					[&]()
+					{
+						node->left = self(self, pointSet, begin, middle, leftBox);
+					},
+					[&]()
+					{
+						node->right = self(self, pointSet, middle, end, rightBox);
+					});
+			}
+			else
+			{
+				bound.min()[splitAxis] = leftBound.first;
+				bound.max()[splitAxis] = leftBound.second;
+				node->left = self(self, pointSet, begin, middle, bound);
+
+				bound.min()[splitAxis] = rightBound.first;
+				bound.max()[splitAxis] = rightBound.second;
+				node->right = self(self, pointSet, middle, end, bound);
+
+				bound.min()[splitAxis] = prevMin;
+				bound.max()[splitAxis] = prevMax;
+			}
+
+			return node;
+		};
+
+		tbb::parallel_for((integer)0, (integer)jobSet.size(),
+			[&](integer i)
+			{
+				Job& job = jobSet[i];
+				job.root = build(
+					build,
+					job.pointSet.data(),
+					0, job.pointSet.size(),
+					job.bound);
+			});
+
+		// Transfer the subdivisions to the tree.
+
+		auto transfer = [&](
+			auto&& self,
+			Node* node,
+			Split* split,
+			const Point_ConstIterator* pointSet,
+			integer begin) -> void
+		{
+			if (!split)
+			{
+				return;
+			}
+
+			auto first = [&](integer begin, integer end)
+			{
+				return begin < end ? pointSet[begin] : this->end();
+			};
+
+			auto last = [&](integer begin, integer end)
+			{
+				return begin < end ? pointSet[end - 1] : this->end();
+			};
+
+			integer middle = split->middle;
+			integer end = split->end;
+
+			Node* left = allocateLeaf(
+				node,
+				first(begin, middle),
+				last(begin, middle),
+				middle - begin);
+
+			Node* right = allocateLeaf(
+				node,
+				first(middle, end),
+				last(middle, end),
+				end - middle);
+
+			node->setLeft(left);
+			node->setRight(right);
+			node->setSplitPosition(split->splitPosition);
+			node->setSplitAxis(split->splitAxis);
+
+			left->setMin(split->leftMin);
+			left->setMax(split->leftMax);
+			left->setPrevMin(split->prevMin);
+			left->setPrevMax(split->prevMax);
+
+			right->setMin(split->rightMin);
+			right->setMax(split->rightMax);
+			right->setPrevMin(split->prevMin);
+			right->setPrevMax(split->prevMax);
+
+			++leaves_;
+
+			self(self, left, split->left, pointSet, begin);
+			self(self, right, split->right, pointSet, middle);
+
+			// The memory is released by clearing the
+			// thread-local pools.
+			destruct(split);
+		};
+
+		for (Job& job : jobSet)
+		{
+			// Reorder the points of the node in the point list.
+			Point_ConstIterator nodeEnd = job.node->end();
+			for (const Point_ConstIterator& point : job.pointSet)
+			{
+				pointSet_.splice(nodeEnd, pointSet_, point);
+			}
+
+			job.node->setFirst(job.pointSet.front());
+			job.node->setLast(job.pointSet.back());
+
+			transfer(transfer, job.node, job.root, job.pointSet.data(), 0);
+		}
+
+		for (Local& local : localSet)
+		{
+			local.splitAllocator.clear();
+		}
+
+		finishRefine(root_);
+		detachSplitHidden();
+	}
+
+}
+
+#endif
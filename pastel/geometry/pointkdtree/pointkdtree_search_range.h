@@ -44,7 +44,7 @@ namespace Pastel
 				Iterator i = begin;
 				while (i != end)
 				{
-					output(i);
+					output_(i);
 					++i;
 				}
 			}
@@ -62,11 +62,14 @@ namespace Pastel
 	kdTree.n() <= 32
 	*/
 	template <
-		typename Settings, template <typename> class Customization, 
+		typename KdTree,
 		typename Point_ConstIterator_Output>
+	requires (
+		IsPointKdTree<KdTree>::value ||
+		IsFrozenPointKdTree<KdTree>::value)
 	void searchRange(
-		const PointKdTree<Settings, Customization>& kdTree,
-		const AlignedBox<typename Settings::Real, Settings::N>& range,
+		const KdTree& kdTree,
+		const AlignedBox<typename KdTree::Real, KdTree::N>& range,
 		Point_ConstIterator_Output report)
 	{
 		PointKdTree_Search_Range_::Search_Output<Point_ConstIterator_Output>
@@ -20,15 +20,21 @@ namespace Pastel
 	kdTree.n() == range.n()
 	kdTree.n() <= 64
 	bucketSize > 0
+
+	kdTree:
+	A PointKdTree or a Frozen_PointKdTree.
 	*/
 	template <
-		typename Settings, template <typename> class Customization,
+		typename KdTree,
 		typename Output_SearchRange,
-		typename Locator = typename Settings::Locator,
+		typename Locator = typename KdTree::Locator,
 		typename Real = typename Locator::Real,
 		int N = Locator::N>
+	requires (
+		IsPointKdTree<KdTree>::value ||
+		IsFrozenPointKdTree<KdTree>::value)
 	void searchRangeAlgorithm(
-		const PointKdTree<Settings, Customization>& kdTree,
+		const KdTree& kdTree,
 		const NoDeduction<AlignedBox<Real, N>>& range,
 		const Output_SearchRange& reporter,
 		integer bucketSize = 8)
@@ -37,10 +43,9 @@ namespace Pastel
 		ENSURE_OP(kdTree.n(), <=, 64);
 		ENSURE_OP(bucketSize, >, 0);
 
-		using Fwd = PointKdTree<Settings, Customization>;
+		using Fwd = KdTree;
 		PASTEL_FWD(Point_ConstIterator);
 		PASTEL_FWD(Cursor);
-		PASTEL_FWD(Point);
 
 		// Note: we assume the search region is open.
 
@@ -14,6 +14,12 @@
 
 #include "pastel/math/sampling/uniform_sampling.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <vector>
 
 namespace Pastel
@@ -54,6 +60,41 @@ namespace Pastel
 			bool& validNewPoint_;
 		};
 
+		//! A counter-based random number generator.
+		/*!
+		The darts of the grid algorithm are drawn from generators
+		keyed by the seed, the cell, the level, and the round, so
+		that the pattern does not depend on the order in which
+		the cells are processed, or on the number of threads.
+		*/
+		class Dart_Random
+		{
+		public:
+			explicit Dart_Random(uint64 key)
+				: state_(mix(key))
+			{
+			}
+
+			//! Returns a uniformly distributed real in [0, 1).
+			template <typename Real>
+			Real uniform()
+			{
+				state_ += 0x9E3779B97F4A7C15ull;
+				return (Real)(mix(state_) >> 11) * (Real)0x1.0p-53;
+			}
+
+			//! The finalizer of the SplitMix64 generator.
+			static uint64 mix(uint64 x)
+			{
+				x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+				x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+				return x ^ (x >> 31);
+			}
+
+		private:
+			uint64 state_;
+		};
+
 	}
 
 	//! Generates an almost-maximal poisson disk pattern.
@@ -249,6 +290,494 @@ namespace Pastel
 			seedSet.begin(), seedSet.end(), maxRejections);
 	}
 
+	//! Generates an almost-maximal poisson disk pattern in parallel.
+	/*!
+	window:
+	The rectangular region to fill with the pattern.
+
+	minDistance (Real > 0):
+	The minimum pairwise distance between pattern points.
+
+	returns (std::vector<Vector<Real, N>>):
+	The pattern points, in the row-major order of the
+	cells of the background grid (the first axis varies
+	fastest).
+
+	Optional arguments
+	------------------
+
+	seed (integer):
+	The seed of the random numbers. The pattern is
+	determined by the window, the minimum distance,
+	and the optional arguments, and does not depend on
+	the number of threads.
+	Default: 0
+
+	maxRejections (integer >= 1):
+	The number of darts thrown into each empty cell
+	at each level of subdivision.
+	Default: 8
+
+	subdivisions (integer >= 0):
+	The number of times the uncovered parts of the
+	empty cells are subdivided to find the remaining gaps.
+	Default: 2
+
+	parallel (bool):
+	Whether to distribute the cells over threads.
+	Default: true
+
+	This is the phased parallel dart throwing of the paper
+
+	"Parallel Poisson Disk Sampling",
+	Li-Yi Wei, Siggraph 2008.
+
+	The window is divided into a background grid of cubic
+	cells of edge length h = minDistance / sqrt(N), so that
+	each cell contains at most one pattern point. A pattern
+	point can only be closer than minDistance to a point in
+	a cell at most k = ceil(sqrt(N)) cells away along each axis.
+	The cells are partitioned into (k + 1)^N phases by their
+	coordinates modulo (k + 1); the cells of a phase are
+	independent of each other, and a dart is thrown into
+	each of its empty cells in parallel. Each round goes
+	through all of the phases.
+
+	After maxRejections rounds, the empty cells are subdivided,
+	the sub-cells covered by the disk of a single neighbor
+	are discarded, and the darts are thrown uniformly
+	into the remaining sub-cells. This finds most of the
+	small gaps which random darts into whole cells miss.
+
+	Time complexity:
+	O(m (maxRejections (subdivisions + 1) + 2^(N subdivisions)) 3^N)
+	where
+	m is the number of cells.
+	*/
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	std::vector<Vector<Real, N>> gridPoissonDiskPattern(
+		const AlignedBox<Real, N>& window,
+		const NoDeduction<Real>& minDistance,
+		ArgumentSet&&... argumentSet)
+	{
+		PASTEL_STATIC_ASSERT(N > 0);
+
+		integer seed = PASTEL_ARG_S(seed, 0);
+		integer maxRejections = PASTEL_ARG_S(maxRejections, 8);
+		integer subdivisions = PASTEL_ARG_S(subdivisions, 2);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+
+		ENSURE_OP(minDistance, >, 0);
+		ENSURE_OP(maxRejections, >=, 1);
+		ENSURE_OP(subdivisions, >=, 0);
+
+		using Point = Vector<Real, N>;
+		using Box = AlignedBox<Real, N>;
+		using Dart_Random = PoissonDiskPattern_::Dart_Random;
+
+		const Real minDistance2 = minDistance * minDistance;
+		const Real h = minDistance / std::sqrt((Real)N);
+
+		// The pattern points closer than minDistance to a point
+		// in a cell are at most k cells away along each axis.
+		integer k = 1;
+		while (k * k < N)
+		{
+			++k;
+		}
+		integer s = k + 1;
+
+		// The grid is padded by k empty cells on each side,
+		// so that the neighborhood of a cell needs no clipping.
+		Vector<integer, N> extent;
+		Vector<integer, N> stride;
+		integer cells = 1;
+		integer phases = 1;
+		for (integer i = 0;i < N;++i)
+		{
+			extent[i] = std::max(
+				(integer)std::ceil((window.max()[i] - window.min()[i]) / h),
+				(integer)1);
+			stride[i] = cells;
+			cells *= extent[i] + 2 * k;
+			phases *= s;
+		}
+
+		const Point empty((Real)Infinity());
+		std::vector<Point> grid(cells, empty);
+
+		auto filled = [&](integer cell)
+		{
+			return grid[cell][0] != (Real)Infinity();
+		};
+
+		// The offsets of the neighbor cells which may contain
+		// a point closer than minDistance to a point in a cell,
+		// nearest first, so that a conflict is found early.
+		std::vector<std::pair<Real, Vector<integer, N>>> nearDeltaSet;
+		{
+			Vector<integer, N> delta(-k);
+			while (true)
+			{
+				Real gap2 = 0;
+				bool center = true;
+				for (integer i = 0;i < N;++i)
+				{
+					Real gap = std::max(std::abs(delta[i]) - 1, (integer)0) * h;
+					gap2 += gap * gap;
+					center = center && delta[i] == 0;
+				}
+				if (!center && gap2 < minDistance2)
+				{
+					nearDeltaSet.emplace_back(gap2, delta);
+				}
+
+				integer i = 0;
+				while (i < N && delta[i] == k)
+				{
+					delta[i] = -k;
+					++i;
+				}
+				if (i == N)
+				{
+					break;
+				}
+				++delta[i];
+			}
+		}
+
+		std::stable_sort(nearDeltaSet.begin(), nearDeltaSet.end(),
+			[](auto&& left, auto&& right) {return left.first < right.first;});
+
+		std::vector<Vector<integer, N>> deltaSet;
+		std::vector<integer> offsetSet;
+		for (auto&& nearDelta : nearDeltaSet)
+		{
+			deltaSet.push_back(nearDelta.second);
+			offsetSet.push_back(dot(nearDelta.second, stride));
+		}
+
+		auto cellBox = [&](integer cell)
+		{
+			Box box;
+			for (integer i = 0;i < N;++i)
+			{
+				integer c = (cell / stride[i]) % (extent[i] + 2 * k) - k;
+				box.min()[i] = window.min()[i] + c * h;
+				box.max()[i] = std::min(box.min()[i] + h, window.max()[i]);
+			}
+			return box;
+		};
+
+		// Partition the cells into phases.
+		std::vector<std::vector<integer>> phaseSet(phases);
+		{
+			Vector<integer, N> c(0);
+			while (true)
+			{
+				integer cell = 0;
+				integer phase = 0;
+				integer phaseStride = 1;
+				for (integer i = 0;i < N;++i)
+				{
+					cell += (c[i] + k) * stride[i];
+					phase += (c[i] % s) * phaseStride;
+					phaseStride *= s;
+				}
+				phaseSet[phase].push_back(cell);
+
+				integer i = 0;
+				while (i < N && c[i] == extent[i] - 1)
+				{
+					c[i] = 0;
+					++i;
+				}
+				if (i == N)
+				{
+					break;
+				}
+				++c[i];
+			}
+		}
+
+		// Throws a dart into a box of a cell, and adds it
+		// to the pattern if no neighbor is too close.
+		// The near-set contains some of the neighbors; since most
+		// darts are rejected, they are first tested against it.
+		auto throwDart = [&](
+			integer cell, const Box& box, Dart_Random& random,
+			const std::vector<Point>& nearSet)
+		{
+			Point point;
+			for (integer i = 0;i < N;++i)
+			{
+				point[i] = box.min()[i] +
+					random.uniform<Real>() * (box.max()[i] - box.min()[i]);
+			}
+
+			for (const Point& neighbor : nearSet)
+			{
+				if (dot(neighbor - point) < minDistance2)
+				{
+					return;
+				}
+			}
+
+			for (integer offset : offsetSet)
+			{
+				const Point& neighbor = grid[cell + offset];
+				if (neighbor[0] != (Real)Infinity() &&
+					dot(neighbor - point) < minDistance2)
+				{
+					return;
+				}
+			}
+
+			grid[cell] = point;
+		};
+
+		auto dartKey = [&](integer cell, integer level, integer round)
+		{
+			return Dart_Random::mix(Dart_Random::mix(seed) ^ cell) ^
+				((uint64)level << 32) ^ (uint64)round;
+		};
+
+		// Runs work(i) for i in [0, n) over the cells of a phase.
+		auto forEach = [&](integer n, const auto& work)
+		{
+			using Block = tbb::blocked_range<integer>;
+			auto run = [&](const Block& block)
+			{
+				for (integer i = block.begin();i < block.end();++i)
+				{
+					work(i);
+				}
+			};
+
+			if (parallel)
+			{
+				tbb::parallel_for(Block(0, n, 256), run);
+			}
+			else
+			{
+				run(Block(0, n, 256));
+			}
+		};
+
+		// Throw darts into whole cells.
+		const std::vector<Point> noNearSet;
+		for (integer round = 0;round < maxRejections;++round)
+		{
+			for (std::vector<integer>& cellSet : phaseSet)
+			{
+				forEach(cellSet.size(), [&](integer i)
+				{
+					integer cell = cellSet[i];
+					Dart_Random random(dartKey(cell, 0, round));
+					throwDart(cell, cellBox(cell), random, noNearSet);
+				});
+
+				cellSet.erase(
+					std::remove_if(cellSet.begin(), cellSet.end(), filled),
+					cellSet.end());
+			}
+		}
+
+		// Throw darts into the uncovered sub-cells of the empty cells.
+		class Active
+		{
+		public:
+			//! The empty cell.
+			integer cell;
+
+			//! The uncovered sub-cells of the cell.
+			std::vector<Box> boxSet;
+
+			//! The points closer than minDistance to the cell,
+			//! which have been scattered to it so far.
+			std::vector<Point> nearSet;
+		};
+
+		std::vector<std::vector<Active>> activeSet(phases);
+		for (integer phase = 0;phase < phases;++phase)
+		{
+			for (integer cell : phaseSet[phase])
+			{
+				activeSet[phase].push_back(
+					Active{cell, std::vector<Box>(1, cellBox(cell)), {}});
+			}
+			phaseSet[phase] = std::vector<integer>();
+		}
+
+		// Returns whether a box is covered by the disk of
+		// a single point.
+		auto covered = [&](const std::vector<Point>& nearSet, const Box& box)
+		{
+			for (const Point& neighbor : nearSet)
+			{
+				Real farthest2 = 0;
+				for (integer i = 0;i < N;++i)
+				{
+					Real d = std::max(
+						std::abs(neighbor[i] - box.min()[i]),
+						std::abs(neighbor[i] - box.max()[i]));
+					farthest2 += d * d;
+				}
+				if (farthest2 < minDistance2)
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+
+		// The neighbor offsets in memory order, for scattering.
+		std::vector<integer> scatterOrder(offsetSet.size());
+		std::iota(scatterOrder.begin(), scatterOrder.end(), 0);
+		std::sort(scatterOrder.begin(), scatterOrder.end(),
+			[&](integer left, integer right) {return offsetSet[left] < offsetSet[right];});
+
+		// The cells whose points have not been scattered yet.
+		std::vector<integer> newSet;
+		if (subdivisions > 0)
+		{
+			for (integer cell = 0;cell < cells;++cell)
+			{
+				if (filled(cell))
+				{
+					newSet.push_back(cell);
+				}
+			}
+		}
+
+		std::vector<Active*> ownerSet(subdivisions > 0 ? cells : 0, nullptr);
+		for (integer level = 1;level <= subdivisions;++level)
+		{
+			// Only the points closer than minDistance to an
+			// empty cell can cover its sub-cells. Since most
+			// cells are empty, these points are found by
+			// scattering the new points to their neighbor cells,
+			// rather than by gathering them from the neighbor
+			// cells of the empty cells.
+			std::fill(ownerSet.begin(), ownerSet.end(), nullptr);
+			for (std::vector<Active>& cellSet : activeSet)
+			{
+				for (Active& active : cellSet)
+				{
+					ownerSet[active.cell] = &active;
+				}
+			}
+
+			for (integer cell : newSet)
+			{
+				const Point& point = grid[cell];
+				Point relative = point - cellBox(cell).min();
+				for (integer j : scatterOrder)
+				{
+					Active* active = ownerSet[cell + offsetSet[j]];
+					if (!active)
+					{
+						continue;
+					}
+
+					// The distance from the point to the
+					// (unclipped) neighbor cell.
+					Real distance2 = 0;
+					for (integer d = 0;d < N;++d)
+					{
+						Real min = deltaSet[j][d] * h;
+						Real gap = std::max(std::max(
+							min - relative[d],
+							relative[d] - (min + h)), (Real)0);
+						distance2 += gap * gap;
+					}
+					if (distance2 < minDistance2)
+					{
+						active->nearSet.emplace_back(point);
+					}
+				}
+			}
+			newSet.clear();
+
+			for (std::vector<Active>& cellSet : activeSet)
+			{
+				forEach(cellSet.size(), [&](integer i)
+				{
+					const std::vector<Point>& nearSet = cellSet[i].nearSet;
+
+					std::vector<Box> boxSet;
+					for (const Box& box : cellSet[i].boxSet)
+					{
+						for (integer j = 0;j < (1 << N);++j)
+						{
+							Box subBox;
+							for (integer d = 0;d < N;++d)
+							{
+								bool upper = (j >> d) & 1;
+								Real mid = (box.min()[d] + box.max()[d]) / 2;
+								subBox.min()[d] = upper ? mid : box.min()[d];
+								subBox.max()[d] = upper ? box.max()[d] : mid;
+							}
+							if (!covered(nearSet, subBox))
+							{
+								boxSet.emplace_back(subBox);
+							}
+						}
+					}
+					cellSet[i].boxSet.swap(boxSet);
+				});
+
+				cellSet.erase(
+					std::remove_if(cellSet.begin(), cellSet.end(),
+						[](const Active& active) {return active.boxSet.empty();}),
+					cellSet.end());
+			}
+
+			for (integer round = 0;round < maxRejections;++round)
+			{
+				for (std::vector<Active>& cellSet : activeSet)
+				{
+					forEach(cellSet.size(), [&](integer i)
+					{
+						const Active& active = cellSet[i];
+						const std::vector<Box>& boxSet = active.boxSet;
+						Dart_Random random(dartKey(active.cell, level, round));
+						integer j = std::min(
+							(integer)(random.uniform<Real>() * boxSet.size()),
+							(integer)boxSet.size() - 1);
+						throwDart(active.cell, boxSet[j], random, active.nearSet);
+					});
+
+					for (const Active& active : cellSet)
+					{
+						if (filled(active.cell))
+						{
+							newSet.push_back(active.cell);
+						}
+					}
+
+					cellSet.erase(
+						std::remove_if(cellSet.begin(), cellSet.end(),
+							[&](const Active& active) {return filled(active.cell);}),
+						cellSet.end());
+				}
+			}
+		}
+
+		std::vector<Point> pointSet;
+		for (const Point& point : grid)
+		{
+			if (point[0] != (Real)Infinity())
+			{
+				pointSet.emplace_back(point);
+			}
+		}
+
+		return pointSet;
+	}
+
 }
 
 #endif
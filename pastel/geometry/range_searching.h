@@ -6,6 +6,7 @@
 #include "pastel/geometry/pointkdtree/pointkdtree_count_range.h"
 #include "pastel/geometry/pointkdtree/pointkdtree_search_range.h"
 #include "pastel/geometry/pointkdtree/pointkdtree_search_range_algorithm.h"
+#include "pastel/geometry/rangetree/rangetree_count_range.h"
 #include "pastel/geometry/rangetree/rangetree_search_range.h"
 
 #endif
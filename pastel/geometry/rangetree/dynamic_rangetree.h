@@ -0,0 +1,456 @@
+// Description: Dynamic range tree
+// Documentation: rangetree.txt
+
+#ifndef PASTELGEOMETRY_DYNAMIC_RANGETREE_H
+#define PASTELGEOMETRY_DYNAMIC_RANGETREE_H
+
+#include "pastel/geometry/rangetree/rangetree.h"
+#include "pastel/geometry/rangetree/rangetree_count_range.h"
+
+#include <memory>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Dynamic range tree
+	/*!
+	A dynamic range tree supports inserting and erasing points
+	between range searches. The points are stored in static range
+	trees (levels) by a binary-counter decomposition: the level i
+	stores at most 2^i points, and inserting points merges the
+	occupied levels below the first free level into that level.
+	A point is then rebuilt O(log(n)) times, and the amortized
+	time to insert a point is O(log(n)^d).
+
+	Erasing a point is lazy: the point is marked erased in its
+	level, and a copy of it is inserted into a second
+	binary-counter decomposition of the erased points. A range
+	count is then the count in the levels minus the count in the
+	erased levels, and takes O(log(n)^d) time. When more than half
+	of the stored points have been erased, all of the levels are
+	compacted into a single level of the alive points. Finding the
+	point searches each of the O(log(n)) levels, so the amortized
+	time to erase a point is O(log(n)^(d + 1) + k), where k is the
+	number of stored points equivalent to it.
+
+	Range searching works through the same searchRange() and
+	countRange() as for the RangeTree.
+	*/
+	template <
+		typename Settings,
+		template <typename> class Customization = Empty_RangeTree_Customization>
+	class Dynamic_RangeTree
+	{
+	public:
+		using Tree = RangeTree<Settings, Customization>;
+
+		using Fwd = RangeTree_Fwd<Settings>;
+		PASTEL_FWD(Point);
+		PASTEL_FWD(MultiLess);
+		PASTEL_FWD(Point_ConstIterator);
+
+		//! A static range tree, and its erased points.
+		class Level
+		{
+		public:
+			//! The range tree; null for a free level.
+			std::unique_ptr<Tree> tree;
+
+			//! Whether the i:th point of the tree is erased.
+			std::vector<bool> erasedSet;
+		};
+
+		//! Constructs an empty tree.
+		/*!
+		Preconditions:
+		orders > 0
+
+		Time complexity: O(1)
+		Exception safety: strong
+		*/
+		explicit Dynamic_RangeTree(integer orders)
+		: levelSet_()
+		, erasedLevelSet_()
+		, orders_(orders)
+		, size_(0)
+		, erased_(0)
+		{
+			ENSURE_OP(orders, >, 0);
+		}
+
+		//! Swaps two trees.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void swap(Dynamic_RangeTree& that)
+		{
+			levelSet_.swap(that.levelSet_);
+			erasedLevelSet_.swap(that.erasedLevelSet_);
+			std::swap(orders_, that.orders_);
+			std::swap(size_, that.size_);
+			std::swap(erased_, that.erased_);
+		}
+
+		//! Removes all points from the tree.
+		/*!
+		Time complexity: O(n log(n)^(d - 1))
+		Exception safety: nothrow
+		*/
+		void clear()
+		{
+			levelSet_.clear();
+			erasedLevelSet_.clear();
+			size_ = 0;
+			erased_ = 0;
+		}
+
+		//! Returns whether the tree is empty.
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		//! Returns the number of points in the tree.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer size() const
+		{
+			return size_ - erased_;
+		}
+
+		//! Returns the number of strict weak orders.
+		integer orders() const
+		{
+			return orders_;
+		}
+
+		//! Returns the levels.
+		/*!
+		The level i stores at most 2^i points, some of
+		which may be erased.
+		*/
+		const std::vector<Level>& levelSet() const
+		{
+			return levelSet_;
+		}
+
+		//! Returns the levels of the erased points.
+		const std::vector<Level>& erasedLevelSet() const
+		{
+			return erasedLevelSet_;
+		}
+
+		//! Inserts points into the tree.
+		/*!
+		Time complexity:
+		O(m log(n)^d) amortized,
+		where m is the number of inserted points.
+
+		Exception safety: basic
+		*/
+		template <ranges::input_range Point_Range>
+		void insertSet(const Point_Range& pointSet)
+		{
+			std::vector<Point> newSet;
+			for (auto&& point : pointSet)
+			{
+				newSet.emplace_back(point);
+			}
+
+			size_ += newSet.size();
+			insertLevels(levelSet_, newSet);
+		}
+
+		//! Inserts a point into the tree.
+		/*!
+		This is a convenience function which calls
+		insertSet(std::vector<Point>{point}).
+		*/
+		void insert(const Point& point)
+		{
+			insertSet(std::vector<Point>{point});
+		}
+
+		//! Erases a point from the tree.
+		/*!
+		Time complexity:
+		O(log(n)^(d + 1) + k) amortized, where k is the
+		number of stored points equivalent to 'point',
+		including the erased ones. The levels are range
+		searched for the point one by one, and the search
+		in a level enumerates all of its equivalent points.
+
+		Exception safety: basic
+
+		returns:
+		Whether a point equivalent to 'point' with respect
+		to all orders was found, and erased. If there are
+		several such points, only one of them is erased.
+		*/
+		bool erase(const Point& point)
+		{
+			for (Level& level : levelSet_)
+			{
+				if (!level.tree)
+				{
+					continue;
+				}
+
+				auto begin = ranges::begin(level.tree->pointSetRange());
+
+				integer found = -1;
+				searchRange(*level.tree, point, point,
+					[&](const Point_ConstIterator& candidate)
+					{
+						integer i = candidate - begin;
+						if (found < 0 && !level.erasedSet[i])
+						{
+							found = i;
+						}
+					});
+
+				if (found >= 0)
+				{
+					level.erasedSet[found] = true;
+					++erased_;
+
+					std::vector<Point> erasedSet(1, begin[found]);
+					insertLevels(erasedLevelSet_, erasedSet);
+
+					if (2 * erased_ > size_)
+					{
+						compact();
+					}
+
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		//! Removes the erased points from the levels.
+		/*!
+		Time complexity: O(n log(n)^(d - 1))
+		Exception safety: basic
+
+		This is done automatically when more than half
+		of the stored points have been erased.
+		*/
+		void compact()
+		{
+			std::vector<Point> aliveSet;
+			aliveSet.reserve(size());
+
+			for (Level& level : levelSet_)
+			{
+				collect(level, aliveSet);
+			}
+
+			levelSet_.clear();
+			erasedLevelSet_.clear();
+			size_ = aliveSet.size();
+			erased_ = 0;
+
+			insertLevels(levelSet_, aliveSet);
+		}
+
+	private:
+		//! Appends the alive points of a level.
+		void collect(
+			const Level& level,
+			std::vector<Point>& pointSet) const
+		{
+			if (!level.tree)
+			{
+				return;
+			}
+
+			integer i = 0;
+			for (const Point& point : level.tree->pointSetRange())
+			{
+				if (!level.erasedSet[i])
+				{
+					pointSet.emplace_back(point);
+				}
+				++i;
+			}
+		}
+
+		//! Inserts points into a binary-counter decomposition.
+		/*!
+		The points are merged with the occupied levels below
+		the first free level which has room for all of them.
+		The erased points of the merged levels are not
+		dropped, since the erased levels still count them;
+		they are dropped only by compact().
+		*/
+		void insertLevels(
+			std::vector<Level>& levelSet,
+			std::vector<Point>& pointSet)
+		{
+			if (pointSet.empty())
+			{
+				return;
+			}
+
+			std::vector<bool> erasedSet(pointSet.size(), false);
+
+			integer i = 0;
+			while (true)
+			{
+				if (i == levelSet.size())
+				{
+					levelSet.emplace_back();
+				}
+
+				Level& level = levelSet[i];
+				if (!level.tree &&
+					((integer)1 << i) >= (integer)pointSet.size())
+				{
+					break;
+				}
+
+				if (level.tree)
+				{
+					integer j = 0;
+					for (const Point& point : level.tree->pointSetRange())
+					{
+						pointSet.emplace_back(point);
+						erasedSet.push_back(level.erasedSet[j]);
+						++j;
+					}
+
+					level.tree.reset();
+					level.erasedSet.clear();
+				}
+
+				++i;
+			}
+
+			// The range tree stores its points in the given order.
+			Level& level = levelSet[i];
+			level.tree = std::make_unique<Tree>(pointSet, orders_);
+			level.erasedSet.swap(erasedSet);
+		}
+
+		//! The levels of the points.
+		std::vector<Level> levelSet_;
+
+		//! The levels of copies of the erased points.
+		std::vector<Level> erasedLevelSet_;
+
+		//! The number of strict weak orders.
+		integer orders_;
+
+		//! The number of stored points, including the erased ones.
+		integer size_;
+
+		//! The number of erased points.
+		integer erased_;
+	};
+
+	//! Range search in a dynamic range tree.
+	/*!
+	Reports the points contained in the closed
+	multi-interval [min, max].
+
+	Time complexity:
+	O(k + log(n)^d) with reporting,
+	O(log(n)^d) with a Null_Output,
+	where
+	k is the number of reported points, and
+	n is the number of stored points.
+
+	returns:
+	The number of points in the range.
+	*/
+	template <
+		typename Settings,
+		template <typename> class Customization,
+		typename Point_ConstIterator_Output = Null_Output>
+	integer searchRange(
+		const Dynamic_RangeTree<Settings, Customization>& tree,
+		const typename Settings::Point& min,
+		const typename Settings::Point& max,
+		const Point_ConstIterator_Output& output = Point_ConstIterator_Output())
+	{
+		using Point_ConstIterator =
+			typename Dynamic_RangeTree<Settings, Customization>::Point_ConstIterator;
+
+		static constexpr bool DiscardOutput =
+			std::is_same<Point_ConstIterator_Output, Null_Output>::value;
+
+		integer count = 0;
+
+		if constexpr (DiscardOutput)
+		{
+			// Count without enumerating the points.
+			for (auto&& level : tree.levelSet())
+			{
+				if (level.tree)
+				{
+					count += countRange(*level.tree, min, max);
+				}
+			}
+
+			for (auto&& level : tree.erasedLevelSet())
+			{
+				if (level.tree)
+				{
+					count -= countRange(*level.tree, min, max);
+				}
+			}
+
+			return count;
+		}
+		else
+		{
+			for (auto&& level : tree.levelSet())
+			{
+				if (!level.tree)
+				{
+					continue;
+				}
+
+				auto begin = ranges::begin(level.tree->pointSetRange());
+
+				searchRange(*level.tree, min, max,
+					[&](const Point_ConstIterator& point)
+					{
+						if (!level.erasedSet[point - begin])
+						{
+							output(point);
+							++count;
+						}
+					});
+			}
+
+			return count;
+		}
+	}
+
+	//! Counts the points in a multi-interval of a dynamic range tree.
+	/*!
+	Time complexity: O(log(n)^d)
+	where
+	n is the number of stored points.
+	*/
+	template <
+		typename Settings,
+		template <typename> class Customization>
+	integer countRange(
+		const Dynamic_RangeTree<Settings, Customization>& tree,
+		const typename Settings::Point& min,
+		const typename Settings::Point& max)
+	{
+		return searchRange(tree, min, max);
+	}
+
+}
+
+#endif
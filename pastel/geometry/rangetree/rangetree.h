@@ -16,6 +16,8 @@
 #include <boost/range/algorithm/unique.hpp>
 #include <range/v3/algorithm/stable_partition.hpp>
 
+#include <tbb/parallel_invoke.h>
+
 #include <algorithm>
 #include <memory>
 #include <vector>
@@ -99,15 +101,32 @@ namespace Pastel
 		where
 		n is the size of pointSet,
 		d = orders.
+
+		Optional arguments
+		------------------
+
+		parallel (bool):
+		Whether to construct the subtrees in parallel.
+		The left and right subtrees of a node, and the
+		tree of the next order, are independent, and
+		are constructed as separate tasks when they
+		are large enough. The resulting tree does not
+		depend on this option.
+		Default: true
 		*/
-		template <ranges::input_range Point_Range>
+		template <
+			ranges::input_range Point_Range,
+			typename... ArgumentSet>
 		explicit RangeTree(
 			Point_Range pointSet,
-			integer orders)
+			integer orders,
+			ArgumentSet&&... argumentSet)
 		: RangeTree()
 		{
 			ENSURE_OP(orders, >, 0);
 
+			bool parallel = PASTEL_ARG_S(parallel, true);
+
 			orders_ = orders;
 			
 			std::vector<Point_Iterator> iteratorSet;
@@ -138,7 +157,7 @@ namespace Pastel
 
 			boost::sort(iteratorSet, lastLess);
 
-			root_ = construct(nullptr, false, 0, iteratorSet);
+			root_ = construct(nullptr, false, 0, iteratorSet, parallel);
 		}
 
 		//! Destructs the tree.
@@ -236,12 +255,31 @@ namespace Pastel
 			return end_.get();
 		}
 
+		//! Returns the points.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+
+		returns:
+		A random-access range of the points, in the
+		order in which they were given to the constructor.
+		*/
+		ranges::subrange<Point_ConstIterator> pointSetRange() const
+		{
+			return ranges::subrange<Point_ConstIterator>(
+				pointSet_.cbegin(), pointSet_.cend());
+		}
+
 	private:
+		//! Point-sets smaller than this are constructed in a single task.
+		static constexpr integer ParallelThreshold = 1 << 12;
+
 		Node_Iterator construct(
 			Node_Iterator parent,
 			bool right,
 			integer depth,
-			std::vector<Point_Iterator>& pointSet)
+			std::vector<Point_Iterator>& pointSet,
+			bool parallel)
 		{
 			ASSERT_OP(depth, >=, 0);
 			ASSERT_OP(depth, <, orders() - 1);
@@ -293,6 +331,61 @@ namespace Pastel
 				}
 			}
 
+			bool parallelNode = parallel &&
+				(integer)pointSet.size() >= ParallelThreshold;
+
+			std::vector<Point_Iterator> sortedSet(pointSet);
+
+			auto constructDown = [&](std::vector<Point_Iterator>& downSet)
+			{
+				// Recurse to the down child. It is important that we
+				// do this with a copy of the 'pointSet', which is
+				// ordered by the last order.
+				node->down() = construct(nullptr, false, depth + 1, downSet, parallel);
+			};
+
+			auto constructChildren = [&]()
+			{
+				constructSplit(node, depth, pointSet, sortedSet, parallel);
+			};
+
+			if (depth < orders() - 2)
+			{
+				if (parallelNode)
+				{
+					// The down tree and the children are independent.
+					std::vector<Point_Iterator> downSet(pointSet);
+					tbb::parallel_invoke(
+						[&]() {constructDown(downSet);},
+						constructChildren);
+				}
+				else
+				{
+					// Reuse the 'sortedSet', which has 
+					// not been sorted yet.
+					constructDown(sortedSet);
+					constructChildren();
+				}
+			}
+			else
+			{
+				constructChildren();
+			}
+
+			// Return the node.
+			return node;
+		}
+
+		//! Splits a node, and constructs its children.
+		void constructSplit(
+			Node_Iterator node,
+			integer depth,
+			std::vector<Point_Iterator>& pointSet,
+			std::vector<Point_Iterator>& sortedSet,
+			bool parallel)
+		{
+			MultiLess multiLess;
+
 			// Sort the points in lexicographical order
 			// with respect to <_depth.
 
@@ -313,16 +406,6 @@ namespace Pastel
 					!xLess(right, left);
 			};
 
-			std::vector<Point_Iterator> sortedSet(pointSet);
-
-			if (depth < orders() - 2)
-			{
-				// Recurse to the down child. It is important that we
-				// do this with a copy of the 'pointSet'; here with
-				// 'sortedSet' which has not been sorted yet.
-				node->down() = construct(nullptr, false, depth + 1, sortedSet);
-			}
-
 			// Sort the points with respect to <_depth.
 			boost::sort(sortedSet, xLess);
 
@@ -361,18 +444,32 @@ namespace Pastel
 				// Clang/C2 v141 toolset.
 				auto leftEnd = ranges::stable_partition(pointSet, lessMedian);
 
-				// Recurse to the left child.
+				std::vector<Point_Iterator> leftSet(
+					pointSet.begin(), leftEnd);
+				std::vector<Point_Iterator> rightSet(
+					leftEnd, pointSet.end());
+
+				// The children write the fractional cascading 
+				// links of this node to different fields, and
+				// so can be constructed concurrently.
+				auto constructLeft = [&]()
 				{
-					std::vector<Point_Iterator> leftSet(
-						pointSet.begin(), leftEnd);
-					node->child(false) = construct(node, false, depth, leftSet);
-				}
+					node->child(false) = construct(node, false, depth, leftSet, parallel);
+				};
+
+				auto constructRight = [&]()
+				{
+					node->child(true) = construct(node, true, depth, rightSet, parallel);
+				};
 
-				// Recurse to the right child.
+				if (parallel && (integer)pointSet.size() >= ParallelThreshold)
+				{
+					tbb::parallel_invoke(constructLeft, constructRight);
+				}
+				else
 				{
-					std::vector<Point_Iterator> rightSet(
-						leftEnd, pointSet.end());
-					node->child(true) = construct(node, true, depth, rightSet);
+					constructLeft();
+					constructRight();
 				}
 			}
 			else
@@ -387,9 +484,6 @@ namespace Pastel
 				// reported or not.
 				node->split_ = *pointSet.begin();
 			}
-
-			// Return the node.
-			return node;
 		}
 		
 		void clear(Node_Iterator node)
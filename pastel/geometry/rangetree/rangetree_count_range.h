@@ -0,0 +1,124 @@
+// Description: Range counting in a range tree
+// Documentation: rangetree_search_range.txt
+
+#ifndef PASTELGEOMETRY_RANGETREE_COUNT_RANGE_H
+#define PASTELGEOMETRY_RANGETREE_COUNT_RANGE_H
+
+#include "pastel/geometry/rangetree/rangetree_search_range.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Counts the points in a multi-interval of a range tree.
+	/*!
+	Returns the number of points contained in the closed
+	multi-interval [min, max].
+
+	Time complexity:
+	O(log(tree.size())^(tree.orders() - 1))
+
+	The points are not enumerated; the count of each
+	bottom node is obtained from the difference of the
+	fractional cascading indices.
+	*/
+	template <
+		typename Settings,
+		template <typename> class Customization>
+	integer countRange(
+		const RangeTree<Settings, Customization>& tree,
+		const typename Settings::Point& min,
+		const typename Settings::Point& max)
+	{
+		return searchRange(tree, min, max);
+	}
+
+	//! Counts the points in many multi-intervals of a range tree.
+	/*!
+	Preconditions:
+	minSet and maxSet have the same size.
+
+	minSet (Random-access range of Points):
+	The minimum corners of the closed multi-intervals.
+
+	maxSet (Random-access range of Points):
+	The maximum corners of the closed multi-intervals.
+
+	returns (std::vector<integer>):
+	The i:th element is the number of points in
+	the multi-interval [minSet[i], maxSet[i]].
+
+	Optional arguments
+	------------------
+
+	parallel (bool):
+	Whether to distribute the queries over threads.
+	Default: true
+
+	grainSize (integer >= 1):
+	The number of consecutive queries under which a
+	range of queries is not divided between threads
+	any further.
+	Default: 256
+
+	Time complexity:
+	O(m log(tree.size())^(tree.orders() - 1))
+	where
+	m is the number of queries.
+
+	A range tree is only read during a search, so the
+	queries are distributed over threads by work-stealing.
+	*/
+	template <
+		typename Settings,
+		template <typename> class Customization,
+		ranges::random_access_range Min_Range,
+		ranges::random_access_range Max_Range,
+		typename... ArgumentSet>
+	std::vector<integer> countAllRange(
+		const RangeTree<Settings, Customization>& tree,
+		const Min_Range& minSet,
+		const Max_Range& maxSet,
+		ArgumentSet&&... argumentSet)
+	{
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer grainSize = PASTEL_ARG_S(grainSize, 256);
+		ENSURE_OP(grainSize, >=, 1);
+
+		integer n = ranges::distance(minSet);
+		ENSURE_OP(ranges::distance(maxSet), ==, n);
+
+		auto minBegin = ranges::begin(minSet);
+		auto maxBegin = ranges::begin(maxSet);
+
+		std::vector<integer> countSet(n, 0);
+
+		using Block = tbb::blocked_range<integer>;
+
+		auto count = [&](const Block& block)
+		{
+			for (integer i = block.begin(); i < block.end(); ++i)
+			{
+				countSet[i] = countRange(tree, minBegin[i], maxBegin[i]);
+			}
+		};
+
+		if (parallel)
+		{
+			tbb::parallel_for(Block(0, n, grainSize), count);
+		}
+		else
+		{
+			count(Block(0, n, grainSize));
+		}
+
+		return countSet;
+	}
+
+}
+
+#endif
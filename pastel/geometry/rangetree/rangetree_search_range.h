@@ -127,7 +127,7 @@ namespace Pastel
 
 				ASSERT(start == n ||
 					!multiLess(*entrySet[start].point(), min, tree.orders() - 1));
-				ASSERT(start == n || 
+				ASSERT(start == end || 
 					!multiLess(max, *entrySet[end - 1].point(), tree.orders() - 1));
 
 				// Report, in the lowest tree, all points which
@@ -0,0 +1,194 @@
+// Description: Batch nearest neighbors searching
+// Documentation: nearest_neighbors.txt
+
+#ifndef PASTELGEOMETRY_SEARCH_ALL_NEAREST_H
+#define PASTELGEOMETRY_SEARCH_ALL_NEAREST_H
+
+// Template concepts
+
+#include "pastel/sys/indicator/indicator_concept.h"
+#include "pastel/sys/point/point_concept.h"
+#include "pastel/math/norm/norm_concept.h"
+#include "pastel/geometry/nearestset/nearestset_concept.h"
+
+// Template defaults
+
+#include "pastel/math/norm/euclidean_norm.h"
+#include "pastel/sys/indicator/all_indicator.h"
+
+// Implementation requirements
+
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/coherent_order.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Finds the nearest neighbors of a set of points in a nearest-set.
+	/*!
+	nearestSet (NearestSet):
+	The nearest-set in which to search neighbors in.
+
+	querySet (Random-access range of points):
+	The points for which to search neighbors for.
+
+	Optional arguments
+	------------------
+
+	accept (Indicator(PointId)):
+	An indicator which decides whether to accept a point
+	as a neighbor or not.
+	Default: allIndicator()
+
+	queryAccept (Function(integer) -> Indicator(PointId)):
+	A function which returns the accept-indicator for
+	the i:th query. Overrides 'accept' when given.
+	Default: [&](integer i) {return accept;}
+
+	kNearest (integer >= 0):
+	The number of nearest neighbors to search for.
+	Default: 1
+
+	maxDistance2 (Distance):
+	The distance after which points are not considered neighbors
+	anymore. Can be set to (Real)Infinity().
+	Default: norm((Real)Infinity())
+
+	queryMaxDistance2 (Function(integer) -> Distance):
+	A function which returns the maximum distance for
+	the i:th query. Overrides 'maxDistance2' when given.
+	Default: [&](integer i) {return maxDistance2;}
+
+	norm (Norm):
+	The norm used to measure distance.
+
+	parallel (bool):
+	Whether to distribute the queries over threads.
+	Default: true
+
+	grainSize (integer >= 1):
+	The number of consecutive queries under which a
+	range of queries is not divided between threads
+	any further.
+	Default: 64
+
+	returns (std::vector<std::pair<Distance, PointId>>)
+	---------------------------------------------------
+
+	A dense (n x kNearest)-matrix, where n is the number
+	of queries, stored in row-major order. The row i
+	contains the neighbors of the i:th query in increasing
+	order of distance (in terms of the norm bijection).
+	Missing neighbors are stored as
+	(norm((Real)Infinity()), *begin(nearestSet.pointSet())).
+
+	The queries are processed in a spatially coherent order
+	(see coherentOrder()), so that consecutive queries on
+	the same thread reuse the same parts of the nearest-set.
+	The threads balance their work by work-stealing. The
+	result does not depend on the number of threads.
+	*/
+	template <
+		NearestSet_Concept NearestSet,
+		ranges::random_access_range Query_Range,
+		typename... ArgumentSet
+	>
+	auto searchAllNearest(
+		const NearestSet& nearestSet,
+		const Query_Range& querySet,
+		ArgumentSet&&... argumentSet)
+	{
+		using std::begin;
+
+		using PointId = PointSet_PointId<NearestSet>;
+		using Search_Point = ranges::range_value_t<Query_Range>;
+		using Real = Point_Real<Search_Point>;
+
+		PASTEL_CONCEPT_CHECK(Search_Point, Point_Concept);
+
+		auto&& accept =
+			PASTEL_ARG_C1(accept, allIndicator(), Indicator_Concept, PointId);
+
+		auto&& queryAccept =
+			PASTEL_ARG_S(queryAccept, [&](integer i) {return accept;});
+
+		auto&& norm =
+			PASTEL_ARG_C(norm, Euclidean_Norm<Real>(), Norm_Concept);
+
+		using Distance = decltype(norm());
+
+		integer kNearest = PASTEL_ARG_S(kNearest, 1);
+		Distance maxDistance2 = PASTEL_ARG_S(maxDistance2, norm((Real)Infinity()));
+
+		auto&& queryMaxDistance2 =
+			PASTEL_ARG_S(queryMaxDistance2, [&](integer i) {return maxDistance2;});
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer grainSize = PASTEL_ARG_S(grainSize, 64);
+
+		ENSURE_OP(kNearest, >=, 0);
+		ENSURE_OP(grainSize, >=, 1);
+
+		using Result = std::pair<Distance, PointId>;
+		const Result notFound(norm((Real)Infinity()), *begin(nearestSet.pointSet()));
+
+		auto queryBegin = ranges::begin(querySet);
+		integer n = ranges::distance(querySet);
+
+		std::vector<Result> resultSet(n * kNearest, notFound);
+		if (n == 0 || kNearest == 0)
+		{
+			return resultSet;
+		}
+
+		std::vector<integer> orderSet = coherentOrder(querySet);
+
+		using Block = tbb::blocked_range<integer>;
+
+		auto search = [&](const Block& block)
+		{
+			for (integer t = block.begin(); t < block.end(); ++t)
+			{
+				integer i = orderSet[t];
+				Result* row = resultSet.data() + i * kNearest;
+
+				integer j = 0;
+				auto report = [&](
+					const Distance& distance,
+					const PointId& pointId)
+				{
+					row[j] = Result(distance, pointId);
+					++j;
+				};
+
+				searchNearest(
+					nearestSet,
+					queryBegin[i],
+					PASTEL_TAG(report), report,
+					PASTEL_TAG(accept), queryAccept(i),
+					PASTEL_TAG(norm), norm,
+					PASTEL_TAG(kNearest), kNearest,
+					PASTEL_TAG(maxDistance2), queryMaxDistance2(i));
+			}
+		};
+
+		if (parallel)
+		{
+			tbb::parallel_for(Block(0, n, grainSize), search);
+		}
+		else
+		{
+			search(Block(0, n, grainSize));
+		}
+
+		return resultSet;
+	}
+
+}
+
+#endif
@@ -0,0 +1,384 @@
+// Description: Batch time-windowed nearest neighbors searching in a TdTree
+// Documentation: nearest_neighbors.txt
+
+#ifndef PASTELGEOMETRY_SEARCH_ALL_TEMPORAL_NEAREST_H
+#define PASTELGEOMETRY_SEARCH_ALL_TEMPORAL_NEAREST_H
+
+// Template concepts
+
+#include "pastel/sys/indicator/indicator_concept.h"
+#include "pastel/math/norm/norm_concept.h"
+
+// Template defaults
+
+#include "pastel/math/norm/euclidean_norm.h"
+#include "pastel/sys/indicator/all_indicator.h"
+
+// Template requirements
+
+#include "pastel/geometry/tdtree/tdtree_fwd.h"
+
+// Implementation requirements
+
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/count_nearest.h"
+#include "pastel/geometry/coherent_order.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cmath>
+#include <vector>
+
+namespace Pastel
+{
+
+	namespace AllTemporalNearest_
+	{
+
+		//! Calls query(i, searchPoint, nearestSet) for all points of a TdTree.
+		/*!
+		The i:th query is the i:th point of the tree in time-order,
+		and its nearest-set is restricted to the time-window
+		[t_i - timeWindow, t_i + timeWindow].
+
+		The points are divided into blocks of consecutive
+		points in time-order. The windows of the queries in a
+		block overlap almost completely, and so the queries
+		visit mostly the same nodes and the same fractional
+		cascading entries; the queries in a block are then
+		processed in a spatially coherent order (see coherentOrder()).
+		The blocks are distributed over threads by work-stealing.
+		*/
+		template <
+			typename TdTree,
+			typename Query
+		>
+		void forAllQueries(
+			const TdTree& tree,
+			const typename TdTree::Real& timeWindow,
+			integer blockSize,
+			bool parallel,
+			const Query& query)
+		{
+			using Real = typename TdTree::Real;
+
+			ENSURE_OP(timeWindow, >=, 0);
+			ENSURE_OP(blockSize, >=, 1);
+
+			integer n = tree.points();
+			if (n == 0)
+			{
+				return;
+			}
+
+			auto pointBegin = tree.begin();
+			auto fullSet = kdTreeNearestSet(tree);
+			using Search_Point = decltype(fullSet.asPoint(pointBegin));
+
+			integer blocks = (n + blockSize - 1) / blockSize;
+
+			using Block = tbb::blocked_range<integer>;
+
+			auto search = [&](const Block& blockRange)
+			{
+				std::vector<Search_Point> searchSet;
+				searchSet.reserve(blockSize);
+
+				for (integer b = blockRange.begin(); b < blockRange.end(); ++b)
+				{
+					integer begin = b * blockSize;
+					integer end = std::min(begin + blockSize, n);
+
+					searchSet.clear();
+					for (integer i = begin; i < end; ++i)
+					{
+						searchSet.emplace_back(
+							fullSet.asPoint(pointBegin + i));
+					}
+
+					for (integer t : coherentOrder(searchSet))
+					{
+						integer i = begin + t;
+						const Real& time = pointBegin[i].time();
+
+						// The nearest-set takes half-open time-intervals;
+						// the window is closed.
+						Vector<Real, 2> window(
+							time - timeWindow,
+							std::nextafter(time + timeWindow, (Real)Infinity()));
+
+						query(
+							i,
+							searchSet[t],
+							kdTreeNearestSet(tree, PASTEL_TAG(intervalSequence), window));
+					}
+				}
+			};
+
+			if (parallel)
+			{
+				tbb::parallel_for(Block(0, blocks, 1), search);
+			}
+			else
+			{
+				search(Block(0, blocks, 1));
+			}
+		}
+
+	}
+
+	//! Finds the nearest neighbors of all points of a TdTree in time-windows.
+	/*!
+	tree (TdTree):
+	The tree whose points to search neighbors for,
+	and in which to search the neighbors in.
+
+	timeWindow (Real >= 0):
+	The half-width of the time-window. The neighbors of
+	a point at time t are searched from the points whose
+	time is in [t - timeWindow, t + timeWindow].
+
+	Optional arguments
+	------------------
+
+	accept (Indicator(ConstIterator)):
+	An indicator which decides whether to accept a point
+	as a neighbor or not.
+	Default: allIndicator()
+
+	excludeSelf (bool):
+	Whether to reject the query point itself as a neighbor.
+	Default: true
+
+	kNearest (integer >= 0):
+	The number of nearest neighbors to search for.
+	Default: 1
+
+	maxDistance2 (Distance):
+	The distance after which points are not considered neighbors
+	anymore. Can be set to (Real)Infinity().
+	Default: norm((Real)Infinity())
+
+	norm (Norm):
+	The norm used to measure distance.
+
+	parallel (bool):
+	Whether to distribute the queries over threads.
+	Default: true
+
+	blockSize (integer >= 1):
+	The number of consecutive points in time-order
+	which are processed together by a thread.
+	Default: 256
+
+	returns (std::vector<std::pair<Distance, ConstIterator>>)
+	---------------------------------------------------------
+
+	A dense (n x kNearest)-matrix, where n = tree.points(),
+	stored in row-major order. The row i contains the neighbors
+	of the point tree.begin() + i (the i:th point in time-order)
+	in increasing order of distance (in terms of the norm
+	bijection). Missing neighbors are stored as
+	(norm((Real)Infinity()), tree.end()). The result does
+	not depend on the number of threads.
+
+	Time-windowed neighbors are needed, for example, in the
+	estimation of temporal entropies and mutual informations:
+	the distances to the k:th neighbors in the joint space are
+	given as the per-query radii to countAllTemporalNearest()
+	on the trees of the marginal spaces. Since the trees are
+	ordered by time, the row i of each refers to the same sample,
+	provided the trees were constructed with the same time-set.
+	*/
+	template <
+		typename TdTree,
+		typename... ArgumentSet
+	>
+	requires IsTdTree<TdTree>::value
+	auto searchAllTemporalNearest(
+		const TdTree& tree,
+		const typename TdTree::Real& timeWindow,
+		ArgumentSet&&... argumentSet)
+	{
+		using Real = typename TdTree::Real;
+		using ConstIterator = typename TdTree::ConstIterator;
+
+		auto&& accept =
+			PASTEL_ARG_C1(accept, allIndicator(), Indicator_Concept, ConstIterator);
+
+		bool excludeSelf = PASTEL_ARG_S(excludeSelf, true);
+
+		auto&& norm =
+			PASTEL_ARG_C(norm, Euclidean_Norm<Real>(), Norm_Concept);
+
+		using Distance = decltype(norm());
+
+		integer kNearest = PASTEL_ARG_S(kNearest, 1);
+		Distance maxDistance2 = PASTEL_ARG_S(maxDistance2, norm((Real)Infinity()));
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer blockSize = PASTEL_ARG_S(blockSize, 256);
+
+		ENSURE_OP(kNearest, >=, 0);
+
+		using Result = std::pair<Distance, ConstIterator>;
+		const Result notFound(norm((Real)Infinity()), tree.end());
+
+		integer n = tree.points();
+		std::vector<Result> resultSet(n * kNearest, notFound);
+		if (n == 0 || kNearest == 0)
+		{
+			return resultSet;
+		}
+
+		auto query = [&](
+			integer i,
+			const auto& searchPoint,
+			const auto& nearestSet)
+		{
+			ConstIterator self = tree.begin() + i;
+			Result* row = resultSet.data() + i * kNearest;
+
+			integer j = 0;
+			searchNearest(
+				nearestSet,
+				searchPoint,
+				PASTEL_TAG(report), [&](
+					const Distance& distance,
+					const ConstIterator& point)
+				{
+					row[j] = Result(distance, point);
+					++j;
+				},
+				PASTEL_TAG(reportMissing), false,
+				PASTEL_TAG(accept), [&](const ConstIterator& point)
+				{
+					return (!excludeSelf || point != self) && accept(point);
+				},
+				PASTEL_TAG(norm), norm,
+				PASTEL_TAG(kNearest), kNearest,
+				PASTEL_TAG(maxDistance2), maxDistance2);
+		};
+
+		AllTemporalNearest_::forAllQueries(
+			tree, timeWindow, blockSize, parallel, query);
+
+		return resultSet;
+	}
+
+	//! Counts the points of a TdTree in norm-balls and time-windows.
+	/*!
+	tree (TdTree):
+	The tree whose points to use as centers,
+	and in which to count the points in.
+
+	timeWindow (Real >= 0):
+	The half-width of the time-window. The points are
+	counted around a point at time t from the points
+	whose time is in [t - timeWindow, t + timeWindow].
+
+	returns (std::vector<integer>):
+	The i:th element is the number of accepted points
+	under distance queryMaxDistance2(i) from the point
+	tree.begin() + i (the i:th point in time-order),
+	in its time-window.
+
+	Optional arguments
+	------------------
+
+	accept (Indicator(ConstIterator)):
+	An indicator which decides whether to accept a point
+	as a neighbor or not.
+	Default: allIndicator()
+
+	excludeSelf (bool):
+	Whether to reject the center point itself.
+	Default: true
+
+	maxDistance2 (Distance):
+	The distance after which points are not considered neighbors
+	anymore. Can be set to (Real)Infinity().
+	Default: norm((Real)Infinity())
+
+	queryMaxDistance2 (Function(integer) -> Distance):
+	A function which returns the maximum distance for
+	the i:th point. Overrides 'maxDistance2' when given.
+	Default: [&](integer i) {return maxDistance2;}
+
+	norm (Norm):
+	The norm used to measure distance.
+
+	parallel (bool):
+	Whether to distribute the queries over threads.
+	Default: true
+
+	blockSize (integer >= 1):
+	The number of consecutive points in time-order
+	which are processed together by a thread.
+	Default: 256
+
+	See searchAllTemporalNearest() for the order of processing.
+	*/
+	template <
+		typename TdTree,
+		typename... ArgumentSet
+	>
+	requires IsTdTree<TdTree>::value
+	std::vector<integer> countAllTemporalNearest(
+		const TdTree& tree,
+		const typename TdTree::Real& timeWindow,
+		ArgumentSet&&... argumentSet)
+	{
+		using Real = typename TdTree::Real;
+		using ConstIterator = typename TdTree::ConstIterator;
+
+		auto&& accept =
+			PASTEL_ARG_C1(accept, allIndicator(), Indicator_Concept, ConstIterator);
+
+		bool excludeSelf = PASTEL_ARG_S(excludeSelf, true);
+
+		auto&& norm =
+			PASTEL_ARG_C(norm, Euclidean_Norm<Real>(), Norm_Concept);
+
+		using Distance = decltype(norm());
+
+		Distance maxDistance2 =
+			PASTEL_ARG_C(maxDistance2, norm((Real)Infinity()), Distance_Concept);
+
+		auto&& queryMaxDistance2 =
+			PASTEL_ARG_S(queryMaxDistance2, [&](integer i) {return maxDistance2;});
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer blockSize = PASTEL_ARG_S(blockSize, 256);
+
+		std::vector<integer> countSet(tree.points(), 0);
+
+		auto query = [&](
+			integer i,
+			const auto& searchPoint,
+			const auto& nearestSet)
+		{
+			ConstIterator self = tree.begin() + i;
+
+			countSet[i] = countNearest(
+				nearestSet,
+				searchPoint,
+				PASTEL_TAG(accept), [&](const ConstIterator& point)
+				{
+					return (!excludeSelf || point != self) && accept(point);
+				},
+				PASTEL_TAG(norm), norm,
+				PASTEL_TAG(maxDistance2), queryMaxDistance2(i));
+		};
+
+		AllTemporalNearest_::forAllQueries(
+			tree, timeWindow, blockSize, parallel, query);
+
+		return countSet;
+	}
+
+}
+
+#endif
@@ -21,10 +21,28 @@
 // Implementation requirements
 
 #include "pastel/geometry/distance/distance_point_point.h"
+#include "pastel/math/distance/block_distance.h"
+
+#include <concepts>
+#include <vector>
 
 namespace Pastel
 {
 
+	namespace SearchNearby_
+	{
+
+		template <typename NearestSet, typename PointId_Range, typename Real>
+		concept HasCoordinateBlock_ = requires(
+			const NearestSet& nearestSet,
+			const PointId_Range& pointIdSet)
+		{
+			{nearestSet.coordinateBlock(pointIdSet)} ->
+				std::same_as<CoordinateBlock<Real>>;
+		};
+
+	}
+
 	//! Finds the nearest neighbors of a point in a nearest-set.
 	/*!
 	nearestSet (NearestSet):
@@ -106,6 +124,11 @@ namespace Pastel
 
 		using Distance = RemoveCvRef<decltype(norm())>;
 
+		// Whether the distances to the points of a node can
+		// be computed with blockDistance().
+		static constexpr bool NormHasBlockDistance =
+			HasBlockDistance<decltype(norm)>;
+
 		const Distance maxDistance2 = PASTEL_ARG_C(
 			maxDistance2, Distance((Real)Infinity()), Distance_Concept);
 		
@@ -119,25 +142,58 @@ namespace Pastel
 			return;
 		}
 
+		// Holds the distances to the points of a node
+		// when they are computed with blockDistance().
+		std::vector<Real> blockDistanceSet;
+
 		auto searchBruteForce = [&](
 			const auto& pointIdSet,
 			Distance cullDistance2)
 		{
+			using PointId_Range = RemoveCvRef<decltype(pointIdSet)>;
+
+			// If the coordinates of the points are contiguous, 
+			// compute the distances for the whole node at once.
+			static constexpr bool UseBlockDistance = 
+				NormHasBlockDistance &&
+				SearchNearby_::HasCoordinateBlock_<NearestSet, PointId_Range, Real>;
+
+			if constexpr (UseBlockDistance)
+			{
+				auto block = nearestSet.coordinateBlock(pointIdSet);
+				if (blockDistanceSet.size() < block.n)
+				{
+					blockDistanceSet.resize(block.n);
+				}
+
+				blockDistance(norm, searchPoint, block, blockDistanceSet.data());
+			}
+
+			integer j = 0;
 			for (auto&& pointId : pointIdSet)
 			{
 				// Compute the distance from the node-point
 				// to the search-point.
-				Distance currentDistance2 = 
-					distance2(
-						nearestSet.asPoint(pointId),
-						searchPoint,
-						PASTEL_TAG(norm),
-						norm,
-						PASTEL_TAG(keepGoing),
-						// Stop computing the distance if it exceeds
-						// the culling distance.
-						[&](auto&& that) {return that < cullDistance2;}
-					);
+				Distance currentDistance2 = norm();
+				if constexpr (UseBlockDistance)
+				{
+					currentDistance2 = norm[blockDistanceSet[j]];
+					++j;
+				}
+				else
+				{
+					currentDistance2 = 
+						distance2(
+							nearestSet.asPoint(pointId),
+							searchPoint,
+							PASTEL_TAG(norm),
+							norm,
+							PASTEL_TAG(keepGoing),
+							// Stop computing the distance if it exceeds
+							// the culling distance.
+							[&](auto&& that) {return that < cullDistance2;}
+						);
+				}
 
 				// Reject the point if the user rejects it or it
 				// is farther than the culling distance.
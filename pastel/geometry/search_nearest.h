@@ -143,7 +143,8 @@ namespace Pastel
 		const integer resultSetSize = std::min(kNearest, n);
 
 		// This set contains the points currently closest
-		// to the search-point. 
+		// to the search-point. For a small k the set is a
+		// sorted array, and otherwise a heap.
 		using ResultSet = RankedSet<Result, Less>;
 		// There will be at most k elements in this set.
 		ResultSet resultSet(resultSetSize);
@@ -177,7 +178,7 @@ namespace Pastel
 		if (neighbors == kNearest)
 		{
 			// Get the k:th nearest neighbor;
-			// it is at the top of the heap.
+			// it is at the top of the set.
 			farthest = resultSet.top();
 		}
 
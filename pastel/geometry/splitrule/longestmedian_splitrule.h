@@ -43,7 +43,7 @@ namespace Pastel
 			// Get the positions of the points along the splitting axis.
 
 			std::vector<Real> positionSet;
-			positionSet.reserve(rangeSize(pointSet));
+			positionSet.reserve(rangeDistance(pointSet));
 
 			for (auto&& point : pointSet)
 			{
@@ -0,0 +1,612 @@
+// Description: Dynamic temporal kd-tree
+// Documentation: tdtree.txt
+
+#ifndef PASTELGEOMETRY_DYNAMIC_TDTREE_H
+#define PASTELGEOMETRY_DYNAMIC_TDTREE_H
+
+#include "pastel/geometry/tdtree/tdtree.h"
+#include "pastel/geometry/nearestset/kdtree_nearestset.h"
+
+#include "pastel/sys/locator/location_set.h"
+#include "pastel/sys/range/interval_range.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Dynamic temporal kd-tree
+	/*!
+	A dynamic temporal kd-tree stores a stream of space-time
+	points, to which new points are appended at the end of time,
+	and from which the oldest points expire. The points are stored
+	in a sequence of static temporal kd-trees (buckets) by the
+	logarithmic method of Bentley and Saxe. Since the points are
+	appended in time-order, each bucket covers a contiguous
+	time-range, and the buckets are in time-order.
+
+	Appending m points creates a new bucket, which is then merged
+	with the previous bucket as long as the previous bucket has at
+	most twice as many points. The sizes of the buckets then at least
+	double towards the older buckets, so that there are O(log(n))
+	buckets, and a point is moved to a new bucket O(log(n)) times.
+	The amortized time to append a point is O(log(n)^2).
+
+	Expiring points removes the buckets whose points have all
+	expired, and excludes the expired points of the oldest remaining
+	bucket from the queries by their time. When less than half of the
+	points of that bucket are alive, the bucket is rebuilt from its
+	alive points. The amortized time to expire a point is O(log(n)).
+
+	A nearest-neighbor query searches each bucket in turn, and
+	shares the culling distance between the buckets. Queries are
+	read-only, and can be run concurrently, as long as the tree is
+	not modified at the same time.
+	*/
+	template <
+		typename Settings,
+		template <typename> class Customization = Empty_TdTree_Customization>
+	class Dynamic_TdTree
+	{
+	public:
+		using Tree = TdTree<Settings, Customization>;
+
+		using Real = typename Tree::Real;
+		using Point = typename Tree::Point;
+		using Locator = typename Tree::Locator;
+		using ConstIterator = typename Tree::ConstIterator;
+		using Point_ConstIterator = ConstIterator;
+
+		static constexpr int N = Tree::N;
+
+		//! Constructs an empty tree.
+		/*!
+		Time complexity: O(1)
+		Exception safety: strong
+		*/
+		explicit Dynamic_TdTree(const Locator& locator = Locator())
+		: bucketSet_()
+		, pointSet_(1, ConstIterator())
+		, first_(0)
+		, locator_(locator)
+		, expiryTime_(-(Real)Infinity())
+		, lastTime_(-(Real)Infinity())
+		, appended_(0)
+		{
+		}
+
+		//! Swaps two trees.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void swap(Dynamic_TdTree& that)
+		{
+			using std::swap;
+
+			bucketSet_.swap(that.bucketSet_);
+			pointSet_.swap(that.pointSet_);
+			swap(first_, that.first_);
+			swap(locator_, that.locator_);
+			swap(expiryTime_, that.expiryTime_);
+			swap(lastTime_, that.lastTime_);
+			swap(appended_, that.appended_);
+		}
+
+		//! Removes all points from the tree.
+		/*!
+		Time complexity: O(n log(n))
+		Exception safety: nothrow
+
+		The expiry time and the time of the last
+		point are preserved, so that the stream
+		continues from where it was.
+		*/
+		void clear()
+		{
+			bucketSet_.clear();
+			pointSet_.assign(1, ConstIterator());
+			first_ = 0;
+		}
+
+		//! Returns whether the tree has no alive points.
+		bool empty() const
+		{
+			return points() == 0;
+		}
+
+		//! Returns the number of alive points.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer points() const
+		{
+			return pointSet_.size() - 1 - first_;
+		}
+
+		//! Returns the number of buckets.
+		integer buckets() const
+		{
+			return bucketSet_.size();
+		}
+
+		//! Returns the i:th bucket.
+		/*!
+		Preconditions:
+		0 <= i < buckets()
+
+		The buckets are in time-order. The oldest bucket
+		may contain expired points; they are excluded by
+		their time, see expiryTime().
+		*/
+		const Tree& bucket(integer i) const
+		{
+			PENSURE_RANGE(i, 0, buckets());
+			return bucketSet_[i];
+		}
+
+		//! Returns the spatial dimension.
+		integer dimension() const
+		{
+			return locator_.n();
+		}
+
+		//! Returns the locator.
+		const Locator& locator() const
+		{
+			return locator_;
+		}
+
+		//! Returns the time before which the points have expired.
+		const Real& expiryTime() const
+		{
+			return expiryTime_;
+		}
+
+		//! Returns the time of the last appended point.
+		/*!
+		If no point has been appended, -(Real)Infinity().
+		*/
+		const Real& lastTime() const
+		{
+			return lastTime_;
+		}
+
+		//! Returns the alive points in time-order.
+		/*!
+		returns:
+		A random-access range of ConstIterators.
+		*/
+		auto pointSetRange() const
+		{
+			return ranges::subrange(
+				pointSet_.begin() + first_,
+				pointSet_.end() - 1);
+		}
+
+		//! Returns the point which is returned for a missing neighbor.
+		/*!
+		This is a value-initialized ConstIterator, which
+		is never equal to the iterator of an alive point.
+		*/
+		ConstIterator notFound() const
+		{
+			return ConstIterator();
+		}
+
+		//! Appends points at the end of time.
+		/*!
+		Preconditions:
+		The times are at least lastTime().
+
+		Time complexity:
+		O(m log(n)^2) amortized,
+		where m is the number of appended points.
+
+		Exception safety: basic
+
+		Optional arguments
+		------------------
+
+		timeSet (Range of Real):
+		Time-points for the point-set.
+		Default: equal to the number of points appended
+		before, i.e. 0, 1, 2,... over the whole stream.
+		*/
+		template <
+			PointSet_Concept PointSet_,
+			typename... ArgumentSet
+		>
+		requires (sizeof...(ArgumentSet) % 2 == 0)
+		void append(
+			const PointSet_& pointSet,
+			ArgumentSet&&... argumentSet)
+		{
+			auto&& timeSet = PASTEL_ARG_S(timeSet,
+				intervalRange(appended_, (integer)Infinity()));
+
+			std::vector<Point> newPointSet;
+			std::vector<Real> newTimeSet;
+			for (auto&& element : zipSet(pointSet, timeSet))
+			{
+				newPointSet.emplace_back(pointPointId(element.first));
+				newTimeSet.emplace_back(element.second);
+			}
+
+			if (newPointSet.empty())
+			{
+				return;
+			}
+
+			for (const Real& time : newTimeSet)
+			{
+				ENSURE(time >= lastTime_);
+			}
+
+			appended_ += newPointSet.size();
+			lastTime_ = *std::max_element(newTimeSet.begin(), newTimeSet.end());
+
+			// Merge the new points with the newest buckets
+			// while the sizes of the buckets stay balanced.
+			integer merged = 0;
+			while (!bucketSet_.empty() &&
+				alive(bucketSet_.back()) <= 2 * (integer)newPointSet.size())
+			{
+				const Tree& previous = bucketSet_.back();
+				merged += alive(previous);
+
+				std::vector<Point> mergedPointSet;
+				std::vector<Real> mergedTimeSet;
+				collect(previous, mergedPointSet, mergedTimeSet);
+				mergedPointSet.insert(mergedPointSet.end(),
+					newPointSet.begin(), newPointSet.end());
+				mergedTimeSet.insert(mergedTimeSet.end(),
+					newTimeSet.begin(), newTimeSet.end());
+
+				newPointSet.swap(mergedPointSet);
+				newTimeSet.swap(mergedTimeSet);
+				bucketSet_.pop_back();
+			}
+
+			if (bucketSet_.empty())
+			{
+				// The oldest bucket was merged; its
+				// expired points were left out.
+				first_ = 0;
+				pointSet_.assign(1, ConstIterator());
+				merged = 0;
+			}
+
+			bucketSet_.emplace_back(build(newPointSet, newTimeSet));
+
+			// Replace the iterators of the merged buckets.
+			pointSet_.resize(pointSet_.size() - 1 - merged);
+			const Tree& tree = bucketSet_.back();
+			for (auto i = tree.begin(); i != tree.end(); ++i)
+			{
+				pointSet_.emplace_back(i);
+			}
+			pointSet_.emplace_back(ConstIterator());
+		}
+
+		//! Appends a point at the end of time.
+		/*!
+		This is a convenience function which calls
+		append(std::vector<Point>{point}, PASTEL_TAG(timeSet),
+		std::vector<Real>{time}).
+		*/
+		void append(const Point& point, const Real& time)
+		{
+			append(
+				std::vector<Point>{point},
+				PASTEL_TAG(timeSet), std::vector<Real>{time});
+		}
+
+		//! Expires the points whose time is less than 'time'.
+		/*!
+		Time complexity: O(log(n)) amortized
+		Exception safety: basic
+
+		An expiry time less than expiryTime() has no effect.
+		*/
+		void expire(const Real& time)
+		{
+			if (time <= expiryTime_)
+			{
+				return;
+			}
+			expiryTime_ = time;
+
+			// Skip the expired points. This must be done before
+			// removing any buckets, since the search dereferences
+			// the iterators into them.
+			auto expiredEnd = std::lower_bound(
+				pointSet_.begin() + first_,
+				pointSet_.end() - 1,
+				expiryTime_,
+				[](const ConstIterator& point, const Real& time)
+				{
+					return point->time() < time;
+				});
+			first_ = expiredEnd - pointSet_.begin();
+
+			// Remove the buckets whose points have all expired.
+			while (!bucketSet_.empty() &&
+				bucketSet_.front().timeToIndex(expiryTime_) ==
+				bucketSet_.front().points())
+			{
+				bucketSet_.pop_front();
+			}
+
+			if (!bucketSet_.empty())
+			{
+				Tree& oldest = bucketSet_.front();
+				integer aliveCount = alive(oldest);
+				if (2 * aliveCount < oldest.points())
+				{
+					// Rebuild the oldest bucket from its alive points.
+					std::vector<Point> alivePointSet;
+					std::vector<Real> aliveTimeSet;
+					collect(oldest, alivePointSet, aliveTimeSet);
+					build(alivePointSet, aliveTimeSet).swap(oldest);
+
+					integer j = first_;
+					for (auto i = oldest.begin(); i != oldest.end(); ++i)
+					{
+						pointSet_[j] = i;
+						++j;
+					}
+				}
+			}
+
+			if (2 * first_ >= (integer)pointSet_.size())
+			{
+				// Release the iterators of the expired points.
+				pointSet_.erase(pointSet_.begin(), pointSet_.begin() + first_);
+				first_ = 0;
+			}
+		}
+
+	private:
+		//! Returns the number of alive points in a bucket.
+		integer alive(const Tree& tree) const
+		{
+			return tree.points() - tree.timeToIndex(expiryTime_);
+		}
+
+		//! Appends the alive points of a bucket in time-order.
+		void collect(
+			const Tree& tree,
+			std::vector<Point>& pointSet,
+			std::vector<Real>& timeSet) const
+		{
+			for (auto i = tree.begin() + tree.timeToIndex(expiryTime_);
+				i != tree.end(); ++i)
+			{
+				pointSet.emplace_back(i->point());
+				timeSet.emplace_back(i->time());
+			}
+		}
+
+		Tree build(
+			const std::vector<Point>& pointSet,
+			const std::vector<Real>& timeSet) const
+		{
+			return Tree(
+				locationSet(pointSet, locator_),
+				PASTEL_TAG(timeSet), timeSet);
+		}
+
+		//! The buckets in time-order.
+		std::deque<Tree> bucketSet_;
+
+		//! The points of the buckets in time-order.
+		/*!
+		The points before first_ have expired. The last
+		element is a sentinel, which is the notFound().
+		*/
+		std::vector<ConstIterator> pointSet_;
+
+		//! The index of the first alive point in pointSet_.
+		integer first_;
+
+		//! The locator.
+		Locator locator_;
+
+		//! The points before this time have expired.
+		Real expiryTime_;
+
+		//! The time of the last appended point.
+		Real lastTime_;
+
+		//! The number of points appended over the whole stream.
+		integer appended_;
+	};
+
+	//! Returns whether Type is an instance of Dynamic_TdTree.
+	template <typename Type>
+	struct IsDynamicTdTree
+	: std::false_type
+	{};
+
+	template <typename Settings,
+		template <typename> class Customization>
+	struct IsDynamicTdTree<Dynamic_TdTree<Settings, Customization>>
+	: std::true_type
+	{};
+
+}
+
+namespace Pastel
+{
+
+	template <
+		typename DynamicTdTree,
+		typename IntervalSequence,
+		typename SearchAlgorithm>
+	class Dynamic_TdTree_NearestSet
+	{
+	public:
+		using Tree = typename DynamicTdTree::Tree;
+		using Real = typename DynamicTdTree::Real;
+		using ConstIterator = typename DynamicTdTree::ConstIterator;
+		using Point_ConstIterator = ConstIterator;
+		using Bucket_NearestSet =
+			KdTree_NearestSet<Tree, IntervalSequence, SearchAlgorithm>;
+
+		Dynamic_TdTree_NearestSet(
+			const DynamicTdTree& tree_,
+			const Real& maxRelativeError,
+			integer nBruteForce,
+			const IntervalSequence& timeIntervalSequence)
+		: tree(tree_)
+		, bucketSet()
+		{
+			// Exclude the expired points by restricting
+			// the time-intervals to [expiryTime, Infinity).
+			IntervalSequence aliveSequence(timeIntervalSequence);
+			for (integer i = 0;i < aliveSequence.size();++i)
+			{
+				aliveSequence[i] = std::max(
+					aliveSequence[i], tree.expiryTime());
+			}
+
+			bucketSet.reserve(tree.buckets());
+			for (integer i = 0;i < tree.buckets();++i)
+			{
+				bucketSet.emplace_back(
+					tree.bucket(i),
+					maxRelativeError,
+					nBruteForce,
+					aliveSequence);
+			}
+		}
+
+		integer points() const {
+			return tree.points();
+		}
+
+		auto pointSet() const
+		{
+			return tree.pointSetRange();
+		}
+
+		auto begin() const
+		{
+			using std::begin;
+			return begin(pointSet());
+		}
+
+		auto end() const
+		{
+			using std::end;
+			return end(pointSet());
+		}
+
+		const auto& pointSetLocator() const
+		{
+			return tree.locator();
+		}
+
+		decltype(auto) asPoint(ConstIterator point) const
+		{
+			return location(point->point(), tree.locator());
+		}
+
+		//! Reports the point-sets of the nodes near the search-point.
+		/*!
+		The buckets are searched from the newest to the oldest,
+		and the culling distance suggested by the reporter in a
+		bucket is used to cull the nodes of the remaining buckets.
+		*/
+		template <
+			Point_Concept Search_Point,
+			Norm_Concept Norm,
+			Distance_Concept Distance,
+			typename Output
+		>
+		void findNearbyPointsets(
+			const Search_Point& searchPoint,
+			const Norm& norm,
+			const Distance& maxDistance2,
+			const Output& report) const
+		{
+			Distance cullDistance2 = maxDistance2;
+
+			auto reportBucket = [&](
+				auto&& pointSet,
+				const Distance& bucketCullDistance2)
+			{
+				Distance cullSuggestion2 = report(
+					std::forward<decltype(pointSet)>(pointSet),
+					bucketCullDistance2);
+				if (cullSuggestion2 < cullDistance2)
+				{
+					cullDistance2 = cullSuggestion2;
+				}
+				return cullSuggestion2;
+			};
+
+			for (integer i = bucketSet.size() - 1;i >= 0;--i)
+			{
+				bucketSet[i].findNearbyPointsets(
+					searchPoint, norm, cullDistance2, reportBucket);
+			}
+		}
+
+		const DynamicTdTree& tree;
+		std::vector<Bucket_NearestSet> bucketSet;
+	};
+
+	//! Constructs a nearest-set for a dynamic temporal kd-tree.
+	/*!
+	The optional arguments are the same as for the
+	kdTreeNearestSet() of a TdTree. The time-intervals
+	are restricted to the alive points.
+	*/
+	template <
+		typename DynamicTdTree,
+		typename... ArgumentSet>
+	requires IsDynamicTdTree<DynamicTdTree>::value
+	decltype(auto) kdTreeNearestSet(
+		const DynamicTdTree& tree,
+		ArgumentSet&&... argumentSet)
+	{
+		using Real = typename DynamicTdTree::Real;
+
+		Real maxRelativeError = PASTEL_ARG_S(maxRelativeError, 0);
+		ENSURE_OP(maxRelativeError, >=, 0);
+
+		integer nBruteForce = PASTEL_ARG_S(nBruteForce, 8);
+		ENSURE_OP(nBruteForce, >=, 0);
+
+		auto&& timeIntervalSequence =
+			PASTEL_ARG_C(
+				intervalSequence,
+				(Vector<Real, 2>({-(Real)Infinity(), (Real)Infinity()})),
+				Point_Concept);
+
+		auto timeIntervalSequence_ = evaluate(pointAsVector(timeIntervalSequence));
+		using IntervalSequence = decltype(timeIntervalSequence_);
+
+		auto&& searchAlgorithmObject =
+			PASTEL_ARG_C(
+				searchAlgorithm,
+				DepthFirst_SearchAlgorithm_PointKdTree(),
+				Trivial_Concept);
+
+		using SearchAlgorithm = RemoveCvRef<decltype(searchAlgorithmObject)>;
+
+		return Dynamic_TdTree_NearestSet<DynamicTdTree, IntervalSequence, SearchAlgorithm>(
+			tree,
+			maxRelativeError,
+			nBruteForce,
+			timeIntervalSequence_);
+	}
+
+}
+
+#endif
@@ -167,20 +167,29 @@ namespace Pastel
 
 				pointSet_.emplace_back(
 					pointPointId(point), time);
-				iteratorSet.emplace_back(
-					std::prev(pointSet_.end()));
 			}
 
 			if (!Simple)
 			{
 				// Sort the points in increasing order by time.
-				ranges::action::stable_sort(
-					iteratorSet,
+				// The point-array itself must be sorted, since
+				// timeToIndex() searches it, and the fractional
+				// cascading indices refer to it.
+				std::stable_sort(
+					pointSet_.begin(), pointSet_.end(),
 					[](auto&& a, auto&& b) 
 					{
-						return a->time() < b->time();
+						return a.time() < b.time();
 					});
+			}
+
+			for (auto i = pointSet_.begin(); i != pointSet_.end(); ++i)
+			{
+				iteratorSet.emplace_back(i);
+			}
 
+			if (!Simple)
+			{
 				// Check explicitly for the simplicity of 
 				// the time-coordinates.
 				simple_ = isSimple(iteratorSet);
@@ -4,10 +4,24 @@
 #define PASTELGFX_CONVOLUTION_H
 
 #include "pastel/sys/view/view.h"
+#include "pastel/sys/named_parameter.h"
 
 namespace Pastel
 {
 
+	//! The algorithm to use in convolute().
+	enum class Convolution_Policy : integer
+	{
+		//! Chooses the algorithm estimated to be the fastest.
+		Automatic,
+		//! Adds the filter to the output for each input element.
+		Direct,
+		//! Convolutes with a rank-1 filter one axis at a time.
+		Separable,
+		//! Convolutes block by block with fast Fourier transforms (overlap-add).
+		Fft
+	};
+
 	//! Convolutes an image with a filter.
 	/*!
 	Preconditions:
@@ -26,6 +40,10 @@ namespace Pastel
 	Dedices whether the input element contributes to
 	the convolution result or not.
 	bool processFunctor(const Input_RingElement& that);
+
+	This is a convenience function that calls
+	convolute(inputView, filterView, outputView,
+	PASTEL_TAG(process), processFunctor).
 	*/
 
 	template <
@@ -48,8 +66,43 @@ namespace Pastel
 	Preconditions:
 	inputView.extent() == outputView.extent()
 
-	Calls 'convolute(inputView, filterView, outputView, skipZero)'
-	where skipZero is a functor that skips zero valued input elements.
+	inputView:
+	The image to convolute.
+
+	filterView:
+	The filter to use. The element of the filter at
+	filterView.extent() / 2 is centered on each pixel.
+
+	outputView:
+	The image to add the convoluted image to.
+
+	Optional arguments
+	------------------
+
+	process (Function(Input_RingElement) -> bool):
+	Decides whether the input element contributes to
+	the convolution result or not.
+	Default: skips zero valued input elements
+
+	policy (Convolution_Policy):
+	The algorithm to use. The direct convolution takes 
+	O(k m) time, where k is the number of processed input 
+	elements, and m is the number of filter elements. The 
+	separable convolution takes O(n sum_i m_i) time, where n 
+	is the number of input elements, and m_i is the extent 
+	of the filter on the i:th axis; it requires the filter 
+	to be of rank 1 (e.g. a box or a Gaussian filter). 
+	The fft convolution takes O(n log(m)) time. The 
+	automatic policy chooses the algorithm with the least
+	estimated cost, where the constants have been measured 
+	by the [convolution] benchmark in
+	benchmark/pastel/gfx/benchmark_convolution.cpp.
+	The separable and the fft convolutions require the 
+	elements of the input and output to be arithmetic types, 
+	or fixed-size vectors of them (e.g. Color), and the elements 
+	of the filter to be arithmetic; otherwise the direct 
+	convolution is always used.
+	Default: Convolution_Policy::Automatic
 	*/
 
 	template <
@@ -59,11 +112,13 @@ namespace Pastel
 		typename Filter_RingElement,
 		typename Filter_ConstView,
 		typename Output_RingElement,
-		typename Output_View>
+		typename Output_View,
+		typename... ArgumentSet>
 		void convolute(
 		const ConstView<N, Input_RingElement, Input_ConstView>& inputView,
 		const ConstView<N, Filter_RingElement, Filter_ConstView>& filterView,
-		const View<N, Output_RingElement, Output_View>& outputView);
+		const View<N, Output_RingElement, Output_View>& outputView,
+		ArgumentSet&&... argumentSet);
 
 	//! Convolutes an image with a varying size filter.
 	/*!
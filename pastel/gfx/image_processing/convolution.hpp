@@ -2,6 +2,7 @@
 #define PASTELGFX_CONVOLUTION_HPP
 
 #include "pastel/gfx/image_processing/convolution.h"
+#include "pastel/gfx/image_processing/convolution_fast.hpp"
 #include "pastel/gfx/texture/nearestimage_texture.h"
 #include "pastel/gfx/color/colormixer/additive_colormixer.h"
 
@@ -84,6 +85,66 @@ namespace Pastel
 
 	}
 
+	namespace Convolute_
+	{
+
+		template <
+			int N,
+			typename Input_RingElement,
+			typename Input_ConstView,
+			typename Filter_RingElement,
+			typename Filter_ConstView,
+			typename Output_RingElement,
+			typename Output_View,
+			typename ConvoluteProcessFunctor>
+		void convoluteDirect(
+			const ConstView<N, Input_RingElement, Input_ConstView>& inputView,
+			const ConstView<N, Filter_RingElement, Filter_ConstView>& filterView,
+			const View<N, Output_RingElement, Output_View>& outputView,
+			const ConvoluteProcessFunctor& processFunctor)
+		{
+			// Convolution performance:
+			//
+			// A 5000 x 5000 float image with 100000 random pixels set to 1 and
+			// other pixels 0 with a 21 x 21 filterView.
+			//
+			// Absolute addressing means to address views as (x, y, ..).
+			// Relative addressing means to move from a pixel to its neighbour.
+			//
+			// 245s shooting, absolute addressing
+			// 1.6s shooting, absolute addressing, zero optimization
+			// 106s gathering, relative addressing
+			// 55s shooting, relative addressing
+			// 0.4s shooting, relative addressing, zero optimization
+			//
+			// - Gathering takes about 2x time compared to shooting.
+			// - Shooting can use zero optimization. This brings dramatic speedups for sparse
+			//   convolutions and adds negligible time for dense convolutions.
+			// - Absolute addressing takes about 4x time compared to relative addressing.
+			// - Clamping the filterView to the viewport takes negligible time (i.e. it does
+			//   not pay to convolute the central area specially without clamping).
+
+			ENSURE(inputView.extent() == outputView.extent());
+
+			Convolute_::ConvoluteFunctor<N, Input_RingElement, Input_ConstView, Filter_RingElement,
+				Filter_ConstView, Output_RingElement, Output_View, ConvoluteProcessFunctor>
+				convoluteFunctor(inputView, filterView, outputView, processFunctor);
+
+			visitPosition(inputView, convoluteFunctor);
+		}
+
+		template <typename Type>
+		class SkipZero
+		{
+		public:
+			bool operator()(const Type& that) const
+			{
+				return !(that == Type(0));
+			}
+		};
+
+	}
+
 	template <
 		int N,
 		typename Input_RingElement,
@@ -92,56 +153,70 @@ namespace Pastel
 		typename Filter_ConstView,
 		typename Output_RingElement,
 		typename Output_View,
-		typename ConvoluteProcessFunctor>
+		typename... ArgumentSet>
 		void convolute(
 		const ConstView<N, Input_RingElement, Input_ConstView>& inputView,
 		const ConstView<N, Filter_RingElement, Filter_ConstView>& filterView,
 		const View<N, Output_RingElement, Output_View>& outputView,
-		const ConvoluteProcessFunctor& processFunctor)
+		ArgumentSet&&... argumentSet)
 	{
-		// Convolution performance:
-		//
-		// A 5000 x 5000 float image with 100000 random pixels set to 1 and
-		// other pixels 0 with a 21 x 21 filterView.
-		//
-		// Absolute addressing means to address views as (x, y, ..).
-		// Relative addressing means to move from a pixel to its neighbour.
-		//
-		// 245s shooting, absolute addressing
-		// 1.6s shooting, absolute addressing, zero optimization
-		// 106s gathering, relative addressing
-		// 55s shooting, relative addressing
-		// 0.4s shooting, relative addressing, zero optimization
-		//
-		// - Gathering takes about 2x time compared to shooting.
-		// - Shooting can use zero optimization. This brings dramatic speedups for sparse
-		//   convolutions and adds negligible time for dense convolutions.
-		// - Absolute addressing takes about 4x time compared to relative addressing.
-		// - Clamping the filterView to the viewport takes negligible time (i.e. it does
-		//   not pay to convolute the central area specially without clamping).
+		auto&& processFunctor = PASTEL_ARG_S(
+			process, Convolute_::SkipZero<Input_RingElement>());
+
+		Convolution_Policy policy = 
+			PASTEL_ARG_ENUM(policy, Convolution_Policy::Automatic);
 
 		ENSURE(inputView.extent() == outputView.extent());
 
-		Convolute_::ConvoluteFunctor<N, Input_RingElement, Input_ConstView, Filter_RingElement,
-			Filter_ConstView, Output_RingElement, Output_View, ConvoluteProcessFunctor>
-			convoluteFunctor(inputView, filterView, outputView, processFunctor);
+		using Channels = Convolute_::Channels<Input_RingElement>;
 
-		visitPosition(inputView, convoluteFunctor);
-	}
+		static constexpr bool FastPathExists =
+			Channels::Exists &&
+			Convolute_::Channels<Output_RingElement>::Exists &&
+			Channels::N == Convolute_::Channels<Output_RingElement>::N &&
+			std::is_arithmetic_v<Filter_RingElement>;
 
-	namespace Convolute_
-	{
+		if constexpr (!FastPathExists)
+		{
+			ENSURE(
+				policy == Convolution_Policy::Automatic || 
+				policy == Convolution_Policy::Direct);
 
-		template <typename Type>
-		class SkipZero
+			Convolute_::convoluteDirect(
+				inputView, filterView, outputView, processFunctor);
+		}
+		else
 		{
-		public:
-			bool operator()(const Type& that) const
+			Convolute_::Filter<N> filter(filterView);
+			if (filter.zero())
 			{
-				return !(that == Type(0));
+				// The result is zero.
+				return;
 			}
-		};
 
+			if (policy == Convolution_Policy::Automatic)
+			{
+				policy = Convolute_::choosePolicy(
+					inputView, filter, processFunctor);
+			}
+
+			switch(policy)
+			{
+			case Convolution_Policy::Separable:
+				ENSURE(filter.separable());
+				Convolute_::convoluteSeparable(
+					inputView, filter, outputView, processFunctor);
+				break;
+			case Convolution_Policy::Fft:
+				Convolute_::convoluteFft(
+					inputView, filter, outputView, processFunctor);
+				break;
+			default:
+				Convolute_::convoluteDirect(
+					inputView, filterView, outputView, processFunctor);
+				break;
+			};
+		}
 	}
 
 	template <
@@ -151,15 +226,17 @@ namespace Pastel
 		typename Filter_RingElement,
 		typename Filter_ConstView,
 		typename Output_RingElement,
-		typename Output_View>
+		typename Output_View,
+		typename ConvoluteProcessFunctor>
 		void convolute(
 		const ConstView<N, Input_RingElement, Input_ConstView>& inputView,
 		const ConstView<N, Filter_RingElement, Filter_ConstView>& filterView,
-		const View<N, Output_RingElement, Output_View>& outputView)
+		const View<N, Output_RingElement, Output_View>& outputView,
+		const ConvoluteProcessFunctor& processFunctor)
 	{
-		Convolute_::SkipZero<Input_RingElement> skipZero;
-
-		Pastel::convolute(inputView, filterView, outputView, skipZero);
+		Pastel::convolute(
+			inputView, filterView, outputView,
+			PASTEL_TAG(process), processFunctor);
 	}
 
 	namespace GeneralizedConvolute_
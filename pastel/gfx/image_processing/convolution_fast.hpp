@@ -0,0 +1,565 @@
+#ifndef PASTELGFX_CONVOLUTION_FAST_HPP
+#define PASTELGFX_CONVOLUTION_FAST_HPP
+
+#include "pastel/gfx/image_processing/convolution.h"
+#include "pastel/gfx/transform/fourier_transform_n.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/ensure.h"
+#include "pastel/sys/view/view_visit.h"
+#include "pastel/sys/view/view_visit_more.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cmath>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
+namespace Pastel
+{
+
+	namespace Convolute_
+	{
+
+		//! Access to the channels of an element.
+		/*!
+		The separable and the fft convolution work on each
+		channel separately. The supported elements are
+		arithmetic types, which have one channel, and
+		fixed-size vectors of arithmetic types (e.g. Color).
+		*/
+		template <typename Type>
+		struct Channels
+		{
+			static constexpr bool Exists = false;
+			static constexpr integer N = 0;
+		};
+
+		template <typename Type>
+		requires std::is_arithmetic_v<Type>
+		struct Channels<Type>
+		{
+			static constexpr bool Exists = true;
+			static constexpr integer N = 1;
+
+			static dreal get(const Type& that, integer channel)
+			{
+				return that;
+			}
+
+			static void add(Type& that, integer channel, dreal value)
+			{
+				that += value;
+			}
+		};
+
+		template <typename Real, int M>
+		requires (std::is_arithmetic_v<Real> && M > 0)
+		struct Channels<Vector<Real, M>>
+		{
+			static constexpr bool Exists = true;
+			static constexpr integer N = M;
+
+			static dreal get(const Vector<Real, M>& that, integer channel)
+			{
+				return that[channel];
+			}
+
+			static void add(Vector<Real, M>& that, integer channel, dreal value)
+			{
+				that[channel] += value;
+			}
+		};
+
+		//! A filter, and its factorization if it is separable.
+		template <int N>
+		class Filter
+		{
+		public:
+			template <typename Filter_Element, typename Filter_ConstView>
+			explicit Filter(
+				const ConstView<N, Filter_Element, Filter_ConstView>& filterView)
+			: data_(filterView.extent(), 0)
+			, center_(filterView.extent() / 2)
+			{
+				visitPosition(filterView,
+					[&](const Vector<integer, N>& position, const Filter_Element& x)
+					{
+						data_(position) = x;
+					});
+
+				factorize();
+			}
+
+			const Array<dreal, N>& data() const
+			{
+				return data_;
+			}
+
+			const Vector<integer, N>& extent() const
+			{
+				return data_.extent();
+			}
+
+			//! The position of the filter which is centered on a pixel.
+			const Vector<integer, N>& center() const
+			{
+				return center_;
+			}
+
+			bool zero() const
+			{
+				return zero_;
+			}
+
+			//! Returns whether the filter is of rank 1.
+			/*!
+			Then the filter is the outer product of
+			the 1-dimensional filters factor(i).
+			*/
+			bool separable() const
+			{
+				return separable_;
+			}
+
+			const std::vector<dreal>& factor(integer axis) const
+			{
+				return factorSet_[axis];
+			}
+
+		private:
+			void factorize()
+			{
+				integer d = data_.n();
+
+				// Find the element with the maximum magnitude.
+				integer pivotIndex = 0;
+				dreal pivot = 0;
+				for (integer i = 0;i < data_.size();++i)
+				{
+					if (std::abs(data_(i)) > std::abs(pivot))
+					{
+						pivot = data_(i);
+						pivotIndex = i;
+					}
+				}
+
+				zero_ = (pivot == 0);
+				if (zero_)
+				{
+					return;
+				}
+
+				// If the filter is of rank 1, then its lines through
+				// the pivot are proportional to the factors.
+				Vector<integer, N> pivotPosition = data_.position(pivotIndex);
+				factorSet_.resize(d);
+				for (integer axis = 0;axis < d;++axis)
+				{
+					Vector<integer, N> position = pivotPosition;
+					for (integer i = 0;i < data_.extent()[axis];++i)
+					{
+						position[axis] = i;
+						factorSet_[axis].push_back(
+							axis == 0 ? data_(position) : data_(position) / pivot);
+					}
+				}
+
+				const dreal tolerance = 1e-6 * std::abs(pivot);
+
+				separable_ = true;
+				for (integer i = 0;i < data_.size() && separable_;++i)
+				{
+					Vector<integer, N> position = data_.position(i);
+					dreal product = 1;
+					for (integer axis = 0;axis < d;++axis)
+					{
+						product *= factorSet_[axis][position[axis]];
+					}
+					separable_ = std::abs(data_(i) - product) <= tolerance;
+				}
+			}
+
+			Array<dreal, N> data_;
+			Vector<integer, N> center_;
+			std::vector<std::vector<dreal>> factorSet_;
+			bool separable_ = false;
+			bool zero_ = true;
+		};
+
+		//! Returns the smallest n' >= n such that n' has no prime factors > 7.
+		inline integer smoothSize(integer n)
+		{
+			for (integer m = std::max(n, (integer)1);;++m)
+			{
+				integer k = m;
+				for (integer p : {2, 3, 5, 7})
+				{
+					while (k % p == 0)
+					{
+						k /= p;
+					}
+				}
+				if (k == 1)
+				{
+					return m;
+				}
+			}
+		}
+
+		//! The subdivision of an image into blocks for overlap-add.
+		template <int N>
+		struct FftBlocking
+		{
+			// The extent of the transforms.
+			Vector<integer, N> fftExtent;
+			// The extent of the input-blocks.
+			Vector<integer, N> blockExtent;
+			// The number of blocks on each axis.
+			Vector<integer, N> blocks;
+		};
+
+		//! Chooses the sizes of the blocks for overlap-add.
+		/*!
+		On each axis, the transform size L is chosen to
+		minimize ceil(n / (L - m + 1)) L log(L), where n is
+		the extent of the image, and m is the extent of the
+		filter. A single block covers the whole image when
+		the filter is large compared to the image.
+		*/
+		template <int N>
+		FftBlocking<N> fftBlocking(
+			const Vector<integer, N>& extent,
+			const Vector<integer, N>& filterExtent)
+		{
+			integer d = extent.n();
+
+			FftBlocking<N> result{extent, extent, extent};
+			for (integer i = 0;i < d;++i)
+			{
+				integer n = extent[i];
+				integer m = filterExtent[i];
+				integer maxSize = smoothSize(n + m - 1);
+
+				dreal minCost = (dreal)Infinity();
+				for (integer size = smoothSize(std::max(2 * m, (integer)64));size <= maxSize;size = smoothSize(size + 1))
+				{
+					integer block = std::min(size - m + 1, n);
+					integer blocks = (n + block - 1) / block;
+					dreal cost = blocks * size * std::log2((dreal)size + 1);
+					if (cost < minCost)
+					{
+						minCost = cost;
+						result.fftExtent[i] = size;
+						result.blockExtent[i] = block;
+						result.blocks[i] = blocks;
+					}
+				}
+
+				if (minCost == (dreal)Infinity())
+				{
+					result.fftExtent[i] = maxSize;
+					result.blockExtent[i] = n;
+					result.blocks[i] = 1;
+				}
+			}
+
+			return result;
+		}
+
+		//! Reads a channel of the processed input elements into an array.
+		template <
+			int N,
+			typename Input_Element,
+			typename Input_ConstView,
+			typename ConvoluteProcessFunctor>
+		Array<dreal, N> inputChannel(
+			const ConstView<N, Input_Element, Input_ConstView>& inputView,
+			integer channel,
+			const ConvoluteProcessFunctor& processFunctor)
+		{
+			Array<dreal, N> result(inputView.extent(), 0);
+			visitPosition(inputView,
+				[&](const Vector<integer, N>& position, const Input_Element& x)
+				{
+					if (processFunctor(x))
+					{
+						result(position) = Channels<Input_Element>::get(x, channel);
+					}
+				});
+			return result;
+		}
+
+		//! Adds a channel of the result to the output.
+		template <
+			int N,
+			typename Output_Element,
+			typename Output_View>
+		void addChannel(
+			const Array<dreal, N>& result,
+			integer channel,
+			const View<N, Output_Element, Output_View>& outputView)
+		{
+			visitPosition(outputView,
+				[&](const Vector<integer, N>& position, Output_Element& x)
+				{
+					Channels<Output_Element>::add(x, channel, result(position));
+				});
+		}
+
+		//! Convolutes with a rank-1 filter by 1-dimensional convolutions.
+		template <
+			int N,
+			typename Input_Element,
+			typename Input_ConstView,
+			typename Output_Element,
+			typename Output_View,
+			typename ConvoluteProcessFunctor>
+		void convoluteSeparable(
+			const ConstView<N, Input_Element, Input_ConstView>& inputView,
+			const Filter<N>& filter,
+			const View<N, Output_Element, Output_View>& outputView,
+			const ConvoluteProcessFunctor& processFunctor)
+		{
+			integer d = inputView.extent().n();
+
+			using Block = tbb::blocked_range<integer>;
+
+			for (integer channel = 0;channel < Channels<Input_Element>::N;++channel)
+			{
+				Array<dreal, N> result =
+					inputChannel(inputView, channel, processFunctor);
+
+				for (integer axis = 0;axis < d;++axis)
+				{
+					integer n = result.extent()[axis];
+					integer stride = result.stride()[axis];
+					const std::vector<dreal>& factor = filter.factor(axis);
+					integer m = factor.size();
+					integer center = filter.center()[axis];
+
+					std::vector<integer> offsetSet = FftN_::lineOffsets(
+						result.extent(), result.stride(),
+						FftN_::lineAxes(result.stride(), axis));
+
+					dreal* data = result.rawBegin();
+
+					tbb::parallel_for(Block(0, offsetSet.size(), 16),
+						[&](const Block& block)
+						{
+							std::vector<dreal> line(n);
+							for (integer j = block.begin();j < block.end();++j)
+							{
+								dreal* begin = data + offsetSet[j];
+								for (integer y = 0;y < n;++y)
+								{
+									line[y] = begin[y * stride];
+								}
+
+								// The element at y receives x * factor[q]
+								// from the element at x = y + center - q.
+								for (integer y = 0;y < n;++y)
+								{
+									integer qMin = std::max(y + center - (n - 1), (integer)0);
+									integer qMax = std::min(y + center + 1, m);
+
+									dreal sum = 0;
+									for (integer q = qMin;q < qMax;++q)
+									{
+										sum += factor[q] * line[y + center - q];
+									}
+									begin[y * stride] = sum;
+								}
+							}
+						});
+				}
+
+				addChannel(result, channel, outputView);
+			}
+		}
+
+		//! Convolutes by overlap-add with fast Fourier transforms.
+		template <
+			int N,
+			typename Input_Element,
+			typename Input_ConstView,
+			typename Output_Element,
+			typename Output_View,
+			typename ConvoluteProcessFunctor>
+		void convoluteFft(
+			const ConstView<N, Input_Element, Input_ConstView>& inputView,
+			const Filter<N>& filter,
+			const View<N, Output_Element, Output_View>& outputView,
+			const ConvoluteProcessFunctor& processFunctor)
+		{
+			using Complex = std::complex<dreal>;
+
+			const Vector<integer, N>& extent = inputView.extent();
+			integer d = extent.n();
+
+			FftBlocking<N> blocking = fftBlocking(extent, filter.extent());
+
+			Vector<integer, N> halfExtent = blocking.fftExtent;
+			halfExtent[0] = halfExtent[0] / 2 + 1;
+
+			// Transform the filter, placed at the origin.
+			Array<dreal, N> block(blocking.fftExtent, 0);
+			Array<Complex, N> filterSpectrum(halfExtent);
+			visit(AlignedBox<integer, N>(Vector<integer, N>(0), filter.extent()),
+				[&](const Vector<integer, N>& position)
+				{
+					block(position) = filter.data()(position);
+				});
+			realFftN(block(), filterSpectrum());
+
+			Array<Complex, N> spectrum(halfExtent);
+
+			// The extent of the non-zero part of the
+			// convolution of a block with the filter.
+			Vector<integer, N> supportExtent =
+				blocking.blockExtent + filter.extent() - 1;
+
+			for (integer channel = 0;channel < Channels<Input_Element>::N;++channel)
+			{
+				Array<dreal, N> input =
+					inputChannel(inputView, channel, processFunctor);
+				Array<dreal, N> result(extent, 0);
+
+				visit(AlignedBox<integer, N>(Vector<integer, N>(0), blocking.blocks),
+					[&](const Vector<integer, N>& blockPosition)
+					{
+						Vector<integer, N> offset =
+							blockPosition * blocking.blockExtent;
+
+						Vector<integer, N> blockExtent = blocking.blockExtent;
+						for (integer i = 0;i < d;++i)
+						{
+							blockExtent[i] = std::min(blockExtent[i], extent[i] - offset[i]);
+						}
+
+						block = 0;
+						visit(AlignedBox<integer, N>(Vector<integer, N>(0), blockExtent),
+							[&](const Vector<integer, N>& position)
+							{
+								block(position) = input(offset + position);
+							});
+
+						realFftN(block(), spectrum());
+						for (integer i = 0;i < spectrum.size();++i)
+						{
+							spectrum(i) *= filterSpectrum(i);
+						}
+						inverseRealFftN(spectrum(), block());
+
+						// Add the block to the result, shifted
+						// by the center of the filter.
+						Vector<integer, N> min = offset - filter.center();
+						Vector<integer, N> begin(ofDimension(d));
+						Vector<integer, N> end(ofDimension(d));
+						for (integer i = 0;i < d;++i)
+						{
+							begin[i] = std::max(-min[i], (integer)0);
+							end[i] = std::min(
+								std::min(supportExtent[i], blocking.fftExtent[i]),
+								extent[i] - min[i]);
+						}
+
+						if (anyGreaterEqual(begin, end))
+						{
+							return;
+						}
+
+						visit(AlignedBox<integer, N>(Vector<integer, N>(0), end - begin),
+							[&](const Vector<integer, N>& position)
+							{
+								result(min + begin + position) += block(begin + position);
+							});
+					});
+
+				addChannel(result, channel, outputView);
+			}
+		}
+
+		//! Chooses the fastest convolution algorithm.
+		/*!
+		The costs are estimated in nanoseconds, with constants
+		fitted to the [convolution] benchmark in
+		benchmark/pastel/gfx/benchmark_convolution.cpp (real32
+		images, one thread). The cost of the direct convolution
+		depends on the number of processed input elements,
+		since it skips the others.
+		*/
+		template <
+			int N,
+			typename Input_Element,
+			typename Input_ConstView,
+			typename ConvoluteProcessFunctor>
+		Convolution_Policy choosePolicy(
+			const ConstView<N, Input_Element, Input_ConstView>& inputView,
+			const Filter<N>& filter,
+			const ConvoluteProcessFunctor& processFunctor)
+		{
+			// Direct: per processed element, and per multiply-add.
+			static constexpr dreal DirectElementCost = 40;
+			static constexpr dreal DirectCost = 1.45;
+
+			// Separable: per element and channel, and per
+			// multiply-add and channel.
+			static constexpr dreal SeparableElementCost = 25;
+			static constexpr dreal SeparableCost = 0.66;
+
+			// Fft: per n log2(n) for an fft of n elements,
+			// per block and channel.
+			static constexpr dreal FftCost = 3.5;
+
+			const Vector<integer, N>& extent = inputView.extent();
+			integer d = extent.n();
+			integer channels = Channels<Input_Element>::N;
+
+			integer processed = 0;
+			visitPosition(inputView,
+				[&](const Vector<integer, N>& position, const Input_Element& x)
+				{
+					if (processFunctor(x))
+					{
+						++processed;
+					}
+				});
+
+			dreal directCost = processed *
+				(DirectElementCost + DirectCost * product(filter.extent()));
+
+			dreal separableCost = (dreal)Infinity();
+			if (filter.separable())
+			{
+				separableCost = channels * product(extent) *
+					(SeparableElementCost + SeparableCost * sum(filter.extent()));
+			}
+
+			// The filter is transformed once for all channels.
+			FftBlocking<N> blocking = fftBlocking(extent, filter.extent());
+			dreal fftSize = product(blocking.fftExtent);
+			dreal fftCost =
+				FftCost * (channels * product(blocking.blocks) + 1) *
+				fftSize * std::log2(fftSize + 1);
+
+			if (directCost <= separableCost && directCost <= fftCost)
+			{
+				return Convolution_Policy::Direct;
+			}
+
+			if (separableCost <= fftCost)
+			{
+				return Convolution_Policy::Separable;
+			}
+
+			return Convolution_Policy::Fft;
+		}
+
+	}
+
+}
+
+#endif
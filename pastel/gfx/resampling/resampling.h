@@ -41,84 +41,125 @@ namespace Pastel
 
 	//! Resamples a 1-dimensional array to a different size.
 	/*!
-	Preconditions:
-	blurFactor >= 1
+	The filter weights of each output element are computed 
+	once, into a table, and each output element is then a 
+	weighted sum of the input elements.
+
+	Optional arguments
+	------------------
+
+	blurFactor (dreal >= 1):
+	The factor by which to enlarge the filter.
+	Default: 1
+
+	deterministic (bool):
+	Whether to divide each output element by the sum of
+	its weights, as the line-by-line resampling does. 
+	Otherwise the weights are normalized in advance, which
+	changes the rounding of the results.
+	Default: false
 	*/
-
 	template <
 		typename Computation_Element,
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
-		void resampleTable(
+		typename Output_View,
+		typename... ArgumentSet>
+	void resampleTable(
 		const ConstView<1, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<1, Input_Element>>& arrayExtender,
 		const ConstTableFilterPtr& filter,
 		const View<1, Output_Element, Output_View>& output,
-		dreal blurFactor = 1);
+		ArgumentSet&&... argumentSet);
 
+	//! Resamples a 1-dimensional array to a different size.
+	/*!
+	This function calls the corresponding resampleTable()
+	function after constructing a Table_Filter out of
+	the given filter.
+	*/
 	template <
 		typename Computation_Element,
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
-		void resample(
+		typename Output_View,
+		typename... ArgumentSet>
+	void resample(
 		const ConstView<1, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<1, Input_Element>>& arrayExtender,
 		const ConstFilterPtr& filter,
 		const View<1, Output_Element, Output_View>& output,
-		dreal blurFactor = 1);
+		ArgumentSet&&... argumentSet);
 
 	//! Resamples a multi-dimensional array to a different size.
 	/*!
-	Preconditions:
-	blurFactor >= 1
-
-	This function essentially calls the 1-dimensional
-	array resampling function for each row of each axis.
+	The array is resampled along one axis at a time, with
+	the filter weights of an axis computed once and reused
+	for all the lines along that axis. The lines are 
+	distributed over threads.
+
+	Optional arguments
+	------------------
+
+	blurFactor (dreal >= 1):
+	The factor by which to enlarge the filter.
+	Default: 1
+
+	parallel (bool):
+	Whether to distribute the lines over threads.
+	Default: true
+
+	deterministic (bool):
+	Whether to compute each output element exactly as the
+	line-by-line resampling does, in which case the result
+	is bit-identical for any number of threads. Otherwise 
+	the input is first copied to an array of 
+	Computation_Element, the weights are normalized in
+	advance, and the neighboring lines along the contiguous
+	axis are resampled together, so that the accumulation 
+	runs over contiguous memory and vectorizes. The results
+	then differ in rounding.
+	Default: false
 	*/
-
 	template <
 		typename Computation_Element,
 		int N,
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
+		typename Output_View,
+		typename... ArgumentSet>
 		requires (N > 1)
 	void resampleTable(
 		const ConstView<N, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<N, Input_Element>>& arrayExtender,
 		const ConstTableFilterPtr& filter,
 		const View<N, Output_Element, Output_View>& output,
-		dreal blurFactor = 1);
+		ArgumentSet&&... argumentSet);
 
 	//! Resamples a multi-dimensional array to a different size.
 	/*!
-	Preconditions:
-	blurFactor >= 1
-
 	This function calls the corresponding resampleTable()
 	function after constructing a Table_Filter out of
 	the given filter.
 	*/
-
 	template <
 		typename Computation_Element,
 		int N,
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
+		typename Output_View,
+		typename... ArgumentSet>
 		requires (N > 1)
 	void resample(
 		const ConstView<N, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<N, Input_Element>>& arrayExtender,
 		const ConstFilterPtr& filter,
 		const View<N, Output_Element, Output_View>& output,
-		dreal blurFactor = 1);
+		ArgumentSet&&... argumentSet);
 
 }
 
@@ -8,8 +8,11 @@
 #include "pastel/sys/view/view_tools.h"
 #include "pastel/sys/math_functions.h"
 #include "pastel/sys/syscommon.h"
-#include "pastel/sys/math_functions.h"
+#include "pastel/sys/named_parameter.h"
+
+#include "pastel/gfx/resampling/resampling_fast.hpp"
 
+#include <algorithm>
 #include <vector>
 
 namespace Pastel
@@ -141,14 +144,18 @@ namespace Pastel
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
+		typename Output_View,
+		typename... ArgumentSet>
 	void resampleTable(
 		const ConstView<1, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<1, Input_Element>>& arrayExtender,
 		const ConstTableFilterPtr& filter,
 		const View<1, Output_Element, Output_View>& output,
-		dreal blurFactor)
+		ArgumentSet&&... argumentSet)
 	{
+		dreal blurFactor = PASTEL_ARG_S(blurFactor, 1);
+		bool deterministic = PASTEL_ARG_S(deterministic, false);
+
 		ENSURE_OP(blurFactor, >=, 1);
 
 		integer inputWidth = input.width();
@@ -160,130 +167,16 @@ namespace Pastel
 			return;
 		}
 
-		/*
-		if (outputWidth == inputWidth)
-		{
-			copy(input, output);
-			return;
-		}
-		*/
-
-		dreal xStep = (dreal)inputWidth / outputWidth;
-
-		const dreal filterFactor = blurFactor * ((xStep > 1) ? xStep : 1);
-		dreal invFilterFactor = inverse(filterFactor);
-
-		const dreal filterRadius = filter->radius() * filterFactor;
-
-		dreal xFilter = 0.5 * xStep;
-
-		// xFilter + xStep * marginWidth > filterRadius
-		// =>
-		// xStep * marginWidth > filterRadius - xFilter
-		// => 
-		// marginWidth > (filterRadius - xFilter) / xStep
-
-		integer introEnd = 
-			clamp(
-			(integer)std::ceil((filterRadius - xFilter) / xStep) + 1,
-			0, outputWidth);
-		integer mainEnd =
-			clamp(outputWidth - introEnd, 
-			introEnd, outputWidth);
-
-		for (integer x = 0;x < introEnd;++x)
-		{
-			integer rangeBegin =
-				toPixelSpanPoint(xFilter - filterRadius);
-			integer rangeEnd =
-				toPixelSpanPoint(xFilter + filterRadius);
-
-			dreal xLocalFilter =
-				(xFilter - (rangeBegin + 0.5)) * invFilterFactor;
-
-			// Compute the resampled value.
-
-			Computation_Element result(0);
-			dreal sumWeights = 0;
-			for (integer i = rangeBegin; i < rangeEnd;++i)
-			{
-				dreal weight =
-					filter->evaluateInRange(xLocalFilter);
-
-				result += weight *
-					arrayExtender(input, i);
-
-				xLocalFilter -= invFilterFactor;
-				sumWeights += weight;
-			}
-
-			output(x) = result / sumWeights;
-
-			xFilter += xStep;
-		}
-
-		for (integer x = introEnd;x < mainEnd;++x)
+		Resample_::WeightTable table(
+			inputWidth, outputWidth, *filter, 
+			arrayExtender.extender(0), blurFactor);
+		if (!deterministic)
 		{
-			integer rangeBegin =
-				toPixelSpanPoint(xFilter - filterRadius);
-			integer rangeEnd =
-				toPixelSpanPoint(xFilter + filterRadius);
-
-			dreal xLocalFilter =
-				(xFilter - (rangeBegin + 0.5)) * invFilterFactor;
-
-			// Compute the resampled value.
-
-			Computation_Element result(0);
-			dreal sumWeights = 0;
-			for (integer i = rangeBegin; i < rangeEnd;++i)
-			{
-				dreal weight =
-					filter->evaluateInRange(xLocalFilter);
-				
-				Computation_Element in = input(i);
-
-				result += weight * in;
-
-				xLocalFilter -= invFilterFactor;
-				sumWeights += weight;
-			}
-
-			output(x) = result / sumWeights;
-
-			xFilter += xStep;
+			table.normalize();
 		}
 
-		for (integer x = mainEnd;x < outputWidth;++x)
-		{
-			integer rangeBegin =
-				toPixelSpanPoint(xFilter - filterRadius);
-			integer rangeEnd =
-				toPixelSpanPoint(xFilter + filterRadius);
-
-			dreal xLocalFilter =
-				(xFilter - (rangeBegin + 0.5)) * invFilterFactor;
-
-			// Compute the resampled value.
-
-			Computation_Element result(0);
-			dreal sumWeights = 0;
-			for (integer i = rangeBegin; i < rangeEnd;++i)
-			{
-				dreal weight =
-					filter->evaluateInRange(xLocalFilter);
-
-				result += weight *
-					arrayExtender(input, i);
-
-				xLocalFilter -= invFilterFactor;
-				sumWeights += weight;
-			}
-
-			output(x) = result / sumWeights;
-
-			xFilter += xStep;
-		}
+		Resample_::resampleLine<Computation_Element>(
+			input, arrayExtender.border(), table, output);
 	}
 
 	template <
@@ -291,53 +184,24 @@ namespace Pastel
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
-		void resample(
+		typename Output_View,
+		typename... ArgumentSet>
+	void resample(
 		const ConstView<1, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<1, Input_Element>>& arrayExtender,
 		const ConstFilterPtr& filter,
 		const View<1, Output_Element, Output_View>& output,
-		dreal blurFactor)
+		ArgumentSet&&... argumentSet)
 	{
-		ENSURE_OP(blurFactor, >=, 1);
-
 		Pastel::resampleTable<Computation_Element>(
 			input, arrayExtender, 
 			tableFilter(filter), output,
-			blurFactor);
+			std::forward<ArgumentSet>(argumentSet)...);
 	}
 
 	namespace Resample_
 	{
 
-		template <typename Computation_Element, typename Input_Element>
-		class ResampleFunctor
-		{
-		public:
-			ResampleFunctor(
-				const ArrayExtender<1, Input_Element>& arrayExtender,
-				const ConstTableFilterPtr& filter,
-				dreal blurFactor)
-			: arrayExtender_(arrayExtender)
-			, filter_(filter)
-			, blurFactor_(blurFactor)
-			{
-			}
-
-			template <typename Left_View, typename Right_View>
-			void operator()(const Left_View& left,
-				const Right_View& right) const
-			{
-				resample<Computation_Element>(left, arrayExtender_, 
-					filter_, right, blurFactor_);
-			}
-
-		private:
-			const ArrayExtender<1, Input_Element>& arrayExtender_;
-			const ConstTableFilterPtr& filter_;
-			dreal blurFactor_;
-		};
-
 		class AxisValue
 		{
 		public:
@@ -373,15 +237,20 @@ namespace Pastel
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
+		typename Output_View,
+		typename... ArgumentSet>
 		requires (N > 1)
 	void resampleTable(
 		const ConstView<N, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<N, Input_Element>>& arrayExtender,
 		const ConstTableFilterPtr& filter,
 		const View<N, Output_Element, Output_View>& output,
-		dreal blurFactor)
+		ArgumentSet&&... argumentSet)
 	{
+		dreal blurFactor = PASTEL_ARG_S(blurFactor, 1);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		bool deterministic = PASTEL_ARG_S(deterministic, false);
+
 		ENSURE_OP(blurFactor, >=, 1);
 
 		// The n-dimensional resampling is done as
@@ -396,6 +265,12 @@ namespace Pastel
 
 		PASTEL_STATIC_ASSERT(N != 1);
 
+		if (anyEqual(input.extent(), 0) ||
+			anyEqual(output.extent(), 0))
+		{
+			return;
+		}
+
 		// Find out the mostly-optimal order.
 
 		std::vector<Resample_::AxisValue> axisSet;
@@ -409,50 +284,84 @@ namespace Pastel
 
 		std::sort(axisSet.begin(), axisSet.end());
 
+		// The weights of an axis are computed once, and 
+		// are then reused for all the lines along the axis.
+		auto weightTable = [&](integer axis)
+		{
+			Resample_::WeightTable table(
+				input.extent()[axis], output.extent()[axis], *filter, 
+				arrayExtender.extender(axis), blurFactor);
+			if (!deterministic)
+			{
+				table.normalize();
+			}
+			return table;
+		};
+
+		Computation_Element border = arrayExtender.border();
+		Vector<integer, N> extent = input.extent();
+
+		if (!deterministic)
+		{
+			// The first resampling reads the input view line by
+			// line; the rest are done between arrays, whose
+			// memory layout is known.
+
+			extent[axisSet[0].axis_] = output.extent()[axisSet[0].axis_];
+			Array<Computation_Element, N> tempArray(extent);
+
+			Resample_::resampleLines<Computation_Element>(
+				input, arrayExtender.border(), weightTable(axisSet[0].axis_), 
+				arrayView(tempArray), axisSet[0].axis_, parallel);
+
+			for (integer i = 1;i < N;++i)
+			{
+				integer axis = axisSet[i].axis_;
+				extent[axis] = output.extent()[axis];
+				Array<Computation_Element, N> tempArray2(extent);
+
+				Resample_::resampleArray(
+					tempArray, border, weightTable(axis), 
+					tempArray2, axis, parallel);
+
+				tempArray.swap(tempArray2);
+			}
+
+			copy(constArrayView(tempArray), output);
+			return;
+		}
+
 		// The first resampling is from the input view to
 		// a temporary array.
 
-		Vector<integer, N> extent = input.extent();
 		extent[axisSet[0].axis_] = output.extent()[axisSet[0].axis_];
 		Array<Computation_Element, N> tempArray(extent);
 
-		{
-			ArrayExtender<1, Input_Element> arrayExtender1D(
-				arrayExtender.extender(0), arrayExtender.border());
-			Resample_::ResampleFunctor<Computation_Element, Input_Element> 
-				resampleFunctor(arrayExtender1D, filter, blurFactor);
-			visitRows(input, arrayView(tempArray), axisSet[0].axis_, resampleFunctor);
-		}
+		Resample_::resampleLines<Computation_Element>(
+			input, arrayExtender.border(), weightTable(axisSet[0].axis_), 
+			arrayView(tempArray), axisSet[0].axis_, parallel);
 
 		// The second resampling to the previous-to-last resampling
 		// is done between temporary arrays.
 
 		for (integer i = 1;i < N - 1;++i)
 		{
-			extent[axisSet[i].axis_] = output.extent()[axisSet[i].axis_];
+			integer axis = axisSet[i].axis_;
+			extent[axis] = output.extent()[axis];
 			Array<Computation_Element, N> tempArray2(extent);
 
-			ArrayExtender<1, Computation_Element> arrayExtender1D(
-				arrayExtender.extender(i), arrayExtender.border());
-			Resample_::ResampleFunctor<Computation_Element, Input_Element> 
-				resampleFunctor(arrayExtender1D, filter, blurFactor);
-
-			visitRows(constArrayView(tempArray), arrayView(tempArray2), 
-				axisSet[i].axis_, resampleFunctor);
+			Resample_::resampleLines<Computation_Element>(
+				constArrayView(tempArray), border, weightTable(axis), 
+				arrayView(tempArray2), axis, parallel);
 
 			tempArray.swap(tempArray2);
 		}
 
 		// The last resampling is done to the output view.
 
-		{
-			ArrayExtender<1, Computation_Element> arrayExtender1D(
-				arrayExtender.extender(N - 1), arrayExtender.border());
-			Resample_::ResampleFunctor<Computation_Element, Input_Element> 
-				resampleFunctor(arrayExtender1D, filter, blurFactor);
-
-			visitRows(constArrayView(tempArray), output, axisSet[N - 1].axis_, resampleFunctor);
-		}
+		Resample_::resampleLines<Computation_Element>(
+			constArrayView(tempArray), border, weightTable(axisSet[N - 1].axis_), 
+			output, axisSet[N - 1].axis_, parallel);
 	}
 
 	template <
@@ -461,21 +370,20 @@ namespace Pastel
 		typename Input_Element,
 		typename Input_View,
 		typename Output_Element,
-		typename Output_View>
+		typename Output_View,
+		typename... ArgumentSet>
 		requires (N > 1)
 	void resample(
 		const ConstView<N, Input_Element, Input_View>& input,
 		const NoDeduction<ArrayExtender<N, Input_Element>>& arrayExtender,
 		const ConstFilterPtr& filter,
 		const View<N, Output_Element, Output_View>& output,
-		dreal blurFactor)
+		ArgumentSet&&... argumentSet)
 	{
-		ENSURE_OP(blurFactor, >=, 1);
-
 		Pastel::resampleTable<Computation_Element>(
 			input, arrayExtender, 
 			tableFilter(filter), output,
-			blurFactor);
+			std::forward<ArgumentSet>(argumentSet)...);
 	}
 
 }
@@ -0,0 +1,510 @@
+#ifndef PASTELGFX_RESAMPLING_FAST_HPP
+#define PASTELGFX_RESAMPLING_FAST_HPP
+
+#include "pastel/gfx/resampling/resampling.h"
+#include "pastel/gfx/transform/fourier_transform_n.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/ensure.h"
+#include "pastel/sys/math_functions.h"
+#include "pastel/sys/syscommon.h"
+#include "pastel/sys/view/rowview.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace Pastel
+{
+
+	namespace Resample_
+	{
+
+		//! Filter weights for resampling lines of a given width.
+		/*!
+		The weights of each output element are computed once,
+		in exactly the same way as the line-by-line resampling
+		used to compute them, and are then reused for all the
+		lines along an axis. The index of each input element
+		is stored already extended; the border is marked by -1.
+		*/
+		class WeightTable
+		{
+		public:
+			WeightTable(
+				integer inputWidth,
+				integer outputWidth,
+				const Table_Filter& filter,
+				const ConstIndexExtenderPtr& extender,
+				dreal blurFactor)
+			: offsetSet_(outputWidth + 1, 0)
+			, sumWeightSet_(outputWidth, 0)
+			{
+				ENSURE_OP(blurFactor, >=, 1);
+
+				if (inputWidth == 0 ||
+					outputWidth == 0)
+				{
+					return;
+				}
+
+				dreal xStep = (dreal)inputWidth / outputWidth;
+
+				const dreal filterFactor = blurFactor * ((xStep > 1) ? xStep : 1);
+				dreal invFilterFactor = inverse(filterFactor);
+
+				const dreal filterRadius = filter.radius() * filterFactor;
+
+				dreal xFilter = 0.5 * xStep;
+
+				// xFilter + xStep * marginWidth > filterRadius
+				// =>
+				// xStep * marginWidth > filterRadius - xFilter
+				// =>
+				// marginWidth > (filterRadius - xFilter) / xStep
+
+				introEnd_ =
+					clamp(
+					(integer)std::ceil((filterRadius - xFilter) / xStep) + 1,
+					0, outputWidth);
+				mainEnd_ =
+					clamp(outputWidth - introEnd_,
+					introEnd_, outputWidth);
+
+				for (integer x = 0;x < outputWidth;++x)
+				{
+					integer rangeBegin =
+						toPixelSpanPoint(xFilter - filterRadius);
+					integer rangeEnd =
+						toPixelSpanPoint(xFilter + filterRadius);
+
+					dreal xLocalFilter =
+						(xFilter - (rangeBegin + 0.5)) * invFilterFactor;
+
+					dreal sumWeights = 0;
+					for (integer i = rangeBegin; i < rangeEnd;++i)
+					{
+						dreal weight =
+							filter.evaluateInRange(xLocalFilter);
+
+						weightSet_.push_back(weight);
+						indexSet_.push_back(
+							extendIndex(i, inputWidth, extender));
+
+						xLocalFilter -= invFilterFactor;
+						sumWeights += weight;
+					}
+
+					offsetSet_[x + 1] = weightSet_.size();
+					sumWeightSet_[x] = sumWeights;
+
+					xFilter += xStep;
+				}
+			}
+
+			//! Divides the weights by their sum.
+			/*!
+			Afterwards the output elements need not be
+			divided by the sum of the weights. This changes
+			the rounding of the results.
+			*/
+			void normalize()
+			{
+				integer outputWidth = sumWeightSet_.size();
+				for (integer x = 0;x < outputWidth;++x)
+				{
+					dreal invSumWeights = inverse(sumWeightSet_[x]);
+					for (integer k = offsetSet_[x];k < offsetSet_[x + 1];++k)
+					{
+						weightSet_[k] *= invSumWeights;
+					}
+					sumWeightSet_[x] = 1;
+				}
+				normalized_ = true;
+			}
+
+			//! Returns whether the weights have been normalized.
+			bool normalized() const
+			{
+				return normalized_;
+			}
+
+			//! Returns the number of weights of an output element.
+			integer size(integer x) const
+			{
+				return offsetSet_[x + 1] - offsetSet_[x];
+			}
+
+			//! Returns the weights of an output element.
+			const dreal* weight(integer x) const
+			{
+				return weightSet_.data() + offsetSet_[x];
+			}
+
+			//! Returns the input indices of an output element.
+			const integer* index(integer x) const
+			{
+				return indexSet_.data() + offsetSet_[x];
+			}
+
+			//! Returns the sum of the weights of an output element.
+			dreal sumWeights(integer x) const
+			{
+				return sumWeightSet_[x];
+			}
+
+			//! Returns whether the filter of an output element is inside the input.
+			/*!
+			This is the middle range of the output elements
+			computed with a single bound check; the bit-identical
+			resampling uses it to convert the input elements in
+			the same way.
+			*/
+			bool inside(integer x) const
+			{
+				return x >= introEnd_ && x < mainEnd_;
+			}
+
+		private:
+			static integer extendIndex(
+				integer i,
+				integer width,
+				const ConstIndexExtenderPtr& extender)
+			{
+				if (i >= 0 && i < width)
+				{
+					return i;
+				}
+
+				if (extender.empty())
+				{
+					return -1;
+				}
+
+				return (*extender)(i, width);
+			}
+
+			std::vector<integer> offsetSet_;
+			std::vector<dreal> weightSet_;
+			std::vector<integer> indexSet_;
+			std::vector<dreal> sumWeightSet_;
+			integer introEnd_ = 0;
+			integer mainEnd_ = 0;
+			bool normalized_ = false;
+		};
+
+		//! The type to multiply an element with.
+		/*!
+		Multiplying by the scalar type of the element, rather
+		than by dreal, avoids conversions in the inner loops
+		which would prevent their vectorization.
+		*/
+		template <typename Type>
+		struct Weight
+		{
+			using type = std::conditional_t<
+				std::is_arithmetic<Type>::value, Type, dreal>;
+		};
+
+		template <typename Real, int M>
+		struct Weight<Vector<Real, M>>
+		{
+			using type = Real;
+		};
+
+		template <typename Type>
+		using Weight_T = typename Weight<Type>::type;
+
+		//! Resamples a line.
+		/*!
+		This is the line-by-line resampling, which computes
+		each output element in the same order of operations
+		for all lines.
+		*/
+		template <
+			typename Computation_Element,
+			typename Input_Element,
+			typename Input_ConstView,
+			typename Output_Element,
+			typename Output_View>
+		void resampleLine(
+			const ConstView<1, Input_Element, Input_ConstView>& input,
+			const NoDeduction<Input_Element>& border,
+			const WeightTable& table,
+			const View<1, Output_Element, Output_View>& output)
+		{
+			integer outputWidth = output.width();
+			for (integer x = 0;x < outputWidth;++x)
+			{
+				const dreal* weight = table.weight(x);
+				const integer* index = table.index(x);
+				integer n = table.size(x);
+
+				Computation_Element result(0);
+				if (table.inside(x))
+				{
+					for (integer k = 0;k < n;++k)
+					{
+						Computation_Element in = input(index[k]);
+						result += weight[k] * in;
+					}
+				}
+				else
+				{
+					for (integer k = 0;k < n;++k)
+					{
+						if (index[k] >= 0)
+						{
+							result += weight[k] * input(index[k]);
+						}
+						else
+						{
+							result += weight[k] * border;
+						}
+					}
+				}
+
+				if (table.normalized())
+				{
+					output(x) = result;
+				}
+				else
+				{
+					output(x) = result / table.sumWeights(x);
+				}
+			}
+		}
+
+		//! Resamples all the lines along an axis.
+		/*!
+		The lines are independent of each other, and are
+		distributed over threads; the result does not depend
+		on the number of threads.
+		*/
+		template <
+			typename Computation_Element,
+			int N,
+			typename Input_Element,
+			typename Input_ConstView,
+			typename Output_Element,
+			typename Output_View>
+		void resampleLines(
+			const ConstView<N, Input_Element, Input_ConstView>& input,
+			const NoDeduction<Input_Element>& border,
+			const WeightTable& table,
+			const View<N, Output_Element, Output_View>& output,
+			integer axis,
+			bool parallel)
+		{
+			using Block = tbb::blocked_range<integer>;
+
+			Vector<integer, N> lineExtent = output.extent();
+			lineExtent[axis] = 1;
+
+			integer lines = product(lineExtent);
+			if (lines == 0 || input.extent()[axis] == 0)
+			{
+				return;
+			}
+
+			auto resample = [&](const Block& block)
+			{
+				for (integer j = block.begin();j < block.end();++j)
+				{
+					// Convert the line index to a position.
+					Vector<integer, N> position(ofDimension(lineExtent.n()));
+					integer rest = j;
+					for (integer i = 0;i < lineExtent.n();++i)
+					{
+						position[i] = rest % lineExtent[i];
+						rest /= lineExtent[i];
+					}
+
+					resampleLine<Computation_Element>(
+						constRowView(input, axis, position), border, table,
+						rowView(output, axis, position));
+				}
+			};
+
+			if (parallel)
+			{
+				tbb::parallel_for(Block(0, lines, 16), resample);
+			}
+			else
+			{
+				resample(Block(0, lines));
+			}
+		}
+
+		//! Resamples the lines along an axis of an array.
+		/*!
+		Preconditions:
+		table.normalized()
+
+		If the axis is the contiguous axis, the lines are
+		resampled one at a time. Otherwise the neighboring
+		lines in the contiguous axis are resampled together:
+		each output line is then a weighted sum of whole input
+		lines, which is accumulated over runs of contiguous
+		elements, and vectorizes.
+		*/
+		template <typename Element, int N>
+		void resampleArray(
+			const Array<Element, N>& input,
+			const Element& border,
+			const WeightTable& table,
+			Array<Element, N>& output,
+			integer axis,
+			bool parallel)
+		{
+			PENSURE(table.normalized());
+
+			using Block = tbb::blocked_range<integer>;
+			using Real = Weight_T<Element>;
+
+			// The number of contiguous elements to resample
+			// together; small enough to stay in the cache.
+			static constexpr integer RunSize = 512;
+
+			if (input.size() == 0 || output.size() == 0)
+			{
+				return;
+			}
+
+			const Vector<integer, N>& inputStride = input.stride();
+			const Vector<integer, N>& outputStride = output.stride();
+			integer inputAxisStride = inputStride[axis];
+			integer outputAxisStride = outputStride[axis];
+			integer outputWidth = output.extent()[axis];
+
+			const Element* inputData = input.rawBegin();
+			Element* outputData = output.rawBegin();
+
+			// The other axes are the same in both arrays,
+			// and are ordered by increasing stride.
+			std::vector<integer> axisSet = FftN_::lineAxes(inputStride, axis);
+
+			if (inputAxisStride == 1 || axisSet.empty())
+			{
+				std::vector<integer> inputOffsetSet =
+					FftN_::lineOffsets(input.extent(), inputStride, axisSet);
+				std::vector<integer> outputOffsetSet =
+					FftN_::lineOffsets(output.extent(), outputStride, axisSet);
+				integer lines = inputOffsetSet.size();
+
+				auto resample = [&](const Block& block)
+				{
+					for (integer j = block.begin();j < block.end();++j)
+					{
+						const Element* in = inputData + inputOffsetSet[j];
+						Element* out = outputData + outputOffsetSet[j];
+						for (integer x = 0;x < outputWidth;++x)
+						{
+							const dreal* weight = table.weight(x);
+							const integer* index = table.index(x);
+							integer n = table.size(x);
+
+							Element result(0);
+							for (integer k = 0;k < n;++k)
+							{
+								const Element& value = index[k] >= 0 ?
+									in[index[k] * inputAxisStride] : border;
+								result += (Real)weight[k] * value;
+							}
+							out[x * outputAxisStride] = result;
+						}
+					}
+				};
+
+				if (parallel)
+				{
+					tbb::parallel_for(Block(0, lines, 16), resample);
+				}
+				else
+				{
+					resample(Block(0, lines));
+				}
+				return;
+			}
+
+			// The contiguous axis is the first of the other axes;
+			// the rest of them enumerate the groups of lines.
+			integer runAxis = axisSet.front();
+			ENSURE_OP(inputStride[runAxis], ==, 1);
+			ENSURE_OP(outputStride[runAxis], ==, 1);
+			axisSet.erase(axisSet.begin());
+
+			std::vector<integer> inputOffsetSet =
+				FftN_::lineOffsets(input.extent(), inputStride, axisSet);
+			std::vector<integer> outputOffsetSet =
+				FftN_::lineOffsets(output.extent(), outputStride, axisSet);
+
+			integer groups = inputOffsetSet.size();
+			integer runWidth = input.extent()[runAxis];
+			integer runs = (runWidth + RunSize - 1) / RunSize;
+
+			auto resample = [&](const Block& block)
+			{
+				for (integer j = block.begin();j < block.end();++j)
+				{
+					integer group = j / runs;
+					integer runBegin = (j % runs) * RunSize;
+					integer runEnd = std::min(runBegin + RunSize, runWidth);
+					integer m = runEnd - runBegin;
+
+					const Element* in =
+						inputData + inputOffsetSet[group] + runBegin;
+					Element* out =
+						outputData + outputOffsetSet[group] + runBegin;
+
+					for (integer x = 0;x < outputWidth;++x)
+					{
+						const dreal* weight = table.weight(x);
+						const integer* index = table.index(x);
+						integer n = table.size(x);
+
+						Element* outRun = out + x * outputAxisStride;
+						std::fill(outRun, outRun + m, Element(0));
+						for (integer k = 0;k < n;++k)
+						{
+							Real w = weight[k];
+							if (index[k] >= 0)
+							{
+								const Element* inRun = in + index[k] * inputAxisStride;
+								for (integer r = 0;r < m;++r)
+								{
+									outRun[r] += w * inRun[r];
+								}
+							}
+							else
+							{
+								Element value = w * border;
+								for (integer r = 0;r < m;++r)
+								{
+									outRun[r] += value;
+								}
+							}
+						}
+					}
+				}
+			};
+
+			if (parallel)
+			{
+				tbb::parallel_for(Block(0, groups * runs), resample);
+			}
+			else
+			{
+				resample(Block(0, groups * runs));
+			}
+		}
+
+	}
+
+}
+
+#endif
@@ -10,8 +10,7 @@ namespace Pastel
 
 	//! Computes a discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Real_ConstRange, 
@@ -34,8 +33,7 @@ namespace Pastel
 
 	//! Computes an inverse discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Real_ConstRange, 
@@ -58,8 +56,7 @@ namespace Pastel
 
 	//! Computes an orthogonal discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Real_ConstRange, 
@@ -82,8 +79,7 @@ namespace Pastel
 
 	//! Computes an inverse orthogonal discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Real_ConstRange, 
@@ -107,8 +103,7 @@ namespace Pastel
 
 	//! Computes a complex discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Complex_ConstRange, 
@@ -131,8 +126,7 @@ namespace Pastel
 
 	//! Computes an inverse complex discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Complex_ConstRange, 
@@ -155,8 +149,7 @@ namespace Pastel
 
 	//! Computes a unitary discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Complex_ConstRange, 
@@ -179,15 +172,14 @@ namespace Pastel
 
 	//! Computes an inverse unitary discrete cosine transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 	template <
 		typename Complex_ConstRange, 
 		typename Complex_Range>
 	void inverseUnitaryDct(
 		const Complex_ConstRange& input,
-		Complex_Range output);
+		const Complex_Range& output);
 
 	//! Computes an inverse unitary discrete cosine transform.
 	/*!
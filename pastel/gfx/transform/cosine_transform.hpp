@@ -176,9 +176,8 @@ namespace Pastel
 			}
 
 			integer n = inputRange.size();
-			ENSURE1(isPowerOfTwo(n), n);
 
-			if (n <= 4)
+			if (n <= 4 && isPowerOfTwo(n))
 			{
 				discreteCosineSmall<Orthogonal, ComplexOutput>(inputRange, outputRange);
 				return;
@@ -289,11 +288,42 @@ namespace Pastel
 			}
 
 			integer n = inputRange.size();
-			ENSURE1(isPowerOfTwo(n), n);
 
 			auto input = inputRange.begin();
 			auto output = outputRange.begin();
 
+			if (ComplexOutput)
+			{
+				// The algorithm below takes the real part of a
+				// complex transform, and so is only real-linear.
+				// Transform the real and imaginary parts separately.
+				std::vector<Real> realSet;
+				realSet.reserve(n);
+				std::vector<Real> imagSet;
+				imagSet.reserve(n);
+				for (integer i = 0;i < n;++i)
+				{
+					Complex x(*input);
+					realSet.push_back(x.real());
+					imagSet.push_back(x.imag());
+					++input;
+				}
+
+				inverseDiscreteCosine<Orthogonal, false>(
+					range(realSet.begin(), realSet.end()),
+					range(realSet.begin(), realSet.end()));
+				inverseDiscreteCosine<Orthogonal, false>(
+					range(imagSet.begin(), imagSet.end()),
+					range(imagSet.begin(), imagSet.end()));
+
+				for (integer i = 0;i < n;++i)
+				{
+					*output = extractOutput(Complex(realSet[i], imagSet[i]));
+					++output;
+				}
+				return;
+			}
+
 			if (n == 1)
 			{
 
@@ -349,6 +379,11 @@ namespace Pastel
 				*output = extractOutput(oddFourier[n - 1 - i]);
 				++output;
 			}
+			if (n % 2 == 1)
+			{
+				*output = extractOutput(oddFourier[nHalf]);
+				++output;
+			}
 		}
 
 	}
@@ -440,10 +475,6 @@ namespace Pastel
 		const Complex_ConstRange& input,
 		const Complex_Range& output)
 	{
-		// FIX: Does not work yet.
-		bool implementationMissing = true;
-		ENSURE(!implementationMissing);
-
 		Dct_::inverseDiscreteCosine<false, true>(input, output);
 	}
 
@@ -477,10 +508,6 @@ namespace Pastel
 		const Complex_ConstRange& input,
 		const Complex_Range& output)
 	{
-		// FIX: Does not work yet.
-		bool implementationMissing = true;
-		ENSURE(!implementationMissing);
-
 		Dct_::inverseDiscreteCosine<true, true>(input, output);
 	}
 
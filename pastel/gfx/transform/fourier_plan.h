@@ -0,0 +1,502 @@
+// Description: Reusable plan for the discrete Fourier transform
+// Documentation: fourier_transform.txt
+
+#ifndef PASTELGFX_FOURIER_PLAN_H
+#define PASTELGFX_FOURIER_PLAN_H
+
+#include "pastel/sys/mytypes.h"
+#include "pastel/sys/ensure.h"
+#include "pastel/sys/math/constants.h"
+
+#include <array>
+#include <complex>
+#include <memory>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! A plan for computing discrete Fourier transforms of a given size.
+	/*!
+	The size n is factored into the radices 4, 2, 3, 5, and 7,
+	and the transform is computed by a mixed-radix Cooley-Tukey
+	algorithm in O(n sum_i p_i) time, where p_i are the factors.
+	If n has a prime factor greater than 7, then the transform
+	is computed by Bluestein's algorithm, which reduces it to a
+	cyclic convolution of power-of-two size m >= 2n - 1, and
+	runs in O(m log(m)) time.
+
+	The twiddle factors, and for Bluestein's algorithm the chirp
+	and its transform, are computed once in the constructor.
+	A plan is immutable after construction, and can be shared
+	between threads.
+	*/
+	template <typename Real>
+	class FourierPlan
+	{
+	public:
+		using Complex = std::complex<Real>;
+
+		//! Constructs a plan for transforms of size n.
+		/*!
+		Preconditions:
+		n >= 0
+		*/
+		explicit FourierPlan(integer n)
+		: n_(n)
+		{
+			ENSURE_OP(n, >=, 0);
+
+			if (n_ <= 1)
+			{
+				return;
+			}
+
+			integer m = n_;
+			auto addFactors = [&](integer p)
+			{
+				while (m % p == 0)
+				{
+					m /= p;
+					factorSet_.push_back(p);
+					factorSet_.push_back(m);
+				}
+			};
+
+			for (integer p : {4, 2, 3, 5, 7})
+			{
+				addFactors(p);
+			}
+
+			if (m > 1)
+			{
+				// There is a prime factor greater than 7;
+				// use Bluestein's algorithm.
+				factorSet_.clear();
+				initializeBluestein();
+				return;
+			}
+
+			twiddleSet_.reserve(n_);
+			for (integer i = 0;i < n_;++i)
+			{
+				twiddleSet_.push_back(twiddle(i, n_));
+			}
+		}
+
+		//! Returns the size of the transform.
+		integer n() const
+		{
+			return n_;
+		}
+
+		//! Returns whether Bluestein's algorithm is used.
+		bool bluestein() const
+		{
+			return convolutionPlan_ != nullptr;
+		}
+
+		//! Computes an unnormalized discrete Fourier transform.
+		/*!
+		input, output:
+		Arrays of n() elements. May be equal.
+
+		inverse:
+		Whether to use the exponent +2 pi i jk / n, rather
+		than -2 pi i jk / n. The result is not divided by n.
+		*/
+		void dft(
+			const Complex* input,
+			Complex* output,
+			bool inverse = false) const
+		{
+			std::vector<Complex> workspace;
+			dft(input, output, inverse, workspace);
+		}
+
+		//! Computes an unnormalized discrete Fourier transform.
+		/*!
+		workspace:
+		A buffer which is resized as needed; to n() elements,
+		or to 2m elements for Bluestein's algorithm. Reusing
+		it over several transforms avoids allocating memory
+		for each transform.
+
+		See the other overload for the other arguments.
+		*/
+		void dft(
+			const Complex* input,
+			Complex* output,
+			bool inverse,
+			std::vector<Complex>& workspace) const
+		{
+			if (n_ <= 1)
+			{
+				if (n_ == 1)
+				{
+					*output = *input;
+				}
+				return;
+			}
+
+			// The inverse transform is computed by
+			// conj(dft(conj(x))).
+			workspace.assign(input, input + n_);
+			if (inverse)
+			{
+				for (Complex& x : workspace)
+				{
+					x = std::conj(x);
+				}
+			}
+
+			if (bluestein())
+			{
+				bluesteinDft(workspace, output);
+			}
+			else
+			{
+				work(output, workspace.data(), 1, factorSet_.data());
+			}
+
+			if (inverse)
+			{
+				for (integer i = 0;i < n_;++i)
+				{
+					output[i] = std::conj(output[i]);
+				}
+			}
+		}
+
+	private:
+		static Complex twiddle(integer i, integer n)
+		{
+			Real angle = -2 * constantPi<Real>() * i / n;
+			return Complex(std::cos(angle), std::sin(angle));
+		}
+
+		void initializeBluestein()
+		{
+			integer m = 1;
+			while (m < 2 * n_ - 1)
+			{
+				m *= 2;
+			}
+
+			// chirp[j] = exp(-pi i j^2 / n). The exponent is reduced
+			// modulo 2n to retain accuracy for large j.
+			chirpSet_.reserve(n_);
+			for (integer j = 0;j < n_;++j)
+			{
+				integer k = (j * j) % (2 * n_);
+				Real angle = -constantPi<Real>() * k / n_;
+				chirpSet_.push_back(Complex(std::cos(angle), std::sin(angle)));
+			}
+
+			convolutionPlan_ = std::make_unique<FourierPlan>(m);
+
+			// The convolution kernel is conj(chirp),
+			// extended symmetrically for the cyclic
+			// convolution.
+			std::vector<Complex> kernelSet(m, Complex(0));
+			kernelSet[0] = std::conj(chirpSet_[0]);
+			for (integer j = 1;j < n_;++j)
+			{
+				kernelSet[j] = std::conj(chirpSet_[j]);
+				kernelSet[m - j] = kernelSet[j];
+			}
+
+			// Include the normalization of the inverse
+			// transform into the kernel.
+			chirpFourierSet_.resize(m);
+			convolutionPlan_->dft(kernelSet.data(), chirpFourierSet_.data());
+			for (Complex& x : chirpFourierSet_)
+			{
+				x /= (Real)m;
+			}
+		}
+
+		//! Computes a dft by Bluestein's algorithm.
+		/*!
+		The input is in the first n elements of the workspace.
+		The workspace is grown to 2m elements, and its halves
+		are the input and the output of the power-of-two
+		transforms, which are run directly, without the
+		copies and allocations of dft().
+		*/
+		void bluesteinDft(
+			std::vector<Complex>& workspace,
+			Complex* output) const
+		{
+			const FourierPlan& plan = *convolutionPlan_;
+			integer m = plan.n();
+
+			workspace.resize(2 * m);
+			Complex* a = workspace.data();
+			Complex* b = a + m;
+
+			for (integer j = 0;j < n_;++j)
+			{
+				a[j] *= chirpSet_[j];
+			}
+			std::fill(a + n_, a + m, Complex(0));
+
+			plan.work(b, a, 1, plan.factorSet_.data());
+
+			// The inverse transform is computed by
+			// conj(dft(conj(x))).
+			for (integer j = 0;j < m;++j)
+			{
+				b[j] = std::conj(b[j] * chirpFourierSet_[j]);
+			}
+			plan.work(a, b, 1, plan.factorSet_.data());
+
+			for (integer k = 0;k < n_;++k)
+			{
+				output[k] = std::conj(a[k]) * chirpSet_[k];
+			}
+		}
+
+		//! Computes a dft of a strided subsequence.
+		/*!
+		The transform of the subsequence input[i * stride] is
+		written to output. The factors list (p, m) pairs, where
+		p is the radix of the step, and m = (size of the
+		subsequence) / p.
+		*/
+		void work(
+			Complex* output,
+			const Complex* input,
+			integer stride,
+			const integer* factor) const
+		{
+			integer p = factor[0];
+			integer m = factor[1];
+
+			if (m == 1)
+			{
+				for (integer q = 0;q < p;++q)
+				{
+					output[q] = input[q * stride];
+				}
+			}
+			else
+			{
+				// Transform the p decimated subsequences.
+				for (integer q = 0;q < p;++q)
+				{
+					work(output + q * m, input + q * stride, stride * p, factor + 2);
+				}
+			}
+
+			switch(p)
+			{
+			case 2:
+				butterfly2(output, stride, m);
+				break;
+			case 3:
+				butterfly3(output, stride, m);
+				break;
+			case 4:
+				butterfly4(output, stride, m);
+				break;
+			case 5:
+				butterfly5(output, stride, m);
+				break;
+			default:
+				butterfly(output, stride, m, p);
+				break;
+			};
+		}
+
+		void butterfly2(Complex* output, integer stride, integer m) const
+		{
+			Complex* output2 = output + m;
+			for (integer k = 0;k < m;++k)
+			{
+				Complex t = output2[k] * twiddleSet_[k * stride];
+				output2[k] = output[k] - t;
+				output[k] += t;
+			}
+		}
+
+		void butterfly3(Complex* output, integer stride, integer m) const
+		{
+			// The imaginary part of exp(-2 pi i / 3).
+			Real epi3 = twiddleSet_[stride * m].imag();
+
+			for (integer k = 0;k < m;++k)
+			{
+				Complex a0 = output[k];
+				Complex a1 = output[k + m] * twiddleSet_[k * stride];
+				Complex a2 = output[k + 2 * m] * twiddleSet_[2 * k * stride];
+
+				Complex s = a1 + a2;
+				Complex t = a0 - s * (Real)0.5;
+				Complex v = (a1 - a2) * epi3;
+
+				output[k] = a0 + s;
+				// t + i v
+				output[k + m] = Complex(t.real() - v.imag(), t.imag() + v.real());
+				// t - i v
+				output[k + 2 * m] = Complex(t.real() + v.imag(), t.imag() - v.real());
+			}
+		}
+
+		void butterfly5(Complex* output, integer stride, integer m) const
+		{
+			// exp(-2 pi i / 5) and exp(-4 pi i / 5).
+			Complex ya = twiddleSet_[stride * m];
+			Complex yb = twiddleSet_[2 * stride * m];
+
+			for (integer k = 0;k < m;++k)
+			{
+				Complex a0 = output[k];
+				Complex a1 = output[k + m] * twiddleSet_[k * stride];
+				Complex a2 = output[k + 2 * m] * twiddleSet_[2 * k * stride];
+				Complex a3 = output[k + 3 * m] * twiddleSet_[3 * k * stride];
+				Complex a4 = output[k + 4 * m] * twiddleSet_[4 * k * stride];
+
+				Complex s14 = a1 + a4;
+				Complex d14 = a1 - a4;
+				Complex s23 = a2 + a3;
+				Complex d23 = a2 - a3;
+
+				output[k] = a0 + s14 + s23;
+
+				Complex b = a0 + s14 * ya.real() + s23 * yb.real();
+				Complex c(
+					d14.imag() * ya.imag() + d23.imag() * yb.imag(),
+					-d14.real() * ya.imag() - d23.real() * yb.imag());
+				output[k + m] = b - c;
+				output[k + 4 * m] = b + c;
+
+				Complex e = a0 + s14 * yb.real() + s23 * ya.real();
+				Complex f(
+					-d14.imag() * yb.imag() + d23.imag() * ya.imag(),
+					d14.real() * yb.imag() - d23.real() * ya.imag());
+				output[k + 2 * m] = e + f;
+				output[k + 3 * m] = e - f;
+			}
+		}
+
+		void butterfly4(Complex* output, integer stride, integer m) const
+		{
+			for (integer k = 0;k < m;++k)
+			{
+				Complex a0 = output[k];
+				Complex a1 = output[k + m] * twiddleSet_[k * stride];
+				Complex a2 = output[k + 2 * m] * twiddleSet_[2 * k * stride];
+				Complex a3 = output[k + 3 * m] * twiddleSet_[3 * k * stride];
+
+				Complex b0 = a0 + a2;
+				Complex b1 = a0 - a2;
+				Complex b2 = a1 + a3;
+				// -i (a1 - a3)
+				Complex b3(
+					a1.imag() - a3.imag(),
+					a3.real() - a1.real());
+
+				output[k] = b0 + b2;
+				output[k + m] = b1 + b3;
+				output[k + 2 * m] = b0 - b2;
+				output[k + 3 * m] = b1 - b3;
+			}
+		}
+
+		void butterfly(Complex* output, integer stride, integer m, integer p) const
+		{
+			std::array<Complex, 7> scratch;
+			ASSERT_OP(p, <=, 7);
+
+			for (integer u = 0;u < m;++u)
+			{
+				for (integer q = 0;q < p;++q)
+				{
+					scratch[q] = output[u + q * m];
+				}
+
+				for (integer q = 0;q < p;++q)
+				{
+					integer k = u + q * m;
+					integer step = stride * k;
+
+					Complex sum = scratch[0];
+					integer i = 0;
+					for (integer r = 1;r < p;++r)
+					{
+						i += step;
+						if (i >= n_)
+						{
+							i %= n_;
+						}
+						sum += scratch[r] * twiddleSet_[i];
+					}
+					output[k] = sum;
+				}
+			}
+		}
+
+		integer n_ = 0;
+		std::vector<integer> factorSet_;
+		std::vector<Complex> twiddleSet_;
+
+		std::unique_ptr<FourierPlan> convolutionPlan_;
+		std::vector<Complex> chirpSet_;
+		std::vector<Complex> chirpFourierSet_;
+	};
+
+	namespace FourierPlan_
+	{
+
+		//! The number of plans kept by fourierPlan().
+		static constexpr integer CachedPlans = 32;
+
+	}
+
+	//! Returns a shared plan for transforms of size n.
+	/*!
+	The plans are created on first use, and then
+	reused for later transforms of the same size.
+	Thread-safe.
+
+	The cache keeps the FourierPlan_::CachedPlans most
+	recently used plans, so that transforms of many
+	different sizes do not accumulate memory. An evicted
+	plan lives on for as long as it is shared; callers
+	which transform a size repeatedly should hold on to
+	the returned plan, or construct their own.
+	*/
+	template <typename Real>
+	std::shared_ptr<const FourierPlan<Real>> fourierPlan(integer n)
+	{
+		using Plan = std::shared_ptr<const FourierPlan<Real>>;
+
+		static std::mutex mutex;
+		// The most recently used plan is at the front.
+		static std::list<Plan> planSet;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto iter = std::find_if(
+			planSet.begin(), planSet.end(),
+			[&](const Plan& plan) {return plan->n() == n;});
+		if (iter != planSet.end())
+		{
+			planSet.splice(planSet.begin(), planSet, iter);
+			return planSet.front();
+		}
+
+		planSet.push_front(std::make_shared<const FourierPlan<Real>>(n));
+		if ((integer)planSet.size() > FourierPlan_::CachedPlans)
+		{
+			planSet.pop_back();
+		}
+		return planSet.front();
+	}
+
+}
+
+#endif
@@ -16,8 +16,7 @@ namespace Pastel
 
 	//! Computes a discrete Fourier transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 
 	template <
@@ -41,8 +40,7 @@ namespace Pastel
 
 	//! Computes a unitary discrete Fourier transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 
 	template <
@@ -66,8 +64,7 @@ namespace Pastel
 
 	//! Computes an inverse discrete Fourier transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 
 	template <
@@ -91,8 +88,7 @@ namespace Pastel
 
 	//! Computes an inverse unitary discrete Fourier transform.
 	/*!
-	Preconditions:
-	isPowerOfTwo(input.size())
+	The input may be of any size; see FourierPlan.
 	*/
 
 	template <
@@ -2,6 +2,7 @@
 #define PASTELGFX_FOURIER_TRANSFORM_HPP
 
 #include "pastel/gfx/transform/fourier_transform.h"
+#include "pastel/gfx/transform/fourier_plan.h"
 
 #include "pastel/sys/math/constants.h"
 #include "pastel/sys/ensure.h"
@@ -10,6 +11,7 @@
 #include "pastel/sys/view/view_tools.h"
 
 #include <complex>
+#include <vector>
 
 namespace Pastel
 {
@@ -31,136 +33,12 @@ namespace Pastel
 			using Result = Real;
 		};
 
-		template <bool Inverse, bool TopLevel, bool Orthogonal, 
-			typename Complex_ConstRange, typename Complex_Range>
-		void discreteFourierSmall(
-			const Complex_ConstRange& inputRange,
-			const Complex_Range& outputRange)
-		{
-			typedef typename Complex_RealType<
-				ranges::range_value_t<Complex_ConstRange>>::Result Real;
-			using Complex = std::complex<Real>;
-			typedef ranges::iterator_t<Complex_ConstRange>
-				ConstIterator;
-
-			auto input = inputRange.begin();
-			auto output = outputRange.begin();
-
-			integer n = inputRange.size();
-			ENSURE_OP(n, <=, 8);
-			ENSURE1(isPowerOfTwo(n), n);
-
-			Real Normalization =
-				n == 1 ? 1 :
-				Orthogonal ? inverse(std::sqrt((Real)n)) :
-				(Inverse ? inverse((Real)n) : 1);
-
-			bool Normalize =
-				(Inverse || Orthogonal) && TopLevel;
-
-			switch(n)
-			{
-			case 1:
-				{
-					// Size 1 dft
-					const Complex a0(*input);
-					++input;
-
-					*output = a0;
-					++output;
-				}
-				break;
-			case 2:
-				{
-					// Size 1 dfts
-					const Complex a0(*input);
-					++input;
-					const Complex a1(*input);
-					++input;
-
-					// Size 2 dft
-					if (Normalize)
-					{
-						*output = (a0 + a1) * Normalization;
-						++output;
-
-						*output = (a0 - a1) * Normalization;
-						++output;
-					}
-					else
-					{
-						*output = a0 + a1;
-						++output;
-
-						*output = a0 - a1;
-						++output;
-					}
-				}
-				break;
-			case 4:
-				{
-					// Size 1 dfts
-					const Complex a0(*input);
-					++input;
-					const Complex a1(*input);
-					++input;
-					const Complex a2(*input);
-					++input;
-					const Complex a3(*input);
-					++input;
-
-					// Size-2 dfts
-					Complex b0(a0 + a2);
-					Complex b1(a0 - a2);
-					Complex b2(a1 + a3);
-					Complex b3(a1 - a3);
-
-					Complex im(0, 
-						Inverse ? -1 : 1);
-					
-					// Size-4 dft
-					if (Normalize)
-					{
-
-						*output = (b0 + b2) * Normalization;
-						++output;
-
-						*output = (b1 - im * b3) * Normalization;
-						++output;
-
-						*output = (b0 - b2) * Normalization;
-						++output;
-
-						*output = (b1 + im * b3) * Normalization;
-						++output;
-					}
-					else
-					{
-						*output = b0 + b2;
-						++output;
-
-						*output = b1 - im * b3;
-						++output;
-
-						*output = b0 - b2;
-						++output;
-
-						*output = b1 + im * b3;
-						++output;
-					}
-				}
-				break;
-			};
-		}
-
-		template <bool Inverse, bool TopLevel, bool Orthogonal,
+		template <bool Inverse, bool Orthogonal,
 			typename Complex_ConstRange, typename Complex_Range>
 		void discreteFourier(
 			const Complex_ConstRange& inputRange,
 			const Complex_Range& outputRange)
 		{
-			using namespace Fourier_;
-
 			typedef ranges::range_value_t<Complex_ConstRange>
 				InputComplex;
 			using Real = typename Complex_RealType<InputComplex>::Result;
@@ -172,109 +50,37 @@ namespace Pastel
 			}
 
 			integer n = inputRange.size();
-			ENSURE1(isPowerOfTwo(n), n);
-
-			if (n <= 4)
-			{
-				// As base-cases we handle 1, 2, and 4 size 
-				// instances by hand.
-
-				Fourier_::discreteFourierSmall<Inverse, TopLevel, Orthogonal>(
-					inputRange, outputRange);
-				return;
-			}
-
-			integer nHalf = n / 2;
-
-			// Separate the inputRange into odd-index and 
-			// even-index subsequences.
 
+			std::vector<Complex> data;
+			data.reserve(n);
 			auto input = inputRange.begin();
-			auto output = outputRange.begin();
-
-			std::vector<Complex> evenFourier;
-			evenFourier.reserve(nHalf);
-			std::vector<Complex> oddFourier;
-			oddFourier.reserve(nHalf);
-			for (integer i = 0;i < nHalf;++i)
+			for (integer i = 0;i < n;++i)
 			{
-
-				evenFourier.push_back(*input);
-				++input;
-				oddFourier.push_back(*input);
+				data.push_back(Complex(*input));
 				++input;
 			}
 
-			// Find out the Fourier transformation
-			// of the even-index subsequence.
-			discreteFourier<Inverse, false, Orthogonal>(
-				range(evenFourier.begin(), evenFourier.end()),
-				range(evenFourier.begin(), evenFourier.end()));
-
-			// Find out the Fourier transformation
-			// of the odd-index subsequence.
-			discreteFourier<Inverse, false, Orthogonal>(
-				range(oddFourier.begin(), oddFourier.end()),
-				range(oddFourier.begin(), oddFourier.end()));
-
-			// Combine the results
-
-			Real NthRootAngle =
-				(Inverse ? 2 : -2) * constantPi<Real>() / n;
-
-			Complex NthRoot(
-				std::cos(NthRootAngle),
-				std::sin(NthRootAngle));
+			fourierPlan<Real>(n)->dft(data.data(), data.data(), Inverse);
 
 			Real Normalization =
 				Orthogonal ? inverse(std::sqrt((Real)n)) :
 				(Inverse ? inverse((Real)n) : 1);
 
 			bool Normalize =
-				(Inverse || Orthogonal) && TopLevel;
+				(Inverse || Orthogonal) && n > 1;
 
-			// Report the first half of the dft.
+			auto output = outputRange.begin();
+			for (integer i = 0;i < n;++i)
 			{
-				Complex oddFactor(1);
-						
-				for (integer i = 0;i < nHalf;++i)
+				if (Normalize)
 				{
-					if (Normalize)
-					{
-						*output = (evenFourier[i] +
-							oddFactor * oddFourier[i]) * Normalization;
-					}
-					else
-					{
-						*output = evenFourier[i] +
-							oddFactor * oddFourier[i];
-					}
-					++output;
-
-					oddFactor *= NthRoot;
+					*output = data[i] * Normalization;
 				}
-			}
-
-			// Report the second half of the dft.
-			{
-				Complex oddFactor(1);
-
-				for (integer i = 0;i < nHalf;++i)
+				else
 				{
-					if (Normalize)
-					{
-						*output = (evenFourier[i] -
-							oddFactor * oddFourier[i]) * Normalization;
-					}
-					else
-					{
-						*output = evenFourier[i] -
-							oddFactor * oddFourier[i];
-					}
-					++output;
-
-					oddFactor *= NthRoot;
+					*output = data[i];
 				}
+				++output;
 			}
 		}
 
@@ -287,7 +93,7 @@ namespace Pastel
 		const Complex_ConstRange& input,
 		const Complex_Range& output)
 	{
-		Fourier_::discreteFourier<false, true, false>(
+		Fourier_::discreteFourier<false, false>(
 			input, output);
 	}
 
@@ -305,7 +111,7 @@ namespace Pastel
 		const Complex_ConstRange& input,
 		const Complex_Range& output)
 	{
-		Fourier_::discreteFourier<false, true, true>(
+		Fourier_::discreteFourier<false, true>(
 			input, output);
 	}
 
@@ -323,7 +129,7 @@ namespace Pastel
 		const Complex_ConstRange& input,
 		const Complex_Range& output)
 	{
-		Fourier_::discreteFourier<true, true, false>(
+		Fourier_::discreteFourier<true, false>(
 			input, output);
 	}
 
@@ -341,7 +147,7 @@ namespace Pastel
 		const Complex_ConstRange& input,
 		const Complex_Range& output)
 	{
-		Fourier_::discreteFourier<true, true, true>(
+		Fourier_::discreteFourier<true, true>(
 			input, output);
 	}
 
@@ -0,0 +1,140 @@
+// Description: Multi-dimensional discrete Fourier transform
+// Documentation: fourier_transform.txt
+
+#ifndef PASTELGFX_FOURIER_TRANSFORM_N_H
+#define PASTELGFX_FOURIER_TRANSFORM_N_H
+
+#include "pastel/sys/mytypes.h"
+#include "pastel/sys/subarray.h"
+
+#include <complex>
+
+namespace Pastel
+{
+
+	//! Computes a multi-dimensional discrete Fourier transform in-place.
+	/*!
+	data:
+	The array to transform. Any extents are allowed.
+
+	The transform is computed by 1-dimensional transforms
+	along each axis in turn. The lines along an axis are
+	processed in blocks: a block of neighboring lines is
+	gathered into a contiguous buffer (a blocked transpose),
+	transformed, and scattered back, so that the memory is
+	accessed by contiguous runs also along the non-contiguous
+	axes. The blocks are distributed over threads.
+
+	Optional arguments
+	------------------
+
+	unitary (bool):
+	Whether to compute the unitary transform, which
+	is scaled by 1 / sqrt(data.size()).
+	Default: false
+
+	parallel (bool):
+	Whether to distribute the lines over threads.
+	Default: true
+
+	blockSize (integer >= 1):
+	The number of lines to transform as a block.
+	Default: 16
+	*/
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void fftN(
+		const SubArray<std::complex<Real>, N>& data,
+		ArgumentSet&&... argumentSet);
+
+	//! Computes a multi-dimensional inverse discrete Fourier transform in-place.
+	/*!
+	The result is scaled by 1 / data.size(), or by
+	1 / sqrt(data.size()) if 'unitary' is true.
+
+	See fftN() for the arguments.
+	*/
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void inverseFftN(
+		const SubArray<std::complex<Real>, N>& data,
+		ArgumentSet&&... argumentSet);
+
+	//! Computes a multi-dimensional discrete Fourier transform of real data.
+	/*!
+	Preconditions:
+	output.extent()[0] == input.extent()[0] / 2 + 1
+	output.extent()[i] == input.extent()[i], for i > 0
+
+	input:
+	The real array to transform.
+
+	output:
+	The non-redundant half of the spectrum. Since the
+	spectrum of real data is conjugate-symmetric, the
+	elements with the first coordinate greater than
+	input.extent()[0] / 2 are left out.
+
+	The transforms along the first axis are computed as
+	real-to-complex transforms of half the size, after which
+	the remaining axes are transformed on the half-spectrum;
+	this halves both the memory and the time compared to
+	fftN() on complex data.
+
+	See fftN() for the optional arguments.
+	*/
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void realFftN(
+		const ConstSubArray<Real, N>& input,
+		const SubArray<std::complex<Real>, N>& output,
+		ArgumentSet&&... argumentSet);
+
+	//! Computes a multi-dimensional discrete Fourier transform of real data.
+	/*!
+	This is a convenience function that calls
+	realFftN(ConstSubArray<Real, N>(input), output, argumentSet...).
+	*/
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void realFftN(
+		const SubArray<Real, N>& input,
+		const SubArray<std::complex<Real>, N>& output,
+		ArgumentSet&&... argumentSet);
+
+	//! Computes a multi-dimensional inverse discrete Fourier transform to real data.
+	/*!
+	Preconditions:
+	input.extent()[0] == output.extent()[0] / 2 + 1
+	input.extent()[i] == output.extent()[i], for i > 0
+
+	input:
+	The half-spectrum, as computed by realFftN().
+	Used as a workspace, and overwritten.
+
+	output:
+	The real array to store the result in.
+
+	The result is scaled by 1 / output.size(), or by
+	1 / sqrt(output.size()) if 'unitary' is true.
+	This is the inverse of realFftN().
+
+	See fftN() for the optional arguments.
+	*/
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void inverseRealFftN(
+		const SubArray<std::complex<Real>, N>& input,
+		const SubArray<Real, N>& output,
+		ArgumentSet&&... argumentSet);
+
+}
+
+#include "pastel/gfx/transform/fourier_transform_n.hpp"
+
+#endif
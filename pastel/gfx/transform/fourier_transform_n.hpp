@@ -0,0 +1,589 @@
+#ifndef PASTELGFX_FOURIER_TRANSFORM_N_HPP
+#define PASTELGFX_FOURIER_TRANSFORM_N_HPP
+
+#include "pastel/gfx/transform/fourier_transform_n.h"
+#include "pastel/gfx/transform/fourier_plan.h"
+
+#include "pastel/sys/ensure.h"
+#include "pastel/sys/named_parameter.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Pastel
+{
+
+	namespace FftN_
+	{
+
+		//! Returns the axes other than the given axis.
+		/*!
+		The axes are ordered by increasing stride, so that
+		lineOffsets() varies the axis with the smallest stride
+		fastest; consecutive lines are then neighbors in memory
+		whenever possible.
+		*/
+		template <int N>
+		std::vector<integer> lineAxes(
+			const Vector<integer, N>& stride,
+			integer axis)
+		{
+			integer d = stride.n();
+
+			std::vector<integer> axisSet;
+			for (integer i = 0;i < d;++i)
+			{
+				if (i != axis)
+				{
+					axisSet.push_back(i);
+				}
+			}
+
+			std::stable_sort(axisSet.begin(), axisSet.end(),
+				[&](integer left, integer right)
+				{
+					return std::abs(stride[left]) < std::abs(stride[right]);
+				});
+
+			return axisSet;
+		}
+
+		//! Returns the offsets of the lines along an axis.
+		/*!
+		axisSet:
+		The other axes, in the order from the fastest
+		varying to the slowest varying.
+		*/
+		template <int N>
+		std::vector<integer> lineOffsets(
+			const Vector<integer, N>& extent,
+			const Vector<integer, N>& stride,
+			const std::vector<integer>& axisSet)
+		{
+			integer lines = 1;
+			for (integer i : axisSet)
+			{
+				lines *= extent[i];
+			}
+
+			std::vector<integer> offsetSet;
+			offsetSet.reserve(lines);
+			if (lines == 0)
+			{
+				return offsetSet;
+			}
+
+			std::vector<integer> position(axisSet.size(), 0);
+			integer offset = 0;
+			for (integer line = 0;line < lines;++line)
+			{
+				offsetSet.push_back(offset);
+
+				for (integer j = 0;j < axisSet.size();++j)
+				{
+					integer i = axisSet[j];
+					++position[j];
+					offset += stride[i];
+					if (position[j] < extent[i])
+					{
+						break;
+					}
+					offset -= position[j] * stride[i];
+					position[j] = 0;
+				}
+			}
+
+			return offsetSet;
+		}
+
+		//! Transforms the lines along an axis.
+		/*!
+		transformLine(bufferLine):
+		Transforms a line which has been gathered
+		contiguously into the buffer.
+
+		The blocks of lines are gathered into a buffer in
+		the order which accesses the memory contiguously:
+		line by line if the axis has the smallest stride,
+		and element by element otherwise.
+		*/
+		template <
+			typename Complex, int N,
+			typename Transform_Line>
+		void forEachLine(
+			Complex* data,
+			const Vector<integer, N>& extent,
+			const Vector<integer, N>& stride,
+			integer axis,
+			integer blockSize,
+			bool parallel,
+			const Transform_Line& transformLine)
+		{
+			integer n = extent[axis];
+			integer axisStride = stride[axis];
+
+			std::vector<integer> offsetSet =
+				lineOffsets(extent, stride, lineAxes(stride, axis));
+			integer lines = offsetSet.size();
+			if (lines == 0 || n == 0)
+			{
+				return;
+			}
+
+			bool lineOuter =
+				lines == 1 ||
+				std::abs(axisStride) <= std::abs(offsetSet[1] - offsetSet[0]);
+
+			using Block = tbb::blocked_range<integer>;
+
+			auto transformBlocks = [&](const Block& blockRange)
+			{
+				std::vector<Complex> buffer(blockSize * n);
+
+				for (integer b = blockRange.begin();b < blockRange.end();++b)
+				{
+					integer begin = b * blockSize;
+					integer m = std::min(lines - begin, blockSize);
+					const integer* offset = offsetSet.data() + begin;
+
+					if (lineOuter)
+					{
+						for (integer j = 0;j < m;++j)
+						{
+							const Complex* line = data + offset[j];
+							Complex* bufferLine = buffer.data() + j * n;
+							for (integer i = 0;i < n;++i)
+							{
+								bufferLine[i] = line[i * axisStride];
+							}
+						}
+					}
+					else
+					{
+						for (integer i = 0;i < n;++i)
+						{
+							const Complex* element = data + i * axisStride;
+							for (integer j = 0;j < m;++j)
+							{
+								buffer[j * n + i] = element[offset[j]];
+							}
+						}
+					}
+
+					for (integer j = 0;j < m;++j)
+					{
+						transformLine(buffer.data() + j * n);
+					}
+
+					if (lineOuter)
+					{
+						for (integer j = 0;j < m;++j)
+						{
+							Complex* line = data + offset[j];
+							const Complex* bufferLine = buffer.data() + j * n;
+							for (integer i = 0;i < n;++i)
+							{
+								line[i * axisStride] = bufferLine[i];
+							}
+						}
+					}
+					else
+					{
+						for (integer i = 0;i < n;++i)
+						{
+							Complex* element = data + i * axisStride;
+							for (integer j = 0;j < m;++j)
+							{
+								element[offset[j]] = buffer[j * n + i];
+							}
+						}
+					}
+				}
+			};
+
+			integer blocks = (lines + blockSize - 1) / blockSize;
+			if (parallel)
+			{
+				tbb::parallel_for(Block(0, blocks), transformBlocks);
+			}
+			else
+			{
+				transformBlocks(Block(0, blocks));
+			}
+		}
+
+		//! Transforms all the lines of all the axes in the given range.
+		template <typename Real, int N>
+		void transformAxes(
+			const SubArray<std::complex<Real>, N>& data,
+			integer axisBegin,
+			integer axisEnd,
+			bool inverse,
+			integer blockSize,
+			bool parallel)
+		{
+			using Complex = std::complex<Real>;
+
+			for (integer axis = axisBegin;axis < axisEnd;++axis)
+			{
+				integer n = data.extent()[axis];
+				if (n <= 1)
+				{
+					continue;
+				}
+
+				auto plan = fourierPlan<Real>(n);
+
+				tbb::enumerable_thread_specific<std::vector<Complex>> workspaceSet;
+
+				forEachLine(
+					data.data(), data.extent(), data.stride(),
+					axis, blockSize, parallel,
+					[&](Complex* line)
+					{
+						plan->dft(line, line, inverse, workspaceSet.local());
+					});
+			}
+		}
+
+		//! Multiplies each element of an array by a scalar.
+		template <typename Type, int N, typename Real>
+		void scale(
+			const SubArray<Type, N>& data,
+			const Real& factor)
+		{
+			for (auto& x : data.range())
+			{
+				x *= factor;
+			}
+		}
+
+		//! Returns the factor to scale the result with.
+		template <typename Real>
+		Real normalization(integer size, bool inverseTransform, bool unitary)
+		{
+			if (unitary)
+			{
+				return inverse(std::sqrt((Real)size));
+			}
+
+			return inverseTransform ? inverse((Real)size) : 1;
+		}
+
+	}
+
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void fftN(
+		const SubArray<std::complex<Real>, N>& data,
+		ArgumentSet&&... argumentSet)
+	{
+		bool unitary = PASTEL_ARG_S(unitary, false);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer blockSize = PASTEL_ARG_S(blockSize, 16);
+		ENSURE_OP(blockSize, >=, 1);
+
+		FftN_::transformAxes(data, 0, data.n(), false, blockSize, parallel);
+
+		if (unitary && data.size() > 1)
+		{
+			FftN_::scale(data, FftN_::normalization<Real>(data.size(), false, true));
+		}
+	}
+
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void inverseFftN(
+		const SubArray<std::complex<Real>, N>& data,
+		ArgumentSet&&... argumentSet)
+	{
+		bool unitary = PASTEL_ARG_S(unitary, false);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer blockSize = PASTEL_ARG_S(blockSize, 16);
+		ENSURE_OP(blockSize, >=, 1);
+
+		FftN_::transformAxes(data, 0, data.n(), true, blockSize, parallel);
+
+		if (data.size() > 1)
+		{
+			FftN_::scale(data, FftN_::normalization<Real>(data.size(), true, unitary));
+		}
+	}
+
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void realFftN(
+		const ConstSubArray<Real, N>& input,
+		const SubArray<std::complex<Real>, N>& output,
+		ArgumentSet&&... argumentSet)
+	{
+		using Complex = std::complex<Real>;
+
+		bool unitary = PASTEL_ARG_S(unitary, false);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer blockSize = PASTEL_ARG_S(blockSize, 16);
+		ENSURE_OP(blockSize, >=, 1);
+
+		integer d = input.n();
+		ENSURE_OP(d, ==, output.n());
+		ENSURE_OP(output.extent()[0], ==, input.extent()[0] / 2 + 1);
+		for (integer i = 1;i < d;++i)
+		{
+			ENSURE_OP(output.extent()[i], ==, input.extent()[i]);
+		}
+
+		integer n = input.extent()[0];
+		if (input.size() == 0)
+		{
+			return;
+		}
+
+		integer h = n / 2;
+		bool packed = n % 2 == 0 && n >= 2;
+
+		// A real line of even size n is transformed by a complex
+		// transform of size n / 2, with the even and odd elements
+		// packed as the real and imaginary parts.
+		auto plan = fourierPlan<Real>(packed ? h : n);
+
+		std::vector<Complex> twiddleSet;
+		if (packed)
+		{
+			twiddleSet.reserve(h);
+			for (integer k = 0;k < h;++k)
+			{
+				Real angle = -2 * constantPi<Real>() * k / n;
+				twiddleSet.emplace_back(std::cos(angle), std::sin(angle));
+			}
+		}
+
+		// Transform the first axis.
+		// The lines of the input and the output correspond
+		// one-to-one when they are enumerated in the same order.
+		std::vector<integer> axisSet = 
+			FftN_::lineAxes(output.stride(), 0);
+		std::vector<integer> inputOffsetSet =
+			FftN_::lineOffsets(input.extent(), input.stride(), axisSet);
+		std::vector<integer> outputOffsetSet =
+			FftN_::lineOffsets(output.extent(), output.stride(), axisSet);
+		integer lines = inputOffsetSet.size();
+
+		using Block = tbb::blocked_range<integer>;
+
+		auto transformLines = [&](const Block& block)
+		{
+			std::vector<Complex> z(packed ? h : n);
+
+			for (integer line = block.begin();line < block.end();++line)
+			{
+				const Real* x = input.data() + inputOffsetSet[line];
+				integer xStride = input.stride()[0];
+				Complex* y = output.data() + outputOffsetSet[line];
+				integer yStride = output.stride()[0];
+
+				if (!packed)
+				{
+					for (integer i = 0;i < n;++i)
+					{
+						z[i] = x[i * xStride];
+					}
+					plan->dft(z.data(), z.data());
+					for (integer k = 0;k <= h;++k)
+					{
+						y[k * yStride] = z[k];
+					}
+					continue;
+				}
+
+				for (integer j = 0;j < h;++j)
+				{
+					z[j] = Complex(x[2 * j * xStride], x[(2 * j + 1) * xStride]);
+				}
+				plan->dft(z.data(), z.data());
+
+				// Separate the transforms of the even and odd
+				// elements, and combine them by a radix-2 step.
+				for (integer k = 0;k <= h;++k)
+				{
+					Complex a = z[k < h ? k : 0];
+					Complex b = std::conj(z[k > 0 ? h - k : 0]);
+					Complex even = (a + b) * (Real)0.5;
+					Complex odd = (a - b) * Complex(0, -0.5);
+					Complex w = k < h ? twiddleSet[k] : Complex(-1);
+					y[k * yStride] = even + w * odd;
+				}
+			}
+		};
+
+		if (parallel)
+		{
+			tbb::parallel_for(Block(0, lines, blockSize), transformLines);
+		}
+		else
+		{
+			transformLines(Block(0, lines, blockSize));
+		}
+
+		// Transform the remaining axes on the half-spectrum.
+		FftN_::transformAxes(output, 1, d, false, blockSize, parallel);
+
+		if (unitary && input.size() > 1)
+		{
+			FftN_::scale(output, FftN_::normalization<Real>(input.size(), false, true));
+		}
+	}
+
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void realFftN(
+		const SubArray<Real, N>& input,
+		const SubArray<std::complex<Real>, N>& output,
+		ArgumentSet&&... argumentSet)
+	{
+		Pastel::realFftN(
+			ConstSubArray<Real, N>(input), output,
+			std::forward<ArgumentSet>(argumentSet)...);
+	}
+
+	template <
+		typename Real, int N,
+		typename... ArgumentSet>
+	void inverseRealFftN(
+		const SubArray<std::complex<Real>, N>& input,
+		const SubArray<Real, N>& output,
+		ArgumentSet&&... argumentSet)
+	{
+		using Complex = std::complex<Real>;
+
+		bool unitary = PASTEL_ARG_S(unitary, false);
+		bool parallel = PASTEL_ARG_S(parallel, true);
+		integer blockSize = PASTEL_ARG_S(blockSize, 16);
+		ENSURE_OP(blockSize, >=, 1);
+
+		integer d = output.n();
+		ENSURE_OP(d, ==, input.n());
+		ENSURE_OP(input.extent()[0], ==, output.extent()[0] / 2 + 1);
+		for (integer i = 1;i < d;++i)
+		{
+			ENSURE_OP(input.extent()[i], ==, output.extent()[i]);
+		}
+
+		integer n = output.extent()[0];
+		if (output.size() == 0)
+		{
+			return;
+		}
+
+		// Transform the remaining axes on the half-spectrum.
+		FftN_::transformAxes(input, 1, d, true, blockSize, parallel);
+
+		integer h = n / 2;
+		bool packed = n % 2 == 0 && n >= 2;
+
+		auto plan = fourierPlan<Real>(packed ? h : n);
+
+		std::vector<Complex> twiddleSet;
+		if (packed)
+		{
+			twiddleSet.reserve(h);
+			for (integer k = 0;k < h;++k)
+			{
+				Real angle = 2 * constantPi<Real>() * k / n;
+				twiddleSet.emplace_back(std::cos(angle), std::sin(angle));
+			}
+		}
+
+		Real factor = FftN_::normalization<Real>(output.size(), true, unitary);
+		if (output.size() == 1)
+		{
+			factor = 1;
+		}
+
+		// The lines of the input and the output correspond
+		// one-to-one when they are enumerated in the same order.
+		std::vector<integer> axisSet = 
+			FftN_::lineAxes(output.stride(), 0);
+		std::vector<integer> inputOffsetSet =
+			FftN_::lineOffsets(input.extent(), input.stride(), axisSet);
+		std::vector<integer> outputOffsetSet =
+			FftN_::lineOffsets(output.extent(), output.stride(), axisSet);
+		integer lines = inputOffsetSet.size();
+
+		using Block = tbb::blocked_range<integer>;
+
+		auto transformLines = [&](const Block& block)
+		{
+			std::vector<Complex> z(packed ? h : n);
+
+			for (integer line = block.begin();line < block.end();++line)
+			{
+				const Complex* y = input.data() + inputOffsetSet[line];
+				integer yStride = input.stride()[0];
+				Real* x = output.data() + outputOffsetSet[line];
+				integer xStride = output.stride()[0];
+
+				if (!packed)
+				{
+					// Reconstruct the full spectrum by
+					// conjugate-symmetry.
+					for (integer k = 0;k <= h;++k)
+					{
+						z[k] = y[k * yStride];
+					}
+					for (integer k = h + 1;k < n;++k)
+					{
+						z[k] = std::conj(z[n - k]);
+					}
+					plan->dft(z.data(), z.data(), true);
+					for (integer i = 0;i < n;++i)
+					{
+						x[i * xStride] = z[i].real() * factor;
+					}
+					continue;
+				}
+
+				// Recover the transforms of the even and odd
+				// elements, and pack them for a single transform.
+				for (integer k = 0;k < h;++k)
+				{
+					Complex a = y[k * yStride];
+					Complex b = std::conj(y[(h - k) * yStride]);
+					Complex even = a + b;
+					Complex odd = (a - b) * twiddleSet[k];
+					z[k] = even + Complex(0, 1) * odd;
+				}
+				plan->dft(z.data(), z.data(), true);
+
+				// The even and odd transforms were not halved above,
+				// so that the result is scaled by n, as for the
+				// unpacked lines.
+				for (integer j = 0;j < h;++j)
+				{
+					x[2 * j * xStride] = z[j].real() * factor;
+					x[(2 * j + 1) * xStride] = z[j].imag() * factor;
+				}
+			}
+		};
+
+		if (parallel)
+		{
+			tbb::parallel_for(Block(0, lines, blockSize), transformLines);
+		}
+		else
+		{
+			transformLines(Block(0, lines, blockSize));
+		}
+	}
+
+}
+
+#endif
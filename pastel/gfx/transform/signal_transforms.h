@@ -5,6 +5,7 @@
 
 #include "pastel/gfx/transform/cosine_transform.h"
 #include "pastel/gfx/transform/fourier_transform.h"
+#include "pastel/gfx/transform/fourier_transform_n.h"
 #include "pastel/gfx/transform/haar_transform.h"
 #include "pastel/gfx/transform/hadamard_transform.h"
 
@@ -4,6 +4,7 @@
 #define PASTELMATH_DISTANCES_H
 
 #include "pastel/math/distance/distance_concept.h"
+#include "pastel/math/distance/block_distance.h"
 #include "pastel/math/distance/euclidean_distance.h"
 #include "pastel/math/distance/manhattan_distance.h"
 #include "pastel/math/distance/maximum_distance.h"
@@ -4,6 +4,7 @@
 #define PASTELSYS_ALLOCATORS_H
 
 #include "pastel/sys/allocator/arena_allocator.h"
+#include "pastel/sys/allocator/concurrent_pool_allocator.h"
 #include "pastel/sys/allocator/native_allocator.h"
 #include "pastel/sys/allocator/pool_allocator.h"
 
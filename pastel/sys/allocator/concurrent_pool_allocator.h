@@ -0,0 +1,9 @@
+// Description: Concurrent pool allocator module
+// Documentation: concurrent_pool_allocator.txt
+
+#ifndef PASTELSYS_CONCURRENT_POOL_ALLOCATOR_H_MODULE
+#define PASTELSYS_CONCURRENT_POOL_ALLOCATOR_H_MODULE
+
+#include "pastel/sys/allocator/concurrent_pool_allocator/concurrent_pool_allocator.h"
+
+#endif
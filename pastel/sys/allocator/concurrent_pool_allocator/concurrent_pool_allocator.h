@@ -0,0 +1,282 @@
+// Description: Concurrent pool allocator
+// Detail: A uniform-sized memory allocator with per-thread caches
+// Documentation: concurrent_pool_allocator.txt
+
+#ifndef PASTELSYS_CONCURRENT_POOL_ALLOCATOR_H
+#define PASTELSYS_CONCURRENT_POOL_ALLOCATOR_H
+
+#include "pastel/sys/mytypes.h"
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! A uniform sized memory allocator for concurrent use.
+	/*!
+	This is a variant of PoolAllocator which can be used
+	from several threads at the same time. Each thread
+	allocates from its own blocks, without locking. A unit
+	can be deallocated by any thread: by its owner directly,
+	and by other threads through a lock-free list, from
+	which the owner collects the units when it next runs
+	out of free units.
+
+	The blocks are aligned to their size, so that the block
+	of a unit is found in constant time by masking its
+	address.
+
+	When a thread exits, its blocks are adopted by the next
+	thread which runs out of free units, together with the
+	units deallocated to the exited thread. The memory of a
+	thread which is alive, but no longer allocates, is freed
+	by clear() or by the destructor.
+	*/
+	class ConcurrentPoolAllocator
+	{
+	public:
+		//! Allocation statistics.
+		/*!
+		The statistics are summed over the threads. They
+		are exact when the allocator is not being used
+		concurrently, and approximate otherwise.
+		*/
+		struct Statistics
+		{
+			//! The number of allocations.
+			integer allocations = 0;
+
+			//! The number of deallocations.
+			integer deallocations = 0;
+
+			//! The number of deallocations by other than the owner thread.
+			integer remoteDeallocations = 0;
+
+			//! The number of blocks allocated from the system.
+			integer blocksAllocated = 0;
+
+			//! The number of blocks returned to the system.
+			integer blocksFreed = 0;
+
+			//! The number of threads which have used the allocator.
+			integer threads = 0;
+		};
+
+		//! Constructs the allocator with the given unit size.
+		/*!
+		Preconditions:
+		'unitSize' > 0
+
+		Time complexity: constant
+		Exception safety: strong
+		*/
+		explicit ConcurrentPoolAllocator(integer unitSize);
+
+		//! Destructs the allocator.
+		/*!
+		Time complexity: linear
+		Exception safety: nothrow
+		*/
+		~ConcurrentPoolAllocator();
+
+		//! Compares two allocators.
+		/*!
+		The allocators are compared by their
+		memory address.
+
+		Time complexity: constant
+		Exception safety: nothrow
+		*/
+		inline auto operator<=>(const ConcurrentPoolAllocator& that) const;
+
+		//! Swaps two allocators.
+		/*!
+		Preconditions:
+		Neither allocator is being used concurrently.
+
+		Time complexity: constant
+		Exception safety: nothrow
+		*/
+		void swap(ConcurrentPoolAllocator& that);
+
+		//! Frees all memory.
+		/*!
+		Preconditions:
+		The allocator is not being used concurrently.
+		Unlike statistics(), this is not thread-safe.
+
+		Time complexity: linear
+		Exception safety: nothrow
+		*/
+		void clear();
+
+		//! Returns the unit size.
+		/*!
+		Time complexity: constant
+		Exception safety: nothrow
+		*/
+		integer unitSize() const;
+
+		//! Returns the number of allocated units.
+		/*!
+		Thread-safe; see Statistics for the accuracy.
+
+		Time complexity: linear in the number of threads
+		Exception safety: nothrow
+		*/
+		integer allocated() const;
+
+		//! Returns the number of units in the blocks.
+		/*!
+		Thread-safe; see Statistics for the accuracy.
+
+		Time complexity: linear in the number of threads
+		Exception safety: nothrow
+		*/
+		integer capacity() const;
+
+		//! Returns the allocation statistics.
+		/*!
+		Thread-safe. The threads are enumerated under
+		a mutex, which is also taken when a thread first
+		uses the allocator, and when a thread runs out
+		of blocks.
+
+		Time complexity: linear in the number of threads
+		Exception safety: nothrow
+		*/
+		Statistics statistics() const;
+
+		//! Allocates unitSize-sized memory area.
+		/*!
+		Thread-safe.
+
+		Time complexity: amortized constant
+		Exception safety: strong
+		*/
+		void* allocate();
+
+		//! Deallocates a previously allocated area.
+		/*!
+		Preconditions:
+		'memAddress' != 0
+		'memAddress' has been allocated from this allocator.
+
+		Thread-safe; the area may have been allocated
+		by another thread.
+
+		Time complexity: constant
+		Exception safety: nothrow
+		*/
+		void deallocate(const void* memAddress);
+
+	private:
+		ConcurrentPoolAllocator(const ConcurrentPoolAllocator& that) = delete;
+		ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator& that) = delete;
+
+		struct Cache;
+
+		//! The header at the start of each block.
+		/*!
+		Only the owner thread accesses the block,
+		except for reading 'cache_'. The owner changes
+		when the block is adopted from an exited thread.
+		*/
+		struct Block
+		{
+			std::atomic<Cache*> cache_;
+			void* firstFreeUnit_;
+			integer unitsAllocated_;
+			integer index_;
+			Block* nextFreeBlock_;
+			Block* previousFreeBlock_;
+			bool free_;
+		};
+
+		//! The state of a thread.
+		struct alignas(64) Cache
+		{
+			// The units deallocated by other threads,
+			// linked through their first bytes.
+			std::atomic<void*> remoteFreeUnit_{nullptr};
+
+			// Set when the owner thread exits.
+			std::shared_ptr<std::atomic<bool>> exited_;
+
+			// Whether the blocks of this cache have been
+			// adopted by another cache. Protected by the mutex.
+			bool adopted_ = false;
+
+			// The blocks of this thread.
+			std::vector<Block*> blockSet_;
+
+			// The adopted caches. Units may still be deallocated
+			// to them, by threads which read the owner of a block
+			// before the adoption; their lists are collected
+			// together with that of this cache.
+			std::vector<Cache*> adoptedSet_;
+
+			// The blocks with free units.
+			Block* firstFreeBlock_ = nullptr;
+			integer emptyBlocks_ = 0;
+
+			// The statistics are written only by the owner
+			// thread, but may be read by others.
+			std::atomic<integer> allocations_{0};
+			std::atomic<integer> deallocations_{0};
+			std::atomic<integer> remoteDeallocations_{0};
+			std::atomic<integer> blocksAllocated_{0};
+			std::atomic<integer> blocksFreed_{0};
+			std::atomic<integer> units_{0};
+		};
+
+		//! The state shared by the threads.
+		struct Threads
+		{
+			// The cache of each thread. TBB finds the element
+			// of a new thread by its id, which may be that of
+			// an exited thread; such a cache is not reused.
+			tbb::enumerable_thread_specific<
+				Cache*,
+				tbb::cache_aligned_allocator<Cache*>,
+				tbb::ets_key_per_instance> localSet_;
+
+			// Protects the cache-set, and adoption.
+			mutable std::mutex mutex_;
+
+			// The caches of all threads, including the exited.
+			std::vector<std::unique_ptr<Cache>> cacheSet_;
+		};
+
+		static Block* blockOf(const void* memAddress, integer blockSize);
+		static void increment(std::atomic<integer>& counter, integer amount = 1);
+
+		Cache& localCache();
+		Cache* createCache();
+		void adoptExited(Cache& cache);
+		Block* allocateBlock(Cache& cache);
+		void deallocateBlock(Cache& cache, Block* block);
+		void collectRemote(Cache& cache);
+		void deallocateLocal(Cache& cache, Block* block, void* memAddress);
+		void pushFreeBlock(Cache& cache, Block* block);
+		void removeFreeBlock(Cache& cache, Block* block);
+
+		integer unitSize_;
+		integer unitStride_;
+		integer blockSize_;
+		integer unitsPerBlock_;
+		std::unique_ptr<Threads> threads_;
+	};
+
+	void swap(ConcurrentPoolAllocator& left, ConcurrentPoolAllocator& right);
+
+}
+
+#include "pastel/sys/allocator/concurrent_pool_allocator/concurrent_pool_allocator.hpp"
+
+#endif
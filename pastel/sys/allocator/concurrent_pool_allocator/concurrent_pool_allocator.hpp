@@ -0,0 +1,580 @@
+#ifndef PASTELSYS_CONCURRENT_POOL_ALLOCATOR_HPP
+#define PASTELSYS_CONCURRENT_POOL_ALLOCATOR_HPP
+
+#include "pastel/sys/allocator/concurrent_pool_allocator.h"
+#include "pastel/sys/ensure.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace Pastel
+{
+
+	namespace ConcurrentPoolAllocator_
+	{
+
+		//! The size of the block header, aligned for any unit.
+		template <typename Block>
+		constexpr integer headerSize()
+		{
+			constexpr integer Alignment = alignof(std::max_align_t);
+			return ((sizeof(Block) + Alignment - 1) / Alignment) * Alignment;
+		}
+
+		//! Marks the caches of a thread as exited when it exits.
+		/*!
+		The flags are shared with the caches, so that an
+		allocator may be destroyed before the thread exits,
+		or the other way around.
+		*/
+		class ThreadExit
+		{
+		public:
+			~ThreadExit()
+			{
+				for (auto& exited : exitedSet_)
+				{
+					exited->store(true, std::memory_order_release);
+				}
+			}
+
+			void add(std::shared_ptr<std::atomic<bool>> exited)
+			{
+				// Forget the caches which have been destroyed.
+				std::erase_if(exitedSet_, [](auto& that)
+				{
+					return that.use_count() == 1;
+				});
+				exitedSet_.push_back(std::move(exited));
+			}
+
+		private:
+			std::vector<std::shared_ptr<std::atomic<bool>>> exitedSet_;
+		};
+
+		inline ThreadExit& threadExit()
+		{
+			thread_local ThreadExit result;
+			return result;
+		}
+
+	}
+
+	inline ConcurrentPoolAllocator::ConcurrentPoolAllocator(
+		integer unitSize)
+		: unitSize_(unitSize)
+		, unitStride_(0)
+		, blockSize_(0)
+		, unitsPerBlock_(0)
+		, threads_(std::make_unique<Threads>())
+	{
+		ENSURE_OP(unitSize, >, 0);
+
+		// A free unit stores a pointer to the next free unit;
+		// align the units for it.
+		constexpr integer PointerSize = sizeof(void*);
+		unitStride_ = ((std::max(unitSize, PointerSize) + PointerSize - 1)
+			/ PointerSize) * PointerSize;
+
+		// The block size is a power of two, so that
+		// the blocks can be aligned to their size.
+		constexpr integer MinBlockSize = 16384;
+		constexpr integer MinBlockUnits = 64;
+		integer headerSize = ConcurrentPoolAllocator_::headerSize<Block>();
+
+		blockSize_ = MinBlockSize;
+		while (blockSize_ < headerSize + MinBlockUnits * unitStride_)
+		{
+			blockSize_ *= 2;
+		}
+
+		unitsPerBlock_ = (blockSize_ - headerSize) / unitStride_;
+	}
+
+	inline ConcurrentPoolAllocator::~ConcurrentPoolAllocator()
+	{
+		// Count the units which are still allocated from the
+		// blocks, after returning the units in the remote lists
+		// to their blocks.
+		integer units = 0;
+		for (auto& cache : threads_->cacheSet_)
+		{
+			if (!cache->adopted_)
+			{
+				collectRemote(*cache);
+			}
+			for (Block* block : cache->blockSet_)
+			{
+				units += block->unitsAllocated_;
+			}
+		}
+		REPORT1(units > 0, units);
+
+		clear();
+	}
+
+	inline auto ConcurrentPoolAllocator::operator<=>(
+		const ConcurrentPoolAllocator& that) const
+	{
+		return this <=> &that;
+	}
+
+	inline void ConcurrentPoolAllocator::swap(ConcurrentPoolAllocator& that)
+	{
+		std::swap(unitSize_, that.unitSize_);
+		std::swap(unitStride_, that.unitStride_);
+		std::swap(blockSize_, that.blockSize_);
+		std::swap(unitsPerBlock_, that.unitsPerBlock_);
+		threads_.swap(that.threads_);
+	}
+
+	inline void ConcurrentPoolAllocator::clear()
+	{
+		for (auto& cache : threads_->cacheSet_)
+		{
+			for (Block* block : cache->blockSet_)
+			{
+				block->~Block();
+				::operator delete((void*)block, std::align_val_t(blockSize_));
+			}
+		}
+
+		threads_->cacheSet_.clear();
+		threads_->localSet_.clear();
+	}
+
+	inline integer ConcurrentPoolAllocator::unitSize() const
+	{
+		return unitSize_;
+	}
+
+	inline integer ConcurrentPoolAllocator::allocated() const
+	{
+		Statistics result = statistics();
+		return result.allocations - result.deallocations;
+	}
+
+	inline integer ConcurrentPoolAllocator::capacity() const
+	{
+		std::lock_guard<std::mutex> lock(threads_->mutex_);
+
+		integer result = 0;
+		for (auto& cache : threads_->cacheSet_)
+		{
+			result += cache->units_.load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	inline ConcurrentPoolAllocator::Statistics
+		ConcurrentPoolAllocator::statistics() const
+	{
+		std::lock_guard<std::mutex> lock(threads_->mutex_);
+
+		Statistics result;
+		for (auto& cache : threads_->cacheSet_)
+		{
+			result.allocations += cache->allocations_.load(std::memory_order_relaxed);
+			result.deallocations += cache->deallocations_.load(std::memory_order_relaxed);
+			result.remoteDeallocations += cache->remoteDeallocations_.load(std::memory_order_relaxed);
+			result.blocksAllocated += cache->blocksAllocated_.load(std::memory_order_relaxed);
+			result.blocksFreed += cache->blocksFreed_.load(std::memory_order_relaxed);
+			++result.threads;
+		}
+		return result;
+	}
+
+	inline void* ConcurrentPoolAllocator::allocate()
+	{
+		Cache& cache = localCache();
+
+		Block* block = cache.firstFreeBlock_;
+		if (!block)
+		{
+			// Reuse the units deallocated by other
+			// threads before allocating a new block.
+			collectRemote(cache);
+			block = cache.firstFreeBlock_;
+		}
+
+		if (!block)
+		{
+			// Reuse the blocks of the exited threads,
+			// and the units deallocated to them.
+			adoptExited(cache);
+			collectRemote(cache);
+			block = cache.firstFreeBlock_;
+		}
+
+		if (!block)
+		{
+			block = allocateBlock(cache);
+		}
+
+		// As an invariant, the blocks in the free
+		// list have a free unit.
+
+		ASSERT(block->firstFreeUnit_);
+
+		// Pop the first unit off the internal
+		// linked list.
+
+		void* memAddress = block->firstFreeUnit_;
+		block->firstFreeUnit_ = *(void**)memAddress;
+
+		if (block->unitsAllocated_ == 0)
+		{
+			--cache.emptyBlocks_;
+		}
+		++block->unitsAllocated_;
+
+		if (!block->firstFreeUnit_)
+		{
+			removeFreeBlock(cache, block);
+		}
+
+		increment(cache.allocations_);
+
+		return memAddress;
+	}
+
+	inline void ConcurrentPoolAllocator::deallocate(const void* memAddress)
+	{
+		// Clearly a null pointer can't
+		// be allocated from this allocator.
+
+		PENSURE(memAddress);
+
+		Block* block = blockOf(memAddress, blockSize_);
+
+		// If the given memory address is not aligned
+		// on unit intervals, abort. This clearly reflects
+		// a bug in the caller's side.
+
+		integer indexInBytes = (const uint8*)memAddress -
+			((const uint8*)block + ConcurrentPoolAllocator_::headerSize<Block>());
+		PENSURE3(
+			indexInBytes >= 0 && indexInBytes % unitStride_ == 0,
+			indexInBytes, unitStride_,
+			indexInBytes % unitStride_);
+
+		Cache& cache = localCache();
+		Cache* owner = block->cache_.load(std::memory_order_acquire);
+		if (owner == &cache)
+		{
+			deallocateLocal(cache, block, (void*)memAddress);
+		}
+		else
+		{
+			// Push the unit into the list of the owner thread.
+			// After the push the block may be freed by the
+			// owner at any time, so it must not be accessed.
+			std::atomic<void*>& head = owner->remoteFreeUnit_;
+			void* next = head.load(std::memory_order_relaxed);
+			do
+			{
+				*(void**)memAddress = next;
+			}
+			while (!head.compare_exchange_weak(
+				next, (void*)memAddress,
+				std::memory_order_release,
+				std::memory_order_relaxed));
+
+			increment(cache.remoteDeallocations_);
+		}
+
+		increment(cache.deallocations_);
+	}
+
+	// Private
+
+	inline ConcurrentPoolAllocator::Block* ConcurrentPoolAllocator::blockOf(
+		const void* memAddress, integer blockSize)
+	{
+		return (Block*)((std::uintptr_t)memAddress &
+			~((std::uintptr_t)blockSize - 1));
+	}
+
+	inline void ConcurrentPoolAllocator::increment(
+		std::atomic<integer>& counter, integer amount)
+	{
+		// Only the owner thread writes a counter,
+		// so there is no need for an atomic addition.
+		counter.store(
+			counter.load(std::memory_order_relaxed) + amount,
+			std::memory_order_relaxed);
+	}
+
+	inline ConcurrentPoolAllocator::Cache&
+		ConcurrentPoolAllocator::localCache()
+	{
+		Cache*& cache = threads_->localSet_.local();
+		if (!cache || cache->exited_->load(std::memory_order_acquire))
+		{
+			// Either the thread has not used the allocator, or 
+			// TBB returned the cache of an exited thread with
+			// the same id.
+			cache = createCache();
+		}
+		return *cache;
+	}
+
+	inline ConcurrentPoolAllocator::Cache*
+		ConcurrentPoolAllocator::createCache()
+	{
+		auto cache = std::make_unique<Cache>();
+		cache->exited_ = std::make_shared<std::atomic<bool>>(false);
+		ConcurrentPoolAllocator_::threadExit().add(cache->exited_);
+
+		std::lock_guard<std::mutex> lock(threads_->mutex_);
+		threads_->cacheSet_.push_back(std::move(cache));
+		return threads_->cacheSet_.back().get();
+	}
+
+	inline void ConcurrentPoolAllocator::adoptExited(Cache& cache)
+	{
+		std::lock_guard<std::mutex> lock(threads_->mutex_);
+
+		for (auto& that : threads_->cacheSet_)
+		{
+			Cache& exited = *that;
+			if (&exited == &cache || exited.adopted_ ||
+				!exited.exited_->load(std::memory_order_acquire))
+			{
+				continue;
+			}
+
+			cache.blockSet_.reserve(
+				cache.blockSet_.size() + exited.blockSet_.size());
+			cache.adoptedSet_.reserve(
+				cache.adoptedSet_.size() + exited.adoptedSet_.size() + 1);
+
+			for (Block* block : exited.blockSet_)
+			{
+				// From now on the units of the block are
+				// deallocated to this cache.
+				block->cache_.store(&cache, std::memory_order_release);
+				block->index_ = cache.blockSet_.size();
+				cache.blockSet_.push_back(block);
+				increment(cache.units_, unitsPerBlock_);
+
+				if (block->free_)
+				{
+					block->free_ = false;
+					pushFreeBlock(cache, block);
+				}
+
+				if (block->unitsAllocated_ == 0)
+				{
+					++cache.emptyBlocks_;
+					if (cache.emptyBlocks_ > 1)
+					{
+						deallocateBlock(cache, block);
+					}
+				}
+			}
+
+			exited.blockSet_.clear();
+			exited.firstFreeBlock_ = nullptr;
+			exited.emptyBlocks_ = 0;
+			exited.units_.store(0, std::memory_order_relaxed);
+
+			cache.adoptedSet_.push_back(&exited);
+			cache.adoptedSet_.insert(cache.adoptedSet_.end(),
+				exited.adoptedSet_.begin(), exited.adoptedSet_.end());
+			exited.adoptedSet_.clear();
+			exited.adopted_ = true;
+		}
+	}
+
+	inline ConcurrentPoolAllocator::Block*
+		ConcurrentPoolAllocator::allocateBlock(Cache& cache)
+	{
+		// Allocate memory for the block, aligned
+		// to the block size.
+
+		void* memory = ::operator new(blockSize_, std::align_val_t(blockSize_));
+
+		Block* block = new (memory) Block{
+			&cache, nullptr, 0, (integer)cache.blockSet_.size(),
+			nullptr, nullptr, false};
+
+		try
+		{
+			cache.blockSet_.push_back(block);
+		}
+		catch(...)
+		{
+			::operator delete(memory, std::align_val_t(blockSize_));
+			throw;
+		}
+
+		// For every unit, its first bytes contain
+		// the address of the next unit in the
+		// internal linked list.
+
+		uint8* data = (uint8*)block + ConcurrentPoolAllocator_::headerSize<Block>();
+		for (integer i = 0;i < unitsPerBlock_;++i)
+		{
+			uint8* unit = data + i * unitStride_;
+			*(void**)unit = (i + 1 < unitsPerBlock_)
+				? (void*)(unit + unitStride_)
+				: nullptr;
+		}
+		block->firstFreeUnit_ = data;
+
+		++cache.emptyBlocks_;
+		pushFreeBlock(cache, block);
+
+		increment(cache.blocksAllocated_);
+		increment(cache.units_, unitsPerBlock_);
+
+		return block;
+	}
+
+	inline void ConcurrentPoolAllocator::deallocateBlock(
+		Cache& cache, Block* block)
+	{
+		ASSERT_OP(block->unitsAllocated_, ==, 0);
+
+		removeFreeBlock(cache, block);
+		--cache.emptyBlocks_;
+
+		// Remove the block from the block set
+		// by moving the last block in its place.
+
+		Block* last = cache.blockSet_.back();
+		last->index_ = block->index_;
+		cache.blockSet_[block->index_] = last;
+		cache.blockSet_.pop_back();
+
+		block->~Block();
+		::operator delete((void*)block, std::align_val_t(blockSize_));
+
+		increment(cache.blocksFreed_);
+		increment(cache.units_, -unitsPerBlock_);
+	}
+
+	inline void ConcurrentPoolAllocator::collectRemote(Cache& cache)
+	{
+		auto collect = [&](Cache& from)
+		{
+			void* unit = from.remoteFreeUnit_.exchange(
+				nullptr, std::memory_order_acquire);
+
+			while (unit)
+			{
+				// The block of a unit is not freed before all of
+				// its units have been deallocated; the next unit
+				// is still allocated.
+				void* next = *(void**)unit;
+				deallocateLocal(cache, blockOf(unit, blockSize_), unit);
+				unit = next;
+			}
+		};
+
+		collect(cache);
+		for (Cache* adopted : cache.adoptedSet_)
+		{
+			collect(*adopted);
+		}
+	}
+
+	inline void ConcurrentPoolAllocator::deallocateLocal(
+		Cache& cache, Block* block, void* memAddress)
+	{
+		// If the block contains no allocated
+		// units, abort. This clearly reflects
+		// a bug in the caller's side.
+
+		PENSURE1(block->unitsAllocated_ != 0,
+			block->unitsAllocated_);
+
+		// Prepend the unit to the internal
+		// linked list.
+
+		bool wasFull = !block->firstFreeUnit_;
+		*(void**)memAddress = block->firstFreeUnit_;
+		block->firstFreeUnit_ = memAddress;
+
+		if (wasFull)
+		{
+			pushFreeBlock(cache, block);
+		}
+
+		--block->unitsAllocated_;
+
+		// If the block becomes totally free, then
+		// deallocate it, unless it is the only free
+		// block; this protects against the pattern of
+		// allocating and deallocating a single unit
+		// repeatedly.
+
+		if (block->unitsAllocated_ == 0)
+		{
+			++cache.emptyBlocks_;
+			if (cache.emptyBlocks_ > 1)
+			{
+				deallocateBlock(cache, block);
+			}
+		}
+	}
+
+	inline void ConcurrentPoolAllocator::pushFreeBlock(
+		Cache& cache, Block* block)
+	{
+		ASSERT(!block->free_);
+
+		// The most recently freed blocks are
+		// used first, since they are likely
+		// to be in the cache.
+
+		block->previousFreeBlock_ = nullptr;
+		block->nextFreeBlock_ = cache.firstFreeBlock_;
+		if (cache.firstFreeBlock_)
+		{
+			cache.firstFreeBlock_->previousFreeBlock_ = block;
+		}
+		cache.firstFreeBlock_ = block;
+		block->free_ = true;
+	}
+
+	inline void ConcurrentPoolAllocator::removeFreeBlock(
+		Cache& cache, Block* block)
+	{
+		ASSERT(block->free_);
+
+		Block* previous = block->previousFreeBlock_;
+		Block* next = block->nextFreeBlock_;
+
+		if (previous)
+		{
+			previous->nextFreeBlock_ = next;
+		}
+		else
+		{
+			cache.firstFreeBlock_ = next;
+		}
+
+		if (next)
+		{
+			next->previousFreeBlock_ = previous;
+		}
+
+		block->previousFreeBlock_ = nullptr;
+		block->nextFreeBlock_ = nullptr;
+		block->free_ = false;
+	}
+
+	inline void swap(ConcurrentPoolAllocator& left,
+		ConcurrentPoolAllocator& right)
+	{
+		left.swap(right);
+	}
+
+}
+
+#endif
@@ -6,5 +6,6 @@
 
 #include "pastel/sys/automaton/automaton.h"
 #include "pastel/sys/automaton/automaton_algorithms.h"
+#include "pastel/sys/automaton/compiled_automaton.h"
 
 #endif
@@ -0,0 +1,337 @@
+// Description: Compiled deterministic automaton
+// Documentation: compiled_automaton.txt
+
+#ifndef PASTELSYS_COMPILED_AUTOMATON_H
+#define PASTELSYS_COMPILED_AUTOMATON_H
+
+#include "pastel/sys/automaton.h"
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Compiled deterministic automaton
+	/*!
+	A deterministic automaton over bytes, stored as a dense
+	transition table, for running it over large inputs.
+	The bytes are partitioned into equivalence classes,
+	where two bytes are equivalent if they have the same
+	transitions from every state; the table has a column
+	for each class.
+
+	The states are identified by the offsets of their rows
+	in the table, so that a transition takes one load for
+	the class and one for the state. The state-ids are
+	contiguous when divided by classes(). The state-id 0 is
+	the dead state, from which no final state can be reached;
+	the final states have the largest state-ids.
+	*/
+	class Compiled_Automaton
+	{
+	public:
+		using State = uint32;
+
+		//! The number of inputs interleaved by run().
+		static constexpr integer Interleave = 8;
+
+		//! Constructs an automaton for the empty language.
+		/*!
+		Time complexity: O(1)
+		Exception safety: strong
+		*/
+		Compiled_Automaton()
+			: table_(1, Dead)
+			, classSet_()
+			, classes_(1)
+			, start_(Dead)
+			, finalBegin_(1)
+		{
+			classSet_.fill(0);
+		}
+
+		//! Swaps two automata.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void swap(Compiled_Automaton& that)
+		{
+			using std::swap;
+			table_.swap(that.table_);
+			swap(classSet_, that.classSet_);
+			swap(classes_, that.classes_);
+			swap(start_, that.start_);
+			swap(finalBegin_, that.finalBegin_);
+		}
+
+		//! Returns the start state.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+
+		returns:
+		The start state, or dead(), if the automaton
+		has no start state.
+		*/
+		State start() const
+		{
+			return start_;
+		}
+
+		//! Returns the dead state.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		State dead() const
+		{
+			return Dead;
+		}
+
+		//! Returns whether a state is final.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		bool final(State state) const
+		{
+			return state >= finalBegin_;
+		}
+
+		//! Returns the state after a transition with a byte.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		State next(State state, uint8 symbol) const
+		{
+			return table_[state + classSet_[symbol]];
+		}
+
+		//! Returns the equivalence class of a byte.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer symbolClass(uint8 symbol) const
+		{
+			return classSet_[symbol];
+		}
+
+		//! Returns the number of states.
+		/*!
+		This includes the dead state.
+
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer states() const
+		{
+			return table_.size() / classes_;
+		}
+
+		//! Returns the number of byte equivalence classes.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer classes() const
+		{
+			return classes_;
+		}
+
+		//! Returns the contiguous index of a state.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+
+		returns:
+		An integer in [0, states()).
+		*/
+		integer index(State state) const
+		{
+			return state / classes_;
+		}
+
+		//! Runs the automaton over an input.
+		/*!
+		Time complexity: O(input.size())
+		Exception safety: nothrow
+
+		state:
+		The state to start from.
+
+		returns:
+		The state after the input. The run stops early
+		when the dead state is reached.
+		*/
+		State run(State state, std::string_view input) const
+		{
+			const State* table = table_.data();
+			const uint8* classSet = classSet_.data();
+			const uint8* data = (const uint8*)input.data();
+			integer n = input.size();
+
+			// The dead state is checked once per block, to
+			// keep the loop free of unpredictable branches.
+			integer i = 0;
+			while (i + Block <= n)
+			{
+				for (integer j = 0;j < Block;++j)
+				{
+					state = table[state + classSet[data[i + j]]];
+				}
+				if (state == Dead)
+				{
+					return Dead;
+				}
+				i += Block;
+			}
+
+			for (;i < n;++i)
+			{
+				state = table[state + classSet[data[i]]];
+			}
+
+			return state;
+		}
+
+		//! Runs the automaton over several inputs.
+		/*!
+		Preconditions:
+		stateSet.size() == inputSet.size()
+
+		Time complexity: O(sum of input sizes)
+		Exception safety: nothrow
+
+		stateSet:
+		The states to start the inputs from, which are
+		replaced with the states after the inputs.
+
+		The inputs are run Interleave at a time, in lockstep
+		over their common length. The transitions of different
+		inputs do not depend on each other, so the latencies
+		of their table lookups overlap; this is faster than
+		running the inputs one after the other, when the
+		table does not fit in the L1 cache.
+		*/
+		void run(
+			std::span<State> stateSet,
+			std::span<const std::string_view> inputSet) const
+		{
+			PENSURE_OP(stateSet.size(), ==, inputSet.size());
+
+			const State* table = table_.data();
+			const uint8* classSet = classSet_.data();
+
+			integer streams = inputSet.size();
+			integer i = 0;
+			for (;i + Interleave <= streams;i += Interleave)
+			{
+				std::array<State, Interleave> state;
+				std::array<const uint8*, Interleave> data;
+				integer n = inputSet[i].size();
+				for (integer k = 0;k < Interleave;++k)
+				{
+					state[k] = stateSet[i + k];
+					data[k] = (const uint8*)inputSet[i + k].data();
+					n = std::min(n, (integer)inputSet[i + k].size());
+				}
+
+				for (integer j = 0;j < n;++j)
+				{
+					for (integer k = 0;k < Interleave;++k)
+					{
+						state[k] = table[state[k] + classSet[data[k][j]]];
+					}
+				}
+
+				for (integer k = 0;k < Interleave;++k)
+				{
+					stateSet[i + k] = run(state[k], inputSet[i + k].substr(n));
+				}
+			}
+
+			for (;i < streams;++i)
+			{
+				stateSet[i] = run(stateSet[i], inputSet[i]);
+			}
+		}
+
+		//! Returns whether the automaton accepts an input.
+		/*!
+		Time complexity: O(input.size())
+		Exception safety: nothrow
+		*/
+		bool accepts(std::string_view input) const
+		{
+			return final(run(start(), input));
+		}
+
+	private:
+		template <
+			typename Symbol,
+			typename StateData,
+			typename TransitionData,
+			typename Customization>
+		friend Compiled_Automaton compileAutomaton(
+			const Automaton<Symbol, StateData, TransitionData, Customization>& automaton);
+
+		static constexpr State Dead = 0;
+		static constexpr integer Block = 16;
+
+		//! The transition table.
+		/*!
+		The row of the state s is at s, and has
+		a column for each equivalence class.
+		*/
+		std::vector<State> table_;
+
+		//! The equivalence class of each byte.
+		std::array<uint8, 256> classSet_;
+
+		//! The number of equivalence classes.
+		integer classes_;
+
+		//! The start state.
+		State start_;
+
+		//! The first final state.
+		State finalBegin_;
+	};
+
+	//! Compiles a deterministic automaton.
+	/*!
+	Preconditions:
+	automaton.deterministic()
+	Every symbol is in [0, 256).
+
+	Time complexity:
+	O(256 n + m) on average, where n is the number of
+	states and m is the number of transitions.
+
+	Exception safety:
+	strong
+
+	The states which can not reach a final state are
+	merged into the dead state. The automaton should be
+	minimized first, since the size of the table is
+	proportional to the number of states.
+	*/
+	template <
+		typename Symbol,
+		typename StateData,
+		typename TransitionData,
+		typename Customization>
+	Compiled_Automaton compileAutomaton(
+		const Automaton<Symbol, StateData, TransitionData, Customization>& automaton);
+
+}
+
+#include "pastel/sys/automaton/compiled_automaton.hpp"
+
+#endif
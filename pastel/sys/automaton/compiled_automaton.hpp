@@ -0,0 +1,151 @@
+#ifndef PASTELSYS_COMPILED_AUTOMATON_HPP
+#define PASTELSYS_COMPILED_AUTOMATON_HPP
+
+#include "pastel/sys/automaton/compiled_automaton.h"
+#include "pastel/sys/automaton/productive_states.h"
+#include "pastel/sys/hashing/iteratoraddress_hash.h"
+
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Pastel
+{
+
+	template <
+		typename Symbol,
+		typename StateData,
+		typename TransitionData,
+		typename Customization>
+	Compiled_Automaton compileAutomaton(
+		const Automaton<Symbol, StateData, TransitionData, Customization>& automaton)
+	{
+		using Automaton = Automaton<Symbol, StateData, TransitionData, Customization>;
+		using State_ConstIterator = typename Automaton::State_ConstIterator;
+		using State = Compiled_Automaton::State;
+
+		ENSURE(automaton.deterministic());
+
+		// Compute the states that can reach a final state;
+		// the others are merged into the dead state.
+
+		std::unordered_set<State_ConstIterator, IteratorAddress_Hash>
+			productiveSet;
+
+		forEachProductive(
+			automaton,
+			[&](const State_ConstIterator& state)
+			{
+				productiveSet.insert(state);
+			},
+			[&](const State_ConstIterator& state) -> bool
+			{
+				return productiveSet.count(state);
+			});
+
+		// Number the productive states, so that the
+		// non-final states come before the final states.
+
+		std::unordered_map<State_ConstIterator, State,
+			IteratorAddress_Hash> idMap;
+
+		integer states = 1;
+		for (bool final : {false, true})
+		{
+			for (auto state = automaton.cStateBegin();
+				state != automaton.cStateEnd();
+				++state)
+			{
+				if (state->data().final() == final &&
+					productiveSet.count(state))
+				{
+					idMap[state] = states;
+					++states;
+				}
+			}
+		}
+
+		integer finalBegin = states - automaton.finalStates();
+
+		auto id = [&](const State_ConstIterator& state) -> State
+		{
+			auto iter = idMap.find(state);
+			return iter == idMap.end() ? 0 : iter->second;
+		};
+
+		// Form the transition table over all bytes. Since
+		// the automaton is deterministic, each entry is set
+		// at most once.
+
+		std::vector<State> byteTable(states * 256, 0);
+		for (auto transition = automaton.cTransitionBegin();
+			transition != automaton.cTransitionEnd();
+			++transition)
+		{
+			integer symbol = *transition->data().symbol();
+			ENSURE_OP(symbol, >=, 0);
+			ENSURE_OP(symbol, <, 256);
+
+			State from = id(transition->from());
+			if (from != 0)
+			{
+				byteTable[from * 256 + symbol] = id(transition->to());
+			}
+		}
+
+		// Two bytes are equivalent if their columns
+		// in the transition table are equal.
+
+		std::array<uint8, 256> classSet;
+		std::vector<integer> byteOfClass;
+		{
+			std::map<std::vector<State>, integer> columnMap;
+			std::vector<State> column(states);
+			for (integer symbol = 0;symbol < 256;++symbol)
+			{
+				for (integer i = 0;i < states;++i)
+				{
+					column[i] = byteTable[i * 256 + symbol];
+				}
+
+				auto result = columnMap.emplace(column, byteOfClass.size());
+				if (result.second)
+				{
+					byteOfClass.push_back(symbol);
+				}
+				classSet[symbol] = result.first->second;
+			}
+		}
+
+		// Form the compressed table, where each state is
+		// identified by the offset of its row.
+
+		integer classes = byteOfClass.size();
+		ENSURE_OP(states * classes, <=, (integer)
+			std::numeric_limits<State>::max());
+
+		Compiled_Automaton result;
+		result.table_.resize(states * classes);
+		for (integer i = 0;i < states;++i)
+		{
+			for (integer j = 0;j < classes;++j)
+			{
+				result.table_[i * classes + j] =
+					byteTable[i * 256 + byteOfClass[j]] * classes;
+			}
+		}
+
+		result.classSet_ = classSet;
+		result.classes_ = classes;
+		result.start_ = automaton.startStates() > 0
+			? id(*automaton.cStartBegin()) * classes
+			: 0;
+		result.finalBegin_ = finalBegin * classes;
+
+		return result;
+	}
+
+}
+
+#endif
@@ -0,0 +1,9 @@
+// Description: B-tree module
+// Documentation: btree.txt
+
+#ifndef PASTELSYS_BTREE_H_MODULE
+#define PASTELSYS_BTREE_H_MODULE
+
+#include "pastel/sys/btree/btree.h"
+
+#endif
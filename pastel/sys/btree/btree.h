@@ -0,0 +1,758 @@
+// Description: B-tree
+
+#ifndef PASTELSYS_BTREE_H
+#define PASTELSYS_BTREE_H
+
+#include "pastel/sys/btree/btree_fwd.h"
+#include "pastel/sys/btree/btree_node.h"
+#include "pastel/sys/btree/btree_iterator.h"
+#include "pastel/sys/redblacktree/redblacktree_concepts.h"
+#include "pastel/sys/redblacktree.h"
+
+namespace Pastel
+{
+
+	//! B-tree
+	/*!
+	Space complexity: O(size())
+
+	The B-tree stores up to Capacity elements in each node,
+	in arrays, and so takes far fewer cache-misses to search
+	than the RedBlackTree, which stores each element in its own
+	node. The interface is that of the RedBlackTree, and the
+	settings and the customization are those of the RedBlackTree
+	(see redblacktree_concepts.h); the settings can in addition
+	specify the node capacity as 'static constexpr integer Capacity',
+	which must be odd.
+
+	The customization sees the tree through the binary view
+	(see btree_iterator.h), and updatePropagation() is called
+	for the elements of the binary view. The propagation data
+	can therefore be used as in the RedBlackTree, provided it
+	does not depend on the colors of the nodes.
+
+	Unlike in the RedBlackTree, the insert() and erase() may
+	move elements between nodes, and so invalidate all iterators.
+	The Key and the Data must be default-constructible, and
+	move-assignable. The sentinel data is not supported.
+	*/
+	template <
+		typename Settings_,
+		template <typename> class Customization_ = Empty_RedBlackTree_Customization>
+	class BTree
+		: public Customization_<BTree_Settings<Settings_>>
+	{
+	public:
+		// See btree_fwd.h for the documentation
+		// for the following types.
+		using Settings = Settings_;
+		using Fwd = BTree_Fwd<Settings>;
+		using Customization = Customization_<BTree_Settings<Settings_>>;
+
+		PASTEL_FWD(Key);
+		PASTEL_FWD(Propagation);
+		PASTEL_FWD(Data);
+		PASTEL_FWD(Less);
+
+		PASTEL_FWD(Iterator);
+		PASTEL_FWD(ConstIterator);
+		PASTEL_FWD(Range);
+		PASTEL_FWD(ConstRange);
+
+		PASTEL_FWD(Node);
+		PASTEL_FWD(Internal_Node);
+
+		PASTEL_FWD(Insert_Return);
+		PASTEL_FWD(FindEqual_Return);
+
+		using iterator = Iterator;
+		using const_iterator = ConstIterator;
+
+		static constexpr integer Capacity = Fwd::Capacity;
+
+		//! The minimum number of elements in a non-root node.
+		static constexpr integer MinCount = Capacity / 2;
+
+		PASTEL_STATIC_ASSERT(!Settings::UserDataInSentinelNodes);
+
+		//! Constructs an empty tree.
+		/*!
+		Time complexity: O(1)
+		Exception safety: strong
+		*/
+		BTree()
+			: root_(allocateRoot())
+		{
+			this->onConstruction();
+		}
+
+		//! Copy-constructs from another tree.
+		/*!
+		Time complexity: O(that.size()) * updatePropagation()
+		Exception safety: strong
+		*/
+		BTree(const BTree& that);
+
+		//! Move-constructs from another tree.
+		/*!
+		Time complexity: O(1)
+		Exception safety: strong
+		*/
+		BTree(BTree&& that)
+			: BTree()
+		{
+			swapElements(that);
+		}
+
+		//! Constructs from a list of keys.
+		/*!
+		Time complexity: O(n log(n)) * updatePropagation()
+		Exception safety: strong
+
+		The user-data is default-initialized.
+		*/
+		template <typename Key_>
+		BTree(std::initializer_list<Key_> dataSet)
+			: BTree()
+		{
+			for (auto&& key : dataSet)
+			{
+				insert(key);
+			}
+		}
+
+		//! Constructs from a list of key-value pairs.
+		/*!
+		Time complexity: O(n log(n)) * updatePropagation()
+		Exception safety: strong
+		*/
+		BTree(std::initializer_list<std::pair<Key, Data>> dataSet)
+			: BTree()
+		{
+			for (auto&& keyValue : dataSet)
+			{
+				insert(keyValue.first, keyValue.second);
+			}
+		}
+
+		//! Copy-assigns from another tree.
+		/*!
+		Time complexity: O(size() + that.size())
+		Exception safety: strong
+		*/
+		BTree& operator=(const BTree& that)
+		{
+			BTree copy(that);
+			swapElements(copy);
+			return *this;
+		}
+
+		//! Move-assigns from another tree.
+		/*!
+		Time complexity: O(size())
+		Exception safety: nothrow
+		*/
+		BTree& operator=(BTree&& that)
+		{
+			clear();
+			swapElements(that);
+			return *this;
+		}
+
+		//! Destructs the tree.
+		/*!
+		Time complexity: O(size())
+		Exception safety: nothrow
+		*/
+		~BTree()
+		{
+			clear();
+			delete (Internal_Node*)root_;
+		}
+
+		//! Swaps two trees.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void swap(BTree& that)
+		{
+			Customization::swap(that);
+			swapElements(that);
+		}
+
+		//! Swaps elements with another tree.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		void swapElements(BTree& that)
+		{
+			std::swap(root_, that.root_);
+		}
+
+		//! Removes all elements from the tree.
+		/*!
+		Time complexity: O(size()) + onClear()
+		Exception safety: nothrow
+		*/
+		void clear();
+
+		//! Returns the number of elements in the tree.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer size() const
+		{
+			return root_->size();
+		}
+
+		//! Returns true if the tree is empty.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		bool empty() const
+		{
+			return root_->count == 0;
+		}
+
+		//! Returns the height of the tree.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+
+		All the leaf nodes are at the same depth;
+		the height is the number of nodes on a path
+		from the root to a leaf node.
+		*/
+		integer height() const;
+
+		//! Inserts an element into the tree.
+		/*!
+		Time complexity: O(Capacity log(size())) * updatePropagation() + onInsert()
+		Exception safety: strong + onInsert(), if the move-assignments
+		of the keys and the user-data do not throw.
+
+		returns:
+		If multiple keys are allowed, an iterator to the new element.
+		Otherwise an iterator-bool pair, where the boolean tells whether
+		the element was inserted. In case the element is not inserted,
+		the iterator points to the existing equivalent element.
+		Multiple equivalent elements are stored in the order they
+		were inserted.
+		*/
+		Insert_Return insert(
+			const Key& key,
+			const Data& data = Data());
+
+		//! Removes an element from the tree by its iterator.
+		/*!
+		Time complexity: O(Capacity log(size())) * updatePropagation()
+		Exception safety: nothrow, if the move-assignments of the keys
+		and the user-data do not throw.
+
+		If that == cend(), then nothing happens. This is
+		so that erase(find(key)) works even if the key is
+		not stored in the tree.
+
+		returns:
+		The element which followed 'that'.
+		*/
+		Iterator erase(const ConstIterator& that);
+
+		//! Removes elements in a range.
+		/*!
+		Time complexity: O(k Capacity log(size())) * updatePropagation()
+		where
+		k is the number of removed elements.
+
+		Exception safety: as in erase(that)
+
+		returns:
+		The element which followed the range.
+		*/
+		Iterator erase(const ConstRange& range);
+
+		//! Removes elements in a range.
+		/*!
+		This is a convenience function which calls
+		erase(ConstRange(begin, end)).
+		*/
+		Iterator erase(
+			const ConstIterator& begin,
+			const ConstIterator& end)
+		{
+			return erase(ConstRange(begin, end));
+		}
+
+		//! Removes all elements equivalent to the key.
+		/*!
+		This is a convenience function which calls
+		erase(equalRange(key)).
+		*/
+		Iterator erase(const Key& key)
+		{
+			return erase(equalRange(key));
+		}
+
+		//! Returns whether an element is contained in the tree.
+		/*!
+		This is a convenience function which returns
+		find(key) != cend().
+		*/
+		bool exists(const Key& key) const
+		{
+			return find(key) != cend();
+		}
+
+		//! Searches for the first element with key == 'key'.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+
+		If there are multiple elements equivalent to 'key',
+		then the first of them is returned (same as lowerBound()).
+		*/
+		ConstIterator find(const Key& key) const;
+
+		Iterator find(const Key& key)
+		{
+			return cast(addConst(*this).find(key));
+		}
+
+		//! Searches for an element equivalent to the key, and the next greater element.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+
+		returns:
+		An element equivalent to the key, or cend() if there
+		is no such element, and the first element greater than
+		the key, or cend() if there is no such element.
+		*/
+		FindEqual_Return findEqualAndUpper(const Key& key) const;
+
+		//! Returns the elements equivalent to the key.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+		*/
+		ConstRange equalRange(const Key& key) const
+		{
+			return ConstRange(lowerBound(key), upperBound(key));
+		}
+
+		Range equalRange(const Key& key)
+		{
+			return Range(lowerBound(key), upperBound(key));
+		}
+
+		//! Returns the first element >= key.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+		*/
+		ConstIterator lowerBound(const Key& key) const
+		{
+			return bound(key, false);
+		}
+
+		Iterator lowerBound(const Key& key)
+		{
+			return cast(addConst(*this).lowerBound(key));
+		}
+
+		ConstIterator lower_bound(const Key& key) const
+		{
+			return lowerBound(key);
+		}
+
+		Iterator lower_bound(const Key& key)
+		{
+			return lowerBound(key);
+		}
+
+		//! Returns the first element > key.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+		*/
+		ConstIterator upperBound(const Key& key) const
+		{
+			return bound(key, true);
+		}
+
+		Iterator upperBound(const Key& key)
+		{
+			return cast(addConst(*this).upperBound(key));
+		}
+
+		ConstIterator upper_bound(const Key& key) const
+		{
+			return upperBound(key);
+		}
+
+		Iterator upper_bound(const Key& key)
+		{
+			return upperBound(key);
+		}
+
+		//! Returns the number of elements equivalent to the key.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+		*/
+		integer count(const Key& key) const
+		{
+			return rank(upperBound(key)) - rank(lowerBound(key));
+		}
+
+		//! Returns the number of elements before the given element.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+
+		The rank of cend() is size().
+		*/
+		integer rank(const ConstIterator& element) const;
+
+		//! Returns the element with the given rank.
+		/*!
+		Preconditions:
+		0 <= i <= size()
+
+		Time complexity: O(Capacity log(size()))
+		Exception safety: nothrow
+
+		returns:
+		The i:th element, or cend() if i == size().
+		*/
+		ConstIterator select(integer i) const;
+
+		Iterator select(integer i)
+		{
+			return cast(addConst(*this).select(i));
+		}
+
+		//! Removes constness from an iterator.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		Iterator cast(const ConstIterator& that)
+		{
+			return Iterator((Node*)that.node_, that.index_);
+		}
+
+		//! Removes constness from a range.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		Range cast(const ConstRange& that)
+		{
+			return Range(cast(that.begin()), cast(that.end()));
+		}
+
+		//! Returns the first element.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+		*/
+		ConstIterator cbegin() const
+		{
+			return extremum(false);
+		}
+
+		ConstIterator begin() const
+		{
+			return cbegin();
+		}
+
+		Iterator begin()
+		{
+			return cast(cbegin());
+		}
+
+		//! Returns the one-past-last element.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		ConstIterator cend() const
+		{
+			return ConstIterator(root_, Capacity);
+		}
+
+		ConstIterator end() const
+		{
+			return cend();
+		}
+
+		Iterator end()
+		{
+			return cast(cend());
+		}
+
+		//! Returns the last element.
+		/*!
+		Time complexity: O(log(size()))
+		Exception safety: nothrow
+		*/
+		ConstIterator clast() const
+		{
+			return extremum(true);
+		}
+
+		ConstIterator last() const
+		{
+			return clast();
+		}
+
+		Iterator last()
+		{
+			return cast(clast());
+		}
+
+		//! Returns the root of the binary view.
+		/*!
+		Time complexity: O(1)
+		Exception safety: nothrow
+
+		If the tree is empty, returns cend().
+		*/
+		ConstIterator croot() const
+		{
+			return ConstIterator(root_, std::max(root_->count - 1, (integer)0));
+		}
+
+		ConstIterator root() const
+		{
+			return croot();
+		}
+
+		Iterator root()
+		{
+			return cast(croot());
+		}
+
+		PASTEL_RANGE_FUNCTIONS(range, begin, end);
+
+	private:
+		template <typename That_Settings, template <typename> class That_Customization>
+		friend bool testInvariants(const BTree<That_Settings, That_Customization>& tree);
+
+		ConstIterator extremum(bool right) const;
+
+		ConstIterator bound(const Key& key, bool upper) const;
+
+		Insert_Return insertReturnType(
+			const Iterator& that, bool success) const
+		{
+			if constexpr (Settings::MultipleKeys)
+			{
+				return that;
+			}
+			else
+			{
+				return Insert_Return(that, success);
+			}
+		}
+
+		//! Returns the number of keys in the node before the key.
+		/*!
+		Time complexity: O(Capacity)
+		Exception safety: nothrow
+
+		upper:
+		Whether to count the keys equivalent to 'key'.
+
+		For arithmetic keys under LessThan the keys are counted
+		without branches, which compiles to vector instructions;
+		otherwise the keys are binary-searched.
+		*/
+		integer searchNode(
+			const Node* node,
+			const Key& key,
+			bool upper) const;
+
+		//! Splits the i:th child of the node.
+		/*!
+		Preconditions:
+		node->count < Capacity
+		node->child(i)->count == Capacity
+
+		Time complexity: O(Capacity) * updatePropagation()
+		Exception safety: strong
+		*/
+		void splitChild(Node* node, integer i);
+
+		//! Splits a full root.
+		/*!
+		Time complexity: O(Capacity) * updatePropagation()
+		Exception safety: strong
+
+		The elements of the root are moved to two new
+		children, so that the root node stays the same.
+		*/
+		void splitRoot();
+
+		//! Removes the i:th element of the node.
+		/*!
+		Time complexity: O(Capacity log(size())) * updatePropagation()
+		Exception safety: nothrow
+		*/
+		void eraseElement(Node* node, integer i);
+
+		//! Makes room for an element at the i:th position.
+		/*!
+		Shifts the elements from the i:th on, and the
+		children from the (i + 1):th on, one step right.
+		*/
+		void openSlot(Node* node, integer i);
+
+		//! Removes the i:th element and the (i + 1):th child.
+		void closeSlot(Node* node, integer i);
+
+		//! Moves elements between nodes.
+		/*!
+		Moves the elements [from, from + n) of 'source' to
+		the positions [to, to + n) of 'target', and the children
+		to the right of those elements along with them. The
+		counts are left to the caller.
+		*/
+		void moveSlots(
+			Node* source, integer from, integer n,
+			Node* target, integer to);
+
+		//! Links a child node as the i:th child.
+		void link(Node* node, integer i, Node* child)
+		{
+			node->child(i) = child;
+			child->parent = node;
+			child->index = i;
+		}
+
+		//! Recomputes the sizes and the propagation data of the node.
+		/*!
+		Time complexity: O(Capacity) * updatePropagation()
+		Exception safety: nothrow
+
+		Only the elements from the 'from':th element on
+		are recomputed; the elements before it must be
+		up-to-date.
+		*/
+		void update(Node* node, integer from = 0);
+
+		//! Recomputes the node and its ancestors.
+		/*!
+		Time complexity: O(Capacity log(size())) * updatePropagation()
+		Exception safety: nothrow
+		*/
+		void updateToRoot(Node* node, integer from = 0);
+
+		//! Copies the subtree of a node.
+		/*!
+		Preconditions:
+		'node' is an allocated empty node.
+
+		On exception, the partially copied subtree
+		is left for clear(node) to deallocate.
+		*/
+		void copyConstruct(const Node* thatNode, Node* node);
+
+		//! Deallocates the subtree of a node.
+		void clear(Node* node);
+
+		//! Allocates the root node.
+		/*!
+		The root node is allocated as an internal node,
+		so that it can change between a leaf and an internal
+		node in place.
+		*/
+		static Node* allocateRoot()
+		{
+			Node* root = new Internal_Node();
+			root->setLeaf(true);
+			return root;
+		}
+
+		Node* allocateNode(bool leaf)
+		{
+			if (leaf)
+			{
+				return new Node();
+			}
+			return new Internal_Node();
+		}
+
+		void deallocateNode(Node* node)
+		{
+			if (node->leaf())
+			{
+				delete node;
+			}
+			else
+			{
+				delete (Internal_Node*)node;
+			}
+		}
+
+		bool less(const Key& left, const Key& right) const
+		{
+			return Less()(left, right);
+		}
+
+		//! The root node.
+		/*!
+		The root node is always allocated; an empty
+		tree consists of an empty leaf node. The root
+		node is never reallocated, so that the
+		end-iterator stays valid.
+		*/
+		Node* root_;
+	};
+
+}
+
+namespace Pastel
+{
+
+	// Map
+
+	template <
+		typename Key = Empty,
+		typename Data = Empty,
+		typename Less = LessThan,
+		typename Propagation = Empty,
+		template <typename> class Customization = Empty_RedBlackTree_Customization>
+	using BTree_Set =
+		BTree<RedBlackTree_Set_Settings<
+		Key, Data, Less, Propagation, Empty, false>,
+		Customization>;
+
+	// Multi-map
+
+	template <
+		typename Key = Empty,
+		typename Data = Empty,
+		typename Less = LessThan,
+		typename Propagation = Empty,
+		template <typename> class Customization = Empty_RedBlackTree_Customization>
+	using BTree_MultiSet =
+		BTree<RedBlackTree_Set_Settings<
+		Key, Data, Less, Propagation, Empty, true>,
+		Customization>;
+
+}
+
+#include "pastel/sys/btree/btree.hpp"
+#include "pastel/sys/btree/btree_erase.hpp"
+#include "pastel/sys/btree/btree_insert.hpp"
+#include "pastel/sys/btree/btree_invariants.h"
+#include "pastel/sys/btree/btree_quantile.h"
+#include "pastel/sys/btree/btree_search.hpp"
+
+#endif
@@ -0,0 +1,321 @@
+#ifndef PASTELSYS_BTREE_HPP
+#define PASTELSYS_BTREE_HPP
+
+#include "pastel/sys/btree/btree.h"
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	BTree<Settings, Customization>::BTree(const BTree& that)
+		: root_(allocateRoot())
+	{
+		try
+		{
+			copyConstruct(that.root_, root_);
+		}
+		catch(...)
+		{
+			clear(root_);
+			delete (Internal_Node*)root_;
+			throw;
+		}
+
+		// The propagation data is not copied, since it
+		// may refer to the elements of 'that'.
+		auto updateAll = [&](auto&& self, Node* node) -> void
+		{
+			if (!node->leaf())
+			{
+				for (integer i = 0;i <= node->count;++i)
+				{
+					self(self, node->child(i));
+				}
+			}
+			update(node);
+		};
+		updateAll(updateAll, root_);
+
+		this->onConstruction();
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::copyConstruct(
+		const Node* thatNode, Node* node)
+	{
+		if (node == root_)
+		{
+			root_->setLeaf(thatNode->leaf());
+		}
+
+		node->count = thatNode->count;
+		for (integer i = 0;i < thatNode->count;++i)
+		{
+			node->keySet[i] = thatNode->keySet[i];
+			node->dataSet[i] = thatNode->dataSet[i];
+		}
+
+		if (!node->leaf())
+		{
+			for (integer i = 0;i <= thatNode->count;++i)
+			{
+				const Node* thatChild = thatNode->child(i);
+				Node* child = allocateNode(thatChild->leaf());
+				link(node, i, child);
+				copyConstruct(thatChild, child);
+			}
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::clear()
+	{
+		this->onClear();
+
+		clear(root_);
+		for (integer i = 0;i < root_->count;++i)
+		{
+			root_->keySet[i] = Key();
+			root_->dataSet[i] = Data();
+		}
+		root_->count = 0;
+		root_->setLeaf(true);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::clear(Node* node)
+	{
+		if (node->leaf())
+		{
+			return;
+		}
+
+		for (integer i = 0;i <= node->count;++i)
+		{
+			Node* child = node->child(i);
+			if (child)
+			{
+				clear(child);
+				deallocateNode(child);
+			}
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	integer BTree<Settings, Customization>::height() const
+	{
+		integer result = 1;
+		for (Node* node = root_;!node->leaf();node = node->child(0))
+		{
+			++result;
+		}
+		return result;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::extremum(bool right) const
+	-> ConstIterator
+	{
+		const Node* node = root_;
+		while (!node->leaf())
+		{
+			node = node->child(right ? node->count : 0);
+		}
+
+		if (node->count == 0)
+		{
+			return cend();
+		}
+
+		return ConstIterator(node, right ? node->count - 1 : 0);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	integer BTree<Settings, Customization>::rank(
+		const ConstIterator& element) const
+	{
+		const Node* node = element.node_;
+		integer i = std::min(element.index_, node->count);
+
+		// The elements before the i:th element in the node.
+		integer result = (i > 0) ? node->slotSize(i - 1) : 0;
+		if (i == 0 && !node->leaf())
+		{
+			result = node->child(0)->size();
+		}
+
+		for (;node->parent;node = node->parent)
+		{
+			// The subtree of the (j - 1):th element in the
+			// parent ends with the j:th child, this node.
+			integer j = node->index;
+			if (j > 0)
+			{
+				result += node->parent->slotSize(j - 1) - node->size();
+			}
+		}
+
+		return result;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::select(integer rank) const
+	-> ConstIterator
+	{
+		PENSURE_RANGE(rank, 0, size() + 1);
+
+		if (rank == size())
+		{
+			return cend();
+		}
+
+		const Node* node = root_;
+		while (!node->leaf())
+		{
+			// Find the first element whose subtree, in the
+			// binary view, contains the searched element.
+			const auto& sizeSet = ((const Internal_Node*)node)->sizeSet;
+			integer i = std::upper_bound(
+				sizeSet.begin(), sizeSet.begin() + node->count,
+				rank) - sizeSet.begin();
+			ASSERT_OP(i, <, node->count);
+
+			// The number of elements before the i:th element.
+			integer before = (i > 0) ?
+				sizeSet[i - 1] : node->child(0)->size();
+
+			if (rank < before)
+			{
+				node = node->child(0);
+			}
+			else if (rank == before)
+			{
+				return ConstIterator(node, i);
+			}
+			else
+			{
+				rank -= before + 1;
+				node = node->child(i + 1);
+			}
+		}
+
+		return ConstIterator(node, rank);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::update(
+		Node* node, integer from)
+	{
+		ASSERT_OP(from, >=, 0);
+
+		if (!node->leaf())
+		{
+			auto& sizeSet = ((Internal_Node*)node)->sizeSet;
+			for (integer i = from;i < node->count;++i)
+			{
+				sizeSet[i] =
+					(i > 0 ? sizeSet[i - 1] : node->child(0)->size()) +
+					1 + node->child(i + 1)->size();
+			}
+		}
+
+		for (integer i = from;i < node->count;++i)
+		{
+			this->updatePropagation(
+				Iterator(node, i),
+				node->propagationSet[i]);
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::updateToRoot(
+		Node* node, integer from)
+	{
+		while (true)
+		{
+			update(node, from);
+			if (!node->parent)
+			{
+				break;
+			}
+
+			// Only the elements whose subtrees contain
+			// the child need to be updated.
+			from = std::max(node->index - 1, (integer)0);
+			node = node->parent;
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::openSlot(
+		Node* node, integer i)
+	{
+		ASSERT_OP(node->count, <, Capacity);
+
+		for (integer j = node->count;j > i;--j)
+		{
+			node->keySet[j] = std::move(node->keySet[j - 1]);
+			node->dataSet[j] = std::move(node->dataSet[j - 1]);
+		}
+
+		if (!node->leaf())
+		{
+			for (integer j = node->count + 1;j > i + 1;--j)
+			{
+				link(node, j, node->child(j - 1));
+			}
+		}
+
+		++node->count;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::closeSlot(
+		Node* node, integer i)
+	{
+		--node->count;
+
+		for (integer j = i;j < node->count;++j)
+		{
+			node->keySet[j] = std::move(node->keySet[j + 1]);
+			node->dataSet[j] = std::move(node->dataSet[j + 1]);
+		}
+
+		if (!node->leaf())
+		{
+			for (integer j = i + 1;j <= node->count;++j)
+			{
+				link(node, j, node->child(j + 1));
+			}
+		}
+
+		// Release the resources of the removed element.
+		node->keySet[node->count] = Key();
+		node->dataSet[node->count] = Data();
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::moveSlots(
+		Node* source, integer from, integer n,
+		Node* target, integer to)
+	{
+		for (integer j = 0;j < n;++j)
+		{
+			target->keySet[to + j] = std::move(source->keySet[from + j]);
+			target->dataSet[to + j] = std::move(source->dataSet[from + j]);
+			source->keySet[from + j] = Key();
+			source->dataSet[from + j] = Data();
+		}
+
+		if (!source->leaf())
+		{
+			for (integer j = 1;j <= n;++j)
+			{
+				link(target, to + j, source->child(from + j));
+			}
+		}
+	}
+
+}
+
+#endif
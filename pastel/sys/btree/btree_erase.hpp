@@ -0,0 +1,185 @@
+#ifndef PASTELSYS_BTREE_ERASE_HPP
+#define PASTELSYS_BTREE_ERASE_HPP
+
+#include "pastel/sys/btree/btree.h"
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::erase(
+		const ConstIterator& that)
+	-> Iterator
+	{
+		if (that == cend())
+		{
+			return end();
+		}
+
+		// The elements move in the nodes, so the next
+		// element is found by its rank afterwards.
+		integer i = rank(that);
+
+		this->onErase(cast(that));
+		eraseElement((Node*)that.node_, that.index_);
+
+		return select(i);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::erase(
+		const ConstRange& range)
+	-> Iterator
+	{
+		integer i = rank(range.begin());
+		integer n = rank(range.end()) - i;
+
+		for (integer j = 0;j < n;++j)
+		{
+			Iterator element = select(i);
+			this->onErase(element);
+			eraseElement(element.node_, element.index_);
+		}
+
+		return select(i);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::eraseElement(
+		Node* node, integer i)
+	{
+		ASSERT_OP(i, >=, 0);
+		ASSERT_OP(i, <, node->count);
+
+		if (!node->leaf())
+		{
+			// Replace the element by its predecessor,
+			// which is in a leaf node, and remove the
+			// predecessor instead.
+			Node* leaf = node->child(i);
+			while (!leaf->leaf())
+			{
+				leaf = leaf->child(leaf->count);
+			}
+			integer j = leaf->count - 1;
+
+			node->keySet[i] = std::move(leaf->keySet[j]);
+			node->dataSet[i] = std::move(leaf->dataSet[j]);
+
+			node = leaf;
+			i = j;
+		}
+
+		closeSlot(node, i);
+
+		// The elements of 'node' from 'from' on are out of
+		// date, and so are the ancestors of 'node'; the nodes
+		// below 'node' are up-to-date.
+		integer from = i;
+		while (node != root_ && node->count < MinCount)
+		{
+			Node* parent = node->parent;
+			integer j = node->index;
+			Node* left = (j > 0) ? parent->child(j - 1) : nullptr;
+			Node* right = (j < parent->count) ? parent->child(j + 1) : nullptr;
+
+			if (left && left->count > MinCount)
+			{
+				// Rotate an element from the left sibling
+				// through the parent.
+				openSlot(node, 0);
+				if (!node->leaf())
+				{
+					link(node, 1, node->child(0));
+					link(node, 0, left->child(left->count));
+				}
+				node->keySet[0] = std::move(parent->keySet[j - 1]);
+				node->dataSet[0] = std::move(parent->dataSet[j - 1]);
+
+				integer k = left->count - 1;
+				parent->keySet[j - 1] = std::move(left->keySet[k]);
+				parent->dataSet[j - 1] = std::move(left->dataSet[k]);
+				left->keySet[k] = Key();
+				left->dataSet[k] = Data();
+				--left->count;
+
+				update(node);
+				from = std::max(j - 2, (integer)0);
+				node = parent;
+				break;
+			}
+
+			if (right && right->count > MinCount)
+			{
+				// Rotate an element from the right sibling
+				// through the parent.
+				integer k = node->count;
+				++node->count;
+				node->keySet[k] = std::move(parent->keySet[j]);
+				node->dataSet[k] = std::move(parent->dataSet[j]);
+				if (!node->leaf())
+				{
+					link(node, k + 1, right->child(0));
+					link(right, 0, right->child(1));
+				}
+
+				parent->keySet[j] = std::move(right->keySet[0]);
+				parent->dataSet[j] = std::move(right->dataSet[0]);
+				closeSlot(right, 0);
+
+				update(node, std::min(from, k));
+				update(right);
+				from = std::max(j - 1, (integer)0);
+				node = parent;
+				break;
+			}
+
+			// Merge with a sibling, and the element
+			// between them in the parent.
+			integer k = left ? j - 1 : j;
+			Node* target = left ? left : node;
+			Node* source = left ? node : right;
+
+			integer m = target->count;
+			target->keySet[m] = std::move(parent->keySet[k]);
+			target->dataSet[m] = std::move(parent->dataSet[k]);
+			if (!target->leaf())
+			{
+				link(target, m + 1, source->child(0));
+			}
+			moveSlots(source, 0, source->count, target, m + 1);
+			target->count += source->count + 1;
+			source->count = 0;
+
+			closeSlot(parent, k);
+			deallocateNode(source);
+
+			update(target, (target == node) ? std::min(from, m) : m);
+			from = std::max(k - 1, (integer)0);
+			node = parent;
+		}
+
+		if (node == root_ && node->count == 0 && !node->leaf())
+		{
+			// The root has become empty; the elements
+			// of its only child are moved to the root.
+			Node* child = node->child(0);
+			root_->setLeaf(child->leaf());
+			if (!child->leaf())
+			{
+				link(root_, 0, child->child(0));
+			}
+			moveSlots(child, 0, child->count, root_, 0);
+			root_->count = child->count;
+			child->count = 0;
+			deallocateNode(child);
+			update(root_);
+			return;
+		}
+
+		updateToRoot(node, from);
+	}
+
+}
+
+#endif
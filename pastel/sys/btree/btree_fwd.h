@@ -0,0 +1,148 @@
+// Description: B-tree types
+
+#ifndef PASTELSYS_BTREE_FWD_H
+#define PASTELSYS_BTREE_FWD_H
+
+#include "pastel/sys/redblacktree/redblacktree_fwd.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace Pastel
+{
+
+	namespace BTree_
+	{
+
+		template <typename>
+		class Node;
+
+		template <typename>
+		class Internal_Node;
+
+		template <typename, typename, bool>
+		class Iterator;
+
+		template <typename Settings>
+		concept Has_Capacity_ = requires
+		{
+			{Settings::Capacity} -> std::convertible_to<integer>;
+		};
+
+		//! Returns the maximum number of keys in a node.
+		/*!
+		If the settings do not specify the capacity, then
+		it is chosen so that the keys of a node take about
+		four cache-lines.
+		*/
+		template <typename Settings>
+		constexpr integer capacity()
+		{
+			if constexpr (Has_Capacity_<Settings>)
+			{
+				return Settings::Capacity;
+			}
+			else
+			{
+				integer keySize = sizeof(typename Settings::Key);
+				return 2 * std::clamp<integer>(128 / keySize, 4, 32) - 1;
+			}
+		}
+
+	}
+
+	template <typename, template <typename> class>
+	class BTree;
+
+	//! Marks settings as those of a B-tree.
+	/*!
+	A B-tree instantiates its customization with these
+	settings, so that RedBlackTree_Fwd in the customization
+	refers to the types of the B-tree. This way the same
+	customization can be used for both the RedBlackTree
+	and the BTree.
+	*/
+	template <typename Settings>
+	class BTree_Settings
+		: public Settings
+	{
+	};
+
+	template <typename Settings>
+	class BTree_Fwd
+	{
+	public:
+		using Fwd = Settings;
+
+		PASTEL_FWD(Key);
+		PASTEL_FWD(Propagation);
+		PASTEL_FWD(Data);
+		PASTEL_FWD(Less);
+
+		static constexpr bool MultipleKeys =
+			Settings::MultipleKeys;
+
+		//! The maximum number of keys in a node.
+		/*!
+		This is odd, so that a full node splits evenly
+		around its median.
+		*/
+		static constexpr integer Capacity =
+			BTree_::capacity<Settings>();
+
+		PASTEL_STATIC_ASSERT(Capacity >= 3 && Capacity % 2 == 1);
+
+		using Key_ = Key;
+		using Data_ = Data;
+		using Propagation_ = Propagation;
+
+		static constexpr bool DereferenceToData =
+			!std::is_same<Data, Empty>::value;
+
+		class Node_Settings
+		{
+		public:
+			using Key = Key_;
+			using Data = Data_;
+			using Propagation = Propagation_;
+			static constexpr integer Capacity = BTree_Fwd::Capacity;
+		};
+
+		using Node = BTree_::Node<Node_Settings>;
+		using Internal_Node = BTree_::Internal_Node<Node_Settings>;
+
+		using Iterator =
+			BTree_::Iterator<Node*, Node_Settings, DereferenceToData>;
+		using ConstIterator =
+			BTree_::Iterator<const Node*, Node_Settings, DereferenceToData>;
+		using Range = ranges::subrange<Iterator>;
+		using ConstRange = ranges::subrange<ConstIterator>;
+
+		using Insert_Return =
+			typename std::conditional<MultipleKeys,
+			Iterator,
+			std::pair<Iterator, bool >>::type;
+
+		struct FindEqual_Return
+		{
+			//! An element equivalent to the key.
+			ConstIterator equal;
+
+			//! The first element greater than the key.
+			ConstIterator upper;
+		};
+	};
+
+	//! The types of a B-tree as seen by its customization.
+	template <typename Settings>
+	class RedBlackTree_Fwd<BTree_Settings<Settings>>
+		: public BTree_Fwd<Settings>
+	{
+	public:
+		template <template <typename> class Customization>
+		using Tree = BTree<Settings, Customization>;
+	};
+
+}
+
+#endif
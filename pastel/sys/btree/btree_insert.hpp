@@ -0,0 +1,158 @@
+#ifndef PASTELSYS_BTREE_INSERT_HPP
+#define PASTELSYS_BTREE_INSERT_HPP
+
+#include "pastel/sys/btree/btree.h"
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::insert(
+		const Key& key,
+		const Data& data)
+	-> Insert_Return
+	{
+		if constexpr (!Settings::MultipleKeys)
+		{
+			// Splitting the nodes does not change the
+			// elements, but it is wasted work if the key
+			// already exists.
+			ConstIterator equal = find(key);
+			if (equal != cend())
+			{
+				return insertReturnType(cast(equal), false);
+			}
+		}
+
+		// The full nodes are split on the way down, so
+		// that the leaf node has room for the element,
+		// and every split has room in the parent.
+		if (root_->count == Capacity)
+		{
+			splitRoot();
+		}
+
+		Node* node = root_;
+		while (!node->leaf())
+		{
+			// The equivalent elements are inserted last,
+			// to keep them in the order of insertion.
+			integer i = searchNode(node, key, true);
+			if (node->child(i)->count == Capacity)
+			{
+				splitChild(node, i);
+				if (!less(key, node->keySet[i]))
+				{
+					++i;
+				}
+			}
+			node = node->child(i);
+		}
+
+		integer i = searchNode(node, key, true);
+
+		// From now on nothing throws, if the move-assignments
+		// do not throw.
+
+		openSlot(node, i);
+		node->keySet[i] = key;
+		node->dataSet[i] = data;
+
+		updateToRoot(node, i);
+
+		Iterator element(node, i);
+		this->onInsert(element);
+
+		return insertReturnType(element, true);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::splitChild(
+		Node* node, integer i)
+	{
+		Node* left = node->child(i);
+		ASSERT_OP(left->count, ==, Capacity);
+		ASSERT_OP(node->count, <, Capacity);
+
+		Node* right = allocateNode(left->leaf());
+
+		// From now on nothing throws.
+
+		//   ... m ...
+		//      / \
+		//  left   right
+		integer m = Capacity / 2;
+		integer n = Capacity - m - 1;
+		moveSlots(left, m + 1, n, right, 0);
+		if (!left->leaf())
+		{
+			link(right, 0, left->child(m + 1));
+		}
+		right->count = n;
+
+		openSlot(node, i);
+		node->keySet[i] = std::move(left->keySet[m]);
+		node->dataSet[i] = std::move(left->dataSet[m]);
+		left->keySet[m] = Key();
+		left->dataSet[m] = Data();
+		left->count = m;
+		link(node, i + 1, right);
+
+		// The elements of 'left' before the median
+		// are unaffected.
+		update(right);
+		update(node, std::max(i - 1, (integer)0));
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void BTree<Settings, Customization>::splitRoot()
+	{
+		ASSERT_OP(root_->count, ==, Capacity);
+
+		bool leaf = root_->leaf();
+		Node* left = allocateNode(leaf);
+		Node* right = nullptr;
+		try
+		{
+			right = allocateNode(leaf);
+		}
+		catch(...)
+		{
+			deallocateNode(left);
+			throw;
+		}
+
+		// From now on nothing throws.
+
+		//      m
+		//     / \
+		//  left  right
+		integer m = Capacity / 2;
+		integer n = Capacity - m - 1;
+		if (!leaf)
+		{
+			link(left, 0, root_->child(0));
+			link(right, 0, root_->child(m + 1));
+		}
+		moveSlots(root_, 0, m, left, 0);
+		left->count = m;
+		moveSlots(root_, m + 1, n, right, 0);
+		right->count = n;
+
+		root_->keySet[0] = std::move(root_->keySet[m]);
+		root_->dataSet[0] = std::move(root_->dataSet[m]);
+		root_->keySet[m] = Key();
+		root_->dataSet[m] = Data();
+		root_->count = 1;
+		root_->setLeaf(false);
+		link(root_, 0, left);
+		link(root_, 1, right);
+
+		update(left);
+		update(right);
+		update(root_);
+	}
+
+}
+
+#endif
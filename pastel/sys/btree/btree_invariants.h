@@ -0,0 +1,26 @@
+// Description: B-tree invariants
+
+#ifndef PASTELSYS_BTREE_INVARIANTS_H
+#define PASTELSYS_BTREE_INVARIANTS_H
+
+#include "pastel/sys/btree/btree.h"
+
+namespace Pastel
+{
+
+	//! Returns whether the B-tree invariants hold for the tree.
+	/*!
+	Time complexity: O(tree.size())
+	Exception safety: nothrow
+
+	This function is useful only for testing. For a correct implementation
+	this function will always return true.
+	*/
+	template <typename Settings, template <typename> class Customization>
+	bool testInvariants(const BTree<Settings, Customization>& tree);
+
+}
+
+#include "pastel/sys/btree/btree_invariants.hpp"
+
+#endif
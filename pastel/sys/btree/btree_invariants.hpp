@@ -0,0 +1,177 @@
+#ifndef PASTELSYS_BTREE_INVARIANTS_HPP
+#define PASTELSYS_BTREE_INVARIANTS_HPP
+
+#include "pastel/sys/btree/btree_invariants.h"
+
+#include <iterator>
+
+namespace Pastel
+{
+
+	namespace BTree_
+	{
+
+		template <typename Tree, typename Node>
+		bool testInvariants(
+			const Node* root,
+			const Node* node,
+			integer depth,
+			integer& leafDepth)
+		{
+			if (node->count > Tree::Capacity)
+			{
+				return false;
+			}
+
+			if (node != root && node->count < Tree::MinCount)
+			{
+				// Every node, except the root, must be
+				// at least half full.
+				return false;
+			}
+
+			if (node->leaf())
+			{
+				if (leafDepth < 0)
+				{
+					leafDepth = depth;
+				}
+
+				// All the leaf nodes must be at the same depth.
+				return depth == leafDepth;
+			}
+
+			if (node->count == 0)
+			{
+				// An internal node must have an element.
+				return false;
+			}
+
+			for (integer i = 0;i <= node->count;++i)
+			{
+				const Node* child = node->child(i);
+				if (child->parent != node ||
+					child->index != i)
+				{
+					// The child must link back to its parent.
+					return false;
+				}
+
+				if (!testInvariants<Tree>(root, child, depth + 1, leafDepth))
+				{
+					return false;
+				}
+			}
+
+			for (integer i = 0;i < node->count;++i)
+			{
+				integer size =
+					(i > 0 ? node->slotSize(i - 1) : node->child(0)->size()) +
+					1 + node->child(i + 1)->size();
+				if (node->slotSize(i) != size)
+				{
+					// The sizes of the subtrees must be up-to-date.
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	bool testInvariants(const BTree<Settings, Customization>& tree)
+	{
+		using Tree = BTree<Settings, Customization>;
+
+		if (tree.root_->parent)
+		{
+			// The root must not have a parent.
+			return false;
+		}
+
+		integer leafDepth = -1;
+		if (!BTree_::testInvariants<Tree>(tree.root_, tree.root_, 0, leafDepth))
+		{
+			return false;
+		}
+
+		if (leafDepth + 1 != tree.height())
+		{
+			return false;
+		}
+
+		using Fwd = Settings;
+		PASTEL_FWD(Less);
+
+		if (std::distance(tree.cbegin(), tree.cend()) != tree.size())
+		{
+			// The size() must equal the number of elements in the tree.
+			return false;
+		}
+
+		integer i = 0;
+		for (auto iter = tree.cbegin();iter != tree.cend();++iter)
+		{
+			if (i > 0)
+			{
+				const auto& previous = std::prev(iter).key();
+				if (Settings::MultipleKeys ?
+					Less()(iter.key(), previous) :
+					!Less()(previous, iter.key()))
+				{
+					// The keys must be in sorted order, and
+					// unique when multiple keys are not allowed.
+					return false;
+				}
+			}
+
+			if (tree.rank(iter) != i ||
+				tree.select(i) != iter)
+			{
+				// The rank must agree with the order.
+				return false;
+			}
+
+			if (!iter.left().isSentinel() &&
+				iter.left().parent() != iter)
+			{
+				// The binary view must be consistent.
+				return false;
+			}
+
+			if (!iter.right().isSentinel() &&
+				iter.right().parent() != iter)
+			{
+				return false;
+			}
+
+			if (iter.size() !=
+				iter.left().size() + 1 + iter.right().size())
+			{
+				return false;
+			}
+
+			++i;
+		}
+
+		if (tree.croot().isNormal() && 
+			tree.croot().size() != tree.size())
+		{
+			// The root of the binary view must
+			// contain all the elements.
+			return false;
+		}
+
+		if (std::prev(tree.cend()) != tree.clast() && !tree.empty())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+}
+
+#endif
@@ -0,0 +1,377 @@
+// Description: B-tree iterator
+
+#ifndef PASTELSYS_BTREE_ITERATOR_H
+#define PASTELSYS_BTREE_ITERATOR_H
+
+#include "pastel/sys/mytypes.h"
+#include "pastel/sys/btree/btree_fwd.h"
+#include "pastel/sys/btree/btree_node.h"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <type_traits>
+
+namespace Pastel
+{
+
+	namespace BTree_
+	{
+
+		//! B-tree iterator
+		/*!
+		An iterator refers to an element in a node. In addition
+		to the in-order traversal, the iterator provides a
+		_binary view_ of the B-tree through left(), right(), and
+		parent(). In the binary view the i:th element of a node
+		has as its left child the (i - 1):th element of the same
+		node, or for i = 0 the last element of the 0:th child node;
+		its right child is the last element of the (i + 1):th child
+		node. This is a binary search tree, on which the
+		propagation data is defined as in the RedBlackTree.
+		*/
+		template <
+			typename NodePtr,
+			typename Node_Settings,
+			bool DereferenceToData>
+		class Iterator
+			: public boost::iterator_facade<
+			Iterator<NodePtr, Node_Settings, DereferenceToData>,
+			typename std::conditional<DereferenceToData,
+			typename Node_Settings::Data,
+			const typename Node_Settings::Key>::type,
+			boost::bidirectional_traversal_tag>
+		{
+		public:
+			using Fwd = Node_Settings;
+			PASTEL_FWD(Key);
+			PASTEL_FWD(Data);
+			PASTEL_FWD(Propagation);
+
+			using Node = BTree_::Node<Node_Settings>;
+
+			//! The index of the end-iterator in the root node.
+			static constexpr integer End = Node_Settings::Capacity;
+
+			template <bool DereferenceToData_>
+			using Other_Iterator = Iterator<NodePtr, Node_Settings, DereferenceToData_>;
+			using Key_Iterator = Other_Iterator<false>;
+			using Data_Iterator = Other_Iterator<true>;
+
+			Iterator()
+				: node_(nullptr)
+				, index_(0)
+			{
+			}
+
+			template <
+				typename That_NodePtr,
+				bool That_DereferenceToData>
+			requires std::is_convertible_v<That_NodePtr, NodePtr>
+			Iterator(
+				const Iterator<That_NodePtr, Node_Settings, That_DereferenceToData>& that)
+				: node_(that.node_)
+				, index_(that.index_)
+			{
+			}
+
+			//! Returns an iterator which dereferences to the key.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			Key_Iterator dereferenceKey() const
+			{
+				return Key_Iterator(*this);
+			}
+
+			//! Returns an iterator which dereferences to user data.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			Data_Iterator dereferenceData() const
+			{
+				return Data_Iterator(*this);
+			}
+
+			//! Returns the key of the element.
+			/*!
+			Preconditions:
+			isNormal()
+
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			const Key& key() const
+			{
+				PENSURE(isNormal());
+				return node_->keySet[index_];
+			}
+
+			//! Returns the user data.
+			/*!
+			Preconditions:
+			isNormal()
+
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			Data& data() const
+			{
+				PENSURE(isNormal());
+				return ((Node*)node_)->dataSet[index_];
+			}
+
+			//! Returns the propagation data.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+
+			The propagation data of a sentinel is
+			default-constructed.
+			*/
+			const Propagation& propagation() const
+			{
+				if (isSentinel())
+				{
+					static const Propagation sentinel = Propagation();
+					return sentinel;
+				}
+				return node_->propagationSet[index_];
+			}
+
+			//! Returns whether this is a sentinel iterator.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+
+			The end-iterator, and the missing children
+			in the binary view, are sentinels. The
+			end-iterator refers to the root node, which
+			is never reallocated, and so stays valid.
+			*/
+			bool isSentinel() const
+			{
+				return index_ < 0 || index_ >= node_->count;
+			}
+
+			//! Returns whether this is a null iterator.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+
+			A default-constructed iterator is a null-iterator.
+			*/
+			bool empty() const
+			{
+				return node_ == nullptr;
+			}
+
+			//! Returns whether this is a normal iterator.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			bool isNormal() const
+			{
+				return !empty() && !isSentinel();
+			}
+
+			//! Returns the left child in the binary view.
+			/*!
+			Preconditions:
+			isNormal()
+
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			Iterator left() const
+			{
+				PENSURE(isNormal());
+				if (index_ > 0)
+				{
+					return Iterator(node_, index_ - 1);
+				}
+				return subtree(0);
+			}
+
+			//! Returns the right child in the binary view.
+			/*!
+			Preconditions:
+			isNormal()
+
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			Iterator right() const
+			{
+				PENSURE(isNormal());
+				return subtree(index_ + 1);
+			}
+
+			//! Returns the given child in the binary view.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			Iterator child(bool right) const
+			{
+				return right ? this->right() : left();
+			}
+
+			//! Returns the parent in the binary view.
+			/*!
+			Preconditions:
+			isNormal()
+
+			Time complexity: O(1)
+			Exception safety: nothrow
+
+			The parent of the root is the end-iterator.
+			*/
+			Iterator parent() const
+			{
+				PENSURE(isNormal());
+				if (index_ + 1 < node_->count)
+				{
+					// The element is the left child of
+					// the next element in the node.
+					return Iterator(node_, index_ + 1);
+				}
+
+				NodePtr parent = node_->parent;
+				if (!parent)
+				{
+					return Iterator(node_, End);
+				}
+
+				// The element is the root of the subtree
+				// of the child node.
+				integer i = node_->index;
+				return Iterator(parent, i > 0 ? i - 1 : 0);
+			}
+
+			//! Returns the number of elements in the subtree of the binary view.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			integer size() const
+			{
+				if (isSentinel())
+				{
+					return 0;
+				}
+				return node_->slotSize(index_);
+			}
+
+		private:
+			template <typename, template <typename> class>
+			friend class Pastel::BTree;
+
+			template <typename, typename, bool>
+			friend class Iterator;
+
+			friend class boost::iterator_core_access;
+
+			Iterator(NodePtr node, integer index)
+				: node_(node)
+				, index_(index)
+			{
+			}
+
+			//! Returns the root of the binary view of the i:th child.
+			Iterator subtree(integer i) const
+			{
+				if (node_->leaf())
+				{
+					return Iterator(node_, -1);
+				}
+				NodePtr child = node_->child(i);
+				return Iterator(child, child->count - 1);
+			}
+
+			using DereferenceType = std::conditional_t<
+				DereferenceToData,
+				Data,
+				const Key>;
+
+			DereferenceType& dereference() const
+			{
+				if constexpr (DereferenceToData) {
+					return data();
+				} else {
+					return key();
+				}
+			}
+
+			template <typename That_NodePtr, bool That_DereferenceToData>
+			bool equal(
+				const Iterator<That_NodePtr, Node_Settings, That_DereferenceToData>& that) const
+			{
+				return node_ == that.node_ &&
+					index_ == that.index_;
+			}
+
+			void increment()
+			{
+				if (!node_->leaf())
+				{
+					// The next element is the minimum
+					// of the next child.
+					node_ = node_->child(index_ + 1);
+					while (!node_->leaf())
+					{
+						node_ = node_->child(0);
+					}
+					index_ = 0;
+					return;
+				}
+
+				++index_;
+				while (index_ == node_->count && node_->parent)
+				{
+					index_ = node_->index;
+					node_ = node_->parent;
+				}
+
+				if (index_ == node_->count)
+				{
+					// This is the root node.
+					index_ = End;
+				}
+			}
+
+			void decrement()
+			{
+				index_ = std::min(index_, node_->count);
+				if (!node_->leaf())
+				{
+					// The previous element is the maximum
+					// of the child before the element.
+					node_ = node_->child(index_);
+					while (!node_->leaf())
+					{
+						node_ = node_->child(node_->count);
+					}
+					index_ = node_->count - 1;
+					return;
+				}
+
+				while (index_ == 0 && node_->parent)
+				{
+					index_ = node_->index;
+					node_ = node_->parent;
+				}
+				--index_;
+			}
+
+			NodePtr node_;
+			integer index_;
+		};
+
+	}
+
+}
+
+#endif
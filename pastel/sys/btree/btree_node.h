@@ -0,0 +1,147 @@
+// Description: B-tree node
+
+#ifndef PASTELSYS_BTREE_NODE_H
+#define PASTELSYS_BTREE_NODE_H
+
+#include "pastel/sys/btree/btree_fwd.h"
+#include "pastel/sys/ensure.h"
+
+#include <array>
+
+namespace Pastel
+{
+
+	namespace BTree_
+	{
+
+		//! Leaf node
+		/*!
+		The keys, the user data, and the propagation data
+		are stored in separate arrays, so that searching a
+		node only reads the contiguous keys.
+		*/
+		template <typename Node_Settings>
+		class Node
+		{
+		public:
+			using Fwd = Node_Settings;
+			PASTEL_FWD(Key);
+			PASTEL_FWD(Data);
+			PASTEL_FWD(Propagation);
+			static constexpr integer Capacity = Node_Settings::Capacity;
+
+			using Internal_Node = BTree_::Internal_Node<Node_Settings>;
+
+			explicit Node(bool leaf = true)
+				: leaf_(leaf)
+			{
+			}
+
+			Node(const Node& that) = delete;
+			Node(Node&& that) = delete;
+			Node& operator=(Node that) = delete;
+
+			bool leaf() const
+			{
+				return leaf_;
+			}
+
+			//! Sets whether the node is a leaf node.
+			/*!
+			Preconditions:
+			This is an Internal_Node.
+
+			This is used for the root node, which changes
+			between a leaf and an internal node in place.
+			*/
+			void setLeaf(bool leaf)
+			{
+				leaf_ = leaf;
+			}
+
+			//! Returns the i:th child.
+			/*!
+			Preconditions:
+			!leaf()
+			0 <= i <= count
+			*/
+			Node*& child(integer i) const
+			{
+				ASSERT(!leaf());
+				return ((Internal_Node*)this)->childSet[i];
+			}
+
+			//! Returns the number of elements in the subtree.
+			integer size() const
+			{
+				if (count == 0)
+				{
+					return 0;
+				}
+				return slotSize(count - 1);
+			}
+
+			//! Returns the size of the subtree of the i:th element.
+			/*!
+			The subtree of the i:th element consists of the
+			children 0, ..., i + 1, and the elements 0, ..., i.
+			This is the subtree of the element in the binary
+			view of the B-tree.
+			*/
+			integer slotSize(integer i) const
+			{
+				if (leaf())
+				{
+					return i + 1;
+				}
+				return ((const Internal_Node*)this)->sizeSet[i];
+			}
+
+			//! The parent node, or null for the root.
+			Node* parent = nullptr;
+
+			//! The index of this node in the children of the parent.
+			integer index = 0;
+
+			//! The number of elements in the node.
+			integer count = 0;
+
+			std::array<Key, Capacity> keySet;
+			std::array<Data, Capacity> dataSet;
+
+			//! The propagation data of the binary view.
+			/*!
+			The i:th propagation data is for the subtree
+			of the i:th element; see slotSize().
+			*/
+			std::array<Propagation, Capacity> propagationSet;
+
+		private:
+			bool leaf_;
+		};
+
+		//! Internal node
+		template <typename Node_Settings>
+		class Internal_Node
+			: public Node<Node_Settings>
+		{
+		public:
+			using Base = Node<Node_Settings>;
+			static constexpr integer Capacity = Base::Capacity;
+
+			Internal_Node()
+				: Base(false)
+			{
+			}
+
+			std::array<Base*, Capacity + 1> childSet{};
+
+			//! The sizes of the subtrees of the elements.
+			std::array<integer, Capacity> sizeSet;
+		};
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+// Description: Quantile of elements in a B-tree
+
+#ifndef PASTELSYS_BTREE_QUANTILE_H
+#define PASTELSYS_BTREE_QUANTILE_H
+
+#include "pastel/sys/btree/btree.h"
+#include "pastel/sys/redblacktree/redblacktree_quantile.h"
+
+namespace Pastel
+{
+
+	//! Returns a quantile of the elements.
+	/*!
+	Time complexity: O(Capacity log(tree.size()))
+
+	This is as quantile() for the RedBlackTree; the
+	search is done in the binary view of the tree.
+	*/
+	template <typename Settings, template <typename> class Customization>
+	typename BTree<Settings, Customization>::ConstIterator
+	quantile(
+		const BTree<Settings, Customization>& tree,
+		dreal alpha)
+	{
+		return RedBlackTree_::quantile(tree, alpha);
+	}
+
+}
+
+#endif
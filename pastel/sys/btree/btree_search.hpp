@@ -0,0 +1,147 @@
+#ifndef PASTELSYS_BTREE_SEARCH_HPP
+#define PASTELSYS_BTREE_SEARCH_HPP
+
+#include "pastel/sys/btree/btree.h"
+
+#include <algorithm>
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	integer BTree<Settings, Customization>::searchNode(
+		const Node* node,
+		const Key& key,
+		bool upper) const
+	{
+		if constexpr (
+			std::is_arithmetic_v<Key> &&
+			std::is_same_v<Less, LessThan>)
+		{
+			// Since the keys are sorted, the number of keys
+			// before the key is the position of the key. The
+			// counting has no branches, and no dependencies
+			// between iterations, and so is vectorized.
+			const Key* keySet = node->keySet.data();
+			integer n = node->count;
+			integer result = 0;
+			if (upper)
+			{
+				for (integer i = 0;i < n;++i)
+				{
+					result += (keySet[i] <= key);
+				}
+			}
+			else
+			{
+				for (integer i = 0;i < n;++i)
+				{
+					result += (keySet[i] < key);
+				}
+			}
+			return result;
+		}
+		else
+		{
+			auto begin = node->keySet.begin();
+			auto end = begin + node->count;
+			if (upper)
+			{
+				return std::upper_bound(begin, end, key, Less()) - begin;
+			}
+			return std::lower_bound(begin, end, key, Less()) - begin;
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::bound(
+		const Key& key, bool upper) const
+	-> ConstIterator
+	{
+		ConstIterator result = cend();
+		const Node* node = root_;
+		while (true)
+		{
+			integer i = searchNode(node, key, upper);
+			if (i < node->count)
+			{
+				// The i:th element is a bound, although
+				// maybe not the first one.
+				result = ConstIterator(node, i);
+			}
+
+			if (node->leaf())
+			{
+				break;
+			}
+
+			node = node->child(i);
+		}
+
+		return result;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::find(
+		const Key& key) const
+	-> ConstIterator
+	{
+		if constexpr (Settings::MultipleKeys)
+		{
+			ConstIterator result = lowerBound(key);
+			if (result != cend() && less(key, result.key()))
+			{
+				return cend();
+			}
+			return result;
+		}
+		else
+		{
+			return findEqualAndUpper(key).equal;
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto BTree<Settings, Customization>::findEqualAndUpper(
+		const Key& key) const
+	-> FindEqual_Return
+	{
+		ConstIterator upper = cend();
+		const Node* node = root_;
+		while (true)
+		{
+			integer i = searchNode(node, key, false);
+			if (i < node->count)
+			{
+				if (!less(key, node->keySet[i]))
+				{
+					// The element is equivalent to the key.
+					ConstIterator equal(node, i);
+					if constexpr (Settings::MultipleKeys)
+					{
+						upper = upperBound(key);
+					}
+					else
+					{
+						upper = std::next(equal);
+					}
+					return {equal, upper};
+				}
+
+				upper = ConstIterator(node, i);
+			}
+
+			if (node->leaf())
+			{
+				break;
+			}
+
+			node = node->child(i);
+		}
+
+		return {cend(), upper};
+	}
+
+}
+
+#endif
@@ -46,8 +46,9 @@ namespace Pastel
 		}
 
 	private:
-		typedef RedBlackTree<Settings, Pastel::Hash_RedBlackTree_Customization>
-			Derived;
+		// The RedBlackTree, or the BTree, which uses this customization.
+		using Derived = typename Fwd::template Tree<
+			Pastel::Hash_RedBlackTree_Customization>;
 
 		Hash_RedBlackTree_Customization(const Hash_RedBlackTree_Customization&) = delete;
 		Hash_RedBlackTree_Customization(Hash_RedBlackTree_Customization&&) = delete;
@@ -9,6 +9,7 @@
 #include "pastel/sys/locator/indirect_locator.h"
 #include "pastel/sys/locator/pointer_locator.h"
 #include "pastel/sys/locator/pointerrange_locator.h"
+#include "pastel/sys/locator/strided_locator.h"
 #include "pastel/sys/locator/sub_locator.h"
 #include "pastel/sys/locator/transform_locator.h"
 
@@ -0,0 +1,75 @@
+// Description: Strided pointer locator
+// Documentation: locators.txt
+
+#ifndef PASTELSYS_STRIDED_LOCATOR_H
+#define PASTELSYS_STRIDED_LOCATOR_H
+
+#include "pastel/sys/locator/locator_concept.h"
+#include "pastel/sys/point/point_concept.h"
+#include "pastel/sys/ensure.h"
+
+namespace Pastel
+{
+
+	//! Locator for points whose coordinates are a stride apart.
+	/*!
+	The i:th coordinate of a point p is p[i * stride()].
+	This is the locator for points stored in a 
+	structure-of-arrays layout, where the coordinates
+	of all points are stored one axis at a time.
+	*/
+	template <typename Real_, int N_ = Dynamic>
+	class Strided_Locator
+	{
+	public:
+		static constexpr int N = N_;
+		using Real = Real_;
+		using Point = const Real*;
+
+		explicit Strided_Locator(
+			integer n = ((N > 0) ? N : 0),
+			integer stride = 1)
+			: n_(n)
+			, stride_(stride)
+		{
+			ENSURE(N == Dynamic || n == N);
+			ENSURE_OP(n, >=, 0);
+			ENSURE_OP(stride, >=, 0);
+		}
+
+		integer n() const
+		{
+			return n_;
+		}
+
+		integer n(const Point& point) const
+		{
+			return n();
+		}
+
+		integer stride() const
+		{
+			return stride_;
+		}
+
+		const Real& operator()(Point point, integer i) const
+		{
+			PENSURE_OP(i, >=, 0);
+			PENSURE_OP(i, <, n_);
+			return point[i * stride_];
+		}
+
+	private:
+		integer n_;
+		integer stride_;
+	};
+
+	template <typename Real_, int N_ = Dynamic>
+	decltype(auto) stridedLocator(integer n = N_, integer stride = 1)
+	{
+		return Strided_Locator<Real_, N_>(n, stride);
+	}
+
+}
+
+#endif
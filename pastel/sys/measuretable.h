@@ -0,0 +1,9 @@
+// Description: Measure table module
+// Documentation: measuretable.txt
+
+#ifndef PASTELSYS_MEASURETABLE_H_MODULE
+#define PASTELSYS_MEASURETABLE_H_MODULE
+
+#include "pastel/sys/measuretable/measuretable.h"
+
+#endif
@@ -1,5 +1,6 @@
 // Description: Measure table
 // Detail: Stores values and the visual design of a table.
+// Documentation: measuretable.txt
 
 #ifndef PASTELSYS_MEASURETABLE_H
 #define PASTELSYS_MEASURETABLE_H
@@ -82,9 +83,10 @@ namespace Pastel
 
 }
 
-#include "pastel/sys/measuretable.hpp"
+#include "pastel/sys/measuretable/measuretable.hpp"
 
-#include "pastel/sys/measuretable_print_latex.h"
-#include "pastel/sys/measuretable_print_pretty.h"
+#include "pastel/sys/measuretable/measuretable_print_latex.h"
+#include "pastel/sys/measuretable/measuretable_print_pretty.h"
+#include "pastel/sys/measuretable/measuretable_print_json.h"
 
 #endif
@@ -1,7 +1,7 @@
 #ifndef PASTELSYS_MEASURETABLE_HPP
 #define PASTELSYS_MEASURETABLE_HPP
 
-#include "pastel/sys/measuretable.h"
+#include "pastel/sys/measuretable/measuretable.h"
 
 namespace Pastel
 {
@@ -0,0 +1,41 @@
+// Description: Json printing for measure-table
+
+#ifndef PASTELSYS_MEASURETABLE_PRINT_JSON_H
+#define PASTELSYS_MEASURETABLE_PRINT_JSON_H
+
+#include "pastel/sys/measuretable/measuretable.h"
+
+#include <iostream>
+
+namespace Pastel
+{
+
+	//! Prints a measure-table as a Json object.
+	/*!
+	The first row of the table is taken to be the header;
+	it is printed as the "columns" array. The other rows
+	are printed as arrays in the "rows" array. An entry
+	is printed as a Json number if its text is a Json
+	number, and as a string otherwise. The separators and
+	the alignments are not printed.
+
+	The output is of the form
+
+		{
+			"caption": "Build",
+			"columns": ["n", "Time"],
+			"rows": [
+				[1000, 0.25],
+				[2000, 0.5]
+			]
+		}
+	*/
+	void printJson(
+		const MeasureTable& measureTable,
+		std::ostream& stream);
+
+}
+
+#include "pastel/sys/measuretable/measuretable_print_json.hpp"
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef PASTELSYS_MEASURETABLE_PRINT_JSON_HPP
+#define PASTELSYS_MEASURETABLE_PRINT_JSON_HPP
+
+#include "pastel/sys/measuretable/measuretable_print_json.h"
+
+#include <cctype>
+#include <cstdio>
+#include <string>
+
+namespace Pastel
+{
+
+	namespace MeasureTable_
+	{
+
+		//! Returns whether the text is a Json number.
+		/*!
+		A Json number is of the form
+		-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+		*/
+		inline bool isJsonNumber(const std::string& text)
+		{
+			auto isDigit = [&](integer i)
+			{
+				return i < (integer)text.size() &&
+					std::isdigit((unsigned char)text[i]);
+			};
+
+			auto skipDigits = [&](integer i)
+			{
+				while (isDigit(i))
+				{
+					++i;
+				}
+				return i;
+			};
+
+			integer n = text.size();
+			integer i = 0;
+			if (i < n && text[i] == '-')
+			{
+				++i;
+			}
+
+			if (!isDigit(i))
+			{
+				return false;
+			}
+			if (text[i] == '0')
+			{
+				++i;
+			}
+			else
+			{
+				i = skipDigits(i);
+			}
+
+			if (i < n && text[i] == '.')
+			{
+				++i;
+				if (!isDigit(i))
+				{
+					return false;
+				}
+				i = skipDigits(i);
+			}
+
+			if (i < n && (text[i] == 'e' || text[i] == 'E'))
+			{
+				++i;
+				if (i < n && (text[i] == '+' || text[i] == '-'))
+				{
+					++i;
+				}
+				if (!isDigit(i))
+				{
+					return false;
+				}
+				i = skipDigits(i);
+			}
+
+			return i == n;
+		}
+
+		inline void printJsonString(
+			const std::string& text,
+			std::ostream& stream)
+		{
+			stream << "\"";
+			for (char c : text)
+			{
+				switch(c)
+				{
+				case '"':
+					stream << "\\\"";
+					break;
+				case '\\':
+					stream << "\\\\";
+					break;
+				case '\n':
+					stream << "\\n";
+					break;
+				case '\r':
+					stream << "\\r";
+					break;
+				case '\t':
+					stream << "\\t";
+					break;
+				default:
+					if ((unsigned char)c < 0x20)
+					{
+						char code[8];
+						std::snprintf(code, sizeof(code), "\\u%04x", (int)c);
+						stream << code;
+					}
+					else
+					{
+						stream << c;
+					}
+					break;
+				};
+			}
+			stream << "\"";
+		}
+
+		inline void printJsonRow(
+			const MeasureTable& measureTable,
+			integer y,
+			bool header,
+			std::ostream& stream)
+		{
+			stream << "[";
+			for (integer x = 0;x < measureTable.width();++x)
+			{
+				const std::string& text = measureTable(x, y).text();
+				if (!header && isJsonNumber(text))
+				{
+					stream << text;
+				}
+				else
+				{
+					printJsonString(text, stream);
+				}
+
+				if (x < measureTable.width() - 1)
+				{
+					stream << ", ";
+				}
+			}
+			stream << "]";
+		}
+
+	}
+
+	inline void printJson(
+		const MeasureTable& measureTable,
+		std::ostream& stream)
+	{
+		using namespace MeasureTable_;
+
+		integer columns = measureTable.width();
+		integer rows = measureTable.height();
+
+		stream << "{" << std::endl;
+
+		stream << "\t\"caption\": ";
+		printJsonString(measureTable.caption(), stream);
+		stream << "," << std::endl;
+
+		stream << "\t\"columns\": ";
+		if (columns > 0 && rows > 0)
+		{
+			printJsonRow(measureTable, 0, true, stream);
+		}
+		else
+		{
+			stream << "[]";
+		}
+		stream << "," << std::endl;
+
+		stream << "\t\"rows\": [";
+		for (integer y = 1;y < rows;++y)
+		{
+			stream << std::endl << "\t\t";
+			printJsonRow(measureTable, y, false, stream);
+			if (y < rows - 1)
+			{
+				stream << ",";
+			}
+		}
+		if (rows > 1)
+		{
+			stream << std::endl << "\t";
+		}
+		stream << "]" << std::endl;
+
+		stream << "}" << std::endl;
+	}
+
+}
+
+#endif
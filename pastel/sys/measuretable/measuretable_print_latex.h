@@ -3,7 +3,7 @@
 #ifndef PASTELSYS_MEASURETABLE_PRINT_LATEX_H
 #define PASTELSYS_MEASURETABLE_PRINT_LATEX_H
 
-#include "pastel/sys/measuretable.h"
+#include "pastel/sys/measuretable/measuretable.h"
 
 #include <iostream>
 
@@ -16,6 +16,6 @@ namespace Pastel
 
 }
 
-#include "pastel/sys/measuretable_print_latex.hpp"
+#include "pastel/sys/measuretable/measuretable_print_latex.hpp"
 
 #endif
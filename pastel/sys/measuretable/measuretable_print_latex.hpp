@@ -1,7 +1,7 @@
 #ifndef PASTELSYS_MEASURETABLE_PRINT_LATEX_HPP
 #define PASTELSYS_MEASURETABLE_PRINT_LATEX_HPP
 
-#include "pastel/sys/measuretable_print_latex.h"
+#include "pastel/sys/measuretable/measuretable_print_latex.h"
 #include "pastel/sys/string.h"
 
 #include <vector>
@@ -3,7 +3,7 @@
 #ifndef PASTELSYS_MEASURETABLE_PRINT_PRETTY_H
 #define PASTELSYS_MEASURETABLE_PRINT_PRETTY_H
 
-#include "pastel/sys/measuretable.h"
+#include "pastel/sys/measuretable/measuretable.h"
 
 #include <iostream>
 
@@ -16,6 +16,6 @@ namespace Pastel
 
 }
 
-#include "pastel/sys/measuretable_print_pretty.hpp"
+#include "pastel/sys/measuretable/measuretable_print_pretty.hpp"
 
 #endif
@@ -8,17 +8,121 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <new>
 
 namespace Pastel
 {
 
+	//! The representation of a ranked set.
+	enum class RankedSet_Policy
+	{
+		//! A binary heap.
+		/*!
+		Insertion takes Theta(log(k)) time.
+		*/
+		Heap,
+		//! A sorted array.
+		/*!
+		Insertion takes O(k) time, but without branches
+		in the search; this is faster for a small k.
+		*/
+		Sorted,
+		//! Sorted for a small capacity, and heap otherwise.
+		/*!
+		The policies keep the same elements up to equivalence,
+		but not necessarily the same equivalent elements; see
+		RankedSet.
+		*/
+		Automatic
+	};
+
+	namespace RankedSet_
+	{
+
+		//! The maximum capacity for which Automatic is Sorted.
+		static constexpr integer SortedCapacity = 16;
+
+		//! Returns the insertion position in a sorted array.
+		/*!
+		returns:
+		The number of elements not greater than that,
+		so that the element is placed after its
+		equivalent elements.
+		*/
+		template <typename Type, typename Less>
+		integer sortedPosition(
+			const Type* dataSet, integer size,
+			const Type& that, const Less& less)
+		{
+			// Count the elements <= that. The sum has no
+			// branches, so that it vectorizes for arithmetic
+			// types, and does not mispredict for others.
+			integer position = 0;
+			for (integer i = 0;i < size;++i)
+			{
+				position += !less(that, dataSet[i]);
+			}
+			return position;
+		}
+
+		//! Inserts an element into a sorted array.
+		/*!
+		Preconditions:
+		size < capacity, or less(that, dataSet[size - 1])
+		If size < capacity, then dataSet[size] is constructed.
+
+		The element is placed after its equivalent elements.
+		If the array is full, the maximum element is dropped.
+
+		returns:
+		The position of the element.
+		*/
+		template <typename Type, typename Less>
+		integer sortedPush(
+			Type* dataSet, integer size, integer capacity,
+			const Type& that, const Less& less)
+		{
+			integer position = sortedPosition(
+				dataSet, size, that, less);
+
+			integer last = std::min(size, capacity - 1);
+			std::move_backward(
+				dataSet + position, dataSet + last,
+				dataSet + last + 1);
+			dataSet[position] = that;
+
+			return position;
+		}
+
+	}
+
 	//! A ranked set
 	/*!
 	Maintains the k smallest elements stored in the set;
-	a bounded priority queue. The k is called the capacity 
+	a bounded priority queue. The k is called the capacity
 	of the set.
+
+	Capacity:
+	The capacity as a compile-time constant, or Dynamic.
+	A fixed capacity stores the elements in a sorted array
+	inside the set, without allocating memory.
+
+	An element is not inserted into a full set, if it is
+	equivalent to the maximum element. Otherwise the
+	representations break ties between equivalent elements
+	differently. A sorted array places an element after its
+	equivalent elements, and drops the last maximum element.
+	A heap drops whichever maximum element is at its top.
+	Therefore, when the k-th smallest element has equivalent
+	elements, the Sorted and Heap policies may keep different
+	ones of them; the Automatic policy changes between them at
+	the capacity RankedSet_::SortedCapacity.
 	*/
-	template <typename Type, typename Less = LessThan>
+	template <
+		typename Type,
+		typename Less = LessThan,
+		int Capacity = Dynamic>
 	class RankedSet
 	{
 	public:
@@ -29,11 +133,22 @@ namespace Pastel
 		using const_iterator = ConstIterator;
 
 		//! Constructs a set.
+		/*!
+		Preconditions:
+		capacity >= 0
+
+		policy:
+		The representation of the set. The Automatic policy
+		is re-applied whenever the capacity is set.
+		*/
 		RankedSet(
 			integer capacity = 0,
-			Less less = Less())
+			Less less = Less(),
+			RankedSet_Policy policy = RankedSet_Policy::Automatic)
 			: dataSet_()
 			, capacity_(0)
+			, policy_(policy)
+			, sorted_(false)
 			, less_(std::move(less))
 		{
 			ENSURE_OP(capacity, >= , 0);
@@ -41,6 +156,11 @@ namespace Pastel
 		}
 
 		//! Inserts an element into the set.
+		/*!
+		returns:
+		An iterator to the inserted element, or
+		end(), if the element was not inserted.
+		*/
 		Iterator push(const Type& that)
 		{
 			if (capacity() == 0)
@@ -55,12 +175,40 @@ namespace Pastel
 					return end();
 				}
 
-				pop();
+				if (!sorted_)
+				{
+					pop();
+				}
+			}
+
+			if (sorted_)
+			{
+				integer n = size();
+				if (n < capacity())
+				{
+					// Make room for the element.
+					dataSet_.push_back(that);
+				}
+				return begin() + RankedSet_::sortedPush(
+					dataSet_.data(), n, capacity(), that, less_);
 			}
-			
+
+			// Sift the element up the heap, as in
+			// std::push_heap, but track its position.
 			dataSet_.push_back(that);
-			std::push_heap(begin(), end(), less_);
-			return std::prev(end());
+			integer i = size() - 1;
+			while (i > 0)
+			{
+				integer parent = (i - 1) / 2;
+				if (!less_(dataSet_[parent], that))
+				{
+					break;
+				}
+				dataSet_[i] = std::move(dataSet_[parent]);
+				i = parent;
+			}
+			dataSet_[i] = that;
+			return begin() + i;
 		}
 
 		//! Releases the underlying data-set.
@@ -68,10 +216,13 @@ namespace Pastel
 		Post-conditions:
 		capacity() == 0
 		size() == 0
+		policy() is kept
 
 		sorted (bool):
-		Whether to sort the data-set in 
-		increasing order using heap-sort.
+		Whether to sort the data-set in
+		increasing order. Otherwise the data-set
+		is a binary heap, as in std::make_heap(),
+		for either representation.
 
 		returns:
 		The underlying data-set moved out
@@ -79,15 +230,20 @@ namespace Pastel
 		*/
 		DataSet release(bool sorted = true)
 		{
-			if (sorted)
+			if (sorted && !sorted_)
 			{
 				for (auto i = end(); i != begin();--i)
 				{
 					std::pop_heap(begin(), i, less_);
 				}
 			}
+			if (!sorted && sorted_)
+			{
+				std::make_heap(begin(), end(), less_);
+			}
 
-			RankedSet self(0);
+			// Keep the policy and the comparison.
+			RankedSet self(0, less_, policy_);
 			swap(self);
 
 			return std::move(self.dataSet_);
@@ -97,7 +253,10 @@ namespace Pastel
 		void pop()
 		{
 			ENSURE(!empty());
-			std::pop_heap(begin(), end(), less_);
+			if (!sorted_)
+			{
+				std::pop_heap(begin(), end(), less_);
+			}
 			dataSet_.pop_back();
 		}
 
@@ -105,9 +264,9 @@ namespace Pastel
 		void clear()
 		{
 			dataSet_.clear();
-			// The implementation of std::vector 
-			// may or may not change the capacity 
-			// of the vector. Restore capacity to 
+			// The implementation of std::vector
+			// may or may not change the capacity
+			// of the vector. Restore capacity to
 			// be sure.
 			dataSet_.reserve(capacity_);
 		}
@@ -138,20 +297,22 @@ namespace Pastel
 			dataSet_.swap(that.dataSet_);
 			swap(less_, that.less_);
 			swap(capacity_, that.capacity_);
+			swap(policy_, that.policy_);
+			swap(sorted_, that.sorted_);
 		}
 
 		//! Returns the maximum element.
 		Type& top()
 		{
 			ENSURE(!empty());
-			return dataSet_.front();
+			return sorted_ ? dataSet_.back() : dataSet_.front();
 		}
 
 		//! Returns the maximum element.
 		const Type& top() const
 		{
 			ENSURE(!empty());
-			return dataSet_.front();
+			return sorted_ ? dataSet_.back() : dataSet_.front();
 		}
 
 		//! Returns the size of the set.
@@ -176,6 +337,23 @@ namespace Pastel
 
 			dataSet_.reserve(capacity);
 			capacity_ = capacity;
+
+			bool sorted =
+				policy_ == RankedSet_Policy::Sorted ||
+				(policy_ == RankedSet_Policy::Automatic &&
+				capacity <= RankedSet_::SortedCapacity);
+			if (sorted != sorted_)
+			{
+				if (sorted)
+				{
+					std::sort(begin(), end(), less_);
+				}
+				else
+				{
+					std::make_heap(begin(), end(), less_);
+				}
+				sorted_ = sorted;
+			}
 		}
 
 		//! Returns the capacity of the set.
@@ -184,12 +362,307 @@ namespace Pastel
 			return capacity_;
 		}
 
+		//! Returns the policy of the set.
+		RankedSet_Policy policy() const
+		{
+			return policy_;
+		}
+
+		//! Returns whether the elements are in a sorted array.
+		/*!
+		Otherwise the elements are in a binary heap.
+		*/
+		bool sorted() const
+		{
+			return sorted_;
+		}
+
 	private:
 		DataSet dataSet_;
 		// Note that std::vector's capacity
 		// may be greater than the capacity
 		// stored here.
 		integer capacity_;
+		RankedSet_Policy policy_;
+		bool sorted_;
+		[[no_unique_address]]
+		Less less_;
+	};
+
+	//! A ranked set of a fixed capacity
+	/*!
+	The elements are stored in increasing order in an
+	array inside the set. Insertion takes O(k) time,
+	but without branches in the search, which is faster
+	than a heap for a small k.
+
+	The array is not initialized; only the elements in
+	the set are constructed, so that Type need not be
+	default-constructible.
+	*/
+	template <
+		typename Type,
+		typename Less,
+		int Capacity>
+	requires (Capacity >= 0)
+	class RankedSet<Type, Less, Capacity>
+	{
+	public:
+		using DataSet = std::vector<Type>;
+		using Iterator = Type*;
+		using ConstIterator = const Type*;
+		using iterator = Iterator;
+		using const_iterator = ConstIterator;
+
+		//! Constructs a set.
+		/*!
+		Preconditions:
+		capacity == Capacity
+		*/
+		RankedSet(
+			integer capacity = Capacity,
+			Less less = Less())
+			: size_(0)
+			, less_(std::move(less))
+		{
+			ENSURE_OP(capacity, ==, Capacity);
+		}
+
+		//! Copy-constructs from another set.
+		/*!
+		Time complexity: O(that.size())
+		Exception safety: strong
+		*/
+		RankedSet(const RankedSet& that)
+			: size_(0)
+			, less_(that.less_)
+		{
+			std::uninitialized_copy(that.begin(), that.end(), data());
+			size_ = that.size_;
+		}
+
+		//! Move-constructs from another set.
+		/*!
+		Time complexity: O(that.size())
+		Exception safety: basic
+
+		The other set is left empty.
+		*/
+		RankedSet(RankedSet&& that)
+			: size_(0)
+			, less_(that.less_)
+		{
+			std::uninitialized_move(that.begin(), that.end(), data());
+			size_ = that.size_;
+			that.clear();
+		}
+
+		//! Destructs the set.
+		~RankedSet()
+		{
+			clear();
+		}
+
+		//! Assigns from another set.
+		/*!
+		Time complexity: 
+		Move/copy-construction
+
+		Exception safety: 
+		Move/copy-construction
+		*/
+		RankedSet& operator=(RankedSet that)
+		{
+			swap(that);
+			return *this;
+		}
+
+		//! Inserts an element into the set.
+		/*!
+		returns:
+		An iterator to the inserted element, or
+		end(), if the element was not inserted.
+		*/
+		Iterator push(const Type& that)
+		{
+			if (Capacity == 0 ||
+				(size_ == Capacity && !less_(that, top())))
+			{
+				return end();
+			}
+
+			Type* dataSet = data();
+			integer position = RankedSet_::sortedPosition(
+				dataSet, size_, that, less_);
+
+			if (size_ == Capacity)
+			{
+				// Drop the maximum element.
+				std::move_backward(
+					dataSet + position, dataSet + size_ - 1,
+					dataSet + size_);
+				dataSet[position] = that;
+				return dataSet + position;
+			}
+
+			if (position == size_)
+			{
+				std::construct_at(dataSet + size_, that);
+			}
+			else
+			{
+				// Construct the new end element, and
+				// then shift the rest by assignment.
+				std::construct_at(dataSet + size_,
+					std::move(dataSet[size_ - 1]));
+				std::move_backward(
+					dataSet + position, dataSet + size_ - 1,
+					dataSet + size_);
+				dataSet[position] = that;
+			}
+			++size_;
+
+			return dataSet + position;
+		}
+
+		//! Releases the elements.
+		/*!
+		Post-conditions:
+		size() == 0
+
+		sorted (bool):
+		Whether to return the elements in increasing
+		order. Otherwise the elements are a binary heap,
+		as in std::make_heap(), as for a dynamic capacity.
+
+		returns:
+		The elements.
+		*/
+		DataSet release(bool sorted = true)
+		{
+			DataSet result(
+				std::make_move_iterator(begin()),
+				std::make_move_iterator(end()));
+			clear();
+			if (!sorted)
+			{
+				std::make_heap(result.begin(), result.end(), less_);
+			}
+			return result;
+		}
+
+		//! Removes the maximum element.
+		void pop()
+		{
+			ENSURE(!empty());
+			--size_;
+			std::destroy_at(data() + size_);
+		}
+
+		//! Removes all elements.
+		void clear()
+		{
+			std::destroy(begin(), end());
+			size_ = 0;
+		}
+
+		//! Returns an iterator to the first element.
+		PASTEL_ITERATOR_FUNCTIONS(begin, data());
+
+		//! Returns an iterator to the one-past-end element.
+		PASTEL_ITERATOR_FUNCTIONS(end, data() + size_);
+
+		//! Returns whether the set is full.
+		bool full() const
+		{
+			return size_ == Capacity;
+		}
+
+		//! Returns whether the set is empty.
+		bool empty() const
+		{
+			return size_ == 0;
+		}
+
+		//! Swaps two sets.
+		/*!
+		Time complexity: O(Capacity)
+		Exception safety: basic
+		*/
+		void swap(RankedSet& that)
+		{
+			using std::swap;
+
+			RankedSet& larger = size_ < that.size_ ? that : *this;
+			RankedSet& smaller = size_ < that.size_ ? *this : that;
+
+			// Swap the common elements, and move
+			// the rest to the smaller set.
+			std::swap_ranges(smaller.begin(), smaller.end(), larger.begin());
+			Type* rest = larger.begin() + smaller.size_;
+			std::uninitialized_move(rest, larger.end(), smaller.end());
+			std::destroy(rest, larger.end());
+
+			swap(size_, that.size_);
+			swap(less_, that.less_);
+		}
+
+		//! Returns the maximum element.
+		Type& top()
+		{
+			ENSURE(!empty());
+			return data()[size_ - 1];
+		}
+
+		//! Returns the maximum element.
+		const Type& top() const
+		{
+			ENSURE(!empty());
+			return data()[size_ - 1];
+		}
+
+		//! Returns the size of the set.
+		integer size() const
+		{
+			return size_;
+		}
+
+		//! Returns the capacity of the set.
+		integer capacity() const
+		{
+			return Capacity;
+		}
+
+		//! Returns the policy of the set.
+		RankedSet_Policy policy() const
+		{
+			return RankedSet_Policy::Sorted;
+		}
+
+		//! Returns whether the elements are in a sorted array.
+		bool sorted() const
+		{
+			return true;
+		}
+
+	private:
+		Type* data()
+		{
+			return std::launder((Type*)storage_);
+		}
+
+		const Type* data() const
+		{
+			return std::launder((const Type*)storage_);
+		}
+
+		//! The storage of the elements.
+		/*!
+		The elements in [0, size_) are constructed.
+		*/
+		alignas(Type) unsigned char
+			storage_[std::max(Capacity, 1) * sizeof(Type)];
+		integer size_;
 		[[no_unique_address]]
 		Less less_;
 	};
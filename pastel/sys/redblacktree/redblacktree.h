@@ -9,6 +9,8 @@
 #include "pastel/sys/redblacktree/redblacktree_iterator.h"
 #include "pastel/sys/downfilter/all_downfilter.h"
 
+#include <vector>
+
 namespace Pastel
 {
 
@@ -203,6 +205,50 @@ namespace Pastel
 			return constructAndSwap(construct);
 		}
 
+		//! Assigns a sorted range of keys.
+		/*!
+		Preconditions:
+		The keys are in non-decreasing order.
+
+		Time complexity: O(size() + n) * updatePropagation() + n * onInsert()
+		where
+		n is the number of keys.
+
+		Exception safety: strong + onInsert()
+
+		Preserves sentinels.
+		The user-data will be default-initialized.
+
+		The tree is built perfectly balanced in one pass
+		over the keys, without comparisons or rebalancing,
+		and the propagation data is computed bottom-up, once
+		for each node. If multiple keys are not allowed, then
+		only the first of equivalent keys is stored. Throws an
+		InvariantFailure if the keys are not sorted.
+		*/
+		template <ranges::forward_range Key_Range>
+		RedBlackTree& assignSorted(const Key_Range& keySet)
+		{
+			return assignSorted(keySet,
+				ranges::views::repeat_n(Data(), ranges::distance(keySet)));
+		}
+
+		//! Assigns a sorted range of keys with user-data.
+		/*!
+		Preconditions:
+		The keys are in non-decreasing order.
+		dataSet has at least as many elements as keySet.
+
+		This is as assignSorted(keySet), except that the
+		i:th element is given the i:th user-data.
+		*/
+		template <
+			ranges::forward_range Key_Range,
+			ranges::input_range Data_Range>
+		RedBlackTree& assignSorted(
+			const Key_Range& keySet,
+			const Data_Range& dataSet);
+
 		//! Destructs the tree.
 		/*!
 		Time complexity: O(size())
@@ -336,12 +382,18 @@ namespace Pastel
 
 		//! Removes elements in a range.
 		/*!
-		Time complexity: O(k log(size()))
+		Time complexity: O(k + log(size()))
 		where
 		k is the number of removed elements.
 
 		Exception safety: nothrow
 
+		A short range is removed element by element. A
+		longer range is split off from the tree, destroyed,
+		and the rest of the tree is joined back together;
+		if the split runs out of memory, the range is removed
+		element by element.
+
 		returns:
 		cast(range.end())
 		*/
@@ -656,6 +708,102 @@ namespace Pastel
 			return split(lowerBound(key, filter));
 		}
 
+		//! Adds the elements of another tree to this tree.
+		/*!
+		Preconditions:
+		sharesBottom(that)
+		!Settings::MultipleKeys
+
+		Optional arguments
+		------------------
+
+		parallel (bool):
+		Whether to compute the subproblems in parallel.
+		The result does not depend on the number of threads.
+		Default: true
+
+		Time complexity:
+		O(m log(n)) * updatePropagation(), if m log(n) < 4(n + m),
+		O(n + m) * updatePropagation(), otherwise,
+		where
+		n = size(),
+		m = that.size().
+
+		Exception safety: basic
+
+		The tree becomes the union of the trees, and 'that'
+		becomes empty. If both trees contain an equivalent
+		element, then the element of this tree is kept, and
+		the element of 'that' is destroyed. The nodes are
+		moved, not copied, so iterators to the kept elements
+		remain valid. As with join() and split(), the
+		customization is not notified of the moved elements.
+		Before the operation, the customization of the tree
+		which contains an element to be destroyed is notified
+		by onErase(); this takes O(n + m) or O(m log(n)) time,
+		as above, unless the customization is the empty one.
+
+		If 'that' is small, its elements are inserted one by
+		one. Otherwise the elements of the trees are merged
+		in order, and linked into a perfectly balanced tree.
+		In parallel, a large problem is first divided by
+		splitting this tree by the key at the root of 'that';
+		the union of the smaller keys, and the union of the
+		greater keys, are then computed in parallel, and
+		joined together.
+
+		The sentinel nodes are preserved.
+		*/
+		template <typename... ArgumentSet>
+		RedBlackTree& unite(
+			RedBlackTree& that,
+			ArgumentSet&&... argumentSet);
+
+		//! Removes the elements not in another tree.
+		/*!
+		Preconditions:
+		sharesBottom(that)
+		!Settings::MultipleKeys
+
+		Time complexity:
+		O(n + m) * updatePropagation(),
+		where
+		n = size(),
+		m = that.size().
+
+		Optional arguments and exception safety
+		are as in unite().
+
+		The tree becomes the intersection of the trees,
+		and 'that' becomes empty. The elements of this tree
+		are kept, and the other elements are destroyed. The
+		destroyed elements are notified as in unite().
+		*/
+		template <typename... ArgumentSet>
+		RedBlackTree& intersect(
+			RedBlackTree& that,
+			ArgumentSet&&... argumentSet);
+
+		//! Removes the elements in another tree.
+		/*!
+		Preconditions:
+		sharesBottom(that)
+		!Settings::MultipleKeys
+
+		Optional arguments, time complexity, and
+		exception safety are as in unite().
+
+		The tree becomes the difference of the trees,
+		and 'that' becomes empty. The remaining elements of
+		this tree are kept, and the other elements are
+		destroyed. The destroyed elements are notified as
+		in unite().
+		*/
+		template <typename... ArgumentSet>
+		RedBlackTree& subtract(
+			RedBlackTree& that,
+			ArgumentSet&&... argumentSet);
+
 		//! Returns the number of equivalent elements.
 		/*!
 		Time complexity: O(log(size()))
@@ -1231,6 +1379,135 @@ namespace Pastel
 			return *this;
 		}
 
+		//! Links sorted nodes into a perfectly balanced tree.
+		/*!
+		Preconditions:
+		empty()
+		The nodes are detached, and in increasing order.
+
+		Time complexity: O(nodeSet.size()) * updatePropagation()
+		Exception safety: nothrow
+		*/
+		void linkSorted(const std::vector<Node*>& nodeSet);
+
+		//! Links sorted nodes into a perfectly balanced subtree.
+		/*!
+		Preconditions:
+		0 <= begin < end <= nodeSet.size()
+
+		Time complexity: O(end - begin) * updatePropagation()
+		Exception safety: nothrow
+
+		The nodes at depth 'redDepth' are colored red, and
+		the other nodes black. The missing left child of the
+		minimum, and the missing right child of the maximum,
+		are the end node. The propagation data is updated
+		bottom-up.
+
+		returns:
+		The root of the subtree.
+		*/
+		Node* linkSorted(
+			const std::vector<Node*>& nodeSet,
+			integer begin, integer end,
+			Node* parent,
+			integer depth, integer redDepth);
+
+		//! Splits the tree at the root.
+		/*!
+		Preconditions:
+		!empty()
+		middle.empty()
+		right.empty()
+		sharesBottom(middle)
+		sharesBottom(right)
+
+		Time complexity: O(log(size())) * updatePropagation()
+		Exception safety: nothrow
+
+		The root element is moved to 'middle', the elements
+		of the right subtree to 'right', and the elements of
+		the left subtree are left in this tree. The subtrees
+		are not rebalanced, only their roots turned black.
+		*/
+		void expose(RedBlackTree& middle, RedBlackTree& right);
+
+		//! The kinds of set operations.
+		enum class SetOperation
+		{
+			Union,
+			Intersection,
+			Difference
+		};
+
+		//! Computes a set operation between two trees.
+		/*!
+		See unite(), intersect(), and subtract().
+		*/
+		void setOperation(
+			RedBlackTree& that,
+			SetOperation operation,
+			bool parallel);
+
+		//! Notifies the erase of the elements a set operation destroys.
+		/*!
+		Time complexity:
+		O(that.size() log(size())), for a small 'that', or
+		O(size() + that.size()), otherwise.
+
+		Exception safety: nothrow
+
+		Calls onErase() of the tree containing the element.
+		*/
+		void notifySetOperation(
+			RedBlackTree& that,
+			SetOperation operation);
+
+		//! Computes a set operation between two subtrees.
+		/*!
+		Preconditions:
+		hasSeparateSentinels()
+		that.hasSeparateSentinels()
+		*/
+		void setOperationRecursive(
+			RedBlackTree& that,
+			SetOperation operation,
+			bool parallel);
+
+		//! Computes a set operation by merging the elements.
+		/*!
+		Time complexity: O(size() + that.size())
+		Exception safety: strong
+		*/
+		void setOperationByMerging(
+			RedBlackTree& that,
+			SetOperation operation);
+
+		//! Computes a set operation element by element.
+		/*!
+		Preconditions:
+		operation != SetOperation::Intersection
+
+		Time complexity: O(that.size() log(size()))
+		Exception safety: strong
+		*/
+		void setOperationByElements(
+			RedBlackTree& that,
+			SetOperation operation);
+
+		//! Destroys the elements of the tree.
+		/*!
+		Time complexity: O(size())
+		Exception safety: nothrow
+
+		Unlike clear(), does not notify the customization.
+		*/
+		void destroy()
+		{
+			clear(rootNode());
+			forget();
+		}
+
 		//! Returns the result of comparing keys.
 		/*!
 		Time complexity: O(1)
@@ -1471,6 +1748,7 @@ namespace Pastel
 }
 
 #include "pastel/sys/redblacktree/redblacktree.hpp"
+#include "pastel/sys/redblacktree/redblacktree_assign_sorted.hpp"
 #include "pastel/sys/redblacktree/redblacktree_copy.hpp"
 #include "pastel/sys/redblacktree/redblacktree_count.hpp"
 #include "pastel/sys/redblacktree/redblacktree_erase.hpp"
@@ -1482,6 +1760,7 @@ namespace Pastel
 #include "pastel/sys/redblacktree/redblacktree_rebalance_red_violation.hpp"
 #include "pastel/sys/redblacktree/redblacktree_search.hpp"
 #include "pastel/sys/redblacktree/redblacktree_sentinels.hpp"
+#include "pastel/sys/redblacktree/redblacktree_set_operation.hpp"
 #include "pastel/sys/redblacktree/redblacktree_splice.hpp"
 #include "pastel/sys/redblacktree/redblacktree_split.hpp"
 #include "pastel/sys/redblacktree/redblacktree_swap.hpp"
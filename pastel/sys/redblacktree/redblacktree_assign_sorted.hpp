@@ -0,0 +1,133 @@
+#ifndef PASTELSYS_REDBLACKTREE_ASSIGN_SORTED_HPP
+#define PASTELSYS_REDBLACKTREE_ASSIGN_SORTED_HPP
+
+#include "pastel/sys/redblacktree.h"
+#include "pastel/sys/math/logarithm.h"
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	template <
+		ranges::forward_range Key_Range,
+		ranges::input_range Data_Range>
+	auto RedBlackTree<Settings, Customization>::assignSorted(
+		const Key_Range& keySet,
+		const Data_Range& dataSet)
+	-> RedBlackTree&
+	{
+		auto construct = [&](RedBlackTree& copy)
+		{
+			std::vector<Node*> nodeSet;
+			nodeSet.reserve(ranges::distance(keySet));
+
+			try
+			{
+				auto dataIter = ranges::begin(dataSet);
+				for (auto&& key : keySet)
+				{
+					ENSURE(dataIter != ranges::end(dataSet));
+
+					if (!nodeSet.empty())
+					{
+						const Key& previous =
+							((Key_Node*)nodeSet.back())->key();
+
+						// The keys must be sorted.
+						ENSURE(!less(key, previous));
+
+						if (!Settings::MultipleKeys &&
+							!less(previous, key))
+						{
+							// Keep the first of equivalent keys.
+							++dataIter;
+							continue;
+						}
+					}
+
+					nodeSet.push_back(allocateNode(key, *dataIter));
+					++dataIter;
+				}
+			}
+			catch(...)
+			{
+				for (Node* node : nodeSet)
+				{
+					deallocateNode((Key_Node*)node);
+				}
+				throw;
+			}
+
+			// From now on nothing throws, except for onInsert().
+
+			copy.linkSorted(nodeSet);
+
+			for (Node* node : nodeSet)
+			{
+				copy.onInsert(Iterator(node));
+			}
+		};
+
+		return constructAndSwap(construct);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::linkSorted(
+		const std::vector<Node*>& nodeSet)
+	{
+		ASSERT(empty());
+
+		integer n = nodeSet.size();
+		if (n == 0)
+		{
+			return;
+		}
+
+		// The midpoint subdivision places every missing child
+		// at depth 'height + 1', or at depth 'height'. If the
+		// latter happens, then the nodes at depth 'height' are
+		// colored red, so that the black-heights agree.
+		integer height = floorLog2<integer>(n);
+		bool complete = ((n + 1) & n) == 0;
+		integer redDepth = complete ? -1 : height;
+
+		rootNode() = linkSorted(
+			nodeSet, 0, n, endNode(), 0, redDepth);
+		minNode() = nodeSet.front();
+		maxNode() = nodeSet.back();
+		blackHeight_ = complete ? height + 1 : height;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	auto RedBlackTree<Settings, Customization>::linkSorted(
+		const std::vector<Node*>& nodeSet,
+		integer begin, integer end,
+		Node* parent,
+		integer depth, integer redDepth)
+	-> Node*
+	{
+		ASSERT_OP(begin, <, end);
+
+		integer middle = begin + (end - begin) / 2;
+		Node* node = nodeSet[middle];
+		node->parent() = parent;
+		node->setRed(depth == redDepth);
+
+		node->left() = (begin < middle) ?
+			linkSorted(nodeSet, begin, middle, node, depth + 1, redDepth) :
+			(middle == 0 ? endNode() : bottomNode());
+
+		node->right() = (middle + 1 < end) ?
+			linkSorted(nodeSet, middle + 1, end, node, depth + 1, redDepth) :
+			(middle + 1 == nodeSet.size() ? endNode() : bottomNode());
+
+		// The children are up-to-date, since
+		// the subtrees are linked in post-order.
+		update(node);
+
+		return node;
+	}
+
+}
+
+#endif
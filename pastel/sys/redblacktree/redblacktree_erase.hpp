@@ -34,12 +34,79 @@ namespace Pastel
 		const ConstRange& range)
 	-> Iterator
 	{
-		ConstIterator iter = range.begin();
-		while(iter != range.end())
+		ConstIterator begin = range.begin();
+		ConstIterator end = range.end();
+
+		// Removing an element costs O(log(n)), while splitting
+		// and joining the tree costs a few O(log(n)), with some
+		// memory allocations. Remove short ranges element by
+		// element.
+		integer bulkSize = 2 * blackHeight() + 8;
+		integer k = 0;
+		for (ConstIterator iter = begin; iter != end && k < bulkSize; ++iter)
 		{
-			iter = erase(iter);
+			++k;
 		}
-		return cast(iter);
+
+		if (k < bulkSize)
+		{
+			ConstIterator iter = begin;
+			while(iter != end)
+			{
+				iter = erase(iter);
+			}
+			return cast(iter);
+		}
+
+		// Notify the customization of the tree.
+		for (ConstIterator iter = begin; iter != end; ++iter)
+		{
+			this->onErase(cast(iter));
+		}
+
+		try
+		{
+			RedBlackTree right;
+			right.useBottomFrom(*this);
+
+			// This tree is left with the elements before
+			// the range.
+			RedBlackTree middle = split(begin);
+			if (end != cend())
+			{
+				try
+				{
+					right = middle.split(end);
+				}
+				catch(...)
+				{
+					// Roll back the first split.
+					join(middle);
+					throw;
+				}
+			}
+
+			// From now on nothing throws.
+
+			middle.destroy();
+			join(right);
+		}
+		catch(...)
+		{
+			// The splits are strongly exception-safe, so
+			// the tree is intact; remove the elements one
+			// by one, without notifying the customization
+			// again.
+			ConstIterator iter = begin;
+			while(iter != end)
+			{
+				Node* node = (Node*)iter.base();
+				iter = ConstIterator(detach(node));
+				deallocateNode((Key_Node*)node);
+			}
+		}
+
+		return cast(end);
 	}
 
 	template <typename Settings, template <typename> class Customization>
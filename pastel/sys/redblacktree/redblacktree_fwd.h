@@ -57,6 +57,10 @@ namespace Pastel
 		static constexpr bool UserDataInSentinelNodes_ =
 			UserDataInSentinelNodes;
 
+		//! The tree with the given customization.
+		template <template <typename> class Customization>
+		using Tree = RedBlackTree<Settings, Customization>;
+
 		using Key_ = Key;
 		using Data_ = Data;
 		using Propagation_ = Propagation;
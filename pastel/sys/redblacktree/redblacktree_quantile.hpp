@@ -6,68 +6,84 @@
 namespace Pastel
 {
 
-	template <typename Settings, template <typename> class Customization>
-	typename RedBlackTree<Settings, Customization>::ConstIterator
-	quantile(
-		const RedBlackTree<Settings, Customization>& tree,
-		dreal alpha)
+	namespace RedBlackTree_
 	{
-		/*
-		Let n = tree.size(), and
 
-		f : ZZ --> RR: f(i) = (i + 0.5) / n.
+		//! Returns a quantile of the elements of a binary search tree.
+		/*!
+		The tree must provide the sizes of the subtrees.
+		*/
+		template <typename Tree>
+		typename Tree::ConstIterator quantile(
+			const Tree& tree,
+			dreal alpha)
+		{
+			/*
+			Let n = tree.size(), and
 
-		Then
+			f : ZZ --> RR: f(i) = (i + 0.5) / n.
 
-		f(i) = alpha
-		<=>
-		f(i) n = alpha n
-		<=>
-		i + 0.5 = alpha n
-		<=>
-		i = alpha n - 0.5
+			Then
 
-		Since i is an integer, this equation may not have
-		a solution. Therefore, we use the closest integer
-		instead:
+			f(i) = alpha
+			<=>
+			f(i) n = alpha n
+			<=>
+			i + 0.5 = alpha n
+			<=>
+			i = alpha n - 0.5
 
-		i = round(alpha n - 0.5) = floor(alpha n)
-		*/
+			Since i is an integer, this equation may not have
+			a solution. Therefore, we use the closest integer
+			instead:
 
-		integer searchIndex = std::floor(alpha * tree.size());
-		if (searchIndex <= 0)
-		{
-			return tree.cbegin();
-		}
-		if (searchIndex >= tree.size() - 1)
-		{
-			return tree.clast();
-		}
+			i = round(alpha n - 0.5) = floor(alpha n)
+			*/
 
-		using ConstIterator = 
-			typename RedBlackTree<Settings, Customization>::ConstIterator;
+			integer searchIndex = std::floor(alpha * tree.size());
+			if (searchIndex <= 0)
+			{
+				return tree.cbegin();
+			}
+			if (searchIndex >= tree.size() - 1)
+			{
+				return tree.clast();
+			}
 
-		ConstIterator node = tree.croot();
+			using ConstIterator = typename Tree::ConstIterator;
 
-		integer i = node.left().size();
-		while (i != searchIndex)
-		{
-			ASSERT(!node.isSentinel());
-		
-			bool right = i < searchIndex;
-			node = node.child(right);
+			ConstIterator node = tree.croot();
 
-			if (right)
-			{
-				i += node.left().size() + 1;
-			}
-			else
+			integer i = node.left().size();
+			while (i != searchIndex)
 			{
-				i -= node.right().size() + 1;
+				ASSERT(!node.isSentinel());
+		
+				bool right = i < searchIndex;
+				node = node.child(right);
+
+				if (right)
+				{
+					i += node.left().size() + 1;
+				}
+				else
+				{
+					i -= node.right().size() + 1;
+				}
 			}
+
+			return node;
 		}
 
-		return node;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	typename RedBlackTree<Settings, Customization>::ConstIterator
+	quantile(
+		const RedBlackTree<Settings, Customization>& tree,
+		dreal alpha)
+	{
+		return RedBlackTree_::quantile(tree, alpha);
 	}
 
 }
@@ -0,0 +1,492 @@
+#ifndef PASTELSYS_REDBLACKTREE_SET_OPERATION_HPP
+#define PASTELSYS_REDBLACKTREE_SET_OPERATION_HPP
+
+#include "pastel/sys/redblacktree.h"
+#include "pastel/sys/named_parameter.h"
+#include "pastel/sys/math/logarithm.h"
+
+#include <tbb/parallel_invoke.h>
+
+#include <type_traits>
+
+namespace Pastel
+{
+
+	template <typename Settings, template <typename> class Customization>
+	template <typename... ArgumentSet>
+	auto RedBlackTree<Settings, Customization>::unite(
+		RedBlackTree& that,
+		ArgumentSet&&... argumentSet)
+	-> RedBlackTree&
+	{
+		static_assert(!Settings::MultipleKeys,
+			"Set operations are not defined for multi-sets.");
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+
+		ENSURE(sharesBottom(that));
+		if (this != &that)
+		{
+			setOperation(that, SetOperation::Union, parallel);
+		}
+
+		return *this;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	template <typename... ArgumentSet>
+	auto RedBlackTree<Settings, Customization>::intersect(
+		RedBlackTree& that,
+		ArgumentSet&&... argumentSet)
+	-> RedBlackTree&
+	{
+		static_assert(!Settings::MultipleKeys,
+			"Set operations are not defined for multi-sets.");
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+
+		ENSURE(sharesBottom(that));
+		if (this != &that)
+		{
+			setOperation(that, SetOperation::Intersection, parallel);
+		}
+
+		return *this;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	template <typename... ArgumentSet>
+	auto RedBlackTree<Settings, Customization>::subtract(
+		RedBlackTree& that,
+		ArgumentSet&&... argumentSet)
+	-> RedBlackTree&
+	{
+		static_assert(!Settings::MultipleKeys,
+			"Set operations are not defined for multi-sets.");
+
+		bool parallel = PASTEL_ARG_S(parallel, true);
+
+		ENSURE(sharesBottom(that));
+		if (this == &that)
+		{
+			clear();
+		}
+		else
+		{
+			setOperation(that, SetOperation::Difference, parallel);
+		}
+
+		return *this;
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::setOperation(
+		RedBlackTree& that,
+		SetOperation operation,
+		bool parallel)
+	{
+		// Notify while the elements are still in their trees;
+		// the subproblems are solved in temporary trees, whose
+		// customizations are not those of the trees.
+		notifySetOperation(that, operation);
+
+		// The end node of a tree may coincide with the shared
+		// bottom node. Since the end nodes are modified by the
+		// subproblems, the operation is done in trees which have
+		// their own end nodes; then the subproblems only read the
+		// bottom node, and can be solved in parallel.
+		RedBlackTree left;
+		left.useBottomFrom(*this);
+
+		RedBlackTree right;
+		right.useBottomFrom(that);
+
+		left.swapElements(*this);
+		right.swapElements(that);
+
+		left.setOperationRecursive(right, operation, parallel);
+		swapElements(left);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::notifySetOperation(
+		RedBlackTree& that,
+		SetOperation operation)
+	{
+		if constexpr (std::is_same_v<
+			Customization,
+			Empty_RedBlackTree_Customization<Settings>>)
+		{
+			// The empty customization does nothing.
+			return;
+		}
+
+		integer n = size();
+		integer m = that.size();
+
+		if (operation != SetOperation::Intersection &&
+			(n == 0 || m * floorLog2<integer>(n) < 4 * (n + m)))
+		{
+			// The 'that' tree is small; find its elements
+			// one by one.
+			for (auto iter = that.cbegin(); iter != that.cend(); ++iter)
+			{
+				auto equal = find(iter.key());
+				if (operation == SetOperation::Difference)
+				{
+					if (equal != cend())
+					{
+						this->onErase(equal);
+					}
+					that.onErase(that.cast(iter));
+				}
+				else if (equal != cend())
+				{
+					// Union keeps the element of this tree.
+					that.onErase(that.cast(iter));
+				}
+			}
+			return;
+		}
+
+		auto a = cbegin();
+		auto b = that.cbegin();
+		while (a != cend() || b != that.cend())
+		{
+			if (b == that.cend() ||
+				(a != cend() && less(a.key(), b.key())))
+			{
+				// Only in this tree.
+				if (operation == SetOperation::Intersection)
+				{
+					this->onErase(cast(a));
+				}
+				++a;
+			}
+			else if (a == cend() || less(b.key(), a.key()))
+			{
+				// Only in 'that'.
+				if (operation != SetOperation::Union)
+				{
+					that.onErase(that.cast(b));
+				}
+				++b;
+			}
+			else
+			{
+				// In both trees.
+				if (operation == SetOperation::Difference)
+				{
+					this->onErase(cast(a));
+				}
+				that.onErase(that.cast(b));
+				++a;
+				++b;
+			}
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::setOperationRecursive(
+		RedBlackTree& that,
+		SetOperation operation,
+		bool parallel)
+	{
+		if (empty() || that.empty())
+		{
+			if (operation == SetOperation::Union)
+			{
+				join(that);
+			}
+			else if (operation == SetOperation::Intersection)
+			{
+				destroy();
+				that.destroy();
+			}
+			else
+			{
+				that.destroy();
+			}
+			return;
+		}
+
+		integer n = size();
+		integer m = that.size();
+
+		// Moving the elements of 'that' one by one is faster
+		// than merging, unless 'that' is about as large as
+		// this tree. The constant is from the benchmarks.
+		if (operation != SetOperation::Intersection &&
+			m * floorLog2<integer>(n) < 4 * (n + m))
+		{
+			// The 'that' tree is small.
+			setOperationByElements(that, operation);
+			return;
+		}
+
+		// Problems smaller than this are solved sequentially.
+		static constexpr integer ParallelSize = 1 << 16;
+		if (!parallel || n + m < ParallelSize)
+		{
+			setOperationByMerging(that, operation);
+			return;
+		}
+
+		// Split this tree by the key at the root of 'that' into
+		// the elements before, equivalent to, and after the key.
+		// This is done before splitting 'that', so that the only
+		// allocations are done before any node is detached.
+		const Key& key = ((Key_Node*)that.rootNode())->key();
+
+		RedBlackTree thatMiddle;
+		thatMiddle.useBottomFrom(that);
+
+		RedBlackTree thatRight;
+		thatRight.useBottomFrom(that);
+
+		RedBlackTree right = split(key);
+		RedBlackTree middle = right.split(right.upperBound(key));
+		middle.swapElements(right);
+
+		// From now on nothing throws, except for the subproblems.
+
+		that.expose(thatMiddle, thatRight);
+
+		bool found = !middle.empty();
+		if (operation == SetOperation::Union)
+		{
+			if (found)
+			{
+				// Keep the element of this tree.
+				thatMiddle.destroy();
+			}
+			else
+			{
+				middle.swapElements(thatMiddle);
+			}
+		}
+		else
+		{
+			thatMiddle.destroy();
+			if (operation == SetOperation::Difference)
+			{
+				middle.destroy();
+			}
+		}
+
+		auto solveLeft = [&]()
+		{
+			setOperationRecursive(that, operation, parallel);
+		};
+
+		auto solveRight = [&]()
+		{
+			right.setOperationRecursive(thatRight, operation, parallel);
+		};
+
+		tbb::parallel_invoke(solveLeft, solveRight);
+
+		join(middle);
+		join(right);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::setOperationByMerging(
+		RedBlackTree& that,
+		SetOperation operation)
+	{
+		std::vector<Node*> aSet;
+		aSet.reserve(size());
+		for (auto iter = cbegin(); iter != cend(); ++iter)
+		{
+			aSet.push_back((Node*)iter.base());
+		}
+
+		std::vector<Node*> bSet;
+		bSet.reserve(that.size());
+		for (auto iter = that.cbegin(); iter != that.cend(); ++iter)
+		{
+			bSet.push_back((Node*)iter.base());
+		}
+
+		std::vector<Node*> nodeSet;
+		nodeSet.reserve(operation == SetOperation::Union ?
+			aSet.size() + bSet.size() : aSet.size());
+
+		// From now on nothing throws.
+
+		forget();
+		that.forget();
+
+		bool keepA = (operation != SetOperation::Intersection);
+		bool keepB = (operation == SetOperation::Union);
+		bool keepEqual = (operation != SetOperation::Difference);
+
+		auto keep = [&](Node* node, bool kept)
+		{
+			if (kept)
+			{
+				nodeSet.push_back(node);
+			}
+			else
+			{
+				deallocateNode((Key_Node*)node);
+			}
+		};
+
+		integer i = 0;
+		integer j = 0;
+		while (i < aSet.size() && j < bSet.size())
+		{
+			const Key& aKey = ((Key_Node*)aSet[i])->key();
+			const Key& bKey = ((Key_Node*)bSet[j])->key();
+			if (less(aKey, bKey))
+			{
+				keep(aSet[i], keepA);
+				++i;
+			}
+			else if (less(bKey, aKey))
+			{
+				keep(bSet[j], keepB);
+				++j;
+			}
+			else
+			{
+				// Keep the element of this tree.
+				keep(aSet[i], keepEqual);
+				keep(bSet[j], false);
+				++i;
+				++j;
+			}
+		}
+
+		for (;i < aSet.size();++i)
+		{
+			keep(aSet[i], keepA);
+		}
+
+		for (;j < bSet.size();++j)
+		{
+			keep(bSet[j], keepB);
+		}
+
+		linkSorted(nodeSet);
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::setOperationByElements(
+		RedBlackTree& that,
+		SetOperation operation)
+	{
+		ASSERT(operation != SetOperation::Intersection);
+
+		if (operation == SetOperation::Difference)
+		{
+			for (auto iter = that.cbegin(); iter != that.cend(); ++iter)
+			{
+				auto equal = find(iter.key());
+				if (equal != cend())
+				{
+					Node* node = (Node*)equal.base();
+					detach(node);
+					deallocateNode((Key_Node*)node);
+				}
+			}
+
+			that.destroy();
+			return;
+		}
+
+		std::vector<Node*> bSet;
+		bSet.reserve(that.size());
+		for (auto iter = that.cbegin(); iter != that.cend(); ++iter)
+		{
+			bSet.push_back((Node*)iter.base());
+		}
+
+		// From now on nothing throws.
+
+		that.forget();
+
+		for (Node* node : bSet)
+		{
+			const Key& key = ((Key_Node*)node)->key();
+			auto equalAndUpper = findEqualAndUpper(key);
+			if (equalAndUpper.equal != cend())
+			{
+				// Keep the element of this tree.
+				deallocateNode((Key_Node*)node);
+				continue;
+			}
+
+			auto parentAndRight = findInsert(key, equalAndUpper);
+
+			node->isolate();
+			node->setRed();
+			Node* updateNode = attach(
+				node,
+				(Node*)parentAndRight.parent.base(),
+				parentAndRight.right);
+			updateToRoot(updateNode);
+		}
+	}
+
+	template <typename Settings, template <typename> class Customization>
+	void RedBlackTree<Settings, Customization>::expose(
+		RedBlackTree& middle,
+		RedBlackTree& right)
+	{
+		ASSERT(!empty());
+		ASSERT(middle.empty());
+		ASSERT(right.empty());
+
+		Node* root = rootNode();
+		Node* min = minNode();
+		Node* max = maxNode();
+		integer childBlackHeight = blackHeight() - root->black();
+
+		// Gives the left or the right subtree of the root
+		// to 'tree'. The extremum on the opposite side of
+		// the root is an extremum of this tree.
+		auto adopt = [&](RedBlackTree& tree, bool side)
+		{
+			Node* child = root->child(side);
+			if (child->isSentinel())
+			{
+				tree.forget();
+				return;
+			}
+
+			// Find the extremum next to the root.
+			Node* inner = child;
+			while (!inner->child(!side)->isSentinel())
+			{
+				inner = inner->child(!side);
+			}
+			Node* outer = side ? max : min;
+
+			tree.rootNode() = child;
+			child->parent() = tree.endNode();
+
+			tree.extremumNode(!side) = inner;
+			inner->child(!side) = tree.endNode();
+			tree.extremumNode(side) = outer;
+			outer->child(side) = tree.endNode();
+
+			tree.blackHeight_ = childBlackHeight;
+			tree.setRootBlack();
+		};
+
+		// The left subtree must be adopted last,
+		// since it is adopted by this tree.
+		adopt(right, true);
+		adopt(*this, false);
+
+		root->isolate();
+		root->setRed();
+		middle.attach(root, middle.endNode(), false);
+	}
+
+}
+
+#endif
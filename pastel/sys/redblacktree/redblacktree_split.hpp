@@ -153,7 +153,9 @@ namespace Pastel
 			if (subtree->red())
 			{
 				// Turn the root of the splitted subtree black. 
+				// The propagation data may depend on the color.
 				subtree->setBlack();
+				update(subtree);
 				++subtreeBlackHeight;
 			}
 
@@ -5,5 +5,6 @@
 #define PASTELSYS_SKIPLIST_H_MODULE
 
 #include "pastel/sys/skiplist/skiplist.h"
+#include "pastel/sys/skiplist/concurrent_skiplist.h"
 
 #endif
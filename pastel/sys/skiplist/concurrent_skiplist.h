@@ -0,0 +1,450 @@
+// Description: Concurrent skip list
+// Documentation: concurrent_skiplist.txt
+
+#ifndef PASTELSYS_CONCURRENT_SKIPLIST_H
+#define PASTELSYS_CONCURRENT_SKIPLIST_H
+
+#include "pastel/sys/skiplist/skiplist.h"
+#include "pastel/sys/skiplist/concurrent_skiplist_epochs.h"
+#include "pastel/sys/skiplist/concurrent_skiplist_node.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Pastel
+{
+
+	//! Concurrent skip list
+	/*!
+	Space complexity:
+	O(n + r),
+	where
+	n is the number stored elements, and
+	r is the number of removed elements waiting
+	for reclamation.
+
+	SkipList_Settings:
+	A type implementing the SkipList_Concepts::Settings concept.
+
+	The readers search and iterate the skip list without
+	locking, concurrently with a writer. The writers are
+	serialized by a lock. A removed element is freed only
+	after the readers which may refer to it have finished.
+	*/
+	template <typename SkipList_Settings>
+	class ConcurrentSkipList
+	{
+	public:
+		using Settings = SkipList_Settings;
+		using Key = typename Settings::Key;
+		using Value = typename Settings::Value;
+		using Less = typename Settings::Less;
+
+		static constexpr bool MultipleKeys = Settings::MultipleKeys;
+
+		//! The maximum number of levels of an element.
+		static constexpr integer MaxHeight = 32;
+
+	private:
+		using Node = ConcurrentSkipList_::Node<Key, Value>;
+		using Link = typename Node::Link;
+
+	public:
+		using ConstIterator = ConcurrentSkipList_::Iterator<Key, Value>;
+		using const_iterator = ConstIterator;
+
+		class Reader;
+
+		//! Constructs an empty skip list.
+		/*!
+		Preconditions:
+		readers > 0
+
+		Time complexity: O(readers)
+		Exception safety: strong
+
+		readers:
+		The number of readers which can read at the
+		same time. Additional readers block, spinning
+		and yielding, until a reader finishes. Choose at
+		least the number of reading threads times the
+		number of readers each of them holds at once.
+		Each slot takes a cache line, and reclamation
+		reads all of them.
+		*/
+		explicit ConcurrentSkipList(integer readers = 128)
+		: epochs_(readers)
+		{
+		}
+
+		//! Destructs the skip list.
+		/*!
+		Preconditions:
+		There are no readers.
+
+		Time complexity: O(size())
+		Exception safety: nothrow
+		*/
+		~ConcurrentSkipList();
+
+		//! Inserts an element.
+		/*!
+		Thread-safe; the writers are serialized.
+
+		Time complexity: O(log(size())) expected
+		Exception safety: strong
+
+		returns:
+		Whether the element was inserted. An element is not
+		inserted if its key exists and multiple keys are
+		not allowed. Equivalent elements are stored in
+		the order they were inserted.
+		*/
+		template <typename... That>
+		bool insert(Key key, That&&... value);
+
+		//! Removes all elements equivalent to 'key'.
+		/*!
+		Thread-safe; the writers are serialized.
+
+		Time complexity: O(k + log(size())) expected,
+		where k is the number of removed elements.
+
+		Exception safety: strong
+
+		returns:
+		The number of removed elements.
+		*/
+		integer erase(const Key& key);
+
+		//! Removes all elements.
+		/*!
+		Thread-safe; the writers are serialized.
+
+		Time complexity: O(size())
+		Exception safety: strong
+		*/
+		void clear();
+
+		//! Frees the removed elements which no reader can refer to.
+		/*!
+		Thread-safe; the writers are serialized.
+
+		Time complexity: O(r + readers)
+		Exception safety: nothrow
+
+		This is called automatically when the removed
+		elements accumulate.
+		*/
+		void reclaim()
+		{
+			std::lock_guard<std::mutex> lock(writeMutex_);
+			reclaimUnlocked();
+		}
+
+		//! Starts reading.
+		/*!
+		Thread-safe.
+
+		Time complexity:
+		O(1) expected, if fewer than readers() readers
+		exist. Otherwise blocks until a reader finishes;
+		a thread which already holds readers() readers
+		blocks forever.
+
+		Exception safety: nothrow
+
+		The returned reader provides the read operations.
+		The removed elements are not freed as long as a
+		reader which started before their removal exists.
+		Therefore readers should be short-lived.
+		*/
+		Reader read() const
+		{
+			return Reader(*this);
+		}
+
+		//! Returns whether an element equivalent to 'key' exists.
+		/*!
+		Thread-safe; lock-free.
+
+		Time complexity: O(log(size())) expected
+		Exception safety: nothrow
+		*/
+		bool exists(const Key& key) const
+		{
+			return read().find(key) != ConstIterator();
+		}
+
+		//! Returns the number of elements.
+		/*!
+		Thread-safe.
+
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer size() const
+		{
+			return size_.load(std::memory_order_relaxed);
+		}
+
+		//! Returns whether the skip list is empty.
+		/*!
+		Thread-safe.
+
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		//! Returns the number of removed elements waiting for reclamation.
+		/*!
+		Thread-safe.
+
+		Time complexity: O(1)
+		Exception safety: nothrow
+		*/
+		integer retired() const
+		{
+			return retired_.load(std::memory_order_relaxed);
+		}
+
+		//! Returns the number of readers which can read at the same time.
+		integer readers() const
+		{
+			return epochs_.slots();
+		}
+
+	private:
+		template <typename Settings_>
+		friend bool testInvariants(const ConcurrentSkipList<Settings_>& that);
+
+		ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+		ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+		//! A removed node, and the epoch of its removal.
+		struct Retired
+		{
+			Node* node;
+			uint64 epoch;
+		};
+
+		//! Returns the links of the predecessor of 'node' on each level.
+		/*!
+		If 'upper' is false, 'node' is the first element >= key,
+		otherwise it is the first element > key.
+		*/
+		void findPredecessors(
+			const Key& key, bool upper,
+			std::array<Link*, MaxHeight>& predecessorSet);
+
+		//! Finds the first element >= key, or > key if 'upper'.
+		const Node* nodeBound(const Key& key, bool upper) const;
+
+		//! Returns the height of the next inserted element.
+		/*!
+		The heights are pseudo-random with a fixed seed, so
+		that the same operations produce the same skip list.
+		*/
+		integer nextHeight();
+
+		//! Tags a removed node with the current epoch.
+		void retire(Node* node);
+
+		void reclaimUnlocked();
+
+		bool less(const Key& left, const Key& right) const
+		{
+			return Less()(left, right);
+		}
+
+		//! The links of the head; one for each level.
+		std::array<Link, MaxHeight> headSet_{};
+
+		//! The number of levels in use.
+		std::atomic<integer> height_{1};
+
+		std::atomic<integer> size_{0};
+		std::atomic<integer> retired_{0};
+
+		//! The number of the inserted elements; seeds nextHeight().
+		uint64 inserted_ = 0;
+
+		//! The removed nodes, in increasing order of epochs.
+		std::vector<Retired> retiredSet_;
+
+		mutable ConcurrentSkipList_::Epochs epochs_;
+
+		std::mutex writeMutex_;
+	};
+
+	//! Reads a concurrent skip list.
+	/*!
+	A reader pins an epoch, so that the elements it refers
+	to are not freed while it exists. The iterators
+	obtained from a reader are valid as long as the reader
+	exists; they may refer to removed elements. An element
+	inserted or removed concurrently with reading may or
+	may not be seen.
+	*/
+	template <typename SkipList_Settings>
+	class ConcurrentSkipList<SkipList_Settings>::Reader
+	{
+	public:
+		explicit Reader(const ConcurrentSkipList& list)
+			: list_(&list)
+			, slot_(list.epochs_.pin())
+		{
+		}
+
+		Reader(Reader&& that)
+			: list_(that.list_)
+			, slot_(that.slot_)
+		{
+			that.list_ = nullptr;
+		}
+
+		~Reader()
+		{
+			if (list_)
+			{
+				list_->epochs_.unpin(slot_);
+			}
+		}
+
+		//! Returns the first element equivalent to 'key', or cend().
+		/*!
+		Time complexity: O(log(size())) expected
+		Exception safety: nothrow
+		*/
+		ConstIterator find(const Key& key) const
+		{
+			ConstIterator result = lowerBound(key);
+			if (result == cend() ||
+				Less()(key, result.key()))
+			{
+				return cend();
+			}
+			return result;
+		}
+
+		//! Returns the first element >= 'key'.
+		/*!
+		Time complexity: O(log(size())) expected
+		Exception safety: nothrow
+		*/
+		ConstIterator lowerBound(const Key& key) const
+		{
+			return ConstIterator(list_->nodeBound(key, false));
+		}
+
+		ConstIterator lower_bound(const Key& key) const
+		{
+			return lowerBound(key);
+		}
+
+		//! Returns the first element > 'key'.
+		/*!
+		Time complexity: O(log(size())) expected
+		Exception safety: nothrow
+		*/
+		ConstIterator upperBound(const Key& key) const
+		{
+			return ConstIterator(list_->nodeBound(key, true));
+		}
+
+		ConstIterator upper_bound(const Key& key) const
+		{
+			return upperBound(key);
+		}
+
+		//! Returns the number of elements equivalent to 'key'.
+		/*!
+		Time complexity: O(k + log(size())) expected,
+		where k is the number of equivalent elements.
+
+		Exception safety: nothrow
+		*/
+		integer count(const Key& key) const
+		{
+			return std::distance(lowerBound(key), upperBound(key));
+		}
+
+		//! Returns the first element.
+		ConstIterator cbegin() const
+		{
+			return ConstIterator(
+				list_->headSet_[0].load(std::memory_order_acquire));
+		}
+
+		ConstIterator begin() const
+		{
+			return cbegin();
+		}
+
+		//! Returns the end-iterator.
+		ConstIterator cend() const
+		{
+			return ConstIterator();
+		}
+
+		ConstIterator end() const
+		{
+			return cend();
+		}
+
+	private:
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+		Reader& operator=(Reader&&) = delete;
+
+		const ConcurrentSkipList* list_;
+		integer slot_;
+	};
+
+}
+
+namespace Pastel
+{
+
+	template <typename Key, typename Value, typename Less = LessThan>
+	using ConcurrentSkipList_Map = ConcurrentSkipList<SkipList_Map_Settings<Key, Value, Less, false>>;
+
+	template <typename Key, typename Value, typename Less = LessThan>
+	using ConcurrentSkipList_MultiMap = ConcurrentSkipList<SkipList_Map_Settings<Key, Value, Less, true>>;
+
+	template <typename Key, typename Less = LessThan>
+	using ConcurrentSkipList_Set = ConcurrentSkipList<SkipList_Map_Settings<Key, Empty, Less, false>>;
+
+	template <typename Key, typename Less = LessThan>
+	using ConcurrentSkipList_MultiSet = ConcurrentSkipList<SkipList_Map_Settings<Key, Empty, Less, true>>;
+
+}
+
+namespace Pastel
+{
+
+	//! Returns whether the invariants hold for 'that'.
+	/*!
+	Preconditions:
+	'that' is not being modified concurrently.
+
+	Time complexity: O(that.size())
+	Exception safety: nothrow
+
+	This function is useful only for testing. If the implementation
+	is correct, this function should always return true.
+	*/
+	template <typename SkipList_Settings>
+	bool testInvariants(const ConcurrentSkipList<SkipList_Settings>& that);
+
+}
+
+#include "pastel/sys/skiplist/concurrent_skiplist.hpp"
+
+#endif
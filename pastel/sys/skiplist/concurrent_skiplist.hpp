@@ -0,0 +1,326 @@
+#ifndef PASTELSYS_CONCURRENT_SKIPLIST_HPP
+#define PASTELSYS_CONCURRENT_SKIPLIST_HPP
+
+#include "pastel/sys/skiplist/concurrent_skiplist.h"
+
+#include <bit>
+
+namespace Pastel
+{
+
+	template <typename SkipList_Settings>
+	ConcurrentSkipList<SkipList_Settings>::~ConcurrentSkipList()
+	{
+		Node* node = headSet_[0].load(std::memory_order_relaxed);
+		while (node)
+		{
+			Node* next = node->linkSet()[0].load(std::memory_order_relaxed);
+			Node::deallocate(node);
+			node = next;
+		}
+
+		for (const Retired& retired : retiredSet_)
+		{
+			Node::deallocate(retired.node);
+		}
+	}
+
+	template <typename SkipList_Settings>
+	template <typename... That>
+	bool ConcurrentSkipList<SkipList_Settings>::insert(
+		Key key, That&&... value)
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+
+		// The equivalent elements are inserted last,
+		// to keep them in the order of insertion.
+		std::array<Link*, MaxHeight> predecessorSet;
+		findPredecessors(key, true, predecessorSet);
+
+		if (!MultipleKeys)
+		{
+			// The element before the upper bound is
+			// the last element <= key.
+			Link* last = predecessorSet[0];
+			if (last != headSet_.data())
+			{
+				// The links of a node are right after the node.
+				const Node* lastNode =
+					(const Node*)last - 1;
+				if (!less(lastNode->key(), key))
+				{
+					return false;
+				}
+			}
+		}
+
+		integer height = nextHeight();
+		Node* node = Node::allocate(height,
+			std::move(key), std::forward<That>(value)...);
+
+		// From now on nothing throws.
+
+		// The node is complete before it is published by
+		// a release store; the readers see it either wholly
+		// or not at all. The readers which find the node on
+		// an upper level also find it on the lower levels.
+		for (integer i = 0;i < height;++i)
+		{
+			node->linkSet()[i].store(
+				predecessorSet[i]->load(std::memory_order_relaxed),
+				std::memory_order_relaxed);
+		}
+
+		for (integer i = 0;i < height;++i)
+		{
+			predecessorSet[i]->store(node, std::memory_order_release);
+		}
+
+		if (height > height_.load(std::memory_order_relaxed))
+		{
+			height_.store(height, std::memory_order_release);
+		}
+
+		size_.store(size() + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	template <typename SkipList_Settings>
+	integer ConcurrentSkipList<SkipList_Settings>::erase(
+		const Key& key)
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+
+		std::array<Link*, MaxHeight> predecessorSet;
+		findPredecessors(key, false, predecessorSet);
+
+		integer removed = 0;
+		for (Node* node = predecessorSet[0]->load(std::memory_order_relaxed);
+			node && !less(key, node->key());
+			node = node->linkSet()[0].load(std::memory_order_relaxed))
+		{
+			++removed;
+		}
+
+		if (removed == 0)
+		{
+			return 0;
+		}
+
+		retiredSet_.reserve(retiredSet_.size() + removed);
+
+		// From now on nothing throws.
+
+		for (integer j = 0;j < removed;++j)
+		{
+			// The predecessors of the removed elements stay
+			// the predecessors of the next equivalent element.
+			Node* node = predecessorSet[0]->load(std::memory_order_relaxed);
+
+			// The removed node keeps its links, so that a
+			// reader on the node continues to the elements
+			// after it.
+			for (integer i = node->height() - 1;i >= 0;--i)
+			{
+				ASSERT(predecessorSet[i]->load(std::memory_order_relaxed) == node);
+				predecessorSet[i]->store(
+					node->linkSet()[i].load(std::memory_order_relaxed),
+					std::memory_order_release);
+			}
+
+			retire(node);
+		}
+
+		size_.store(size() - removed, std::memory_order_relaxed);
+
+		epochs_.advance();
+		if ((integer)retiredSet_.size() >= 2 * epochs_.slots())
+		{
+			reclaimUnlocked();
+		}
+
+		return removed;
+	}
+
+	template <typename SkipList_Settings>
+	void ConcurrentSkipList<SkipList_Settings>::clear()
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+
+		retiredSet_.reserve(retiredSet_.size() + size());
+
+		// From now on nothing throws.
+
+		Node* node = headSet_[0].load(std::memory_order_relaxed);
+		for (Link& link : headSet_)
+		{
+			link.store(nullptr, std::memory_order_release);
+		}
+
+		while (node)
+		{
+			Node* next = node->linkSet()[0].load(std::memory_order_relaxed);
+			retire(node);
+			node = next;
+		}
+
+		height_.store(1, std::memory_order_relaxed);
+		size_.store(0, std::memory_order_relaxed);
+
+		epochs_.advance();
+		reclaimUnlocked();
+	}
+
+	template <typename SkipList_Settings>
+	void ConcurrentSkipList<SkipList_Settings>::findPredecessors(
+		const Key& key, bool upper,
+		std::array<Link*, MaxHeight>& predecessorSet)
+	{
+		// Only the writer modifies the links, and the
+		// writer holds the lock, so the links can be
+		// read without synchronization.
+		integer height = height_.load(std::memory_order_relaxed);
+		for (integer i = MaxHeight - 1;i >= height;--i)
+		{
+			// The levels above the height are empty.
+			predecessorSet[i] = headSet_.data() + i;
+		}
+
+		Link* linkSet = headSet_.data();
+		for (integer i = height - 1;i >= 0;--i)
+		{
+			Node* next = linkSet[i].load(std::memory_order_relaxed);
+			while (next && (upper ?
+				!less(key, next->key()) :
+				less(next->key(), key)))
+			{
+				linkSet = next->linkSet();
+				next = linkSet[i].load(std::memory_order_relaxed);
+			}
+			predecessorSet[i] = linkSet + i;
+		}
+	}
+
+	template <typename SkipList_Settings>
+	auto ConcurrentSkipList<SkipList_Settings>::nodeBound(
+		const Key& key, bool upper) const
+	-> const Node*
+	{
+		const Link* linkSet = headSet_.data();
+		const Node* next = nullptr;
+		for (integer i = height_.load(std::memory_order_acquire) - 1;i >= 0;--i)
+		{
+			next = linkSet[i].load(std::memory_order_acquire);
+			while (next && (upper ?
+				!less(key, next->key()) :
+				less(next->key(), key)))
+			{
+				linkSet = next->linkSet();
+				next = linkSet[i].load(std::memory_order_acquire);
+			}
+		}
+		return next;
+	}
+
+	template <typename SkipList_Settings>
+	integer ConcurrentSkipList<SkipList_Settings>::nextHeight()
+	{
+		// A SplitMix64 hash of the insertion count; each
+		// trailing zero bit adds a level.
+		uint64 z = (inserted_++) + 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		z = z ^ (z >> 31);
+
+		return std::min(
+			(integer)std::countr_zero(z) + 1,
+			MaxHeight);
+	}
+
+	template <typename SkipList_Settings>
+	void ConcurrentSkipList<SkipList_Settings>::retire(Node* node)
+	{
+		// The readers which pin a later epoch
+		// can not reach the node.
+		retiredSet_.push_back(Retired{node, epochs_.current()});
+		retired_.store(retiredSet_.size(), std::memory_order_relaxed);
+	}
+
+	template <typename SkipList_Settings>
+	void ConcurrentSkipList<SkipList_Settings>::reclaimUnlocked()
+	{
+		uint64 minPinned = epochs_.minPinned();
+
+		// The epochs of the retired nodes are increasing,
+		// so the nodes to free form a prefix.
+		integer n = 0;
+		while (n < (integer)retiredSet_.size() &&
+			retiredSet_[n].epoch < minPinned)
+		{
+			Node::deallocate(retiredSet_[n].node);
+			++n;
+		}
+
+		retiredSet_.erase(retiredSet_.begin(), retiredSet_.begin() + n);
+		retired_.store(retiredSet_.size(), std::memory_order_relaxed);
+	}
+
+	template <typename SkipList_Settings>
+	bool testInvariants(const ConcurrentSkipList<SkipList_Settings>& that)
+	{
+		using List = ConcurrentSkipList<SkipList_Settings>;
+		using Less = typename List::Less;
+		using Node = typename List::Node;
+
+		integer height = that.height_.load();
+		if (height < 1 || height > List::MaxHeight)
+		{
+			return false;
+		}
+
+		for (integer i = 0;i < List::MaxHeight;++i)
+		{
+			// Each level is a sorted sublist of the level below.
+			const Node* lower = that.headSet_[0].load();
+			const Node* previous = nullptr;
+			for (const Node* node = that.headSet_[i].load();
+				node;node = node->linkSet()[i].load())
+			{
+				if (i >= height || i >= node->height())
+				{
+					return false;
+				}
+
+				while (lower && lower != node)
+				{
+					lower = lower->linkSet()[0].load();
+				}
+				if (!lower)
+				{
+					return false;
+				}
+
+				if (previous && (List::MultipleKeys ?
+					Less()(node->key(), previous->key()) :
+					!Less()(previous->key(), node->key())))
+				{
+					return false;
+				}
+				previous = node;
+			}
+		}
+
+		integer size = 0;
+		for (const Node* node = that.headSet_[0].load();
+			node;node = node->linkSet()[0].load())
+		{
+			++size;
+		}
+
+		return size == that.size() &&
+			that.retired() == (integer)that.retiredSet_.size();
+	}
+
+}
+
+#endif
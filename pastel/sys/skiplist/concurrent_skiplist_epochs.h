@@ -0,0 +1,175 @@
+// Description: Epoch-based memory reclamation for the concurrent skip list
+
+#ifndef PASTELSYS_CONCURRENT_SKIPLIST_EPOCHS_H
+#define PASTELSYS_CONCURRENT_SKIPLIST_EPOCHS_H
+
+#include "pastel/sys/mytypes.h"
+#include "pastel/sys/ensure.h"
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace Pastel
+{
+
+	namespace ConcurrentSkipList_
+	{
+
+		//! Epochs of the readers
+		/*!
+		A reader pins the current epoch to a slot for the
+		duration of its reads. The writer tags an unlinked
+		node with the epoch at the time of unlinking, and
+		then advances the epoch. The node can be freed when
+		every pinned epoch is greater than its tag, since
+		those readers started after the node was unlinked.
+		*/
+		class Epochs
+		{
+		public:
+			//! Constructs with the given number of reader slots.
+			/*!
+			Preconditions:
+			slots > 0
+
+			Time complexity: O(slots)
+			Exception safety: strong
+			*/
+			explicit Epochs(integer slots)
+				: slots_(slots)
+				, slotSet_(new Slot[slots])
+			{
+				ENSURE_OP(slots, >, 0);
+			}
+
+			//! Returns the number of reader slots.
+			integer slots() const
+			{
+				return slots_;
+			}
+
+			//! Pins the current epoch to a free slot.
+			/*!
+			Time complexity:
+			O(1) expected, when fewer threads pin than there
+			are slots. Otherwise blocks, spinning and yielding,
+			until another thread unpins a slot; this does not
+			return if the slots are held by the calling thread.
+
+			Exception safety: nothrow
+
+			returns:
+			The index of the slot.
+			*/
+			integer pin() const
+			{
+				// Start from a slot specific to the thread,
+				// so that the threads rarely contend for a slot.
+				static thread_local std::size_t hint =
+					std::hash<std::thread::id>()(std::this_thread::get_id());
+
+				while (true)
+				{
+					for (integer j = 0;j < slots_;++j)
+					{
+						integer i = (hint + j) % (std::size_t)slots_;
+						std::atomic<uint64>& pinned = slotSet_[i].pinned;
+
+						uint64 free = 0;
+						uint64 epoch = epoch_.load();
+						if (pinned.load(std::memory_order_relaxed) == 0 &&
+							pinned.compare_exchange_strong(free, epoch))
+						{
+							// The epoch may have advanced before
+							// it was pinned; pin it again until
+							// it is up-to-date.
+							uint64 current = epoch_.load();
+							while (current != epoch)
+							{
+								epoch = current;
+								pinned.store(epoch);
+								current = epoch_.load();
+							}
+							return i;
+						}
+					}
+					std::this_thread::yield();
+				}
+			}
+
+			//! Releases a slot.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			void unpin(integer slot) const
+			{
+				slotSet_[slot].pinned.store(0, std::memory_order_release);
+			}
+
+			//! Returns the current epoch.
+			uint64 current() const
+			{
+				return epoch_.load();
+			}
+
+			//! Advances the epoch.
+			/*!
+			Time complexity: O(1)
+			Exception safety: nothrow
+			*/
+			void advance()
+			{
+				epoch_.fetch_add(1);
+			}
+
+			//! Returns the minimum pinned epoch.
+			/*!
+			Time complexity: O(slots())
+			Exception safety: nothrow
+
+			returns:
+			The minimum pinned epoch, or the maximum
+			uint64 if no epoch is pinned.
+			*/
+			uint64 minPinned() const
+			{
+				uint64 result = std::numeric_limits<uint64>::max();
+				for (integer i = 0;i < slots_;++i)
+				{
+					uint64 pinned = slotSet_[i].pinned.load();
+					if (pinned != 0 && pinned < result)
+					{
+						result = pinned;
+					}
+				}
+				return result;
+			}
+
+		private:
+			//! A slot for a reader.
+			/*!
+			The slots are on separate cache lines, so that
+			the readers do not write to the same cache line.
+			*/
+			struct alignas(64) Slot
+			{
+				//! The pinned epoch, or 0 if the slot is free.
+				std::atomic<uint64> pinned{0};
+			};
+
+			//! The current epoch; starts from 1.
+			std::atomic<uint64> epoch_{1};
+
+			integer slots_;
+			std::unique_ptr<Slot[]> slotSet_;
+		};
+
+	}
+
+}
+
+#endif
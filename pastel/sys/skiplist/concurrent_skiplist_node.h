@@ -0,0 +1,195 @@
+// Description: Concurrent skip list node and iterator
+
+#ifndef PASTELSYS_CONCURRENT_SKIPLIST_NODE_H
+#define PASTELSYS_CONCURRENT_SKIPLIST_NODE_H
+
+#include "pastel/sys/mytypes.h"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+namespace Pastel
+{
+
+	namespace ConcurrentSkipList_
+	{
+
+		template <typename Key, typename Value>
+		using DereferenceType_ = std::conditional_t<
+			std::is_same_v<Value, Empty>, const Key, const Value>;
+
+		//! Concurrent skip list node
+		/*!
+		The links of a node are stored right after the
+		node in the same allocation, so that following a
+		link does not need another indirection. The key
+		and the value are immutable after insertion.
+		*/
+		template <typename Key, typename Value>
+		class Node
+		{
+		public:
+			using Link = std::atomic<Node*>;
+
+			//! Allocates a node with the given height.
+			/*!
+			Exception safety: strong
+
+			The links are null.
+			*/
+			template <typename... That>
+			static Node* allocate(integer height, Key key, That&&... value)
+			{
+				void* memory = ::operator new(
+					sizeof(Node) + height * sizeof(Link));
+				Node* node = nullptr;
+				try
+				{
+					node = new(memory) Node(height,
+						std::move(key), std::forward<That>(value)...);
+				}
+				catch(...)
+				{
+					::operator delete(memory);
+					throw;
+				}
+
+				for (integer i = 0;i < height;++i)
+				{
+					new(node->linkSet() + i) Link(nullptr);
+				}
+
+				return node;
+			}
+
+			//! Deallocates a node.
+			static void deallocate(Node* node)
+			{
+				node->~Node();
+				::operator delete((void*)node);
+			}
+
+			Node(const Node&) = delete;
+			Node& operator=(const Node&) = delete;
+
+			const Key& key() const
+			{
+				return key_;
+			}
+
+			const Value& value() const
+			{
+				return value_;
+			}
+
+			integer height() const
+			{
+				return height_;
+			}
+
+			//! Returns the links of the node, one for each level.
+			Link* linkSet()
+			{
+				return (Link*)(this + 1);
+			}
+
+			const Link* linkSet() const
+			{
+				return (const Link*)(this + 1);
+			}
+
+		private:
+			template <typename... That>
+			Node(integer height, Key key, That&&... value)
+				: key_(std::move(key))
+				, value_(std::forward<That>(value)...)
+				, height_(height)
+			{
+			}
+
+			~Node() = default;
+
+			Key key_;
+			Value value_;
+			integer height_;
+		};
+
+		//! Concurrent skip list iterator
+		/*!
+		An iterator is valid as long as the reader it was
+		obtained from exists; see ConcurrentSkipList::Reader.
+		*/
+		template <typename Key, typename Value>
+		class Iterator
+			: public boost::iterator_facade<
+			Iterator<Key, Value>,
+			DereferenceType_<Key, Value>,
+			boost::forward_traversal_tag>
+		{
+		public:
+			using Node = ConcurrentSkipList_::Node<Key, Value>;
+
+			Iterator()
+				: node_(nullptr)
+			{
+			}
+
+			explicit Iterator(const Node* node)
+				: node_(node)
+			{
+			}
+
+			const Key& key() const
+			{
+				return node_->key();
+			}
+
+			const Value& value() const
+			{
+				return node_->value();
+			}
+
+			//! Returns the number of levels of the element.
+			integer height() const
+			{
+				return node_->height();
+			}
+
+			const Node* base() const
+			{
+				return node_;
+			}
+
+		private:
+			friend class boost::iterator_core_access;
+
+			DereferenceType_<Key, Value>& dereference() const
+			{
+				if constexpr (std::is_same_v<Value, Empty>) {
+					return node_->key();
+				} else {
+					return node_->value();
+				}
+			}
+
+			bool equal(const Iterator& that) const
+			{
+				return node_ == that.node_;
+			}
+
+			void increment()
+			{
+				node_ = node_->linkSet()[0].load(std::memory_order_acquire);
+			}
+
+			const Node* node_;
+		};
+
+	}
+
+}
+
+#endif
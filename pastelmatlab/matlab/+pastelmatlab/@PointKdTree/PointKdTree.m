@@ -5,7 +5,10 @@
 
 classdef PointKdTree < handle
     properties (Access = 'private')
-        kdTree        
+        kdTree
+        % The point-sets whose points are referenced 
+        % in place by the kd-tree.
+        pointSetSet = {}
     end
     methods
         function self = PointKdTree(dimension)
@@ -19,4 +22,31 @@ classdef PointKdTree < handle
                 'pointkdtree_construct', dimension);
         end
     end
+    methods (Static)
+        % LOAD_TREE
+        % Loads a kd-tree from a file.
+        %
+        % kdTree = PointKdTree.load_tree(fileName)
+        %
+        % where
+        %
+        % FILENAME is the name of a file written by 'save_tree'.
+        %
+        % The subdivision of the kd-tree is loaded as it was
+        % saved, without refining it again.
+        function self = load_tree(fileName)
+            eval(import_pastel);
+
+            concept_check(fileName, 'string');
+
+            kdTree = pastelmatlab(...
+                'pointkdtree_load', fileName);
+            dimension = pastelmatlab(...
+                'pointkdtree_dimension', kdTree);
+
+            self = pastelmatlab.PointKdTree(dimension);
+            pastelmatlab('pointkdtree_destruct', self.kdTree);
+            self.kdTree = kdTree;
+        end
+    end
 end
\ No newline at end of file
@@ -12,4 +12,6 @@ function clear(self)
     pastelmatlab(...
         'pointkdtree_clear', ...
         self.kdTree)
+
+    self.pointSetSet = {};
 end
@@ -21,6 +21,7 @@ function erase(self, idSet)
         pastelmatlab(...
             'pointkdtree_erase', ...
             self.kdTree);
+        self.pointSetSet = {};
     else
         pastelmatlab(...
             'pointkdtree_erase', ...
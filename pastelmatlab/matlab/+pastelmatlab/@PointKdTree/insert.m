@@ -14,6 +14,10 @@
 %
 % IDSET is a positive integer array containing the identifiers 
 % of the inserted points in the kd-tree.
+%
+% A real double POINTSET is referenced in place rather than
+% copied; the kd-tree keeps a reference to it for as long
+% as it contains its points. Other numeric types are copied.
 
 % Description: Inserts points into a kd-tree
 % DocumentationOf: PointKdTree.m
@@ -25,7 +29,16 @@ function idSet = insert(self, pointSet)
         error('Dimensions of the kd-tree and the point-set do not match.');
     end
 
+    shared = isa(pointSet, 'double') && isreal(pointSet) && ...
+        ~issparse(pointSet);
+
     idSet = pastelmatlab(...
         'pointkdtree_insert', ...
-        self.kdTree, pointSet);
+        self.kdTree, pointSet, double(shared));
+
+    if shared
+        % Keep the point-set alive; Matlab copies it
+        % on write, so the referenced data never changes.
+        self.pointSetSet{end + 1} = pointSet;
+    end
 end
@@ -0,0 +1,25 @@
+% SAVE_TREE
+% Saves a kd-tree to a file.
+%
+% save_tree(fileName)
+%
+% where
+%
+% FILENAME is the name of the file to write.
+%
+% The file stores the subdivision, the points, and their
+% identifiers in a binary format. Load the kd-tree with
+% PointKdTree.load_tree(fileName).
+
+% Description: Saves a kd-tree to a file.
+% DocumentationOf: PointKdTree.m
+
+function save_tree(self, fileName)
+    eval(import_pastel);
+
+    concept_check(fileName, 'string');
+
+    pastelmatlab(...
+        'pointkdtree_save', ...
+        self.kdTree, fileName);
+end
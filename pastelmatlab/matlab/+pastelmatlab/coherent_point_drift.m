@@ -76,6 +76,14 @@
 % which to accept the transformation and stop iteration. 
 % Default: 1e-11.
 %
+% KERNELERROR ('kernelError') is a real number in [0, 1), which gives
+% the value of the Gaussian kernel under which the affinity between
+% a pair of points is ignored. When zero, the affinities between all
+% pairs of points are evaluated, which takes O(nm) time and memory.
+% When positive, only the affinities between nearby points are 
+% evaluated, which allows to register large point-sets. 
+% Default: 0.
+%
 % It should approximately be true that 
 % 
 %     Q * S * fromSet + t * ones(1, n)
@@ -98,6 +106,7 @@ noiseRatio = 0.2;
 minIterations = 1;
 maxIterations = 100;
 minError = 1e-11;
+kernelError = 0;
 matrix = 'free';
 scaling = 'free';
 translation = 'free';
@@ -109,7 +118,7 @@ t0 = [];
 eval(process_options({...
     'noiseRatio', ...
     'minIterations', 'maxIterations', ...
-    'minError', 'matrix', 'scaling', 'translation', ...
+    'minError', 'kernelError', 'matrix', 'scaling', 'translation', ...
     'orientation', 'Q0', 'S0', 't0'}, ...
     varargin));
 
@@ -127,6 +136,7 @@ eval(process_options({...
     t0, ...
     minIterations, ...
     maxIterations, ...
-    minError);
+    minError, ...
+    kernelError);
 
 end
@@ -89,6 +89,23 @@ for i = 1 : size(querySet, 2)
 end
 hold off
 
+% Save the kd-tree, and load it back.
+fileName = [tempname(), '.kdtree'];
+kdTree.save_tree(fileName);
+loadedTree = PointKdTree.load_tree(fileName);
+delete(fileName);
+
+if loadedTree.nodes() ~= kdTree.nodes() || ...
+    loadedTree.points() ~= kdTree.points()
+    error('The loaded kd-tree differs from the saved kd-tree.');
+end
+
+if ~isequal(loadedTree.as_points(idSet), pointSet)
+    error('The loaded kd-tree has different points.');
+end
+
+clear loadedTree;
+
 % Hide some of the points.
 kdTree.hide(idSet(101 : 200));
 
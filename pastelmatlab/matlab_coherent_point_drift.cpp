@@ -33,6 +33,7 @@ namespace
 			MinIterations,
 			MaxIterations,
 			MinError,
+			KernelError,
 			Inputs
 		};
 
@@ -84,6 +85,9 @@ namespace
 		dreal minError = 
 			matlabAsScalar<dreal>(inputSet[MinError]);
 
+		dreal kernelError = 
+			matlabAsScalar<dreal>(inputSet[KernelError]);
+
 		integer d = P.rows();
 		integer n = P.cols();
 		integer m = R.cols();
@@ -120,7 +124,8 @@ namespace
 			PASTEL_TAG(orientation), orientation,
 			PASTEL_TAG(minIterations), minIterations,
 			PASTEL_TAG(maxIterations), maxIterations,
-			PASTEL_TAG(minError), minError);
+			PASTEL_TAG(minError), minError,
+			PASTEL_TAG(kernelError), kernelError);
 
 		if (qSpecified)
 		{
@@ -2,21 +2,21 @@
 // Documentation: pointkdtree_matlab.txt
 
 #include "pastel/geometry/pointkdtree/pointkdtree.h"
-#include "pastel/geometry/count_nearest.h"
-#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/count_all_nearest.h"
+#include "pastel/geometry/search_all_nearest.h"
 #include "pastel/geometry/nearestset/kdtree_nearestset.h"
 #include "pastel/math/norm.h"
 
-#include "pastel/sys/allocator/pool_allocator.h"
+#include "pastel/sys/binaryfile.h"
+#include "pastel/sys/endian.h"
 #include "pastel/sys/indicator/predicate_indicator.h"
 
 #include "pastel/sys/range.h"
 #include <boost/range/algorithm/fill.hpp>
 
-#include <tbb/blocked_range.h>
-#include <tbb/parallel_for.h>
-
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "pastelmatlab/pastelmatlab.h"
 
@@ -92,7 +92,7 @@ namespace Pastel
 			explicit KdState(integer dimension)
 				: tree(TreePoint_Locator(dimension))
 				, indexMap()
-				, pointAllocator(dimension * sizeof(dreal))
+				, blockSet()
 				, index(1)
 			{
 			}
@@ -100,7 +100,7 @@ namespace Pastel
 			explicit KdState(const KdState& that)
 				: tree(that.tree)
 				, indexMap()
-				, pointAllocator(that.tree.n() * sizeof(dreal))
+				, blockSet()
 				, index(that.index)
 			{
 				// Remove points, but retain structure.
@@ -109,61 +109,88 @@ namespace Pastel
 				const Tree& thatTree = that.tree;
 				integer dimension = thatTree.n();
 
-				// Copy point data.
-				{
-					Point_ConstRange range = thatTree.range();
-					for (auto&& p : range)
-					{
-						const TreePoint& treePoint = p.point();
-						
-						dreal* data = (dreal*)pointAllocator.allocate();
-						dreal* thatData = treePoint.data;
-
-						std::copy(thatData, thatData + dimension, data);
-
-						integer index = treePoint.id;
-
-						Point_ConstIterator iter = tree.insert(TreePoint(data, index));
-						indexMap.insert(std::make_pair(index, iter));
-					}
-				}
+				// Copy the point data into a single block.
+				dreal* data = allocate(
+					thatTree.points() + 
+					ranges::distance(thatTree.hiddenRange()));
 
-				// Copy hidden data.
+				auto copy = [&](const Point_ConstRange& range, bool hidden)
 				{
-					Point_ConstRange range = thatTree.hiddenRange();
 					for (auto&& p : range)
 					{
 						const TreePoint& treePoint = p.point();
-						
-						dreal* data = (dreal*)pointAllocator.allocate();
-						dreal* thatData = treePoint.data;
-
-						std::copy(thatData, thatData + dimension, data);
+						std::copy(treePoint.data, treePoint.data + dimension, data);
 
 						integer index = treePoint.id;
 
 						Point_ConstIterator iter = tree.insert(
-							TreePoint(data, index), true);
+							TreePoint(data, index), hidden);
 						indexMap.insert(std::make_pair(index, iter));
+
+						data += dimension;
 					}
-				}
+				};
+
+				copy(thatTree.range(), false);
+				copy(thatTree.hiddenRange(), true);
 			}
 
 			~KdState()
 			{
 				tree.clear();
-				pointAllocator.clear();
+			}
+
+			//! Allocates memory for the coordinates of points.
+			dreal* allocate(integer points)
+			{
+				blockSet.emplace_back(
+					std::make_unique<dreal[]>(points * tree.n()));
+				return blockSet.back().get();
+			}
+
+			//! Removes all points, and the memory of their coordinates.
+			void clear(bool eraseSubdivision)
+			{
+				if (eraseSubdivision)
+				{
+					tree.clear();
+				}
+				else
+				{
+					tree.erase(true);
+				}
+				indexMap.clear();
+				blockSet.clear();
 			}
 
 			Tree tree;
 			// Mapping from integer identifiers to point iterators.
 			IndexMap indexMap;
-			// Memory region for point data.
-			PoolAllocator pointAllocator;
+			// Memory blocks for the point coordinates which
+			// are not referenced in place from Matlab.
+			std::vector<std::unique_ptr<dreal[]>> blockSet;
 			// The current allocation index for identifiers.
 			integer index;
 		};
 
+		// The format of a saved kd-tree.
+		static constexpr uint32 FileMagic = 0x54444B50;
+		static constexpr uint32 FileVersion = 1;
+
+		void writeInteger(BinaryFile& file, integer value)
+		{
+			file << (uint32)((uint64)value & 0xFFFFFFFF);
+			file << (uint32)((uint64)value >> 32);
+		}
+
+		integer readInteger(BinaryFile& file)
+		{
+			uint32 low = 0;
+			uint32 high = 0;
+			file >> low >> high;
+			return (integer)(((uint64)high << 32) | low);
+		}
+
 		KdState* asState(const mxArray* matlabArray)
 		{
 			return *((KdState**)mxGetData(matlabArray));
@@ -329,7 +356,7 @@ namespace Pastel
 			ENSURE_OP(inputs, ==, Inputs);
 
 			KdState* state = asState(inputSet[State]);
-			state->tree.clear();
+			state->clear(true);
 		}
 
 		void kdInsert(
@@ -340,6 +367,7 @@ namespace Pastel
 			{
 				State,
 				PointSet,
+				Shared,
 				Inputs
 			};
 
@@ -349,25 +377,40 @@ namespace Pastel
 				Outputs
 			};
 
-			ENSURE_OP(inputs, ==, Inputs);
+			ENSURE_OP(inputs, >=, Shared);
+			ENSURE_OP(inputs, <=, Inputs);
 
 			KdState* state = asState(inputSet[State]);
 			Tree& tree = state->tree;
+			integer d = tree.n();
+
+			// When the point-set is shared, the caller keeps the
+			// Matlab array alive for as long as the points are in
+			// the tree, and the points are referenced in place.
+			bool shared = (inputs > Shared) &&
+				matlabAsScalar<integer>(inputSet[Shared]) != 0;
 
-			MatlabMatrix<dreal> pointSet_ = matlabAsMatrix<dreal>(inputSet[PointSet]);
-			auto pointSet = pointSet_.view();
+			MatlabMatrix<dreal> pointSet = matlabAsMatrix<dreal>(inputSet[PointSet]);
+			ENSURE_OP(pointSet.rows(), ==, d);
 			integer points = pointSet.cols();
 
+			dreal* data = pointSet.data();
+			if (!shared || pointSet.hasMemory())
+			{
+				// The points are not of type double, or they
+				// are not shared; copy them into a single block.
+				dreal* block = state->allocate(points);
+				std::copy(data, data + points * d, block);
+				data = block;
+			}
+
 			MatrixView<integer> result =
 				matlabCreateMatrix<integer>(points, 1, outputSet[IdSet]);
 			for (integer i = 0;i < points;++i)
 			{
-
-				dreal* data = (dreal*)state->pointAllocator.allocate();
-				ranges::copy(pointSet.columnRange(i), data);
-
 				integer index = state->index;
-				Point_ConstIterator iter = tree.insert(TreePoint(data, index));
+				Point_ConstIterator iter = tree.insert(
+					TreePoint(data + i * d, index));
 				state->indexMap.insert(std::make_pair(index, iter));
 				++state->index;
 
@@ -394,12 +437,11 @@ namespace Pastel
 			ENSURE_OP(inputs, >=, IdSet);
 
 			KdState* state = asState(inputSet[State]);
-			Tree& tree = state->tree;
 
 			if (inputs <= IdSet)
 			{
-				// Erase all;
-				tree.erase();
+				// Erase all, but retain structure.
+				state->clear(false);
 				return;
 			}
 
@@ -624,6 +666,78 @@ namespace Pastel
 			*outPoints = state->tree.points();
 		}
 
+		using Query = Location<TreePoint, TreePoint_Locator>;
+
+		//! Returns query points given by their coordinates.
+		/*!
+		The i:th column of 'coordinateSet' is the i:th query
+		point, which is referenced in place.
+		*/
+		std::vector<Query> coordinateQueries(
+			const KdState& state,
+			const MatlabMatrix<dreal>& coordinateSet)
+		{
+			integer d = state.tree.n();
+			ENSURE_OP(coordinateSet.rows(), ==, d);
+
+			integer queries = coordinateSet.cols();
+
+			std::vector<Query> querySet;
+			querySet.reserve(queries);
+			for (integer i = 0;i < queries;++i)
+			{
+				querySet.emplace_back(
+					TreePoint(coordinateSet.data() + i * d, 0),
+					state.tree.locator());
+			}
+
+			return querySet;
+		}
+
+		//! Returns query points given by their ids.
+		/*!
+		The i:th query point is the point in the kd-tree 
+		with the id idSet(i), and pointSet[i] is its iterator.
+		If there is no such point, then the query point is
+		'origin', pointSet[i] is state.tree.end(), and
+		missingSet[i] is true.
+		*/
+		std::vector<Query> idQueries(
+			const KdState& state,
+			const MatlabMatrix<integer>& idSet_,
+			dreal* origin,
+			std::vector<Point_ConstIterator>& pointSet,
+			std::vector<bool>& missingSet)
+		{
+			const IndexMap& indexMap = state.indexMap;
+			auto idSet = idSet_.view();
+			integer queries = idSet.size();
+
+			std::vector<Query> querySet;
+			querySet.reserve(queries);
+			pointSet.assign(queries, state.tree.end());
+			missingSet.assign(queries, false);
+			for (integer i = 0;i < queries;++i)
+			{
+				ConstIterator query = indexMap.find(idSet(i));
+				if (query == indexMap.end())
+				{
+					missingSet[i] = true;
+					querySet.emplace_back(
+						TreePoint(origin, 0), 
+						state.tree.locator());
+					continue;
+				}
+
+				pointSet[i] = query->second;
+				querySet.emplace_back(
+					query->second->point(),
+					state.tree.locator());
+			}
+
+			return querySet;
+		}
+
 		template <Norm_Concept Norm>
 		void kdSearchNearest_(
 			int outputs, mxArray *outputSet[],
@@ -653,10 +767,10 @@ namespace Pastel
 			//		kdtree, querySet, maxDistanceSet, kNearest);
 
 			KdState* state = asState(inputSet[State]);
-			const IndexMap& indexMap = state->indexMap;
 			MatlabMatrix<dreal> maxDistanceSet_ = matlabAsVectorizedMatrix<dreal>(inputSet[MaxDistanceSet]);
 			auto maxDistanceSet = maxDistanceSet_.view();
 			integer kNearest = matlabAsScalar<integer>(inputSet[KNearest]);
+			ENSURE_OP(kNearest, >=, 0);
 
 			auto norm = Norm();
 
@@ -668,16 +782,52 @@ namespace Pastel
 
 			bool wantDistance = (outputs >= 2);
 
-			integer queries = 0;
+			// The queries are either a set of points given explicitly
+			// by their coordinates, where each column is a query point,
+			// or the points in the kd-tree given by their ids. When
+			// the query is by an id, the query point is not accepted
+			// as its own neighbor.
+			MatlabMatrix<dreal> coordinateSet;
+			std::vector<dreal> origin(state->tree.n(), 0);
+			std::vector<Point_ConstIterator> pointSet;
+			std::vector<bool> missingSet;
+
+			std::vector<Query> querySet;
 			if (queriesAreCoordinates)
 			{
-				queries = mxGetN(inputSet[QuerySet]);
+				coordinateSet = matlabAsMatrix<dreal>(inputSet[QuerySet]);
+				querySet = coordinateQueries(*state, coordinateSet);
+				pointSet.assign(querySet.size(), state->tree.end());
+				missingSet.assign(querySet.size(), false);
 			}
 			else
 			{
-				queries = mxGetNumberOfElements(inputSet[QuerySet]);
+				querySet = idQueries(*state, 
+					matlabAsVectorizedMatrix<integer>(inputSet[QuerySet]),
+					origin.data(), pointSet, missingSet);
 			}
 
+			integer queries = querySet.size();
+			ENSURE_OP(maxDistanceSet.size(), ==, queries);
+
+			// Find the k-nearest-neighbors for each point.
+			auto resultSet = searchAllNearest(
+				kdTreeNearestSet(state->tree),
+				querySet,
+				PASTEL_TAG(queryAccept), 
+				[&](integer i)
+				{
+					return predicateIndicator(pointSet[i], NotEqualTo());
+				},
+				PASTEL_TAG(norm), norm,
+				PASTEL_TAG(kNearest), kNearest,
+				PASTEL_TAG(queryMaxDistance2), 
+				[&](integer i)
+				{
+					// A missing query point has no neighbors.
+					return norm[missingSet[i] ? 0 : maxDistanceSet(i)];
+				});
+
 			MatrixView<integer> nearestArray =
 				matlabCreateMatrix<integer>(queries, kNearest, outputSet[IdSet]);
 
@@ -692,104 +842,21 @@ namespace Pastel
 				ranges::fill(distanceArray.range(), (dreal)Infinity());
 			}
 
-			using Block = tbb::blocked_range<integer>;
-
-			if (queriesAreCoordinates)
-			{
-				// The queries are a set of points given explicitly
-				// by their coordinates. Each column is a query point.
-				MatlabMatrix<dreal> querySet_ = matlabAsMatrix<dreal>(inputSet[QuerySet]);
-				auto querySet = querySet_.view();
-				integer n = state->tree.n();
-
-				// Find the k-nearest-neighbors for each point.
-
-				auto search = [&](const Block& block)
-				{
-					Vector<dreal> query(ofDimension(n));
-					for (integer i = block.begin(); i < block.end(); ++i)
-					{
-						ranges::copy(
-							querySet.columnRange(i),
-							query.begin());
-
-						integer j = 0;
-						auto report = [&](
-							const auto& distance,
-							Point_ConstIterator point)
-						{
-							if (point != state->tree.end())
-							{
-								nearestArray(i, j) = point->point().id;
-								if (wantDistance)
-								{
-									distanceArray(i, j) = ~distance;
-								}
-							}
-							++j;
-						};
-
-						searchNearest(
-							kdTreeNearestSet(state->tree), 
-							query, 
-							PASTEL_TAG(report), report,
-							PASTEL_TAG(norm), norm,
-							PASTEL_TAG(kNearest), kNearest,
-							PASTEL_TAG(maxDistance2), norm[maxDistanceSet(i)]);
-					}
-				};
-
-				tbb::parallel_for(Block(0, queries), search);
-			}
-			else
+			for (integer i = 0;i < queries;++i)
 			{
-				// The queries are over the points in the kd-tree,
-				// given by their ids.
-				MatlabMatrix<integer> querySet_ = matlabAsVectorizedMatrix<integer>(inputSet[QuerySet]);
-				auto querySet = querySet_.view();
-		
-				// Find the k-nearest-neighbors for each point.
-				auto search = [&](const Block& block)
+				for (integer j = 0;j < kNearest;++j)
 				{
-					for (integer i = block.begin(); i < block.end(); ++i)
+					const auto& result = resultSet[i * kNearest + j];
+					dreal distance = ~result.first;
+					if (distance < (dreal)Infinity())
 					{
-						integer j = 0;
-						auto report = [&](
-							const auto& distance,
-							Point_ConstIterator point)
-						{
-							if (point != state->tree.end())
-							{
-								nearestArray(i, j) = point->point().id;
-								if (wantDistance)
-								{
-									distanceArray(i, j) = ~distance;
-								}
-							}
-							++j;
-						};
-
-						auto query_ = indexMap.find(querySet(i));
-						if (query_ == indexMap.end())
+						nearestArray(i, j) = result.second->point().id;
+						if (wantDistance)
 						{
-							// The query index does not exist.
-							continue;
+							distanceArray(i, j) = distance;
 						}
-
-						Point_ConstIterator query = query_->second;
-
-						searchNearest(
-							kdTreeNearestSet(state->tree),
-							location(query->point(), state->tree.locator()),
-							PASTEL_TAG(report), report,
-							PASTEL_TAG(accept), predicateIndicator(query, NotEqualTo()), 
-							PASTEL_TAG(norm), norm,
-							PASTEL_TAG(kNearest), kNearest,
-							PASTEL_TAG(maxDistance2), norm[maxDistanceSet(i)]);
 					}
-				};
-
-				tbb::parallel_for(Block(0, queries), search);
+				}
 			}
 		}
 
@@ -868,50 +935,41 @@ namespace Pastel
 			//		kdtree, querySet, maxDistanceSet, norm);
 
 			KdState* state = asState(inputSet[State]);
-			const IndexMap& indexMap = state->indexMap;
 			MatlabMatrix<dreal> maxDistanceSet_ = matlabAsVectorizedMatrix<dreal>(inputSet[MaxDistanceSet]);
 			auto maxDistanceSet = maxDistanceSet_.view();
-			integer queries = mxGetNumberOfElements(inputSet[QuerySet]);
-			ENSURE_OP(maxDistanceSet.size(), ==, queries);
 
 			// The queries are over the points in the kd-tree,
 			// given by their ids.
-			MatlabMatrix<integer> querySet_ = matlabAsVectorizedMatrix<integer>(inputSet[QuerySet]);
-			auto querySet = querySet_.view();
-
-			// Create the result array.
-			MatrixView<integer> result =
-				matlabCreateMatrix<integer>(queries, 1, outputSet[IdSet]);
+			std::vector<dreal> origin(state->tree.n(), 0);
+			std::vector<Point_ConstIterator> pointSet;
+			std::vector<bool> missingSet;
+			std::vector<Query> querySet = idQueries(*state,
+				matlabAsVectorizedMatrix<integer>(inputSet[QuerySet]),
+				origin.data(), pointSet, missingSet);
+
+			integer queries = querySet.size();
+			ENSURE_OP(maxDistanceSet.size(), ==, queries);
 
 			// Count the neighbors for each point.
-
-			using Block = tbb::blocked_range<integer>;
 			auto norm = Norm();
-
-			auto count = [&](const Block& block)
-			{
-				for (integer i = block.begin(); i < block.end(); ++i)
+			std::vector<integer> countSet = countAllNearest(
+				kdTreeNearestSet(state->tree),
+				querySet,
+				PASTEL_TAG(norm), norm,
+				PASTEL_TAG(queryMaxDistance2),
+				[&](integer i)
 				{
-					ConstIterator query_ = indexMap.find(querySet(i));
-					if (query_ == indexMap.end())
-					{
-						continue;
-					}
-
-					Point_ConstIterator query = query_->second;
-
-					integer count = countNearest(
-						kdTreeNearestSet(state->tree),
-						location(query->point(), state->tree.locator()),
-						PASTEL_TAG(norm), norm,
-						PASTEL_TAG(kNearest), state->tree.points(),
-						PASTEL_TAG(maxDistance2), norm[maxDistanceSet(i)]);
-
-					result(i) = count;
-				}
-			};
+					// A missing query point has no neighbors.
+					return norm[missingSet[i] ? 0 : maxDistanceSet(i)];
+				});
 
-			tbb::parallel_for(Block(0, queries), count);
+			// Create the result array.
+			MatrixView<integer> result =
+				matlabCreateMatrix<integer>(queries, 1, outputSet[IdSet]);
+			for (integer i = 0;i < queries;++i)
+			{
+				result(i) = countSet[i];
+			}
 		}
 
 		void kdCountNearest(
@@ -960,6 +1018,172 @@ namespace Pastel
 			}
 		}
 
+		void kdSave(
+			int outputs, mxArray *outputSet[],
+			int inputs, const mxArray *inputSet[])
+		{
+			enum
+			{
+				State,
+				FileName,
+				Inputs
+			};
+
+			ENSURE_OP(inputs, ==, Inputs);
+
+			KdState* state = asState(inputSet[State]);
+			std::string fileName = matlabAsString(inputSet[FileName]);
+			const Tree& tree = state->tree;
+			integer d = tree.n();
+
+			BinaryFile file(fileName, false, true);
+			ENSURE(file.isOpen());
+			file << binaryLittleEndian;
+
+			file << FileMagic << FileVersion;
+			writeInteger(file, d);
+			writeInteger(file, state->index);
+
+			// The subdivision in pre-order.
+			auto saveNode = [&](auto&& self, const Tree::Cursor& node) -> void
+			{
+				file << (uint8)node.leaf();
+				if (node.leaf())
+				{
+					return;
+				}
+
+				file << (real64)node.splitPosition();
+				writeInteger(file, node.splitAxis());
+				file << (real64)node.left().prevMin();
+				file << (real64)node.left().prevMax();
+
+				self(self, node.left());
+				self(self, node.right());
+			};
+			saveNode(saveNode, tree.root());
+
+			// The visible points, followed by the hidden points.
+			auto savePoints = [&](const Point_ConstRange& range)
+			{
+				writeInteger(file, ranges::distance(range));
+				for (auto&& p : range)
+				{
+					const TreePoint& treePoint = p.point();
+					writeInteger(file, treePoint.id);
+					for (integer i = 0;i < d;++i)
+					{
+						file << (real64)treePoint.data[i];
+					}
+				}
+			};
+			savePoints(tree.range());
+			savePoints(tree.hiddenRange());
+
+			file.flush();
+		}
+
+		void kdLoad(
+			int outputs, mxArray *outputSet[],
+			int inputs, const mxArray *inputSet[])
+		{
+			enum
+			{
+				FileName,
+				Inputs
+			};
+
+			ENSURE_OP(inputs, ==, Inputs);
+
+			std::string fileName = matlabAsString(inputSet[FileName]);
+
+			BinaryFile file(fileName, true, false);
+			ENSURE(file.isOpen());
+			file << binaryLittleEndian;
+
+			uint32 magic = 0;
+			uint32 version = 0;
+			file >> magic >> version;
+			ENSURE_OP(magic, ==, FileMagic);
+			ENSURE_OP(version, ==, FileVersion);
+
+			integer d = readInteger(file);
+			ENSURE_OP(d, >, 0);
+
+			std::unique_ptr<KdState> state = std::make_unique<KdState>(d);
+			state->index = readInteger(file);
+			Tree& tree = state->tree;
+
+			// Recreate the subdivision before inserting 
+			// the points, so that no splitting rule is run.
+			auto loadNode = [&](auto&& self, const Tree::Cursor& node) -> void
+			{
+				uint8 leaf = 0;
+				file >> leaf;
+				ENSURE(!file.isInEnd());
+				if (leaf)
+				{
+					return;
+				}
+
+				real64 splitPosition = 0;
+				real64 prevMin = 0;
+				real64 prevMax = 0;
+				file >> splitPosition;
+				integer splitAxis = readInteger(file);
+				file >> prevMin >> prevMax;
+
+				tree.subdivide(node, splitPosition, splitAxis, prevMin, prevMax);
+
+				self(self, node.left());
+				self(self, node.right());
+			};
+			loadNode(loadNode, tree.root());
+
+			auto loadPoints = [&](bool hidden)
+			{
+				integer points = readInteger(file);
+				ENSURE_OP(points, >=, 0);
+
+				dreal* data = state->allocate(points);
+				std::vector<TreePoint> pointSet;
+				pointSet.reserve(points);
+				for (integer i = 0;i < points;++i)
+				{
+					integer id = readInteger(file);
+					
+					// Read the coordinates as a block.
+					file.read((char*)data, d * sizeof(real64));
+					for (integer j = 0;j < d;++j)
+					{
+						data[j] = littleEndian(data[j]);
+					}
+
+					pointSet.emplace_back(data, id);
+					data += d;
+				}
+				ENSURE(!file.isInEnd());
+
+				tree.insertSet(pointSet, PASTEL_TAG(hidden), hidden);
+			};
+			loadPoints(false);
+			loadPoints(true);
+
+			auto insertIds = [&](const Point_ConstRange& range)
+			{
+				for (auto iter = ranges::begin(range);iter != ranges::end(range);++iter)
+				{
+					state->indexMap.insert(
+						std::make_pair(iter->point().id, iter));
+				}
+			};
+			insertIds(tree.range());
+			insertIds(tree.hiddenRange());
+
+			KdState** rawResult = matlabCreateScalar<KdState*>(outputSet[0]);
+			*rawResult = state.release();
+		}
+
 		void addStuff()
 		{
 			matlabAddFunction("pointkdtree_as_points", kdAsPoints);
@@ -980,6 +1204,8 @@ namespace Pastel
 			matlabAddFunction("pointkdtree_refine", kdRefine);
 			matlabAddFunction("pointkdtree_search_nearest", kdSearchNearest);
 			matlabAddFunction("pointkdtree_count_nearest", kdCountNearest);
+			matlabAddFunction("pointkdtree_save", kdSave);
+			matlabAddFunction("pointkdtree_load", kdLoad);
 		}
 
 		CallFunction run(addStuff);
@@ -167,6 +167,79 @@ namespace
 		}
 	}
 
+	template <typename Real>
+	void testTruncated()
+	{
+		integer d = 2;
+		integer n = 300;
+
+		Matrix<Real> P(d, n);
+		for (integer i = 0;i < n;++i)
+		{
+			P(0, i) = random<Real>() * 10;
+			P(1, i) = random<Real>() * 10;
+		}
+
+		Real alpha = constantPi<Real>() / 20;
+		Matrix<Real> Q(2, 2);
+		Q <<
+			std::cos(alpha), -std::sin(alpha),
+			std::sin(alpha), std::cos(alpha);
+		ColMatrix<Real> t(2, 1);
+		t << 0.5, -0.25;
+
+		Matrix<Real> R = (Q * P).colwise() + t;
+
+		for (auto translation : {Cpd_Translation::Free, Cpd_Translation::Identity})
+		{
+			if (translation == Cpd_Translation::Identity)
+			{
+				R = Q * P;
+			}
+
+			// Returns Q, S, and t as estimated with the
+			// given truncation of the kernel.
+			auto estimate = [&](Real kernelError)
+			{
+				Matrix<Real> Qe(d, d);
+				Matrix<Real> Se(d, d);
+				ColMatrix<Real> te(d, 1);
+				bool wEmpty = true;
+
+				coherentPointDrift(
+					view(P), view(R), view(Qe), view(Se), view(te),
+					PASTEL_TAG(matrix), Cpd_Matrix::Free,
+					PASTEL_TAG(scaling), Cpd_Scaling::Rigid,
+					PASTEL_TAG(translation), translation,
+					PASTEL_TAG(kernelError), kernelError,
+					PASTEL_TAG(report), [&](auto&& state)
+					{
+						wEmpty = wEmpty && state.W.isEmpty();
+					});
+
+				// The weighting matrix is formed only
+				// when the kernel is not truncated.
+				REQUIRE(wEmpty == (kernelError > 0));
+
+				return std::make_tuple(Qe, Se, te);
+			};
+
+			auto [qExact, sExact, tExact] = estimate(0);
+			auto [qTruncated, sTruncated, tTruncated] = estimate(1e-8);
+
+			Real threshold = 1e-3;
+			REQUIRE(maxNorm(qTruncated - qExact) < threshold);
+			REQUIRE(maxNorm(sTruncated - sExact) < threshold);
+			REQUIRE(maxNorm(tTruncated - tExact) < threshold);
+
+			REQUIRE(maxNorm(qTruncated - Q) < threshold);
+			if (translation == Cpd_Translation::Free)
+			{
+				REQUIRE(maxNorm(tTruncated - t) < threshold);
+			}
+		}
+	}
+
 }
 
 TEST_CASE("translation (coherent_point_drift)")
@@ -180,3 +253,9 @@ TEST_CASE("rotation (coherent_point_drift)")
 	testRotation<float>();
 	testRotation<double>();
 }
+
+TEST_CASE("truncated (coherent_point_drift)")
+{
+	testTruncated<float>();
+	testTruncated<double>();
+}
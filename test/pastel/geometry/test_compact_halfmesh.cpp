@@ -0,0 +1,188 @@
+// Description: Testing for Compact_HalfMesh
+// DocumentationOf: compact_halfmesh.h
+
+#include "test/test_init.h"
+
+#include "pastel/geometry/halfmesh/compact_halfmesh.h"
+
+#include <vector>
+
+namespace
+{
+
+	using Settings = HalfMesh_Settings<int, int, int, int, false, true>;
+	using Mesh = HalfMesh<Settings>;
+	using Compact = Compact_HalfMesh<Settings>;
+	using Index = Compact::Index;
+
+	//! Triangulates a k x k grid of squares.
+	std::vector<integer> gridTriangles(integer k)
+	{
+		std::vector<integer> indexSet;
+		for (integer y = 0;y < k;++y)
+		{
+			for (integer x = 0;x < k;++x)
+			{
+				integer a = y * (k + 1) + x;
+				integer b = a + 1;
+				integer c = b + k + 1;
+				integer d = a + k + 1;
+				indexSet.insert(indexSet.end(), {a, b, c, a, c, d});
+			}
+		}
+		return indexSet;
+	}
+
+	std::vector<Index> loopVertices(const Compact& mesh, Index begin)
+	{
+		std::vector<Index> result;
+		Index half = begin;
+		do
+		{
+			result.push_back(mesh.origin(half));
+			half = mesh.next(half);
+		}
+		while (half != begin && result.size() <= mesh.halves());
+		return result;
+	}
+
+}
+
+TEST_CASE("Triangles (Compact_HalfMesh)")
+{
+	integer k = 20;
+	integer n = (k + 1) * (k + 1);
+
+	// The last vertex is isolated.
+	Compact mesh(n + 1, gridTriangles(k));
+	REQUIRE(testInvariants(mesh));
+
+	// Euler characteristic of a disk.
+	REQUIRE(mesh.vertices() == n + 1);
+	REQUIRE(mesh.polygons() == 2 * k * k);
+	REQUIRE(mesh.edges() == (n - 1) + mesh.polygons());
+	REQUIRE(mesh.vertexHalf(n) == Compact::InvalidIndex);
+
+	for (integer i = 0;i < mesh.polygons();++i)
+	{
+		REQUIRE(loopVertices(mesh, mesh.polygonHalf(i)).size() == 3);
+	}
+
+	// The free half-edges form a single boundary loop.
+	integer frees = 0;
+	for (integer half = 0;half < mesh.halves();++half)
+	{
+		frees += mesh.free(half);
+		REQUIRE(mesh.pair(mesh.pair(half)) == half);
+		REQUIRE(mesh.edge(mesh.pair(half)) == mesh.edge(half));
+	}
+	REQUIRE(frees == 4 * k);
+	REQUIRE(loopVertices(mesh, mesh.vertexHalf(0)).size() == 4 * k);
+
+	// The boundary vertices have a free half-edge.
+	REQUIRE(mesh.free(mesh.vertexHalf(k)));
+	REQUIRE(mesh.free(mesh.vertexHalf(n - 1)));
+
+	// An interior vertex has 6 edges around it.
+	{
+		Index v = (k / 2) * (k + 1) + k / 2;
+		Index begin = mesh.vertexHalf(v);
+		REQUIRE(!mesh.free(begin));
+
+		integer degree = 0;
+		Index half = begin;
+		do
+		{
+			REQUIRE(mesh.origin(half) == v);
+			REQUIRE(mesh.rotatePrevious(mesh.rotateNext(half)) == half);
+			half = mesh.rotateNext(half);
+			++degree;
+		}
+		while (half != begin && degree <= 6);
+		REQUIRE(degree == 6);
+	}
+
+	// The result does not depend on threading.
+	Compact serial(n + 1, gridTriangles(k), PASTEL_TAG(parallel), false);
+	REQUIRE(serial.halves() == mesh.halves());
+	for (integer half = 0;half < mesh.halves();++half)
+	{
+		REQUIRE(serial.next(half) == mesh.next(half));
+		REQUIRE(serial.origin(half) == mesh.origin(half));
+		REQUIRE(serial.left(half) == mesh.left(half));
+	}
+
+	Compact().swap(mesh);
+	REQUIRE(mesh.vertices() == 0);
+	REQUIRE(mesh.halves() == 0);
+	REQUIRE(testInvariants(mesh));
+}
+
+TEST_CASE("Conversion (Compact_HalfMesh)")
+{
+	integer k = 6;
+	integer n = (k + 1) * (k + 1);
+
+	Compact mesh(n, gridTriangles(k));
+	for (integer i = 0;i < mesh.vertices();++i)
+	{
+		mesh.vertexData(i) = i;
+	}
+	for (integer i = 0;i < mesh.polygons();++i)
+	{
+		mesh.polygonData(i) = -i;
+	}
+
+	Mesh linked = mesh.toHalfMesh();
+	REQUIRE(testInvariants(linked));
+	REQUIRE(linked.vertices() == mesh.vertices());
+	REQUIRE(linked.edges() == mesh.edges());
+	REQUIRE(linked.polygons() == mesh.polygons());
+
+	Compact back(linked);
+	REQUIRE(testInvariants(back));
+	REQUIRE(back.vertices() == mesh.vertices());
+	REQUIRE(back.edges() == mesh.edges());
+	REQUIRE(back.polygons() == mesh.polygons());
+
+	for (integer i = 0;i < mesh.vertices();++i)
+	{
+		REQUIRE(back.vertexData(i) == i);
+	}
+
+	// The polygons keep their loops.
+	for (integer i = 0;i < mesh.polygons();++i)
+	{
+		REQUIRE(back.polygonData(i) == -i);
+		REQUIRE(
+			loopVertices(back, back.polygonHalf(i)) ==
+			loopVertices(mesh, mesh.polygonHalf(i)));
+	}
+}
+
+TEST_CASE("Errors (Compact_HalfMesh)")
+{
+	using IndexSet = std::vector<integer>;
+
+	// Not triangles.
+	REQUIRE_THROWS_AS(Compact(4, IndexSet{0, 1}), InvariantFailure);
+
+	// A vertex out of range.
+	REQUIRE_THROWS_AS(Compact(3, IndexSet{0, 1, 3}), InvariantFailure);
+
+	// A degenerate triangle.
+	REQUIRE_THROWS_AS(Compact(3, IndexSet{0, 1, 1}), InvariantFailure);
+
+	// Inconsistent orientation.
+	REQUIRE_THROWS_AS(Compact(4, IndexSet{0, 1, 2, 0, 1, 3}), InvariantFailure);
+
+	// Three triangles on an edge.
+	REQUIRE_THROWS_AS(
+		Compact(5, IndexSet{0, 1, 2, 1, 0, 3, 1, 0, 4}),
+		InvariantFailure);
+
+	// Two triangles sharing an edge.
+	Compact mesh(4, IndexSet{0, 1, 2, 1, 0, 3});
+	REQUIRE(testInvariants(mesh));
+	REQUIRE(mesh.edges() == 5);
+}
@@ -0,0 +1,231 @@
+// Description: Testing for dynamic temporal kd-tree
+// Documentation: tdtree.txt
+
+#include "test/test_init.h"
+
+#include "pastel/geometry/tdtree/dynamic_tdtree.h"
+#include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/count_nearest.h"
+
+#include "pastel/sys/locator.h"
+#include "pastel/sys/random.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+
+	using Point = Vector2;
+	using Locator = Vector_Locator<dreal, 2>;
+	using Tree = Dynamic_TdTree<TdTree_Settings<Locator>>;
+	using ConstIterator = Tree::ConstIterator;
+
+	PASTEL_STATIC_ASSERT(IsDynamicTdTree<Tree>::value);
+
+}
+
+TEST_CASE("Construction (Dynamic_TdTree)")
+{
+	Tree tree;
+	REQUIRE(tree.empty());
+	REQUIRE(tree.points() == 0);
+	REQUIRE(tree.buckets() == 0);
+
+	// Searching an empty tree finds nothing.
+	auto result = searchNearest(kdTreeNearestSet(tree), Point(0, 0));
+	REQUIRE(result.second == tree.notFound());
+
+	tree.append(std::vector<Point>{Point(0, 0), Point(1, 0), Point(2, 0)});
+	REQUIRE(tree.points() == 3);
+	REQUIRE(tree.lastTime() == 2);
+
+	// The default times continue over the stream.
+	tree.append(Point(3, 0), 3);
+	tree.append(std::vector<Point>{Point(4, 0)});
+	REQUIRE(tree.points() == 5);
+	REQUIRE(tree.lastTime() == 4);
+
+	tree.expire(2);
+	REQUIRE(tree.points() == 3);
+	REQUIRE((*ranges::begin(tree.pointSetRange()))->time() == 2);
+
+	result = searchNearest(kdTreeNearestSet(tree), Point(0, 0));
+	REQUIRE(result.second->point() == Point(2, 0));
+
+	tree.expire(10);
+	REQUIRE(tree.empty());
+	REQUIRE(tree.buckets() == 0);
+
+	Tree().swap(tree);
+	REQUIRE(tree.lastTime() == -(dreal)Infinity());
+}
+
+TEST_CASE("Expire buckets (Dynamic_TdTree)")
+{
+	Tree tree;
+	integer n = 100;
+	for (integer i = 0; i < n; ++i)
+	{
+		tree.append(Point(i, 0), i);
+	}
+
+	// The buckets have 64, 32, and 4 points.
+	REQUIRE(tree.buckets() == 3);
+
+	// Expire two whole buckets at once, and
+	// then all of the remaining buckets.
+	for (integer time : {97, 200})
+	{
+		tree.expire(time);
+
+		integer alive = std::max(n - time, (integer)0);
+		REQUIRE(tree.points() == alive);
+		REQUIRE(tree.buckets() == (alive > 0));
+
+		integer j = time;
+		for (ConstIterator point : tree.pointSetRange())
+		{
+			REQUIRE(point->time() == j);
+			++j;
+		}
+		REQUIRE(j == std::max(time, n));
+
+		auto result = searchNearest(kdTreeNearestSet(tree), Point(0, 0));
+		if (alive > 0)
+		{
+			REQUIRE(result.second->point() == Point(time, 0));
+		}
+		else
+		{
+			REQUIRE(result.second == tree.notFound());
+		}
+	}
+}
+
+TEST_CASE("Stream (Dynamic_TdTree)")
+{
+	Tree tree;
+
+	// The alive points, for brute-force checking.
+	std::deque<std::pair<Point, dreal>> aliveSet;
+
+	integer n = 3000;
+	dreal time = 0;
+	integer mismatches = 0;
+	integer queries = 0;
+	integer maxBuckets = 0;
+	integer batches = 0;
+
+	for (integer i = 0; i < n;)
+	{
+		// Append a batch of points at once, or one point.
+		integer m = std::min(randomInteger(8) + 1, n - i);
+		std::vector<Point> pointSet;
+		std::vector<dreal> timeSet;
+		for (integer j = 0; j < m; ++j)
+		{
+			// The same time may repeat.
+			time += randomInteger(3);
+			pointSet.emplace_back(randomGaussianVector<dreal, 2>());
+			timeSet.push_back(time);
+			aliveSet.emplace_back(pointSet.back(), time);
+		}
+		tree.append(pointSet, PASTEL_TAG(timeSet), timeSet);
+		i += m;
+
+		// Keep the points of the last 400 time-units.
+		dreal expiryTime = time - 400;
+		tree.expire(expiryTime);
+		while (!aliveSet.empty() && aliveSet.front().second < expiryTime)
+		{
+			aliveSet.pop_front();
+		}
+
+		REQUIRE(tree.points() == aliveSet.size());
+		maxBuckets = std::max(maxBuckets, tree.buckets());
+
+		++batches;
+		if (batches % 5 != 0)
+		{
+			continue;
+		}
+
+		// The alive points are in time-order.
+		auto pointSetRange = tree.pointSetRange();
+		integer j = 0;
+		for (ConstIterator point : pointSetRange)
+		{
+			if (point->time() != aliveSet[j].second ||
+				point->point() != aliveSet[j].first)
+			{
+				++mismatches;
+			}
+			++j;
+		}
+
+		// Search in a time-window which extends beyond
+		// the expired points, and compare to brute-force.
+		Point searchPoint = randomGaussianVector<dreal, 2>();
+		dreal tBegin = time - 600 + random<dreal>() * 500;
+		dreal tEnd = tBegin + 150;
+		integer k = 5;
+
+		std::vector<dreal> distanceSet;
+		for (auto&& alive : aliveSet)
+		{
+			if (alive.second >= tBegin && alive.second < tEnd)
+			{
+				distanceSet.push_back(dot(alive.first - searchPoint));
+			}
+		}
+		std::sort(distanceSet.begin(), distanceSet.end());
+
+		auto nearestSet = kdTreeNearestSet(tree,
+			PASTEL_TAG(intervalSequence), Vector2(tBegin, tEnd));
+
+		std::vector<dreal> resultSet;
+		searchNearest(
+			nearestSet, searchPoint,
+			PASTEL_TAG(kNearest), k,
+			PASTEL_TAG(report), [&](auto&& distance, ConstIterator point)
+			{
+				resultSet.push_back(~distance);
+				if (point->time() < tBegin || point->time() >= tEnd)
+				{
+					++mismatches;
+				}
+			});
+
+		distanceSet.resize(std::min(k, (integer)distanceSet.size()));
+		if (resultSet != distanceSet)
+		{
+			++mismatches;
+		}
+
+		integer count = countNearest(
+			nearestSet, searchPoint,
+			PASTEL_TAG(maxDistance2), Euclidean_Distance<dreal>(Distance_Native(), 0.25));
+		integer correctCount = 0;
+		for (auto&& alive : aliveSet)
+		{
+			if (alive.second >= tBegin && alive.second < tEnd &&
+				dot(alive.first - searchPoint) < 0.25)
+			{
+				++correctCount;
+			}
+		}
+		if (count != correctCount)
+		{
+			++mismatches;
+		}
+
+		++queries;
+	}
+
+	REQUIRE(queries > 0);
+	REQUIRE(mismatches == 0);
+
+	// The bucket sizes at least double towards the older buckets.
+	REQUIRE(maxBuckets <= 2 * (integer)std::log2(n) + 2);
+}
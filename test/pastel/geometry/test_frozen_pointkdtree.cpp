@@ -0,0 +1,185 @@
+// Description: Testing for Frozen_PointKdTree
+// DocumentationOf: frozen_pointkdtree.h
+
+#include "test/test_init.h"
+
+#include <pastel/geometry/pointkdtree/frozen_pointkdtree.h>
+#include <pastel/geometry/pointkdtree/pointkdtree_count_range.h>
+#include <pastel/geometry/nearestset/kdtree_nearestset.h>
+#include <pastel/geometry/search_nearest.h>
+#include <pastel/geometry/bestfirst_pointkdtree_searchalgorithm.h>
+#include <pastel/geometry/splitrules.h>
+
+#include <pastel/sys/locator.h>
+#include <pastel/sys/random.h>
+#include <pastel/sys/output.h>
+
+#include <vector>
+
+namespace
+{
+
+	template <typename SearchAlgorithm, typename Norm>
+	void testNearest()
+	{
+		static constexpr int N = 3;
+		using Locator = Vector_Locator<dreal, N>;
+		using Settings = PointKdTree_Settings<Locator>;
+		using Tree = PointKdTree<Settings>;
+
+		integer n = 2000;
+		std::vector<Vector<dreal, N>> pointSet;
+		pointSet.reserve(n);
+		for (integer i = 0; i < n; ++i)
+		{
+			pointSet.emplace_back(
+				randomGaussianVector<dreal, N>());
+		}
+
+		Tree tree;
+		tree.insertSet(pointSet);
+		tree.refine(SlidingMidpoint_SplitRule(), 4);
+
+		auto frozen = freeze(tree);
+		REQUIRE(frozen.points() == tree.points());
+		REQUIRE(frozen.nodes() == tree.nodes());
+
+		// The points are in leaf order.
+		{
+			integer i = 0;
+			for (auto&& point : tree.range())
+			{
+				const auto& frozenPoint = frozen.begin()[i];
+				REQUIRE(frozenPoint.original() == point.point());
+				for (integer axis = 0; axis < N; ++axis)
+				{
+					REQUIRE(frozen.locator()(frozenPoint.point(), axis) ==
+						point.point()[axis]);
+				}
+				++i;
+			}
+		}
+
+		// A copy must not refer to the coordinates of the original.
+		Frozen_PointKdTree<Settings> copy(frozen);
+		frozen = Frozen_PointKdTree<Settings>();
+		REQUIRE(frozen.empty());
+
+		auto treeSet = kdTreeNearestSet(
+			tree, PASTEL_TAG(searchAlgorithm), SearchAlgorithm());
+		auto frozenSet = kdTreeNearestSet(
+			copy, PASTEL_TAG(searchAlgorithm), SearchAlgorithm());
+
+		integer k = 6;
+		auto norm = Norm();
+		using Distance = decltype(norm());
+
+		std::vector<Distance> aSet;
+		std::vector<Distance> bSet;
+
+		integer mismatches = 0;
+		for (integer i = 0; i < n; ++i)
+		{
+			aSet.clear();
+			searchNearest(
+				treeSet,
+				pointSet[i],
+				PASTEL_TAG(report), [&](auto&& distance, auto&&) {aSet.push_back(distance);},
+				PASTEL_TAG(kNearest), k,
+				PASTEL_TAG(norm), norm);
+
+			bSet.clear();
+			searchNearest(
+				frozenSet,
+				pointSet[i],
+				PASTEL_TAG(report), [&](auto&& distance, auto&&) {bSet.push_back(distance);},
+				PASTEL_TAG(kNearest), k,
+				PASTEL_TAG(norm), norm);
+
+			if (aSet != bSet)
+			{
+				++mismatches;
+			}
+		}
+
+		REQUIRE(mismatches == 0);
+	}
+
+}
+
+TEST_CASE("Nearest (Frozen_PointKdTree)")
+{
+	testNearest<DepthFirst_SearchAlgorithm_PointKdTree, Euclidean_Norm<dreal>>();
+	testNearest<BestFirst_SearchAlgorithm_PointKdTree, Euclidean_Norm<dreal>>();
+	testNearest<DepthFirst_SearchAlgorithm_PointKdTree, Manhattan_Norm<dreal>>();
+	testNearest<DepthFirst_SearchAlgorithm_PointKdTree, Maximum_Norm<dreal>>();
+}
+
+TEST_CASE("CountRange (Frozen_PointKdTree)")
+{
+	using Settings = PointKdTree_Settings<Vector_Locator<dreal, 2>>;
+
+	PointKdTree<Settings> tree;
+
+	Vector2 pointSet[] = 
+	{
+		{ -1, -1 },
+		{ -1, -2 },
+		{ -3, -1 },
+		{ -3, -3 },
+		{ -5, -2 },
+		{ -5, 1 },
+		{ -4, 3 },
+		{ -2, 4 },
+		{ -2, 1 },
+		{ -1, 1 },
+		{ -1, 2 },
+		{ 1, 1 },
+		{ 2, 3 },
+		{ 3, 1 },
+		{ 2, -1 },
+		{ 1, -3 }
+	};
+
+	tree.insertSet(pointSet);
+	tree.refine(SlidingMidpoint_SplitRule(), 1);
+
+	auto frozen = freeze(tree);
+
+	for (integer r = 1; r <= 6; ++r)
+	{
+		AlignedBox2 box(-r, -r, r, r);
+		REQUIRE(countRange(frozen, box, 1) == countRange(tree, box, 1));
+	}
+
+	REQUIRE(countRange(frozen, AlignedBox2(-6, -6, 0, 0), 1) == 5);
+	REQUIRE(countRange(frozen, AlignedBox2(0, 0, 6, 6), 1) == 3);
+	REQUIRE(countRange(frozen, AlignedBox2(0, -6, 6, 0), 1) == 2);
+	REQUIRE(countRange(frozen, AlignedBox2(-6, 0, 0, 6), 1) == 6);
+}
+
+TEST_CASE("Empty (Frozen_PointKdTree)")
+{
+	using Settings = PointKdTree_Settings<Vector_Locator<dreal, 2>>;
+
+	auto test = [](const Frozen_PointKdTree<Settings>& frozen)
+	{
+		REQUIRE(frozen.empty());
+		REQUIRE(frozen.nodes() == 1);
+		REQUIRE(frozen.root().leaf());
+		REQUIRE(frozen.root().points() == 0);
+
+		REQUIRE(countRange(frozen, AlignedBox2(-1, -1, 1, 1), 1) == 0);
+
+		integer found = 0;
+		searchNearest(
+			kdTreeNearestSet(frozen),
+			Vector2(0, 0),
+			PASTEL_TAG(report), [&](auto&&, auto&&) {++found;},
+			PASTEL_TAG(kNearest), 3);
+		REQUIRE(found == 0);
+	};
+
+	test(Frozen_PointKdTree<Settings>());
+	test(freeze(PointKdTree<Settings>()));
+}
@@ -0,0 +1,189 @@
+// Description: Testing for iterated closest points
+// DocumentationOf: icp.h
+
+#include "test/test_init.h"
+
+#include <pastel/geometry/pattern_matching/icp.h>
+#include <pastel/sys/random.h>
+
+namespace
+{
+
+	template <typename Real>
+	Matrix<Real> rotation2(Real alpha)
+	{
+		Matrix<Real> Q(2, 2);
+		Q <<
+			std::cos(alpha), -std::sin(alpha),
+			std::sin(alpha), std::cos(alpha);
+		return Q;
+	}
+
+	template <typename Real>
+	Matrix<Real> randomPointSet(integer n)
+	{
+		Matrix<Real> P(2, n);
+		for (integer i = 0;i < n;++i)
+		{
+			P(0, i) = random<Real>() * 10;
+			P(1, i) = random<Real>() * 10;
+		}
+		return P;
+	}
+
+	template <typename Real>
+	void testMatching()
+	{
+		Real threshold = 
+			std::is_same<Real, float>::value ? 1e-3 : 1e-6;
+
+		Matrix<Real> P = randomPointSet<Real>(300);
+
+		Matrix<Real> Q = rotation2<Real>(constantPi<Real>() / 60);
+		ColMatrix<Real> t(2, 1);
+		t << 0.1, -0.05;
+		Matrix<Real> R = (Q * P).colwise() + t;
+
+		for (auto matching : {Icp_Matching::Closest, Icp_Matching::Biunique})
+		{
+			for (integer levels : {1, 3})
+			{
+				Matrix<Real> Qe(2, 2);
+				Matrix<Real> Se(2, 2);
+				ColMatrix<Real> te(2, 1);
+
+				auto result = icp(
+					view(P), view(R), view(Qe), view(Se), view(te),
+					PASTEL_TAG(matching), matching,
+					PASTEL_TAG(levels), levels,
+					PASTEL_TAG(minError), threshold * threshold);
+
+				REQUIRE(result.iterations > 0);
+				REQUIRE(maxNorm(Qe - Q) < threshold);
+				REQUIRE(maxNorm(Se - Matrix<Real>::Identity(2, 2)) < threshold);
+				REQUIRE(maxNorm(te - t) < threshold);
+			}
+		}
+	}
+
+	template <typename Real>
+	void testDeterministic()
+	{
+		Matrix<Real> P = randomPointSet<Real>(1000);
+		Matrix<Real> R = randomPointSet<Real>(800);
+
+		// Returns the transformation, and the reported 
+		// mean distances, with or without threads.
+		auto estimate = [&](bool parallel)
+		{
+			Matrix<Real> Qe(2, 2);
+			Matrix<Real> Se(2, 2);
+			ColMatrix<Real> te(2, 1);
+			std::vector<Real> meanDistanceSet;
+
+			icp(
+				view(P), view(R), view(Qe), view(Se), view(te),
+				PASTEL_TAG(levels), 2,
+				PASTEL_TAG(maxIterations), 20,
+				PASTEL_TAG(parallel), parallel,
+				PASTEL_TAG(report), [&](auto&& state)
+				{
+					meanDistanceSet.push_back(state.meanDistance);
+				});
+
+			return std::make_tuple(Qe, Se, te, meanDistanceSet);
+		};
+
+		auto parallel = estimate(true);
+		auto serial = estimate(false);
+
+		// The results must be identical, not just close.
+		REQUIRE(std::get<0>(parallel) == std::get<0>(serial));
+		REQUIRE(std::get<1>(parallel) == std::get<1>(serial));
+		REQUIRE(std::get<2>(parallel) == std::get<2>(serial));
+		REQUIRE(std::get<3>(parallel) == std::get<3>(serial));
+	}
+
+	template <typename Real>
+	void testMatchingDistance()
+	{
+		Matrix<Real> P = randomPointSet<Real>(50);
+		Matrix<Real> R = (P.array() + 100).matrix();
+
+		Matrix<Real> Qe = Matrix<Real>::Identity(2, 2);
+		Matrix<Real> Se = Matrix<Real>::Identity(2, 2);
+		ColMatrix<Real> te = ColMatrix<Real>::Zero(2, 1);
+
+		// With the zero translation, 
+		// no point is close enough to be paired.
+		auto result = icp(
+			view(P), view(R), view(Qe), view(Se), view(te),
+			PASTEL_TAG(matchingDistance2), 1,
+			PASTEL_TAG(translation), Icp_Translation::Identity,
+			PASTEL_TAG(initialize), false);
+		REQUIRE(result.iterations == 0);
+	}
+
+	void testEqualDistances()
+	{
+		using Real = float;
+
+		// The points are translated so that every
+		// pair has the same squared distance d = a^2.
+		// The rounded mean of 18 copies of d is less
+		// than d.
+		Real a = 1 + std::ldexp((Real)1, -10);
+		integer n = 18;
+		Matrix<Real> P(2, n);
+		for (integer i = 0;i < n;++i)
+		{
+			P(0, i) = (i % 3) * 10;
+			P(1, i) = (i / 3) * 10;
+		}
+		Matrix<Real> R = P;
+		R.row(0).array() += a;
+
+		Matrix<Real> Qe = Matrix<Real>::Identity(2, 2);
+		Matrix<Real> Se = Matrix<Real>::Identity(2, 2);
+		ColMatrix<Real> te = ColMatrix<Real>::Zero(2, 1);
+
+		std::vector<integer> pairSet;
+		auto result = icp(
+			view(P), view(R), view(Qe), view(Se), view(te),
+			PASTEL_TAG(levels), 1,
+			PASTEL_TAG(initialize), false,
+			PASTEL_TAG(report), [&](auto&& state)
+			{
+				pairSet.push_back(state.pairs);
+			});
+		REQUIRE(result.iterations > 0);
+
+		// No pair is rejected in the first iteration.
+		REQUIRE(pairSet.front() == n);
+		REQUIRE(std::abs(te(0) - a) < 1e-3);
+		REQUIRE(std::abs(te(1)) < 1e-3);
+	}
+
+}
+
+TEST_CASE("matching (icp)")
+{
+	testMatching<float>();
+	testMatching<double>();
+}
+
+TEST_CASE("deterministic (icp)")
+{
+	testDeterministic<float>();
+	testDeterministic<double>();
+}
+
+TEST_CASE("matchingDistance (icp)")
+{
+	testMatchingDistance<double>();
+}
+
+TEST_CASE("equalDistances (icp)")
+{
+	testEqualDistances();
+}
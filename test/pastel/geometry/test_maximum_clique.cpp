@@ -10,6 +10,9 @@
 
 #include "pastel/sys/vector/vector_tools.h"
 #include "pastel/sys/output/push_back_output.h"
+#include "pastel/sys/random.h"
+
+#include <functional>
 
 namespace
 {
@@ -256,3 +259,134 @@ TEST_CASE("maximumClique (maximumClique)")
 		testCase(boxSet, correct, 1, correctSet);
 	}
 }
+
+namespace
+{
+
+	template <int N>
+	void testRandomClique(integer n, integer width)
+	{
+		using Box = AlignedBox<integer, N>;
+		using Point = Vector<integer, N>;
+
+		std::vector<Box> boxSet;
+		for (integer i = 0;i < n;++i)
+		{
+			Point min;
+			Point max;
+			for (integer k = 0;k < N;++k)
+			{
+				min[k] = randomInteger(width);
+				max[k] = min[k] + randomInteger(width / 2) + 1;
+			}
+			boxSet.emplace_back(min, max);
+		}
+
+		std::vector<const Box*> resultSet;
+		auto result = maximumCliqueAlignedBox(
+			boxSet,
+			PASTEL_TAG(report), [&](auto iter) {resultSet.push_back(&*iter);});
+		integer depth = result.second;
+
+		// The result does not depend on the threads.
+		auto serialResult = maximumCliqueAlignedBox(
+			boxSet, PASTEL_TAG(parallel), false);
+		REQUIRE(serialResult.second == depth);
+		REQUIRE(serialResult.first.min() == result.first.min());
+		REQUIRE(serialResult.first.max() == result.first.max());
+
+		// The boxes are [min, max), and so a deepest
+		// point can be found among the minimum corners.
+		integer correct = 0;
+		Point p;
+		std::function<void(integer)> search = [&](integer k)
+		{
+			if (k == N)
+			{
+				integer count = 0;
+				for (const Box& box : boxSet)
+				{
+					if (allLessEqual(box.min(), p) && allLess(p, box.max()))
+					{
+						++count;
+					}
+				}
+				correct = std::max(correct, count);
+				return;
+			}
+
+			for (const Box& box : boxSet)
+			{
+				p[k] = box.min()[k];
+				search(k + 1);
+			}
+		};
+		search(0);
+
+		REQUIRE(depth == correct);
+		REQUIRE(resultSet.size() == depth);
+
+		// The reported boxes have a common point.
+		for (integer k = 0;k < N;++k)
+		{
+			integer min = -1000;
+			integer max = 1000;
+			for (const Box* box : resultSet)
+			{
+				min = std::max(min, box->min()[k]);
+				max = std::min(max, box->max()[k]);
+			}
+			REQUIRE(min < max);
+			REQUIRE(result.first.min()[k] >= min);
+			REQUIRE(result.first.max()[k] <= max);
+		}
+	}
+
+}
+
+TEST_CASE("maximumCliqueAlignedBox (maximumClique)")
+{
+	// Agrees with the 2-dimensional algorithm.
+	{
+		Box boxSet[] =
+		{
+			Box(-1, -1, 1, 1),
+			Box(0, 0, 2, 2),
+			Box(0, -1, 2, 1),
+			Box(Real(-1, 2), Real(-1, 2),
+			Real(1, 2), Real(1, 2))
+		};
+
+		std::vector<const Box*> resultSet;
+		auto result = maximumCliqueAlignedBox(
+			range(boxSet),
+			PASTEL_TAG(report), pushBackOutput(resultSet));
+		REQUIRE(result.second == 4);
+		REQUIRE(resultSet.size() == 4);
+		REQUIRE(result.first.min() == Vector<Real, 2>(0, 0));
+		REQUIRE(result.first.max() == Vector<Real, 2>(Real(1, 2), Real(1, 2)));
+	}
+
+	// Open boxes which touch do not overlap.
+	{
+		Box boxSet[] =
+		{
+			Box(-2, -1, 0, 1),
+			Box(0, -1, 2, 1)
+		};
+		REQUIRE(maximumCliqueAlignedBox(range(boxSet)).second == 1);
+
+		boxSet[0].maxTopology().set(Topology::Closed);
+		REQUIRE(maximumCliqueAlignedBox(range(boxSet)).second == 2);
+	}
+
+	REQUIRE(maximumCliqueAlignedBox(std::vector<Box>()).second == 0);
+
+	for (integer i = 0;i < 10;++i)
+	{
+		testRandomClique<1>(50, 40);
+		testRandomClique<2>(50, 20);
+		testRandomClique<3>(60, 20);
+		testRandomClique<4>(25, 10);
+	}
+}
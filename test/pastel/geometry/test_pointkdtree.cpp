@@ -7,11 +7,13 @@
 #include "pastel/geometry/search_nearest.h"
 #include "pastel/geometry/nearestset/kdtree_nearestset.h"
 #include "pastel/geometry/splitrule/slidingmidpoint_splitrule.h"
+#include "pastel/geometry/splitrule/longestmedian_splitrule.h"
 #include "pastel/geometry/bestfirst_pointkdtree_searchalgorithm.h"
 #include "pastel/geometry/pointkdtree.h"
 
 #include "pastel/math/sampling/uniform_sampling.h"
 
+#include "pastel/sys/allocator/concurrent_pool_allocator.h"
 #include "pastel/sys/iterator.h"
 #include "pastel/sys/output.h"
 #include "pastel/sys/locator.h"
@@ -422,3 +424,164 @@ TEST_CASE("PointKdTree (PointKdTree)")
 	testSearch(
 		BestFirst_SearchAlgorithm_PointKdTree());
 }
+
+namespace
+{
+
+	template <int N, typename SplitRule>
+	void testRefineInParallel(
+		const SplitRule& splitRule,
+		bool simulateKdTree)
+	{
+		using Tree = PointKdTree<Settings<N>>;
+
+		integer m = 20000;
+
+		// Use integer coordinates, so that there are 
+		// points on the splitting planes.
+		std::vector<Vector<dreal, N>> pointSet;
+		pointSet.reserve(m);
+		for (integer i = 0;i < m;++i)
+		{
+			Vector<dreal, N> point;
+			for (integer axis = 0;axis < N;++axis)
+			{
+				point[axis] = randomInteger(64);
+			}
+			pointSet.push_back(point);
+		}
+
+		Tree aTree(Vector_Locator<dreal, N>(), simulateKdTree);
+		Tree bTree(Vector_Locator<dreal, N>(), simulateKdTree);
+
+		aTree.insertSet(pointSet);
+		bTree.insertSet(pointSet);
+
+		auto sameOrder = [&]()
+		{
+			auto a = aTree.begin();
+			auto b = bTree.begin();
+			for (;a != aTree.end();++a, ++b)
+			{
+				if (a->point() != b->point())
+				{
+					return false;
+				}
+			}
+			return true;
+		};
+
+		// Refine an unrefined tree.
+		aTree.refine(splitRule, 256);
+		bTree.refineInParallel(splitRule, 256, 64);
+		REQUIRE(testInvariants(bTree));
+		REQUIRE(equivalent(aTree, bTree));
+		REQUIRE(sameOrder());
+
+		// Refine an already refined tree.
+		aTree.refine(splitRule, 4);
+		bTree.refineInParallel(splitRule, 4, 64);
+		REQUIRE(testInvariants(bTree));
+		REQUIRE(equivalent(aTree, bTree));
+		REQUIRE(sameOrder());
+	}
+
+}
+
+TEST_CASE("refineInParallel (PointKdTree)")
+{
+	testRefineInParallel<2>(SlidingMidpoint_SplitRule(), false);
+	testRefineInParallel<2>(SlidingMidpoint_SplitRule(), true);
+	testRefineInParallel<3>(LongestMedian_SplitRule(), false);
+	testRefineInParallel<3>(SlidingMidpoint2_SplitRule(), false);
+}
+
+TEST_CASE("subdivide (PointKdTree)")
+{
+	using Cursor = Tree::Cursor;
+
+	std::vector<Vector<dreal, 2>> pointSet;
+	for (integer i = 0;i < 10000;++i)
+	{
+		pointSet.push_back(Vector<dreal, 2>(randomInteger(64), randomInteger(64)));
+	}
+
+	Tree aTree;
+	aTree.insertSet(pointSet);
+	aTree.refine(SlidingMidpoint_SplitRule(), 8);
+
+	// Recreate the subdivision in pre-order.
+	Tree bTree;
+	auto copy = [&](auto&& self, const Cursor& from, const Cursor& to) -> void
+	{
+		if (from.leaf())
+		{
+			return;
+		}
+
+		bTree.subdivide(to,
+			from.splitPosition(), from.splitAxis(),
+			from.left().prevMin(), from.left().prevMax());
+
+		self(self, from.left(), to.left());
+		self(self, from.right(), to.right());
+	};
+	copy(copy, aTree.root(), bTree.root());
+	REQUIRE(bTree.nodes() == aTree.nodes());
+	REQUIRE(bTree.leaves() == aTree.leaves());
+
+	bTree.insertSet(pointSet);
+	REQUIRE(testInvariants(bTree));
+	REQUIRE(equivalent(aTree, bTree));
+
+	// A tree with points can not be subdivided this way.
+	Cursor leaf = bTree.root();
+	while (!leaf.leaf())
+	{
+		leaf = leaf.left();
+	}
+	REQUIRE_THROWS_AS(
+		bTree.subdivide(leaf, leaf.min(), 0, leaf.min(), leaf.max()),
+		InvariantFailure);
+}
+
+TEST_CASE("Allocator (PointKdTree)")
+{
+	class Concurrent_Settings
+		: public Settings<2>
+	{
+	public:
+		using Allocator = ConcurrentPoolAllocator;
+	};
+
+	using ConcurrentTree = PointKdTree<Concurrent_Settings>;
+	PASTEL_STATIC_ASSERT((std::is_same<
+		ConcurrentTree::NodeAllocator, ConcurrentPoolAllocator>::value));
+
+	std::vector<Vector<dreal, 2>> pointSet;
+	for (integer i = 0;i < 10000;++i)
+	{
+		pointSet.push_back(Vector<dreal, 2>(randomInteger(64), randomInteger(64)));
+	}
+
+	Tree aTree;
+	ConcurrentTree bTree;
+	aTree.insertSet(pointSet);
+	bTree.insertSet(pointSet);
+
+	aTree.refine(SlidingMidpoint_SplitRule(), 8);
+	bTree.refine(SlidingMidpoint_SplitRule(), 8);
+	REQUIRE(testInvariants(bTree));
+	REQUIRE(bTree.nodes() == aTree.nodes());
+
+	bTree.merge();
+	REQUIRE(testInvariants(bTree));
+	REQUIRE(bTree.nodes() == 1);
+
+	bTree.refineInParallel(SlidingMidpoint_SplitRule(), 8, 64);
+	REQUIRE(testInvariants(bTree));
+	REQUIRE(bTree.nodes() == aTree.nodes());
+
+	bTree.clear();
+	REQUIRE(bTree.nodes() == 1);
+}
@@ -102,3 +102,79 @@ TEST_CASE("PoissonDiskPattern (PointPattern)")
 	savePcx(image, "testpointpattern_poissondisk_4d.pcx");
 }
 
+
+namespace
+{
+
+	template <int N>
+	void testGridPoissonDiskPattern(dreal width, dreal minDistance)
+	{
+		using Point = Vector<dreal, N>;
+		AlignedBox<dreal, N> window(Point(0), Point(width));
+
+		std::vector<Point> pointSet =
+			gridPoissonDiskPattern(window, minDistance,
+				PASTEL_TAG(seed), 5);
+		REQUIRE(!pointSet.empty());
+
+		// The pattern does not depend on the number of threads.
+		REQUIRE(pointSet == gridPoissonDiskPattern(window, minDistance,
+			PASTEL_TAG(seed), 5,
+			PASTEL_TAG(parallel), false));
+
+		// The pattern depends on the seed.
+		REQUIRE(pointSet != gridPoissonDiskPattern(window, minDistance,
+			PASTEL_TAG(seed), 6));
+
+		integer n = pointSet.size();
+		integer violations = 0;
+		for (integer i = 0;i < n;++i)
+		{
+			if (!overlaps(window, pointSet[i]))
+			{
+				++violations;
+			}
+
+			for (integer j = i + 1;j < n;++j)
+			{
+				if (dot(pointSet[i] - pointSet[j]) < square(minDistance))
+				{
+					++violations;
+				}
+			}
+		}
+		REQUIRE(violations == 0);
+
+		// The pattern is almost maximal: almost every point
+		// of the window is covered by the disk of a pattern point.
+		integer probes = 2000;
+		integer uncovered = 0;
+		for (integer i = 0;i < probes;++i)
+		{
+			Point probe = window.at(randomVector<dreal, N>());
+			bool covered = false;
+			for (const Point& point : pointSet)
+			{
+				if (dot(point - probe) < square(minDistance))
+				{
+					covered = true;
+					break;
+				}
+			}
+			if (!covered)
+			{
+				++uncovered;
+			}
+		}
+		REQUIRE(uncovered <= probes / 100);
+	}
+
+}
+
+TEST_CASE("gridPoissonDiskPattern (PointPattern)")
+{
+	testGridPoissonDiskPattern<1>(500, 5);
+	testGridPoissonDiskPattern<2>(100, 3);
+	testGridPoissonDiskPattern<3>(30, 3);
+	testGridPoissonDiskPattern<4>(15, 3);
+}
@@ -4,8 +4,11 @@
 #include "test/test_init.h"
 
 #include <pastel/geometry/rangetree/rangetree.h>
+#include <pastel/geometry/rangetree/rangetree_count_range.h>
+#include <pastel/geometry/rangetree/dynamic_rangetree.h>
 #include <pastel/sys/math/eps.h>
 #include <pastel/sys/for_each_point.h>
+#include <pastel/sys/random.h>
 
 #include <iostream>
 #include <queue>
@@ -284,3 +287,193 @@ TEST_CASE("RangeTree (RangeTree)")
 	testSingular<3>();
 	testSingular<4>();
 }
+
+TEST_CASE("countAllRange (RangeTree)")
+{
+	static constexpr int N = 3;
+	using Tree = RangeTree<Settings<N>>;
+	using Point = typename Tree::Point;
+
+	// Enough points to construct the upper levels in
+	// parallel; the coordinates are integers, so that
+	// there are many equivalent points.
+	integer n = 10000;
+	std::vector<Point> pointSet;
+	pointSet.reserve(n);
+	for (integer i = 0; i < n; ++i)
+	{
+		Point point;
+		for (integer k = 0; k < N; ++k)
+		{
+			point[k] = randomInteger(20);
+		}
+		pointSet.emplace_back(point);
+	}
+
+	Tree tree(pointSet, N);
+	REQUIRE(testInvariants(tree));
+
+	Tree serialTree(pointSet, N, PASTEL_TAG(parallel), false);
+	REQUIRE(testInvariants(serialTree));
+
+	integer m = 300;
+	std::vector<Point> minSet;
+	std::vector<Point> maxSet;
+	for (integer i = 0; i < m; ++i)
+	{
+		Point min;
+		Point max;
+		for (integer k = 0; k < N; ++k)
+		{
+			min[k] = randomInteger(20);
+			max[k] = min[k] + randomInteger(10);
+		}
+		minSet.emplace_back(min);
+		maxSet.emplace_back(max);
+	}
+
+	std::vector<integer> countSet = countAllRange(tree, minSet, maxSet);
+	REQUIRE(countSet.size() == m);
+
+	REQUIRE(countSet == countAllRange(serialTree, minSet, maxSet,
+		PASTEL_TAG(parallel), false));
+
+	integer mismatches = 0;
+	for (integer i = 0; i < m; ++i)
+	{
+		integer correct = 0;
+		for (const Point& point : pointSet)
+		{
+			if (allGreaterEqual(point, minSet[i]) &&
+				allLessEqual(point, maxSet[i]))
+			{
+				++correct;
+			}
+		}
+
+		if (countSet[i] != correct ||
+			countRange(tree, minSet[i], maxSet[i]) != correct)
+		{
+			++mismatches;
+		}
+	}
+
+	REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Dynamic_RangeTree (RangeTree)")
+{
+	static constexpr int N = 2;
+	using Tree = Dynamic_RangeTree<Settings<N>>;
+	using Point = typename Tree::Point;
+	using Point_ConstIterator = typename Tree::Point_ConstIterator;
+
+	auto randomPoint = [&]()
+	{
+		Point point;
+		for (integer k = 0; k < N; ++k)
+		{
+			point[k] = randomInteger(10);
+		}
+		return point;
+	};
+
+	Tree tree(N);
+	REQUIRE(tree.empty());
+	REQUIRE(searchRange(tree, Point(0), Point(10)) == 0);
+	REQUIRE(!tree.erase(Point(0)));
+
+	// The points in the tree, for brute-force checking.
+	std::vector<Point> correctSet;
+
+	integer mismatches = 0;
+	integer maxLevels = 0;
+	for (integer i = 0; i < 3000; ++i)
+	{
+		integer action = randomInteger(4);
+		if (action == 0)
+		{
+			// Insert many points at once.
+			std::vector<Point> pointSet;
+			integer m = randomInteger(20);
+			for (integer j = 0; j < m; ++j)
+			{
+				pointSet.emplace_back(randomPoint());
+				correctSet.emplace_back(pointSet.back());
+			}
+			tree.insertSet(pointSet);
+		}
+		else if (action == 1)
+		{
+			Point point = randomPoint();
+			tree.insert(point);
+			correctSet.emplace_back(point);
+		}
+		else
+		{
+			// The point may not be in the tree.
+			Point point = randomPoint();
+			auto iter = ranges::find(correctSet, point);
+			bool found = (iter != correctSet.end());
+			if (found)
+			{
+				correctSet.erase(iter);
+			}
+			if (tree.erase(point) != found)
+			{
+				++mismatches;
+			}
+		}
+
+		REQUIRE(tree.size() == correctSet.size());
+		maxLevels = std::max(maxLevels, (integer)tree.levelSet().size());
+
+		Point min = randomPoint();
+		Point max = min + randomInteger(6);
+
+		integer correct = 0;
+		for (const Point& point : correctSet)
+		{
+			if (allGreaterEqual(point, min) &&
+				allLessEqual(point, max))
+			{
+				++correct;
+			}
+		}
+
+		std::vector<Point> resultSet;
+		integer count = searchRange(tree, min, max,
+			[&](const Point_ConstIterator& point)
+			{
+				resultSet.emplace_back(*point);
+			});
+
+		if (count != correct ||
+			resultSet.size() != correct ||
+			countRange(tree, min, max) != correct)
+		{
+			++mismatches;
+		}
+
+		for (const Point& point : resultSet)
+		{
+			if (!allGreaterEqual(point, min) ||
+				!allLessEqual(point, max))
+			{
+				++mismatches;
+			}
+		}
+	}
+
+	REQUIRE(mismatches == 0);
+
+	// The levels grow exponentially.
+	REQUIRE(maxLevels <= 16);
+
+	tree.compact();
+	REQUIRE(tree.size() == correctSet.size());
+	REQUIRE(searchRange(tree, Point(0), Point(10)) == correctSet.size());
+
+	tree.clear();
+	REQUIRE(tree.empty());
+}
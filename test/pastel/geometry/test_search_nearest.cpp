@@ -6,6 +6,8 @@
 
 #include "pastel/geometry/search_nearest.h"
 #include "pastel/geometry/count_nearest.h"
+#include "pastel/geometry/search_all_nearest.h"
+#include "pastel/geometry/count_all_nearest.h"
 #include "pastel/geometry/nearestset/kdtree_nearestset.h"
 #include "pastel/geometry/nearestset/bruteforce_nearestset.h"
 
@@ -493,3 +495,88 @@ TEST_CASE("search_nearest gaussian tdtree")
 		testGaussian(pointSet, aCreate, bCreate);
 	}
 }
+
+TEST_CASE("search_all_nearest (PointKdTree)")
+{
+	static constexpr int N = 3;
+	using PointSet = std::vector<Vector<dreal, N>>;
+
+	integer n = 2000;
+	PointSet pointSet;
+	pointSet.reserve(n);
+	for (integer i = 0; i < n; ++i)
+	{
+		pointSet.emplace_back(
+			randomGaussianVector<dreal, N>());
+	}
+
+	auto create = CreatePointKdTree<DepthFirst_SearchAlgorithm_PointKdTree>();
+	auto dataSet = create.createDataSet(pointSet).first;
+	auto nearestSet = create.createNearestSet(dataSet);
+
+	integer k = 5;
+	auto norm = Euclidean_Norm<dreal>();
+	auto maxDistance2 = norm[0.25];
+
+	auto resultSet = searchAllNearest(
+		nearestSet,
+		pointSet,
+		PASTEL_TAG(kNearest), k,
+		PASTEL_TAG(norm), norm,
+		PASTEL_TAG(maxDistance2), maxDistance2);
+	REQUIRE(resultSet.size() == n * k);
+
+	auto countSet = countAllNearest(
+		nearestSet,
+		pointSet,
+		PASTEL_TAG(norm), norm,
+		PASTEL_TAG(maxDistance2), maxDistance2);
+	REQUIRE(countSet.size() == n);
+
+	using Distance = decltype(norm());
+	using PointId = PointSet_PointId<decltype(nearestSet)>;
+	std::vector<std::pair<Distance, PointId>> correctSet;
+
+	integer mismatches = 0;
+	for (integer i = 0; i < n; ++i)
+	{
+		correctSet.clear();
+		searchNearest(
+			nearestSet,
+			pointSet[i],
+			PASTEL_TAG(report), emplaceBackOutput(correctSet),
+			PASTEL_TAG(kNearest), k,
+			PASTEL_TAG(norm), norm,
+			PASTEL_TAG(maxDistance2), maxDistance2);
+
+		for (integer j = 0; j < k; ++j)
+		{
+			const auto& result = resultSet[i * k + j];
+			if (j < correctSet.size())
+			{
+				if (result.first != correctSet[j].first ||
+					result.second != correctSet[j].second)
+				{
+					++mismatches;
+				}
+			}
+			else if (result.second != *nearestSet.begin())
+			{
+				++mismatches;
+			}
+		}
+
+		integer correctCount = countNearest(
+			nearestSet,
+			pointSet[i],
+			PASTEL_TAG(norm), norm,
+			PASTEL_TAG(maxDistance2), maxDistance2);
+		if (countSet[i] != correctCount)
+		{
+			++mismatches;
+		}
+	}
+
+	REQUIRE(mismatches == 0);
+}
+
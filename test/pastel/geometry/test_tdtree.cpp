@@ -6,6 +6,7 @@
 #include "pastel/geometry/tdtree/tdtree.h"
 
 #include "pastel/geometry/search_nearest.h"
+#include "pastel/geometry/search_all_temporal_nearest.h"
 #include "pastel/geometry/nearestset/kdtree_nearestset.h"
 #include "pastel/geometry/nearestset/bruteforce_nearestset.h"
 #include "pastel/geometry/distance/distance_point_point.h"
@@ -195,3 +196,100 @@ TEST_CASE("Linear (TdTree)")
 		}
 	}
 }
+
+TEST_CASE("searchAllTemporalNearest (TdTree)")
+{
+	integer n = 1500;
+	std::vector<Point> pointSet;
+	std::vector<dreal> timeSet;
+	for (integer i = 0; i < n; ++i)
+	{
+		pointSet.emplace_back(randomGaussianVector<dreal, 2>());
+		// Irregular times, with some equal times.
+		timeSet.push_back(std::floor(random<dreal>() * 500));
+	}
+
+	Tree tree(pointSet, PASTEL_TAG(timeSet), timeSet);
+	REQUIRE(!tree.simple());
+
+	integer k = 4;
+	dreal timeWindow = 20;
+	auto norm = Euclidean_Norm<dreal>();
+	auto maxDistance2 = norm[0.5];
+
+	auto resultSet = searchAllTemporalNearest(
+		tree, timeWindow,
+		PASTEL_TAG(kNearest), k,
+		PASTEL_TAG(maxDistance2), maxDistance2,
+		PASTEL_TAG(blockSize), 100);
+	REQUIRE(resultSet.size() == n * k);
+
+	// The serial search gives the same result.
+	REQUIRE(resultSet == searchAllTemporalNearest(
+		tree, timeWindow,
+		PASTEL_TAG(kNearest), k,
+		PASTEL_TAG(maxDistance2), maxDistance2,
+		PASTEL_TAG(parallel), false));
+
+	// Count within the distance to the k:th neighbor.
+	auto countDistance2 = [&](integer i)
+	{
+		return std::min(resultSet[i * k + k - 1].first, maxDistance2);
+	};
+
+	auto countSet = countAllTemporalNearest(
+		tree, timeWindow,
+		PASTEL_TAG(queryMaxDistance2), countDistance2);
+	REQUIRE(countSet.size() == n);
+
+	auto begin = tree.begin();
+	std::vector<dreal> distanceSet;
+
+	integer mismatches = 0;
+	for (integer i = 0; i < n; ++i)
+	{
+		distanceSet.clear();
+		for (integer j = 0; j < n; ++j)
+		{
+			if (j != i &&
+				std::abs(begin[j].time() - begin[i].time()) <= timeWindow)
+			{
+				dreal distance = dot(begin[j].point() - begin[i].point());
+				if (distance < ~maxDistance2)
+				{
+					distanceSet.push_back(distance);
+				}
+			}
+		}
+		std::sort(distanceSet.begin(), distanceSet.end());
+
+		for (integer j = 0; j < k; ++j)
+		{
+			const auto& result = resultSet[i * k + j];
+			if (j < distanceSet.size())
+			{
+				if (~result.first != distanceSet[j] ||
+					std::abs(result.second->time() - begin[i].time()) > timeWindow ||
+					result.second == begin + i)
+				{
+					++mismatches;
+				}
+			}
+			else if (result.second != tree.end())
+			{
+				++mismatches;
+			}
+		}
+
+		// The points strictly nearer than the k:th neighbor.
+		integer correctCount = std::lower_bound(
+			distanceSet.begin(), distanceSet.end(),
+			~countDistance2(i)) - distanceSet.begin();
+		if (countSet[i] != correctCount)
+		{
+			++mismatches;
+		}
+	}
+
+	REQUIRE(mismatches == 0);
+}
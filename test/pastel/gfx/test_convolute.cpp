@@ -77,3 +77,159 @@ TEST_CASE("Convolute3 (Convolute3)")
 		fitColor);
 }
 
+
+namespace
+{
+
+	template <typename Element, int N>
+	Array<Element, N> convoluteWith(
+		const Array<Element, N>& input,
+		const Array<real32, N>& filter,
+		Convolution_Policy policy)
+	{
+		Array<Element, N> output(input.extent(), Element(0));
+		convolute(constArrayView(input),
+			constArrayView(filter),
+			arrayView(output),
+			PASTEL_TAG(policy), policy);
+		return output;
+	}
+
+	dreal elementError(real32 left, real32 right)
+	{
+		return std::abs(left - right);
+	}
+
+	dreal elementError(const Color& left, const Color& right)
+	{
+		return max(abs(left - right));
+	}
+
+	template <typename Element, int N>
+	dreal maxError(
+		const Array<Element, N>& left,
+		const Array<Element, N>& right)
+	{
+		dreal error = 0;
+		for (integer i = 0;i < left.size();++i)
+		{
+			error = std::max(error, elementError(left(i), right(i)));
+		}
+		return error;
+	}
+
+	template <typename Element, int N>
+	void testPolicies(
+		const Vector<integer, N>& extent,
+		const Vector<integer, N>& filterExtent,
+		bool separable)
+	{
+		Array<Element, N> input(extent, Element(0));
+		for (integer i = 0;i < input.size();++i)
+		{
+			// Leave some elements zero, so that they are skipped.
+			if (random<dreal>() < 0.8)
+			{
+				input(i) = Element(random<real32>());
+			}
+		}
+
+		Array<real32, N> filter(filterExtent);
+		if (separable)
+		{
+			std::vector<std::vector<real32>> factorSet(N);
+			for (integer axis = 0;axis < N;++axis)
+			{
+				for (integer j = 0;j < filterExtent[axis];++j)
+				{
+					factorSet[axis].push_back(random<real32>(-1, 1));
+				}
+			}
+
+			for (integer i = 0;i < filter.size();++i)
+			{
+				Vector<integer, N> position = filter.position(i);
+				filter(i) = 1;
+				for (integer axis = 0;axis < N;++axis)
+				{
+					filter(i) *= factorSet[axis][position[axis]];
+				}
+			}
+		}
+		else
+		{
+			for (integer i = 0;i < filter.size();++i)
+			{
+				filter(i) = random<real32>(-1, 1);
+			}
+		}
+
+		Array<Element, N> expected =
+			convoluteWith(input, filter, Convolution_Policy::Direct);
+
+		Array<Element, N> fftOutput =
+			convoluteWith(input, filter, Convolution_Policy::Fft);
+		REQUIRE(maxError(fftOutput, expected) < 1e-3);
+
+		if (separable)
+		{
+			Array<Element, N> separableOutput =
+				convoluteWith(input, filter, Convolution_Policy::Separable);
+			REQUIRE(maxError(separableOutput, expected) < 1e-3);
+		}
+
+		Array<Element, N> automaticOutput =
+			convoluteWith(input, filter, Convolution_Policy::Automatic);
+		REQUIRE(maxError(automaticOutput, expected) < 1e-3);
+	}
+
+}
+
+TEST_CASE("Policies (Convolute)")
+{
+	testPolicies<real32, 2>(Vector2i(17, 23), Vector2i(5, 4), false);
+	testPolicies<real32, 2>(Vector2i(17, 23), Vector2i(5, 4), true);
+	testPolicies<real32, 2>(Vector2i(40, 9), Vector2i(7, 13), true);
+	testPolicies<real32, 2>(Vector2i(300, 20), Vector2i(9, 3), false);
+	testPolicies<real32, 2>(Vector2i(3, 4), Vector2i(1, 1), true);
+	testPolicies<Color, 2>(Vector2i(31, 12), Vector2i(6, 5), false);
+	testPolicies<Color, 2>(Vector2i(31, 12), Vector2i(6, 5), true);
+	testPolicies<real32, 3>(Vector3i(10, 8, 9), Vector3i(3, 4, 5), false);
+	testPolicies<real32, 3>(Vector3i(10, 8, 9), Vector3i(3, 4, 5), true);
+}
+
+TEST_CASE("Process (Convolute)")
+{
+	Array<real32, 2> input(Vector2i(20, 20), 0);
+	for (integer i = 0;i < input.size();++i)
+	{
+		input(i) = random<real32>();
+	}
+
+	Array<real32, 2> filter(Vector2i(5, 5), 1);
+
+	// Only the elements greater than 1/2 contribute.
+	auto process = [](real32 x) {return x > 0.5;};
+
+	Array<real32, 2> processed(input);
+	for (integer i = 0;i < input.size();++i)
+	{
+		if (!process(input(i)))
+		{
+			processed(i) = 0;
+		}
+	}
+
+	Array<real32, 2> expected(input.extent(), 0);
+	convolute(constArrayView(processed), constArrayView(filter), arrayView(expected),
+		PASTEL_TAG(policy), Convolution_Policy::Direct);
+
+	for (auto policy : {Convolution_Policy::Direct, Convolution_Policy::Separable, Convolution_Policy::Fft})
+	{
+		Array<real32, 2> output(input.extent(), 0);
+		convolute(constArrayView(input), constArrayView(filter), arrayView(output),
+			PASTEL_TAG(process), process,
+			PASTEL_TAG(policy), policy);
+		REQUIRE(maxError(output, expected) < 1e-3);
+	}
+}
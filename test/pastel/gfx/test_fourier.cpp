@@ -281,3 +281,193 @@ TEST_CASE("Simple (Fourier)")
 		REQUIRE(testHadamard(input));
 	}
 }
+
+namespace
+{
+
+	std::vector<std::complex<dreal>> naiveDft(
+		const std::vector<std::complex<dreal>>& input,
+		bool inverse)
+	{
+		integer n = input.size();
+		std::vector<std::complex<dreal>> output(n);
+		for (integer k = 0;k < n;++k)
+		{
+			std::complex<dreal> sum = 0;
+			for (integer j = 0;j < n;++j)
+			{
+				dreal angle = (inverse ? 2 : -2) * constantPi<dreal>() * 
+					((j * k) % n) / n;
+				sum += input[j] * std::complex<dreal>(std::cos(angle), std::sin(angle));
+			}
+			output[k] = inverse ? sum / (dreal)n : sum;
+		}
+		return output;
+	}
+
+	std::vector<std::complex<dreal>> randomSignal(integer n)
+	{
+		std::vector<std::complex<dreal>> input;
+		input.reserve(n);
+		for (integer j = 0;j < n;++j)
+		{
+			input.emplace_back(random<dreal>(-1, 1), random<dreal>(-1, 1));
+		}
+		return input;
+	}
+
+	dreal maxError(
+		const std::vector<std::complex<dreal>>& a,
+		const std::vector<std::complex<dreal>>& b)
+	{
+		dreal error = 0;
+		for (integer i = 0;i < a.size();++i)
+		{
+			error = std::max(error, std::abs(a[i] - b[i]));
+		}
+		return error;
+	}
+
+}
+
+TEST_CASE("Arbitrary size (Fourier)")
+{
+	std::vector<integer> sizeSet;
+	for (integer n = 1;n <= 64;++n)
+	{
+		sizeSet.push_back(n);
+	}
+	for (integer n : {97, 100, 121, 210, 343, 1000, 1009, 2310})
+	{
+		sizeSet.push_back(n);
+	}
+
+	for (integer n : sizeSet)
+	{
+		std::vector<std::complex<dreal>> input = randomSignal(n);
+		std::vector<std::complex<dreal>> output(n);
+
+		dft(range(input.begin(), input.end()),
+			range(output.begin(), output.end()));
+		{
+			INFO(n);
+			REQUIRE(maxError(output, naiveDft(input, false)) < 1e-9 * n);
+		}
+
+		inverseDft(
+			range(input.begin(), input.end()),
+			range(output.begin(), output.end()));
+		{
+			INFO(n);
+			REQUIRE(maxError(output, naiveDft(input, true)) < 1e-9);
+		}
+
+		unitaryDft(
+			range(input.begin(), input.end()),
+			range(output.begin(), output.end()));
+		inverseUnitaryDft(range(output.begin(), output.end()));
+		{
+			INFO(n);
+			REQUIRE(maxError(output, input) < 1e-9);
+		}
+	}
+}
+
+TEST_CASE("FourierPlan (Fourier)")
+{
+	for (integer n : {1, 12, 35, 49, 64, 97, 2 * 11 * 13})
+	{
+		FourierPlan<dreal> plan(n);
+		REQUIRE(plan.n() == n);
+		REQUIRE(plan.bluestein() == (n % 11 == 0 || n == 97));
+
+		std::vector<std::complex<dreal>> input = randomSignal(n);
+		std::vector<std::complex<dreal>> output(n);
+
+		// The plan can be reused.
+		for (integer i = 0;i < 2;++i)
+		{
+			plan.dft(input.data(), output.data());
+			REQUIRE(maxError(output, naiveDft(input, false)) < 1e-9 * n);
+		}
+
+		// The transform can be computed in-place.
+		plan.dft(output.data(), output.data(), true);
+		for (auto& x : output)
+		{
+			x /= (dreal)n;
+		}
+		REQUIRE(maxError(output, input) < 1e-9);
+	}
+
+	REQUIRE(fourierPlan<dreal>(100) == fourierPlan<dreal>(100));
+
+	// The least recently used plans are evicted,
+	// but stay valid for as long as they are held.
+	auto plan = fourierPlan<dreal>(97);
+	for (integer n = 1;n <= FourierPlan_::CachedPlans;++n)
+	{
+		fourierPlan<dreal>(1000 + n);
+	}
+	REQUIRE(fourierPlan<dreal>(97) != plan);
+	REQUIRE(plan->n() == 97);
+}
+
+TEST_CASE("Arbitrary size (Cosine)")
+{
+	for (integer n = 1;n <= 40;++n)
+	{
+		std::vector<dreal> input;
+		input.reserve(n);
+		for (integer j = 0;j < n;++j)
+		{
+			input.push_back(random<dreal>(-1, 1));
+		}
+
+		std::vector<dreal> output(n);
+		dct(range(input.begin(), input.end()),
+			range(output.begin(), output.end()));
+		for (integer k = 0;k < n;++k)
+		{
+			dreal sum = 0;
+			for (integer j = 0;j < n;++j)
+			{
+				sum += input[j] * 
+					std::cos(constantPi<dreal>() * k * (2 * j + 1) / (2 * n));
+			}
+			INFO(n);
+			INFO(k);
+			REQUIRE(std::abs(output[k] - sum) < 1e-9 * n);
+		}
+
+		INFO(n);
+		REQUIRE(testDct(range(input.begin(), input.end())));
+	}
+}
+
+TEST_CASE("Complex inverse (Cosine)")
+{
+	for (integer n : {1, 2, 3, 4, 7, 8, 30})
+	{
+		std::vector<std::complex<dreal>> input = randomSignal(n);
+		std::vector<std::complex<dreal>> output(n);
+
+		complexDct(
+			range(input.begin(), input.end()),
+			range(output.begin(), output.end()));
+		inverseComplexDct(range(output.begin(), output.end()));
+		{
+			INFO(n);
+			REQUIRE(maxError(output, input) < 1e-9);
+		}
+
+		unitaryDct(
+			range(input.begin(), input.end()),
+			range(output.begin(), output.end()));
+		inverseUnitaryDct(range(output.begin(), output.end()));
+		{
+			INFO(n);
+			REQUIRE(maxError(output, input) < 1e-9);
+		}
+	}
+}
@@ -0,0 +1,151 @@
+// Description: Testing for multi-dimensional Fourier transforms
+// DocumentationOf: fourier_transform.txt
+
+#include "test/test_init.h"
+
+#include "pastel/gfx/transform/fourier_transform.h"
+#include "pastel/gfx/transform/fourier_transform_n.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/random.h"
+#include "pastel/sys/subarray_for_each.h"
+
+namespace
+{
+
+	using Complex = std::complex<dreal>;
+
+	template <int N>
+	Array<Complex, N> randomArray(const Vector<integer, N>& extent)
+	{
+		Array<Complex, N> result(extent);
+		for (integer i = 0;i < result.size();++i)
+		{
+			result(i) = Complex(random<dreal>(-1, 1), random<dreal>(-1, 1));
+		}
+		return result;
+	}
+
+	template <typename Left_Range, typename Right_Range>
+	dreal maxError(const Left_Range& left, const Right_Range& right)
+	{
+		dreal error = 0;
+		auto iter = right.begin();
+		for (auto&& x : left)
+		{
+			error = std::max(error, (dreal)std::abs(x - *iter));
+			++iter;
+		}
+		return error;
+	}
+
+	template <int N>
+	void testComplex(const Vector<integer, N>& extent)
+	{
+		Array<Complex, N> input = randomArray(extent);
+
+		// The reference transforms the rows one axis at a time.
+		Array<Complex, N> expected(input);
+		forEachRowOnAllAxes(expected(), Dft());
+
+		for (bool parallel : {false, true})
+		{
+			for (integer blockSize : {1, 3, 16})
+			{
+				Array<Complex, N> output(input);
+				fftN(output(),
+					PASTEL_TAG(parallel), parallel,
+					PASTEL_TAG(blockSize), blockSize);
+				REQUIRE(maxError(output.range(), expected.range()) < 1e-9 * input.size());
+
+				inverseFftN(output(), PASTEL_TAG(parallel), parallel);
+				REQUIRE(maxError(output.range(), input.range()) < 1e-9);
+			}
+		}
+
+		Array<Complex, N> output(input);
+		fftN(output(), PASTEL_TAG(unitary), true);
+		inverseFftN(output(), PASTEL_TAG(unitary), true);
+		REQUIRE(maxError(output.range(), input.range()) < 1e-9);
+	}
+
+	template <int N>
+	void testReal(const Vector<integer, N>& extent)
+	{
+		Array<dreal, N> input(extent);
+		Array<Complex, N> complexInput(extent);
+		for (integer i = 0;i < input.size();++i)
+		{
+			input(i) = random<dreal>(-1, 1);
+			complexInput(i) = input(i);
+		}
+
+		fftN(complexInput());
+
+		Vector<integer, N> halfExtent = extent;
+		halfExtent[0] = extent[0] / 2 + 1;
+
+		Array<Complex, N> output(halfExtent);
+		realFftN(input(), output());
+
+		// The half-spectrum is the first part of the full spectrum.
+		REQUIRE(maxError(
+			output.range(),
+			complexInput(Vector<integer, N>(0), halfExtent).range()) < 1e-9 * input.size());
+
+		Array<dreal, N> result(extent);
+		inverseRealFftN(output(), result());
+		REQUIRE(maxError(result.range(), input.range()) < 1e-9);
+
+		realFftN(input(), output(), PASTEL_TAG(unitary), true);
+		inverseRealFftN(output(), result(), PASTEL_TAG(unitary), true);
+		REQUIRE(maxError(result.range(), input.range()) < 1e-9);
+	}
+
+}
+
+TEST_CASE("fftN (fftN)")
+{
+	testComplex(Vector<integer, 2>(12, 1));
+	testComplex(Vector<integer, 2>(8, 5));
+	testComplex(Vector<integer, 2>(1, 7));
+	testComplex(Vector<integer, 3>(6, 11, 4));
+	testComplex(Vector<integer, 4>(3, 4, 5, 2));
+}
+
+TEST_CASE("fftN on a sub-array (fftN)")
+{
+	Array<Complex, 2> input = randomArray(Vector<integer, 2>(9, 12));
+	Array<Complex, 2> output(input);
+
+	// Every other column, in reverse order.
+	Vector<integer, 2> min(8, 1);
+	Vector<integer, 2> max(-1, 11);
+	Vector<integer, 2> delta(-2, 1);
+
+	Array<Complex, 2> expected(input(min, max, delta).extent());
+	expected() = input(min, max, delta);
+	forEachRowOnAllAxes(expected(), Dft());
+
+	fftN(output(min, max, delta));
+
+	Array<Complex, 2> result(expected.extent());
+	result() = output(min, max, delta);
+	REQUIRE(maxError(result.range(), expected.range()) < 1e-9);
+
+	// The elements outside the sub-array are not modified.
+	REQUIRE(output(7, 4) == input(7, 4));
+	REQUIRE(output(2, 0) == input(2, 0));
+}
+
+TEST_CASE("realFftN (fftN)")
+{
+	testReal(Vector<integer, 2>(1, 1));
+	testReal(Vector<integer, 2>(2, 1));
+	testReal(Vector<integer, 2>(16, 1));
+	testReal(Vector<integer, 2>(15, 1));
+	testReal(Vector<integer, 2>(8, 6));
+	testReal(Vector<integer, 2>(7, 6));
+	testReal(Vector<integer, 3>(10, 3, 4));
+	testReal(Vector<integer, 3>(9, 1, 5));
+}
@@ -0,0 +1,227 @@
+// Description: Testing for resampling
+// DocumentationOf: resampling.h
+
+#include "test/test_init.h"
+
+#include "pastel/gfx/resampling.h"
+#include "pastel/gfx/filter.h"
+#include "pastel/gfx/color.h"
+
+#include "pastel/sys/array.h"
+#include "pastel/sys/extender/indexextenders.h"
+#include "pastel/sys/random.h"
+#include "pastel/sys/view/arrayview.h"
+#include "pastel/sys/view/rowview.h"
+#include "pastel/sys/view/view_visit_more2.h"
+
+namespace
+{
+
+	//! The line-by-line resampling, computing the weights on the fly.
+	template <typename Element, typename Input_ConstView, typename Output_View>
+	void referenceResample(
+		const ConstView<1, Element, Input_ConstView>& input,
+		const ArrayExtender<1, Element>& arrayExtender,
+		const ConstTableFilterPtr& filter,
+		const View<1, Element, Output_View>& output)
+	{
+		integer inputWidth = input.width();
+		integer outputWidth = output.width();
+
+		dreal xStep = (dreal)inputWidth / outputWidth;
+		dreal filterFactor = (xStep > 1) ? xStep : 1;
+		dreal invFilterFactor = inverse(filterFactor);
+		dreal filterRadius = filter->radius() * filterFactor;
+		dreal xFilter = 0.5 * xStep;
+
+		integer introEnd =
+			clamp(
+			(integer)std::ceil((filterRadius - xFilter) / xStep) + 1,
+			0, outputWidth);
+		integer mainEnd =
+			clamp(outputWidth - introEnd,
+			introEnd, outputWidth);
+
+		for (integer x = 0;x < outputWidth;++x)
+		{
+			integer rangeBegin = toPixelSpanPoint(xFilter - filterRadius);
+			integer rangeEnd = toPixelSpanPoint(xFilter + filterRadius);
+			dreal xLocalFilter = (xFilter - (rangeBegin + 0.5)) * invFilterFactor;
+
+			Element result(0);
+			dreal sumWeights = 0;
+			for (integer i = rangeBegin; i < rangeEnd;++i)
+			{
+				dreal weight = filter->evaluateInRange(xLocalFilter);
+				if (x >= introEnd && x < mainEnd)
+				{
+					Element in = input(i);
+					result += weight * in;
+				}
+				else
+				{
+					result += weight * arrayExtender(input, i);
+				}
+				xLocalFilter -= invFilterFactor;
+				sumWeights += weight;
+			}
+
+			output(x) = result / sumWeights;
+			xFilter += xStep;
+		}
+	}
+
+	template <typename Element>
+	Array<Element, 2> referenceResample(
+		const Array<Element, 2>& input,
+		const ArrayExtender<2, Element>& arrayExtender,
+		const ConstTableFilterPtr& filter,
+		const Vector<integer, 2>& extent)
+	{
+		// Resample the axes in the order chosen by resample().
+		dreal value0 = (dreal)extent[0] / input.extent()[0];
+		dreal value1 = (dreal)extent[1] / input.extent()[1];
+		integer first = (value1 < value0) ? 1 : 0;
+
+		Vector<integer, 2> tempExtent = input.extent();
+		tempExtent[first] = extent[first];
+		Array<Element, 2> temp(tempExtent);
+		Array<Element, 2> result(extent);
+
+		ArrayExtender<1, Element> extender1(
+			arrayExtender.extender(0), arrayExtender.border());
+
+		visitRows(constArrayView(input), arrayView(temp), first,
+			[&](auto&& left, auto&& right)
+			{
+				referenceResample(left, extender1, filter, right);
+			});
+
+		visitRows(constArrayView(temp), arrayView(result), 1 - first,
+			[&](auto&& left, auto&& right)
+			{
+				referenceResample(left, extender1, filter, right);
+			});
+
+		return result;
+	}
+
+	template <typename Element>
+	Array<Element, 2> randomImage(const Vector<integer, 2>& extent)
+	{
+		Array<Element, 2> image(extent);
+		for (integer i = 0;i < image.size();++i)
+		{
+			image(i) = Element(random<real32>());
+		}
+		return image;
+	}
+
+	template <typename Element>
+	Array<Element, 2> resampleWith(
+		const Array<Element, 2>& input,
+		const ArrayExtender<2, Element>& arrayExtender,
+		const ConstTableFilterPtr& filter,
+		const Vector<integer, 2>& extent,
+		bool parallel,
+		bool deterministic)
+	{
+		Array<Element, 2> result(extent);
+		resampleTable<Element>(
+			constArrayView(input), arrayExtender, filter, arrayView(result),
+			PASTEL_TAG(parallel), parallel,
+			PASTEL_TAG(deterministic), deterministic);
+		return result;
+	}
+
+	real32 elementError(real32 left, real32 right)
+	{
+		return std::abs(left - right);
+	}
+
+	real32 elementError(const Color& left, const Color& right)
+	{
+		return max(abs(left - right));
+	}
+
+	template <typename Element>
+	void testResample(
+		const Vector<integer, 2>& inputExtent,
+		const Vector<integer, 2>& outputExtent,
+		const ArrayExtender<2, Element>& arrayExtender)
+	{
+		Array<Element, 2> input = randomImage<Element>(inputExtent);
+		ConstTableFilterPtr filter = tableFilter(lanczosFilter(2));
+
+		Array<Element, 2> expected = referenceResample(
+			input, arrayExtender, filter, outputExtent);
+
+		for (bool parallel : {false, true})
+		{
+			// The deterministic mode is bit-identical to the
+			// line-by-line resampling.
+			Array<Element, 2> exact = resampleWith(
+				input, arrayExtender, filter, outputExtent, parallel, true);
+			bool identical = true;
+			for (integer i = 0;i < exact.size();++i)
+			{
+				identical = identical && (elementError(exact(i), expected(i)) == 0);
+			}
+			REQUIRE(identical);
+
+			Array<Element, 2> fast = resampleWith(
+				input, arrayExtender, filter, outputExtent, parallel, false);
+			real32 error = 0;
+			for (integer i = 0;i < fast.size();++i)
+			{
+				error = std::max(error, elementError(fast(i), expected(i)));
+			}
+			REQUIRE(error < 1e-4);
+		}
+	}
+
+}
+
+TEST_CASE("resample (resample)")
+{
+	ArrayExtender<2, real32> clampArrayExtender(clampExtender());
+	ArrayExtender<2, real32> borderArrayExtender(ConstIndexExtenderPtr(), 0.5);
+
+	testResample<real32>(Vector<integer, 2>(64, 48), Vector<integer, 2>(16, 20), clampArrayExtender);
+	testResample<real32>(Vector<integer, 2>(31, 17), Vector<integer, 2>(70, 9), clampArrayExtender);
+	testResample<real32>(Vector<integer, 2>(40, 33), Vector<integer, 2>(13, 80), borderArrayExtender);
+	testResample<real32>(Vector<integer, 2>(1, 5), Vector<integer, 2>(3, 2), clampArrayExtender);
+
+	testResample<Color>(Vector<integer, 2>(50, 64), Vector<integer, 2>(25, 32),
+		ArrayExtender<2, Color>(repeatExtender()));
+	testResample<Color>(Vector<integer, 2>(20, 10), Vector<integer, 2>(45, 33),
+		ArrayExtender<2, Color>(mirrorExtender()));
+}
+
+TEST_CASE("resample 1D (resample)")
+{
+	Array<real32, 1> input(Vector<integer, 1>(37));
+	for (integer i = 0;i < input.size();++i)
+	{
+		input(i) = random<real32>();
+	}
+
+	Array<real32, 1> exact(Vector<integer, 1>(15));
+	Array<real32, 1> fast(Vector<integer, 1>(15));
+	resample<real32>(constArrayView(input), clampExtender(), lanczosFilter(2),
+		arrayView(exact), PASTEL_TAG(deterministic), true);
+	resample<real32>(constArrayView(input), clampExtender(), lanczosFilter(2),
+		arrayView(fast));
+
+	// A constant signal is preserved.
+	Array<real32, 1> constant(Vector<integer, 1>(37), 0.25);
+	Array<real32, 1> result(Vector<integer, 1>(15));
+	resample<real32>(constArrayView(constant), clampExtender(), lanczosFilter(2),
+		arrayView(result), PASTEL_TAG(blurFactor), 2);
+
+	for (integer i = 0;i < exact.size();++i)
+	{
+		REQUIRE(std::abs(exact(i) - fast(i)) < 1e-5);
+		REQUIRE(std::abs(result(i) - 0.25) < 1e-5);
+	}
+}
@@ -4,6 +4,10 @@
 #include "test/test_init.h"
 
 #include "pastel/math/distance.h"
+#include "pastel/math/norm.h"
+#include "pastel/sys/random.h"
+
+#include <vector>
 
 template <typename Distance>
 void testBasic()
@@ -104,3 +108,58 @@ TEST_CASE("Distance (Product)")
 	REQUIRE(~distance == std::max(4*4 + 2*2, 100 + 10));
 }
 
+
+template <typename Norm>
+void testBlock()
+{
+	Norm norm;
+	using Distance = decltype(norm());
+
+	integer d = 5;
+	for (integer n : {0, 1, 15, 16, 37})
+	{
+		// Store the points in structure-of-arrays 
+		// layout, with some slack between the axes.
+		integer stride = n + 3;
+		std::vector<dreal> coordinateSet(d * stride);
+		for (auto& x : coordinateSet)
+		{
+			x = random<dreal>() - 0.5;
+		}
+
+		Vector<dreal> searchPoint(ofDimension(d));
+		for (integer axis = 0; axis < d; ++axis)
+		{
+			searchPoint[axis] = random<dreal>() - 0.5;
+		}
+
+		std::vector<dreal> distanceSet(n);
+		blockDistance(
+			norm, searchPoint,
+			CoordinateBlock<dreal>{coordinateSet.data(), stride, n},
+			distanceSet.data());
+
+		for (integer j = 0; j < n; ++j)
+		{
+			Distance distance = norm();
+			for (integer axis = 0; axis < d; ++axis)
+			{
+				distance.set(axis, 
+					searchPoint[axis] - coordinateSet[axis * stride + j]);
+			}
+			REQUIRE(norm[distanceSet[j]] == distance);
+		}
+	}
+}
+
+TEST_CASE("Distance (Block)")
+{
+	PASTEL_STATIC_ASSERT(HasBlockDistance<Euclidean_Norm<dreal>>);
+	PASTEL_STATIC_ASSERT(HasBlockDistance<Manhattan_Norm<dreal>>);
+	PASTEL_STATIC_ASSERT(HasBlockDistance<Maximum_Norm<dreal>>);
+	PASTEL_STATIC_ASSERT(!HasBlockDistance<Minkowski_Norm<dreal>>);
+
+	testBlock<Euclidean_Norm<dreal>>();
+	testBlock<Manhattan_Norm<dreal>>();
+	testBlock<Maximum_Norm<dreal>>();
+}
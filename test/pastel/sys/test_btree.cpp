@@ -0,0 +1,263 @@
+// Description: Testing for B-tree
+// DocumentationOf: btree.h
+
+#include "test/test_init.h"
+
+#include <pastel/sys/btree.h>
+#include <pastel/sys/hashed_tree.h>
+#include <pastel/sys/random/random_integer.h>
+
+#include <map>
+#include <set>
+
+namespace
+{
+
+	//! Propagates the number of elements, and the sum of the data.
+	template <typename Settings_>
+	class Counting_Customization
+		: public Empty_RedBlackTree_Customization<Settings_>
+	{
+	protected:
+		using Fwd = RedBlackTree_Fwd<Settings_>;
+		PASTEL_FWD(Iterator);
+		PASTEL_FWD(Propagation);
+
+		Counting_Customization() {}
+
+		void updatePropagation(
+			const Iterator& iter,
+			Propagation& propagation)
+		{
+			propagation.first =
+				iter.left().propagation().first + 1 +
+				iter.right().propagation().first;
+			propagation.second =
+				iter.left().propagation().second + iter.data() +
+				iter.right().propagation().second;
+		}
+
+	private:
+		Counting_Customization(const Counting_Customization& that) = delete;
+		Counting_Customization(Counting_Customization&& that) = delete;
+		Counting_Customization& operator=(Counting_Customization) = delete;
+	};
+
+	template <bool MultipleKeys, integer Capacity_>
+	class Small_Settings
+		: public RedBlackTree_Set_Settings<integer, integer, LessThan,
+		std::pair<integer, integer>, Empty, MultipleKeys>
+	{
+	public:
+		static constexpr integer Capacity = Capacity_;
+	};
+
+	template <bool MultipleKeys, integer Capacity>
+	using Tree = BTree<Small_Settings<MultipleKeys, Capacity>, Counting_Customization>;
+
+	template <typename Tree, typename Model>
+	bool agrees(const Tree& tree, const Model& model)
+	{
+		if (!testInvariants(tree) ||
+			tree.size() != model.size())
+		{
+			return false;
+		}
+
+		if (!ranges::equal(
+			ranges::subrange(tree.cbegin().dereferenceKey(), tree.cend().dereferenceKey()),
+			model | ranges::views::keys))
+		{
+			return false;
+		}
+
+		if (!ranges::equal(tree, model | ranges::views::values))
+		{
+			return false;
+		}
+
+		integer sum = 0;
+		for (auto&& keyValue : model)
+		{
+			sum += keyValue.second;
+		}
+
+		if (!tree.empty() &&
+			(tree.croot().propagation().first != tree.size() ||
+			tree.croot().propagation().second != sum))
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	template <bool MultipleKeys, integer Capacity>
+	void testRandom()
+	{
+		using Model = std::conditional_t<MultipleKeys,
+			std::multimap<integer, integer>,
+			std::map<integer, integer>>;
+
+		Tree<MultipleKeys, Capacity> tree;
+		Model model;
+
+		integer n = 2000;
+		for (integer i = 0;i < n;++i)
+		{
+			integer key = randomInteger(n / 2);
+			tree.insert(key, i);
+			model.insert(std::make_pair(key, i));
+		}
+		REQUIRE(agrees(tree, model));
+
+		for (integer i = 0;i < n;++i)
+		{
+			integer key = randomInteger(n / 2);
+			REQUIRE(tree.count(key) == model.count(key));
+			REQUIRE(tree.exists(key) == (model.count(key) > 0));
+			REQUIRE(tree.rank(tree.lowerBound(key)) ==
+				std::distance(model.begin(), model.lower_bound(key)));
+			REQUIRE(tree.rank(tree.upperBound(key)) ==
+				std::distance(model.begin(), model.upper_bound(key)));
+
+			auto equalAndUpper = tree.findEqualAndUpper(key);
+			REQUIRE((equalAndUpper.equal == tree.cend()) == (model.count(key) == 0));
+			REQUIRE(equalAndUpper.upper == tree.upperBound(key));
+		}
+
+		// Erase by iterators, by keys, and by ranges.
+		for (integer i = 0;i < n / 4;++i)
+		{
+			integer key = randomInteger(n / 2);
+
+			auto iter = tree.find(key);
+			auto next = tree.erase(iter);
+			if (iter != tree.cend())
+			{
+				auto modelIter = model.find(key);
+				REQUIRE(tree.rank(next) ==
+					std::distance(model.begin(), modelIter));
+				model.erase(modelIter);
+			}
+
+			key = randomInteger(n / 2);
+			tree.erase(key);
+			model.erase(key);
+
+			key = randomInteger(n / 2);
+			tree.erase(tree.lowerBound(key), tree.upperBound(key + 3));
+			model.erase(model.lower_bound(key), model.upper_bound(key + 3));
+		}
+		REQUIRE(agrees(tree, model));
+
+		Tree<MultipleKeys, Capacity> copy(tree);
+		REQUIRE(agrees(copy, model));
+
+		Tree<MultipleKeys, Capacity> moved(std::move(copy));
+		REQUIRE(agrees(moved, model));
+		REQUIRE(copy.empty());
+		REQUIRE(testInvariants(copy));
+
+		while (!tree.empty())
+		{
+			integer i = randomInteger(tree.size());
+			auto iter = tree.select(i);
+			model.erase(std::next(model.begin(), i));
+			tree.erase(iter);
+		}
+		REQUIRE(agrees(tree, model));
+
+		moved.clear();
+		REQUIRE(moved.empty());
+		REQUIRE(testInvariants(moved));
+
+		moved.insert(1, 2);
+		REQUIRE(moved.size() == 1);
+		REQUIRE(testInvariants(moved));
+	}
+
+}
+
+TEST_CASE("Random (BTree)", "[BTree]")
+{
+	testRandom<false, 3>();
+	testRandom<false, 5>();
+	testRandom<false, 63>();
+	testRandom<true, 3>();
+	testRandom<true, 7>();
+	testRandom<true, 31>();
+}
+
+TEST_CASE("Interface (BTree)", "[BTree]")
+{
+	using Set = BTree_Set<integer>;
+	Set tree{ 5, 3, 8, 1, 9, 5 };
+	REQUIRE(testInvariants(tree));
+	REQUIRE(Set::Capacity % 2 == 1);
+
+	{
+		integer correctSet[] = { 1, 3, 5, 8, 9 };
+		REQUIRE(ranges::equal(tree, correctSet));
+		REQUIRE(ranges::equal(tree | ranges::views::reverse,
+			correctSet | ranges::views::reverse));
+	}
+
+	{
+		auto result = tree.insert(3);
+		REQUIRE(!result.second);
+		REQUIRE(result.first == tree.find(3));
+		REQUIRE(*result.first == 3);
+	}
+
+	REQUIRE(*tree.cbegin() == 1);
+	REQUIRE(*tree.clast() == 9);
+	REQUIRE(*tree.lowerBound(4) == 5);
+	REQUIRE(*tree.upperBound(5) == 8);
+	REQUIRE(tree.lowerBound(10) == tree.cend());
+	REQUIRE(tree.find(4) == tree.cend());
+	REQUIRE(*quantile(tree, 0.5) == 5);
+
+	{
+		BTree_Set<integer> large;
+		for (integer i = 0;i < 1000;++i)
+		{
+			large.insert(i);
+		}
+		REQUIRE(large.height() > 1);
+		REQUIRE(*quantile(large, 0.25) == 250);
+		REQUIRE(*quantile(large, 0.9999) == 999);
+		REQUIRE(large.croot().size() == 1000);
+	}
+
+	REQUIRE(*tree.erase(tree.find(5)) == 8);
+	REQUIRE(tree.erase(tree.find(9)) == tree.cend());
+	REQUIRE(tree.erase(tree.cend()) == tree.cend());
+	REQUIRE(tree.size() == 3);
+	REQUIRE(testInvariants(tree));
+}
+
+TEST_CASE("HashedTree (BTree)", "[BTree]")
+{
+	using Settings = HashedTree_Settings<
+		RedBlackTree_Set_Settings<integer>, std::hash<integer>>;
+	using Hashed_BTree = BTree<Settings, Hash_RedBlackTree_Customization>;
+
+	Hashed_BTree tree;
+	Hashed_Set<integer> redBlackTree;
+	for (integer i = 0;i < 500;++i)
+	{
+		integer key = randomInteger(1000);
+		tree.insert(key);
+		redBlackTree.insert(key);
+	}
+	REQUIRE(tree.hash() == redBlackTree.hash());
+
+	for (integer i = 0;i < 200;++i)
+	{
+		integer key = randomInteger(1000);
+		tree.erase(key);
+		redBlackTree.erase(key);
+	}
+	REQUIRE(tree.hash() == redBlackTree.hash());
+}
@@ -0,0 +1,163 @@
+// Description: Testing for compiled automata
+// DocumentationOf: compiled_automaton.h
+
+#include "test/test_init.h"
+
+#include "pastel/sys/automaton/compiled_automaton.h"
+#include "pastel/sys/automaton/automaton_minimization.h"
+#include "pastel/sys/random/random_integer.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+	using Autom = Automaton<integer>;
+	using State = Autom::State_ConstIterator;
+
+	//! Returns an automaton for the strings containing "ab".
+	Autom containsAb()
+	{
+		Autom automaton;
+		State a = automaton.addState();
+		State b = automaton.addState();
+		State c = automaton.addState();
+		for (integer symbol = 0;symbol < 256;++symbol)
+		{
+			automaton.addTransition(a, symbol, symbol == 'a' ? b : a);
+			automaton.addTransition(b, symbol,
+				symbol == 'a' ? b : (symbol == 'b' ? c : a));
+			automaton.addTransition(c, symbol, c);
+		}
+		automaton.addStart(a);
+		automaton.addFinal(c);
+		return automaton;
+	}
+
+	//! Returns an automaton for the non-empty decimal numbers.
+	/*!
+	The automaton has an explicit trap state.
+	*/
+	Autom decimal()
+	{
+		Autom automaton;
+		State start = automaton.addState();
+		State digits = automaton.addState();
+		State trap = automaton.addState();
+		for (integer symbol = 0;symbol < 256;++symbol)
+		{
+			bool digit = (symbol >= '0' && symbol <= '9');
+			automaton.addTransition(start, symbol, digit ? digits : trap);
+			automaton.addTransition(digits, symbol, digit ? digits : trap);
+			automaton.addTransition(trap, symbol, trap);
+		}
+		automaton.addStart(start);
+		automaton.addFinal(digits);
+		return automaton;
+	}
+
+	std::string randomString(integer maxSize, const std::string& alphabet)
+	{
+		std::string result(randomInteger(maxSize + 1), ' ');
+		for (char& c : result)
+		{
+			c = alphabet[randomInteger(alphabet.size())];
+		}
+		return result;
+	}
+
+}
+
+TEST_CASE("ContainsAb (Compiled_Automaton)")
+{
+	Compiled_Automaton compiled = compileAutomaton(containsAb());
+
+	// 'a', 'b', and the other bytes.
+	REQUIRE(compiled.classes() == 3);
+	REQUIRE(compiled.symbolClass('c') == compiled.symbolClass('z'));
+	REQUIRE(compiled.symbolClass('a') != compiled.symbolClass('b'));
+	REQUIRE(compiled.states() == 4);
+
+	REQUIRE(!compiled.accepts(""));
+	REQUIRE(!compiled.accepts("a"));
+	REQUIRE(!compiled.accepts("ba"));
+	REQUIRE(compiled.accepts("ab"));
+	REQUIRE(compiled.accepts("xxaab"));
+	REQUIRE(compiled.accepts("abxx"));
+
+	for (integer i = 0;i < 1000;++i)
+	{
+		std::string input = randomString(40, "abc");
+		REQUIRE(compiled.accepts(input) == (input.find("ab") != std::string::npos));
+	}
+}
+
+TEST_CASE("Decimal (Compiled_Automaton)")
+{
+	Compiled_Automaton compiled = compileAutomaton(decimal());
+
+	// The trap state is merged into the dead state.
+	REQUIRE(compiled.states() == 3);
+	REQUIRE(compiled.classes() == 2);
+	REQUIRE(compiled.next(compiled.start(), 'x') == compiled.dead());
+	REQUIRE(compiled.final(compiled.next(compiled.start(), '7')));
+	REQUIRE(compiled.index(compiled.dead()) == 0);
+
+	REQUIRE(!compiled.accepts(""));
+	REQUIRE(compiled.accepts("0"));
+	REQUIRE(compiled.accepts("0123456789"));
+	REQUIRE(!compiled.accepts("12a"));
+	REQUIRE(!compiled.accepts(std::string(100, '1') + "x" + std::string(100, '1')));
+	REQUIRE(compiled.accepts(std::string(1000, '5')));
+
+	// A run can be continued from where it stopped.
+	Compiled_Automaton::State state = compiled.run(compiled.start(), "12");
+	REQUIRE(compiled.final(compiled.run(state, "34")));
+	REQUIRE(compiled.run(state, "3.4") == compiled.dead());
+}
+
+TEST_CASE("Minimized (Compiled_Automaton)")
+{
+	Autom minimal = minimizeAutomaton(decimal());
+	Compiled_Automaton compiled = compileAutomaton(minimal);
+	REQUIRE(compiled.accepts("2024"));
+	REQUIRE(!compiled.accepts("20 24"));
+}
+
+TEST_CASE("Empty (Compiled_Automaton)")
+{
+	Compiled_Automaton compiled;
+	REQUIRE(compiled.states() == 1);
+	REQUIRE(!compiled.accepts(""));
+	REQUIRE(!compiled.accepts("abc"));
+
+	Compiled_Automaton compiledEmpty = compileAutomaton(Autom());
+	REQUIRE(compiledEmpty.start() == compiledEmpty.dead());
+	REQUIRE(!compiledEmpty.accepts(""));
+}
+
+TEST_CASE("Interleaved (Compiled_Automaton)")
+{
+	Compiled_Automaton compiled = compileAutomaton(containsAb());
+
+	for (integer streams : {0, 1, 3, 4, 5, 9, 16})
+	{
+		std::vector<std::string> inputSet;
+		for (integer i = 0;i < streams;++i)
+		{
+			inputSet.push_back(randomString(100, "abcd"));
+		}
+
+		std::vector<std::string_view> viewSet(
+			inputSet.begin(), inputSet.end());
+		std::vector<Compiled_Automaton::State> stateSet(
+			streams, compiled.start());
+		compiled.run(stateSet, viewSet);
+
+		for (integer i = 0;i < streams;++i)
+		{
+			REQUIRE(stateSet[i] == compiled.run(compiled.start(), inputSet[i]));
+		}
+	}
+}
@@ -0,0 +1,272 @@
+// Description: Testing for ConcurrentPoolAllocator
+// DocumentationOf: concurrent_pool_allocator.h
+
+#include "test/test_init.h"
+#include "pastel/sys/allocator/concurrent_pool_allocator.h"
+
+#include "pastel/sys/random.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Allocate (ConcurrentPoolAllocator)")
+{
+	ConcurrentPoolAllocator allocator(15);
+	REQUIRE(allocator.unitSize() == 15);
+
+	std::vector<uint8*> memoryList;
+	for (integer i = 0;i < 2055;++i)
+	{
+		uint8* memory = (uint8*)allocator.allocate();
+		std::fill(memory, memory + 15, (uint8)i);
+		memoryList.push_back(memory);
+	}
+
+	REQUIRE(allocator.allocated() == 2055);
+	REQUIRE(allocator.capacity() >= 2055);
+
+	// The units do not overlap.
+	std::set<uint8*> memorySet(memoryList.begin(), memoryList.end());
+	REQUIRE(memorySet.size() == memoryList.size());
+	for (integer i = 0;i < memoryList.size();++i)
+	{
+		REQUIRE(std::count(memoryList[i], memoryList[i] + 15, (uint8)i) == 15);
+	}
+
+	for (uint8* memory : memoryList)
+	{
+		allocator.deallocate(memory);
+	}
+
+	REQUIRE(allocator.allocated() == 0);
+
+	ConcurrentPoolAllocator::Statistics statistics = allocator.statistics();
+	REQUIRE(statistics.allocations == 2055);
+	REQUIRE(statistics.deallocations == 2055);
+	REQUIRE(statistics.remoteDeallocations == 0);
+	REQUIRE(statistics.threads == 1);
+
+	// One empty block is kept.
+	REQUIRE(statistics.blocksAllocated - statistics.blocksFreed == 1);
+
+	allocator.clear();
+	REQUIRE(allocator.capacity() == 0);
+}
+
+TEST_CASE("RandomDeallocate (ConcurrentPoolAllocator)")
+{
+	ConcurrentPoolAllocator allocator(sizeof(int));
+	integer Units = 100000;
+
+	std::vector<int*> memoryList;
+	for (integer i = 0;i < Units;++i)
+	{
+		memoryList.push_back((int*)allocator.allocate());
+		*memoryList.back() = i;
+	}
+
+	for (integer i = 0;i < Units;++i)
+	{
+		integer index = randomInteger(Units);
+		if (memoryList[index] != 0)
+		{
+			REQUIRE(*memoryList[index] == index);
+			allocator.deallocate(memoryList[index]);
+			memoryList[index] = 0;
+		}
+	}
+
+	// Reallocate some of the freed units.
+	for (integer i = 0;i < Units;++i)
+	{
+		if (memoryList[i] == 0 && randomInteger(2) == 0)
+		{
+			memoryList[i] = (int*)allocator.allocate();
+			*memoryList[i] = i;
+		}
+	}
+
+	for (integer i = 0;i < Units;++i)
+	{
+		if (memoryList[i] != 0)
+		{
+			REQUIRE(*memoryList[i] == i);
+			allocator.deallocate(memoryList[i]);
+		}
+	}
+
+	REQUIRE(allocator.allocated() == 0);
+}
+
+TEST_CASE("Remote deallocation (ConcurrentPoolAllocator)")
+{
+	ConcurrentPoolAllocator allocator(24);
+	integer Units = 10000;
+
+	std::vector<void*> memoryList;
+	for (integer i = 0;i < Units;++i)
+	{
+		memoryList.push_back(allocator.allocate());
+	}
+
+	// Another thread deallocates the units.
+	std::thread thread([&]()
+	{
+		for (void* memory : memoryList)
+		{
+			allocator.deallocate(memory);
+		}
+	});
+	thread.join();
+
+	ConcurrentPoolAllocator::Statistics statistics = allocator.statistics();
+	REQUIRE(statistics.remoteDeallocations == Units);
+	REQUIRE(statistics.threads == 2);
+	REQUIRE(allocator.allocated() == 0);
+
+	// The owner reuses the remotely deallocated units
+	// before growing the capacity.
+	integer capacity = allocator.capacity();
+	for (integer i = 0;i < Units;++i)
+	{
+		memoryList[i] = allocator.allocate();
+	}
+	REQUIRE(allocator.capacity() <= capacity);
+
+	for (void* memory : memoryList)
+	{
+		allocator.deallocate(memory);
+	}
+	REQUIRE(allocator.allocated() == 0);
+}
+
+TEST_CASE("Exited thread (ConcurrentPoolAllocator)")
+{
+	ConcurrentPoolAllocator allocator(24);
+	integer Units = 10000;
+
+	// A thread allocates the units, and exits.
+	std::vector<void*> memoryList;
+	std::thread([&]()
+	{
+		for (integer i = 0;i < Units;++i)
+		{
+			memoryList.push_back(allocator.allocate());
+		}
+	}).join();
+
+	integer blocks = allocator.statistics().blocksAllocated;
+	integer unitsPerBlock = allocator.capacity() / blocks;
+	REQUIRE(blocks > 1);
+
+	// The units are deallocated to the exited thread.
+	for (void* memory : memoryList)
+	{
+		allocator.deallocate(memory);
+	}
+	REQUIRE(allocator.allocated() == 0);
+	REQUIRE(allocator.capacity() == blocks * unitsPerBlock);
+
+	// Another thread adopts the blocks, and the units
+	// deallocated to them, instead of allocating a new
+	// block. It keeps one empty block, and exits with a
+	// unit allocated.
+	void* memory = nullptr;
+	std::thread([&]()
+	{
+		memory = allocator.allocate();
+	}).join();
+
+	ConcurrentPoolAllocator::Statistics statistics = allocator.statistics();
+	REQUIRE(statistics.blocksAllocated == blocks);
+	REQUIRE(statistics.blocksFreed == blocks - 1);
+	REQUIRE(allocator.capacity() == unitsPerBlock);
+	REQUIRE(allocator.allocated() == 1);
+
+	// The adopted blocks are adopted again.
+	allocator.deallocate(memory);
+	memoryList.clear();
+	for (integer i = 0;i < unitsPerBlock;++i)
+	{
+		memoryList.push_back(allocator.allocate());
+	}
+	REQUIRE(allocator.statistics().blocksAllocated == blocks);
+	REQUIRE(allocator.capacity() == unitsPerBlock);
+	REQUIRE(allocator.statistics().threads == 3);
+
+	for (void* memory : memoryList)
+	{
+		allocator.deallocate(memory);
+	}
+	REQUIRE(allocator.allocated() == 0);
+}
+
+TEST_CASE("Parallel (ConcurrentPoolAllocator)")
+{
+	ConcurrentPoolAllocator allocator(sizeof(integer));
+	integer Threads = 4;
+	integer Units = 50000;
+
+	auto runThreads = [&](auto&& work)
+	{
+		std::vector<std::thread> threadSet;
+		for (integer t = 0;t < Threads;++t)
+		{
+			threadSet.emplace_back(work, t);
+		}
+		for (std::thread& thread : threadSet)
+		{
+			thread.join();
+		}
+	};
+
+	std::vector<std::vector<integer*>> memorySet(Threads);
+	runThreads([&](integer t)
+	{
+		for (integer i = 0;i < Units;++i)
+		{
+			memorySet[t].push_back((integer*)allocator.allocate());
+			*memorySet[t].back() = t * Units + i;
+		}
+	});
+
+	// Each thread deallocates the units of another thread,
+	// while allocating new units concurrently.
+	std::vector<std::vector<integer*>> secondSet(Threads);
+	std::vector<integer> errorSet(Threads, 0);
+	runThreads([&](integer t)
+	{
+		integer other = (t + 1) % Threads;
+		for (integer i = 0;i < Units;++i)
+		{
+			integer* memory = memorySet[other][i];
+			if (*memory != other * Units + i)
+			{
+				++errorSet[t];
+			}
+			allocator.deallocate(memory);
+
+			secondSet[t].push_back((integer*)allocator.allocate());
+			*secondSet[t].back() = t * Units + i;
+		}
+	});
+
+	REQUIRE(std::count(errorSet.begin(), errorSet.end(), 0) == Threads);
+
+	ConcurrentPoolAllocator::Statistics statistics = allocator.statistics();
+	REQUIRE(statistics.deallocations == Threads * Units);
+	REQUIRE(allocator.allocated() == Threads * Units);
+
+	for (integer t = 0;t < Threads;++t)
+	{
+		for (integer i = 0;i < Units;++i)
+		{
+			REQUIRE(*secondSet[t][i] == t * Units + i);
+			allocator.deallocate(secondSet[t][i]);
+		}
+	}
+
+	REQUIRE(allocator.allocated() == 0);
+}
@@ -0,0 +1,221 @@
+// Description: Testing for concurrent skip lists
+// DocumentationOf: concurrent_skiplist.h
+
+#include "test/test_init.h"
+
+#include "pastel/sys/skiplist.h"
+#include "pastel/sys/random/random_integer.h"
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Random (ConcurrentSkipList)")
+{
+	using List = ConcurrentSkipList_MultiMap<integer, integer>;
+	List list;
+	std::multimap<integer, integer> model;
+
+	integer n = 5000;
+	for (integer i = 0;i < n;++i)
+	{
+		integer key = randomInteger(n / 4);
+		REQUIRE(list.insert(key, i));
+		model.insert(std::make_pair(key, i));
+	}
+	REQUIRE(testInvariants(list));
+	REQUIRE(list.size() == n);
+
+	auto agrees = [&]()
+	{
+		auto reader = list.read();
+		return ranges::equal(reader, model | ranges::views::values);
+	};
+	REQUIRE(agrees());
+
+	for (integer i = 0;i < n / 4;++i)
+	{
+		integer key = randomInteger(n / 4);
+		{
+			auto reader = list.read();
+			REQUIRE(reader.count(key) == model.count(key));
+			REQUIRE((reader.find(key) == reader.cend()) == (model.count(key) == 0));
+			if (reader.lowerBound(key) != reader.cend())
+			{
+				REQUIRE(reader.lowerBound(key).key() == model.lower_bound(key)->first);
+			}
+			if (reader.upperBound(key) != reader.cend())
+			{
+				REQUIRE(reader.upperBound(key).key() == model.upper_bound(key)->first);
+			}
+		}
+
+		REQUIRE(list.erase(key) == model.erase(key));
+		REQUIRE(list.exists(key) == false);
+	}
+	REQUIRE(testInvariants(list));
+	REQUIRE(list.size() == model.size());
+	REQUIRE(agrees());
+
+	list.clear();
+	REQUIRE(list.empty());
+	REQUIRE(list.retired() == 0);
+	REQUIRE(testInvariants(list));
+}
+
+TEST_CASE("Set (ConcurrentSkipList)")
+{
+	using List = ConcurrentSkipList_Set<integer>;
+	List list;
+	for (integer i : {5, 3, 8, 1, 9, 5})
+	{
+		list.insert(i);
+	}
+	REQUIRE(!list.insert(3));
+	REQUIRE(list.size() == 5);
+	REQUIRE(testInvariants(list));
+
+	{
+		integer correctSet[] = { 1, 3, 5, 8, 9 };
+		auto reader = list.read();
+		REQUIRE(ranges::equal(reader, correctSet));
+		REQUIRE(*reader.lowerBound(4) == 5);
+		REQUIRE(*reader.upperBound(5) == 8);
+		REQUIRE(reader.lowerBound(10) == reader.cend());
+	}
+
+	REQUIRE(list.erase(4) == 0);
+	REQUIRE(list.erase(5) == 1);
+	REQUIRE(!list.exists(5));
+	REQUIRE(list.size() == 4);
+}
+
+TEST_CASE("Reclamation (ConcurrentSkipList)")
+{
+	using List = ConcurrentSkipList_Map<integer, integer>;
+	List list(4);
+	REQUIRE(list.readers() == 4);
+
+	for (integer i = 0;i < 100;++i)
+	{
+		list.insert(i, i * i);
+	}
+
+	{
+		// The reader keeps the removed elements alive.
+		auto reader = list.read();
+		auto iter = reader.find(50);
+		REQUIRE(iter != reader.cend());
+
+		for (integer i = 0;i < 100;i += 2)
+		{
+			list.erase(i);
+		}
+		REQUIRE(list.retired() == 50);
+		REQUIRE(iter.value() == 2500);
+
+		// The iteration from a removed element continues
+		// to the elements after it.
+		++iter;
+		REQUIRE(iter.key() == 51);
+
+		list.reclaim();
+		REQUIRE(list.retired() == 50);
+	}
+
+	// A reader which starts after the removal does not
+	// keep the removed elements alive.
+	{
+		auto reader = list.read();
+		list.reclaim();
+		REQUIRE(list.retired() == 0);
+		REQUIRE(reader.count(50) == 0);
+	}
+
+	REQUIRE(list.size() == 50);
+	REQUIRE(testInvariants(list));
+}
+
+TEST_CASE("Concurrent (ConcurrentSkipList)")
+{
+	using List = ConcurrentSkipList_Set<integer>;
+	List list;
+
+	// The multiples of 4 are never removed.
+	integer n = 4000;
+	for (integer i = 0;i < n;i += 4)
+	{
+		list.insert(i);
+	}
+
+	std::atomic<bool> done(false);
+	std::atomic<integer> failures(0);
+
+	auto read = [&](integer seed)
+	{
+		std::minstd_rand random(seed);
+		while (!done)
+		{
+			auto reader = list.read();
+
+			integer key = random() % n;
+			if (reader.find(key - key % 4) == reader.cend())
+			{
+				++failures;
+			}
+
+			// The elements are always seen in order, and
+			// only the even keys are ever inserted.
+			integer previous = -1;
+			integer stable = 0;
+			for (integer key : reader)
+			{
+				if (key <= previous || key % 2 != 0)
+				{
+					++failures;
+				}
+				stable += (key % 4 == 0);
+				previous = key;
+			}
+
+			if (stable != n / 4)
+			{
+				++failures;
+			}
+		}
+	};
+
+	std::vector<std::thread> readerSet;
+	for (integer i = 0;i < 4;++i)
+	{
+		readerSet.emplace_back(read, i + 1);
+	}
+
+	for (integer round = 0;round < 20;++round)
+	{
+		for (integer i = 2;i < n;i += 4)
+		{
+			list.insert(i);
+		}
+		for (integer i = 2;i < n;i += 4)
+		{
+			list.erase(i);
+		}
+	}
+
+	done = true;
+	for (auto& thread : readerSet)
+	{
+		thread.join();
+	}
+
+	REQUIRE(failures == 0);
+	REQUIRE(list.size() == n / 4);
+
+	list.reclaim();
+	REQUIRE(list.retired() == 0);
+	REQUIRE(testInvariants(list));
+}
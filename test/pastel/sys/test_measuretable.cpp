@@ -0,0 +1,99 @@
+// Description: Testing for MeasureTable
+// DocumentationOf: measuretable.h
+
+#include "test/test_init.h"
+
+#include "pastel/sys/measuretable.h"
+
+#include <sstream>
+
+TEST_CASE("isJsonNumber (MeasureTable)")
+{
+	using MeasureTable_::isJsonNumber;
+
+	REQUIRE(isJsonNumber("0"));
+	REQUIRE(isJsonNumber("-0"));
+	REQUIRE(isJsonNumber("12"));
+	REQUIRE(isJsonNumber("-12.5"));
+	REQUIRE(isJsonNumber("0.001"));
+	REQUIRE(isJsonNumber("1e10"));
+	REQUIRE(isJsonNumber("1.5E-3"));
+	REQUIRE(isJsonNumber("2e+3"));
+
+	REQUIRE(!isJsonNumber(""));
+	REQUIRE(!isJsonNumber("-"));
+	REQUIRE(!isJsonNumber("01"));
+	REQUIRE(!isJsonNumber(".5"));
+	REQUIRE(!isJsonNumber("1."));
+	REQUIRE(!isJsonNumber("+1"));
+	REQUIRE(!isJsonNumber("1e"));
+	REQUIRE(!isJsonNumber("inf"));
+	REQUIRE(!isJsonNumber("nan"));
+	REQUIRE(!isJsonNumber("0x10"));
+	REQUIRE(!isJsonNumber("1 "));
+	REQUIRE(!isJsonNumber("Uniform"));
+}
+
+TEST_CASE("printJson (MeasureTable)")
+{
+	MeasureTable table;
+	table.setCaption("A \"quoted\" caption");
+	table.setSize(3, 3);
+	table(0, 0).text() = "Name";
+	table(1, 0).text() = "1";
+	table(2, 0).text() = "Time";
+	table(0, 1).text() = "a\\b";
+	table(1, 1).text() = "1000";
+	table(2, 1).text() = "0.25";
+	table(0, 2).text() = "c";
+	table(1, 2).text() = "";
+	table(2, 2).text() = "1e-05";
+	table.addHorizontalSeparator(1);
+
+	std::stringstream stream;
+	printJson(table, stream);
+
+	std::string expected =
+		"{\n"
+		"\t\"caption\": \"A \\\"quoted\\\" caption\",\n"
+		"\t\"columns\": [\"Name\", \"1\", \"Time\"],\n"
+		"\t\"rows\": [\n"
+		"\t\t[\"a\\\\b\", 1000, 0.25],\n"
+		"\t\t[\"c\", \"\", 1e-05]\n"
+		"\t]\n"
+		"}\n";
+	REQUIRE(stream.str() == expected);
+
+	// A table with only the header.
+	table.setSize(3, 1);
+	std::stringstream headerStream;
+	printJson(table, headerStream);
+	REQUIRE(headerStream.str() ==
+		"{\n"
+		"\t\"caption\": \"A \\\"quoted\\\" caption\",\n"
+		"\t\"columns\": [\"Name\", \"1\", \"Time\"],\n"
+		"\t\"rows\": []\n"
+		"}\n");
+}
+
+TEST_CASE("printPretty (MeasureTable)")
+{
+	MeasureTable table;
+	table.setSize(2, 2);
+	table(0, 0).text() = "n";
+	table(1, 0).text() = "Time";
+	table(0, 1).text() = "10";
+	table(1, 1).text() = "1";
+	table(1, 1).setAlignment(MeasureTable::Alignment::Right);
+
+	std::stringstream pretty;
+	printPretty(table, pretty);
+	REQUIRE(pretty.str() ==
+		" n   Time \n"
+		" 10     1 \n"
+		"\n");
+
+	std::stringstream latex;
+	printLatex(table, latex);
+	REQUIRE(latex.str().find("10 & 1 \\\\") != std::string::npos);
+}
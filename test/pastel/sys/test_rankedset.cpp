@@ -3,6 +3,9 @@
 
 #include "test/test_init.h"
 #include "pastel/sys/rankedset/rankedset.h"
+#include "pastel/sys/random/random_integer.h"
+
+#include <memory>
 
 TEST_CASE("Simple (RankedSet)")
 {
@@ -96,3 +99,190 @@ TEST_CASE("Overflow (RankedSet)")
 
 	//REQUIRE_THROWS_AS(aSet.pop(), InvariantFailure);
 }
+
+namespace
+{
+
+	template <typename Set>
+	bool agrees(Set& aSet, integer k, std::vector<integer>& model)
+	{
+		std::sort(model.begin(), model.end());
+		if ((integer)model.size() > k)
+		{
+			model.resize(k);
+		}
+
+		if (aSet.size() != (integer)model.size())
+		{
+			return false;
+		}
+
+		if (!model.empty() && aSet.top() != model.back())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	template <typename Set>
+	void testRandom(Set aSet, integer k)
+	{
+		std::vector<integer> model;
+		for (integer i = 0;i < 20 * k + 10;++i)
+		{
+			integer that = randomInteger(4 * k + 1);
+			auto iter = aSet.push(that);
+			REQUIRE((iter == aSet.end() || *iter == that));
+			model.push_back(that);
+			REQUIRE(agrees(aSet, k, model));
+		}
+
+		aSet.pop();
+		model.pop_back();
+		REQUIRE(agrees(aSet, k, model));
+
+		Set copySet = aSet;
+		std::vector<integer> heap = copySet.release(false);
+		REQUIRE(std::is_heap(heap.begin(), heap.end()));
+		std::sort(heap.begin(), heap.end());
+		REQUIRE(heap == model);
+
+		REQUIRE(aSet.release(true) == model);
+		REQUIRE(aSet.empty());
+	}
+
+}
+
+TEST_CASE("Random (RankedSet)")
+{
+	for (integer k : {1, 2, 3, 8, 32, 33, 100})
+	{
+		testRandom(RankedSet<integer>(k, LessThan(), RankedSet_Policy::Heap), k);
+		testRandom(RankedSet<integer>(k, LessThan(), RankedSet_Policy::Sorted), k);
+		testRandom(RankedSet<integer>(k), k);
+	}
+
+	testRandom(RankedSet<integer, LessThan, 1>(), 1);
+	testRandom(RankedSet<integer, LessThan, 5>(), 5);
+	testRandom(RankedSet<integer, LessThan, 16>(), 16);
+}
+
+TEST_CASE("Policy (RankedSet)")
+{
+	RankedSet<integer> aSet(4);
+	REQUIRE(aSet.policy() == RankedSet_Policy::Automatic);
+	REQUIRE(aSet.sorted());
+
+	for (integer i : {5, 1, 4, 2, 3})
+	{
+		aSet.push(i);
+	}
+	{
+		integer correctSet[] = {1, 2, 3, 4};
+		REQUIRE(ranges::equal(aSet, correctSet));
+	}
+
+	// A large capacity switches to a heap.
+	aSet.reserve(RankedSet_::SortedCapacity + 1);
+	REQUIRE(!aSet.sorted());
+	REQUIRE(aSet.top() == 4);
+	aSet.push(0);
+	REQUIRE(aSet.top() == 4);
+
+	// A small capacity switches back to a sorted array.
+	aSet.reserve(3);
+	REQUIRE(aSet.sorted());
+	{
+		integer correctSet[] = {0, 1, 2};
+		REQUIRE(ranges::equal(aSet, correctSet));
+	}
+
+	RankedSet<integer> heapSet(4, LessThan(), RankedSet_Policy::Heap);
+	REQUIRE(!heapSet.sorted());
+	RankedSet<integer> sortedSet(100, LessThan(), RankedSet_Policy::Sorted);
+	REQUIRE(sortedSet.sorted());
+
+	// Releasing keeps the policy.
+	heapSet.push(1);
+	heapSet.release();
+	REQUIRE(heapSet.policy() == RankedSet_Policy::Heap);
+	REQUIRE(heapSet.capacity() == 0);
+	heapSet.reserve(4);
+	REQUIRE(!heapSet.sorted());
+
+	sortedSet.release(false);
+	REQUIRE(sortedSet.policy() == RankedSet_Policy::Sorted);
+	sortedSet.reserve(100);
+	REQUIRE(sortedSet.sorted());
+}
+
+TEST_CASE("Fixed (RankedSet)")
+{
+	RankedSet<integer, LessThan, 3> aSet;
+	REQUIRE(aSet.capacity() == 3);
+	REQUIRE(aSet.empty());
+
+	for (integer i : {5, 1, 4, 2, 3})
+	{
+		aSet.push(i);
+	}
+	REQUIRE(aSet.full());
+	REQUIRE(aSet.top() == 3);
+	REQUIRE(aSet.push(7) == aSet.end());
+	REQUIRE(*aSet.push(0) == 0);
+
+	integer correctSet[] = {0, 1, 2};
+	REQUIRE(ranges::equal(aSet, correctSet));
+
+	RankedSet<integer, LessThan, 0> emptySet;
+	REQUIRE(emptySet.push(1) == emptySet.end());
+	REQUIRE(emptySet.empty());
+}
+
+TEST_CASE("NoDefault (RankedSet)")
+{
+	struct Element
+	{
+		explicit Element(integer value)
+			: value(std::make_shared<integer>(value))
+		{
+		}
+
+		bool operator<(const Element& that) const
+		{
+			return *value < *that.value;
+		}
+
+		std::shared_ptr<integer> value;
+	};
+
+	using Set = RankedSet<Element, LessThan, 4>;
+
+	Set aSet;
+	for (integer i : {6, 2, 5, 1, 4, 3})
+	{
+		aSet.push(Element(i));
+	}
+	aSet.pop();
+
+	Set bSet;
+	bSet.push(Element(9));
+	bSet.swap(aSet);
+	REQUIRE(aSet.size() == 1);
+	REQUIRE(bSet.size() == 3);
+	REQUIRE(*bSet.top().value == 3);
+
+	Set cSet = std::move(bSet);
+	REQUIRE(bSet.empty());
+	bSet = cSet;
+	REQUIRE(bSet.size() == 3);
+
+	std::vector<Element> elementSet = cSet.release();
+	REQUIRE(elementSet.size() == 3);
+	for (integer i = 0;i < 3;++i)
+	{
+		REQUIRE(*elementSet[i].value == i + 1);
+		REQUIRE(elementSet[i].value.use_count() == 2);
+	}
+}
@@ -9,8 +9,13 @@
 #include <pastel/sys/downfilter.h>
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <list>
+#include <numeric>
+#include <set>
+
+#include <tbb/task_arena.h>
 
 namespace
 {
@@ -26,6 +31,13 @@ namespace
 	class Map_Counting_Customization
 		: public Empty_RedBlackTree_Customization<Settings_>
 	{
+	public:
+		//! Returns the number of erased elements.
+		integer erased() const
+		{
+			return erased_;
+		}
+
 	protected:
 		using Fwd = RedBlackTree_Fwd<Settings_>;
 		PASTEL_FWD(Iterator);
@@ -33,6 +45,11 @@ namespace
 
 		Map_Counting_Customization() {}
 
+		void onErase(const Iterator& element)
+		{
+			++erased_;
+		}
+
 		void updatePropagation(
 			const Iterator& iter,
 			Propagation& propagation)
@@ -50,6 +67,8 @@ namespace
 		Map_Counting_Customization(const Map_Counting_Customization& that) = delete;
 		Map_Counting_Customization(Map_Counting_Customization&& that) = delete;
 		Map_Counting_Customization& operator=(Map_Counting_Customization) = delete;
+
+		integer erased_ = 0;
 	};
 
 	template <typename Settings_>
@@ -1546,3 +1565,277 @@ TEST_CASE("RedBlackTree (RedBlackTree)")
 	testManyThings<MultiSet>();
 	testManyThings<MultiMap>();
 }
+
+TEST_CASE("AssignSorted (RedBlackTree)")
+{
+	auto blackHeightPropagates = [](const auto& tree)
+	{
+		return tree.croot().propagation().blackHeight == tree.blackHeight();
+	};
+
+	for (integer n = 0; n < 130; ++n)
+	{
+		Set tree = { 5, 6, 7 };
+		auto end = tree.cend();
+
+		tree.assignSorted(ranges::views::iota((integer)0, n));
+		REQUIRE(testInvariants(tree));
+		REQUIRE(tree.size() == n);
+		REQUIRE(tree.cend() == end);
+		REQUIRE(ranges::equal(tree.crange().dereferenceKey(), ranges::views::iota((integer)0, n)));
+		REQUIRE(blackHeightPropagates(tree));
+	}
+
+	{
+		std::vector<integer> keySet = { 1, 1, 2, 3, 3, 3, 4 };
+		std::vector<Data> dataSet = { 0, 1, 2, 3, 4, 5, 6 };
+
+		Map map;
+		map.assignSorted(keySet, dataSet);
+		REQUIRE(testInvariants(map));
+		REQUIRE(ranges::equal(map.crange().dereferenceKey(), std::vector<integer>{1, 2, 3, 4}));
+
+		// The first of equivalent keys is stored.
+		REQUIRE(ranges::equal(map.crange().dereferenceData() | DataAsInteger, std::vector<integer>{0, 2, 3, 6}));
+
+		MultiMap multiMap;
+		multiMap.assignSorted(keySet, dataSet);
+		REQUIRE(testInvariants(multiMap));
+		REQUIRE(ranges::equal(multiMap.crange().dereferenceKey(), keySet));
+		REQUIRE(ranges::equal(multiMap.crange().dereferenceData() | DataAsInteger, 
+			ranges::views::iota((integer)0, (integer)7)));
+	}
+
+	{
+		// Unsorted keys are rejected, and the tree is left as it was.
+		Set tree = { 1, 2 };
+		REQUIRE_THROWS_AS(tree.assignSorted(std::vector<integer>{1, 3, 2}), InvariantFailure);
+		REQUIRE(testInvariants(tree));
+		REQUIRE(ranges::equal(tree.crange().dereferenceKey(), std::vector<integer>{1, 2}));
+	}
+
+	{
+		// The bulk-built tree works with the other operations.
+		integer n = 5000;
+		Set tree;
+		tree.assignSorted(ranges::views::iota((integer)0, n) | 
+			ranges::views::transform([](integer x) {return 2 * x;}));
+		REQUIRE(testInvariants(tree));
+
+		for (integer i = 0; i < 100; ++i)
+		{
+			tree.insert(2 * randomInteger(n) + 1);
+			tree.erase(2 * randomInteger(n));
+		}
+		REQUIRE(testInvariants(tree));
+		REQUIRE(blackHeightPropagates(tree));
+
+		Set right = tree.split(n);
+		REQUIRE(testInvariants(tree));
+		REQUIRE(testInvariants(right));
+		REQUIRE(blackHeightPropagates(right));
+	}
+}
+
+TEST_CASE("Erase range (RedBlackTree)")
+{
+	integer n = 300;
+	std::vector<integer> keySet(n);
+	std::iota(keySet.begin(), keySet.end(), (integer)0);
+
+	for (integer i = 0; i <= n; i += 13)
+	{
+		for (integer j = i; j <= n; j += 11)
+		{
+			MultiSet tree;
+			tree.assignSorted(keySet);
+			auto end = tree.cend();
+
+			auto next = tree.erase(
+				std::next(tree.cbegin(), i), 
+				std::next(tree.cbegin(), j));
+
+			REQUIRE(testInvariants(tree));
+			REQUIRE(tree.size() == n - (j - i));
+			REQUIRE(tree.cend() == end);
+			REQUIRE(next == std::next(tree.begin(), i));
+			REQUIRE(tree.croot().propagation().blackHeight == tree.blackHeight());
+
+			std::vector<integer> correctSet = keySet;
+			correctSet.erase(correctSet.begin() + i, correctSet.begin() + j);
+			REQUIRE(ranges::equal(tree.crange().dereferenceKey(), correctSet));
+		}
+	}
+
+	{
+		Map map;
+		map.assignSorted(keySet);
+		map.erase(map.cbegin(), map.cend());
+		REQUIRE(testInvariants(map));
+		REQUIRE(map.empty());
+
+		map.assignSorted(keySet);
+		REQUIRE(testInvariants(map));
+		REQUIRE(map.size() == n);
+	}
+}
+
+TEST_CASE("Set operations (RedBlackTree)")
+{
+	using Operation = std::function<void(Map&, Map&, bool)>;
+
+	auto test = [&](
+		integer aSize, integer bSize, integer m,
+		const Operation& operation,
+		auto&& correctOperation)
+	{
+		std::set<integer> aSet;
+		std::set<integer> bSet;
+		while (aSet.size() < aSize)
+		{
+			aSet.insert(randomInteger(m));
+		}
+		while (bSet.size() < bSize)
+		{
+			bSet.insert(randomInteger(m));
+		}
+
+		std::vector<integer> correctSet;
+		correctOperation(
+			aSet.begin(), aSet.end(), 
+			bSet.begin(), bSet.end(),
+			std::back_inserter(correctSet));
+
+		// The elements of the first tree which are not kept.
+		integer aErased = aSize;
+		for (integer key : correctSet)
+		{
+			aErased -= aSet.count(key);
+		}
+		integer bErased = aSize + bSize - correctSet.size() - aErased;
+
+		std::vector<std::pair<integer, bool>> previousSet;
+		// Zero threads means a sequential computation.
+		for (integer threads : {0, 1, 4})
+		{
+			bool parallel = (threads > 0);
+
+			Map aTree;
+			aTree.assignSorted(aSet, ranges::views::repeat_n(Data(1), aSize));
+
+			Map bTree;
+			bTree.useBottomFrom(aTree);
+			for (integer key : bSet)
+			{
+				bTree.insert(key, Data(2));
+			}
+
+			auto compute = [&]()
+			{
+				operation(aTree, bTree, parallel);
+			};
+
+			if (parallel)
+			{
+				tbb::task_arena(threads).execute(compute);
+			}
+			else
+			{
+				compute();
+			}
+
+			if (!testInvariants(aTree) || 
+				!testInvariants(bTree) ||
+				!bTree.empty() ||
+				!ranges::equal(aTree.crange().dereferenceKey(), correctSet))
+			{
+				return false;
+			}
+
+			// The destroyed elements are notified to their trees.
+			if (aTree.erased() != aErased ||
+				bTree.erased() != bErased)
+			{
+				return false;
+			}
+
+			if (!aTree.empty() && 
+				aTree.croot().propagation().blackHeight != aTree.blackHeight())
+			{
+				return false;
+			}
+
+			std::vector<std::pair<integer, bool>> resultSet;
+			for (auto iter = aTree.cbegin(); iter != aTree.cend(); ++iter)
+			{
+				// The element of the first tree is kept.
+				if (aSet.count(iter.key()) && iter.data().value != 1)
+				{
+					return false;
+				}
+				resultSet.emplace_back(iter.key(), iter.red());
+			}
+
+			// The result does not depend on threading.
+			if (threads > 1 && resultSet != previousSet)
+			{
+				return false;
+			}
+			previousSet = resultSet;
+		}
+
+		return true;
+	};
+
+	Operation unite = [](Map& a, Map& b, bool parallel) 
+	{
+		a.unite(b, PASTEL_TAG(parallel), parallel);
+	};
+
+	Operation intersect = [](Map& a, Map& b, bool parallel) 
+	{
+		a.intersect(b, PASTEL_TAG(parallel), parallel);
+	};
+
+	Operation subtract = [](Map& a, Map& b, bool parallel) 
+	{
+		a.subtract(b, PASTEL_TAG(parallel), parallel);
+	};
+
+	auto correctUnion = [](auto&&... x) {std::set_union(x...);};
+	auto correctIntersection = [](auto&&... x) {std::set_intersection(x...);};
+	auto correctDifference = [](auto&&... x) {std::set_difference(x...);};
+
+	std::vector<std::array<integer, 3>> sizeSet = 
+	{
+		{0, 0, 10},
+		{0, 10, 100},
+		{10, 0, 100},
+		{1, 1, 2},
+		{10, 10, 20},
+		{100, 3, 1000},
+		{3, 100, 1000},
+		{1000, 1000, 1500},
+		{4000, 3000, 10000},
+		{200, 6000, 8000},
+		{100000, 2000, 1000000},
+		{50000, 40000, 200000}
+	};
+
+	for (auto&& sizes : sizeSet)
+	{
+		REQUIRE(test(sizes[0], sizes[1], sizes[2], unite, correctUnion));
+		REQUIRE(test(sizes[0], sizes[1], sizes[2], intersect, correctIntersection));
+		REQUIRE(test(sizes[0], sizes[1], sizes[2], subtract, correctDifference));
+	}
+
+	{
+		Set tree = { 1, 2, 3 };
+		tree.unite(tree);
+		REQUIRE(tree.size() == 3);
+		tree.intersect(tree);
+		REQUIRE(tree.size() == 3);
+		tree.subtract(tree);
+		REQUIRE(tree.empty());
+	}
+}